@@ -83,6 +83,21 @@ void BruteForceDetection::addCollisionModel(core::CollisionModel *cm)
 
     // If a box is defined, check that both collision models are inside the box
     // If both models are outside, ignore them
+    if (!isInsideBox(cm))
+        return;
+
+    addSelfCollisionPair(cm);
+
+    // Browse all other collision models to check if there is a potential collision (conservative check)
+    for (sofa::helper::vector<core::CollisionModel*>::iterator it = collisionModels.begin(); it != collisionModels.end(); ++it)
+    {
+        addPotentialCollisionPair(cm, *it);
+    }
+    collisionModels.push_back(cm);
+}
+
+bool BruteForceDetection::isInsideBox(core::CollisionModel *cm)
+{
     if (boxModel)
     {
         bool swapModels = false;
@@ -94,10 +109,14 @@ void BruteForceDetection::addCollisionModel(core::CollisionModel *cm)
 
             // Here we assume a single root element is present in both models
             if (!intersector->canIntersect(cm1->begin(), cm2->begin()))
-                return;
+                return false;
         }
     }
+    return true;
+}
 
+void BruteForceDetection::addSelfCollisionPair(core::CollisionModel *cm)
+{
     if (cm->isSimulated() && cm->getLast()->canCollideWith(cm->getLast()))
     {
         // self collision
@@ -109,36 +128,32 @@ void BruteForceDetection::addCollisionModel(core::CollisionModel *cm)
                 cmPairs.push_back(std::make_pair(cm, cm));
             }
     }
+}
 
-    // Browse all other collision models to check if there is a potential collision (conservative check)
-    for (sofa::helper::vector<core::CollisionModel*>::iterator it = collisionModels.begin(); it != collisionModels.end(); ++it)
+void BruteForceDetection::addPotentialCollisionPair(core::CollisionModel *cm, core::CollisionModel *cm2)
+{
+    // ignore this pair if both are NOT simulated (inactive)
+    if (!cm->isSimulated() && !cm2->isSimulated())
     {
-        core::CollisionModel* cm2 = *it;
-
-        // ignore this pair if both are NOT simulated (inactive)
-        if (!cm->isSimulated() && !cm2->isSimulated())
-        {
-            continue;
-        }
+        return;
+    }
 
-        if (!keepCollisionBetween(cm->getLast(), cm2->getLast()))
-            continue;
+    if (!keepCollisionBetween(cm->getLast(), cm2->getLast()))
+        return;
 
-        bool swapModels = false;
-        core::collision::ElementIntersector* intersector = intersectionMethod->findIntersector(cm, cm2, swapModels);
-        if (intersector == nullptr)
-            continue;
+    bool swapModels = false;
+    core::collision::ElementIntersector* intersector = intersectionMethod->findIntersector(cm, cm2, swapModels);
+    if (intersector == nullptr)
+        return;
 
-        core::CollisionModel* cm1 = (swapModels?cm2:cm);
-        cm2 = (swapModels?cm:cm2);
+    core::CollisionModel* cm1 = (swapModels?cm2:cm);
+    cm2 = (swapModels?cm:cm2);
 
-        // Here we assume a single root element is present in both models
-        if (intersector->canIntersect(cm1->begin(), cm2->begin()))
-        {
-            cmPairs.push_back(std::make_pair(cm1, cm2));
-        }
+    // Here we assume a single root element is present in both models
+    if (intersector->canIntersect(cm1->begin(), cm2->begin()))
+    {
+        cmPairs.push_back(std::make_pair(cm1, cm2));
     }
-    collisionModels.push_back(cm);
 }
 
 
@@ -155,28 +170,41 @@ bool BruteForceDetection::keepCollisionBetween(core::CollisionModel *cm1, core::
 
 
 void BruteForceDetection::addCollisionPair(const std::pair<core::CollisionModel*, core::CollisionModel*>& cmPair)
-{    
-    typedef std::pair< std::pair<core::CollisionElementIterator,core::CollisionElementIterator>, std::pair<core::CollisionElementIterator,core::CollisionElementIterator> > TestPair;
+{
+    std::string msg = "BruteForceDetection addCollisionPair: " + cmPair.first->getLast()->getName() + " - " + cmPair.second->getLast()->getName();
+    sofa::helper::ScopedAdvancedTimer bfTimer(msg);
+
+    CollisionPairTests tests;
+    if (prepareCollisionPair(cmPair, tests))
+    {
+        traverseCollisionPair(tests);
+        reportCollisionPairErrors(tests);
+    }
+}
+
+core::collision::ElementIntersector* BruteForceDetection::findIntersector(core::CollisionModel* cm1, core::CollisionModel* cm2, bool& swapModels)
+{
+    return intersectionMethod->findIntersector(cm1, cm2, swapModels);
+}
 
+bool BruteForceDetection::prepareCollisionPair(const std::pair<core::CollisionModel*, core::CollisionModel*>& cmPair, CollisionPairTests& tests)
+{
     core::CollisionModel *cm1 = cmPair.first; //->getNext();
     core::CollisionModel *cm2 = cmPair.second; //->getNext();
 
     if (!cm1->isSimulated() && !cm2->isSimulated())
-        return;
+        return false;
 
     if (cm1->empty() || cm2->empty())
-        return;
+        return false;
 
     core::CollisionModel *finalcm1 = cm1->getLast();//get the finnest CollisionModel which is not a CubeModel
     core::CollisionModel *finalcm2 = cm2->getLast();
 
-    std::string msg = "BruteForceDetection addCollisionPair: " + finalcm1->getName() + " - " + finalcm2->getName();
-    sofa::helper::ScopedAdvancedTimer bfTimer(msg);
-    
     bool swapModels = false;
     core::collision::ElementIntersector* finalintersector = intersectionMethod->findIntersector(finalcm1, finalcm2, swapModels);//find the method for the finnest CollisionModels
     if (finalintersector == nullptr)
-        return;
+        return false;
     if (swapModels)
     {
         core::CollisionModel* tmp;
@@ -198,6 +226,35 @@ void BruteForceDetection::addCollisionPair(const std::pair<core::CollisionModel*
         finalintersector = nullptr;
     }
 
+    tests.cm1 = cm1;
+    tests.cm2 = cm2;
+    tests.finalcm1 = finalcm1;
+    tests.finalcm2 = finalcm2;
+    tests.finalintersector = finalintersector;
+    tests.self = self;
+    tests.outputs = outputs;
+    return true;
+}
+
+void BruteForceDetection::reportCollisionPairErrors(const CollisionPairTests& tests)
+{
+    for (const std::pair<core::CollisionModel*, core::CollisionModel*>& models : tests.missingIntersectors)
+        msg_error() << "BruteForceDetection: Error finding intersector " << intersectionMethod->getName() << " for "<<models.first->getClassName()<<" - "<<models.second->getClassName()<<sendl;
+}
+
+void BruteForceDetection::traverseCollisionPair(CollisionPairTests& tests)
+{
+    typedef std::pair< std::pair<core::CollisionElementIterator,core::CollisionElementIterator>, std::pair<core::CollisionElementIterator,core::CollisionElementIterator> > TestPair;
+
+    core::CollisionModel *cm1 = tests.cm1;
+    core::CollisionModel *cm2 = tests.cm2;
+    core::CollisionModel *finalcm1 = tests.finalcm1;
+    core::CollisionModel *finalcm2 = tests.finalcm2;
+    core::collision::ElementIntersector* finalintersector = tests.finalintersector;
+    const bool self = tests.self;
+    core::collision::DetectionOutputVector* outputs = tests.outputs;
+    bool swapModels = false;
+
     std::queue< TestPair > externalCells;
 
     std::pair<core::CollisionElementIterator,core::CollisionElementIterator> internalChildren1 = cm1->begin().getInternalChildren();
@@ -236,11 +293,11 @@ void BruteForceDetection::addCollisionPair(const std::pair<core::CollisionModel*
             cm1 = root.first.first.getCollisionModel();
             cm2 = root.second.first.getCollisionModel();
             if (!cm1 || !cm2) continue;
-            intersector = intersectionMethod->findIntersector(cm1, cm2, swapModels);
+            intersector = findIntersector(cm1, cm2, swapModels);
 
             if (intersector == nullptr)
             {
-                msg_error() << "BruteForceDetection: Error finding intersector " << intersectionMethod->getName() << " for "<<cm1->getClassName()<<" - "<<cm2->getClassName()<<sendl;
+                tests.missingIntersectors.push_back(std::make_pair(cm1, cm2));
             }
 
             if (swapModels)
@@ -87,6 +87,8 @@ public:
 
 private:
     bool _is_initialized;
+
+protected:
     sofa::helper::vector<core::CollisionModel*> collisionModels;
 
     Data< helper::fixed_array<sofa::defaulttype::Vector3,2> > box; ///< if not empty, objects that do not intersect this bounding-box will be ignored
@@ -101,6 +103,43 @@ protected:
 
     virtual bool keepCollisionBetween(core::CollisionModel *cm1, core::CollisionModel *cm2);
 
+    /// Return false if a box is defined and the collision model is outside of it
+    bool isInsideBox(core::CollisionModel *cm);
+
+    /// Add the self-collision pair of the model, if it is needed
+    void addSelfCollisionPair(core::CollisionModel *cm);
+
+    /// Add the pair of models if they can collide (conservative check on their root elements)
+    void addPotentialCollisionPair(core::CollisionModel *cm, core::CollisionModel *cm2);
+
+    /// Intersection tests between the elements of a pair of collision models
+    struct CollisionPairTests
+    {
+        core::CollisionModel* cm1;
+        core::CollisionModel* cm2;
+        core::CollisionModel* finalcm1; ///< finest collision model of the first hierarchy (nullptr if it also contains the root element)
+        core::CollisionModel* finalcm2; ///< finest collision model of the second hierarchy (nullptr if it also contains the root element)
+        core::collision::ElementIntersector* finalintersector;
+        bool self;
+        core::collision::DetectionOutputVector* outputs;
+        /// pairs of models without intersector found during the traversal (see reportCollisionPairErrors)
+        helper::vector< std::pair<core::CollisionModel*, core::CollisionModel*> > missingIntersectors;
+    };
+
+    /// Find the intersector of the finest models of the pair and create its detection outputs.
+    /// Return false if the pair does not need to be tested.
+    bool prepareCollisionPair(const std::pair<core::CollisionModel*, core::CollisionModel*>& cmPair, CollisionPairTests& tests);
+
+    /// Traverse the bounding trees of a prepared pair of collision models and compute the intersections of their elements.
+    /// Only the detection outputs and the errors of this pair are modified, no message is emitted.
+    void traverseCollisionPair(CollisionPairTests& tests);
+
+    /// Emit the errors found during the traversal of a pair of collision models
+    void reportCollisionPairErrors(const CollisionPairTests& tests);
+
+    /// Find the intersector between two collision models
+    virtual core::collision::ElementIntersector* findIntersector(core::CollisionModel* cm1, core::CollisionModel* cm2, bool& swapModels);
+
 public:
 
     void init() override;
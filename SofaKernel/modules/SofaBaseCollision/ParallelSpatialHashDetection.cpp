@@ -0,0 +1,262 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaBaseCollision/ParallelSpatialHashDetection.h>
+#include <sofa/core/ObjectFactory.h>
+#include <sofa/helper/AdvancedTimer.h>
+#include <sofa/simulation/ParallelForRange.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace sofa
+{
+
+namespace component
+{
+
+namespace collision
+{
+
+using namespace sofa::defaulttype;
+
+int ParallelSpatialHashDetectionClass = core::RegisterObject("Collision detection using a uniform grid broad phase and a parallel narrow phase")
+        .add< ParallelSpatialHashDetection >()
+        ;
+
+namespace
+{
+
+/// Integer coordinate of the cell containing x, clamped to the 21 bits of the keys
+/// (the far or degenerate boxes, e.g. with NaN coordinates, end up in the border cells)
+inline int cellCoordinate(SReal x)
+{
+    const int limit = 1 << 20;
+    const SReal c = std::floor(x);
+    if (!(c > SReal(-limit)))
+        return -limit;
+    if (c >= SReal(limit))
+        return limit - 1;
+    return int(c);
+}
+
+/// Integer coordinates of a cell packed in a 64 bits key (21 bits per axis)
+inline std::uint64_t cellKey(const int c[3])
+{
+    const std::uint64_t mask = (std::uint64_t(1) << 21) - 1;
+    return ((std::uint64_t(c[0]) & mask) << 42) | ((std::uint64_t(c[1]) & mask) << 21) | (std::uint64_t(c[2]) & mask);
+}
+
+} // namespace
+
+ParallelSpatialHashDetection::ParallelSpatialHashDetection()
+    : d_cellSize(initData(&d_cellSize, (SReal)0, "cellSize", "Size of the cells of the grid (0 to use the mean size of the bounding boxes of the models)"))
+    , d_maxCellsPerModel(initData(&d_maxCellsPerModel, 64u, "maxCellsPerModel", "Models covering more cells are tested against all the other models"))
+    , d_parallelNarrowPhase(initData(&d_parallelNarrowPhase, true, "parallelNarrowPhase", "Compute the intersections of the pairs of models in parallel with the TaskScheduler"))
+    , d_nbTestedPairs(initData(&d_nbTestedPairs, 0u, "nbTestedPairs", "Number of pairs of models tested in the last broad phase"))
+{
+    d_nbTestedPairs.setReadOnly(true);
+}
+
+ParallelSpatialHashDetection::~ParallelSpatialHashDetection()
+{
+}
+
+void ParallelSpatialHashDetection::addCollisionModel(core::CollisionModel *cm)
+{
+    if (cm->empty())
+        return;
+
+    if (!isInsideBox(cm))
+        return;
+
+    addSelfCollisionPair(cm);
+
+    // the pairs between models are computed at the end of the broad phase
+    collisionModels.push_back(cm);
+}
+
+void ParallelSpatialHashDetection::endBroadPhase()
+{
+    BruteForceDetection::endBroadPhase();
+
+    const std::size_t nbModels = collisionModels.size();
+    const SReal margin = intersectionMethod->getAlarmDistance();
+
+    // bounding box of the root element of each model, or an empty box if it is not a cube
+    helper::vector<Vector3> bbMin(nbModels), bbMax(nbModels);
+    helper::vector<bool> bounded(nbModels, false);
+    SReal meanSize = 0;
+    std::size_t nbBounded = 0;
+    for (std::size_t i = 0; i < nbModels; ++i)
+    {
+        CubeCollisionModel* cubeModel = dynamic_cast<CubeCollisionModel*>(collisionModels[i]);
+        if (!cubeModel || cubeModel->empty())
+            continue;
+        const Cube root(cubeModel, 0);
+        const SReal inflate = margin + collisionModels[i]->getProximity();
+        bbMin[i] = root.minVect() - Vector3(inflate, inflate, inflate);
+        bbMax[i] = root.maxVect() + Vector3(inflate, inflate, inflate);
+        bounded[i] = true;
+        const Vector3 size = bbMax[i] - bbMin[i];
+        meanSize += std::max(size[0], std::max(size[1], size[2]));
+        ++nbBounded;
+    }
+
+    SReal cellSize = d_cellSize.getValue();
+    if (cellSize <= 0)
+        cellSize = (nbBounded > 0 && meanSize > 0) ? meanSize / nbBounded : (SReal)1;
+    const SReal invCellSize = (SReal)1 / cellSize;
+
+    // potential pairs (i,j) with j < i, tested in the same order as BruteForceDetection
+    helper::vector< std::pair<std::size_t, std::size_t> > candidates;
+
+    // hash the models in the cells covered by their bounding box
+    helper::vector< std::pair<std::uint64_t, std::size_t> > cells;
+    helper::vector<std::size_t> largeModels;
+    helper::vector< helper::fixed_array<int,3> > cellMin(nbModels);
+    for (std::size_t i = 0; i < nbModels; ++i)
+    {
+        if (!bounded[i])
+        {
+            largeModels.push_back(i);
+            continue;
+        }
+        int cmin[3], cmax[3];
+        std::size_t nbCells = 1;
+        for (int d = 0; d < 3; ++d)
+        {
+            cmin[d] = cellCoordinate(bbMin[i][d] * invCellSize);
+            cmax[d] = std::max(cmin[d], cellCoordinate(bbMax[i][d] * invCellSize));
+            nbCells *= std::size_t(cmax[d] - cmin[d] + 1);
+            cellMin[i][d] = cmin[d];
+        }
+        if (nbCells > d_maxCellsPerModel.getValue())
+        {
+            largeModels.push_back(i);
+            continue;
+        }
+        int c[3];
+        for (c[0] = cmin[0]; c[0] <= cmax[0]; ++c[0])
+            for (c[1] = cmin[1]; c[1] <= cmax[1]; ++c[1])
+                for (c[2] = cmin[2]; c[2] <= cmax[2]; ++c[2])
+                    cells.push_back(std::make_pair(cellKey(c), i));
+    }
+    std::sort(cells.begin(), cells.end());
+
+    // pairs of models sharing a cell: a pair is only reported in the cell containing
+    // the minimum corner of the intersection of their bounding boxes, to avoid duplicates
+    for (std::size_t begin = 0; begin < cells.size(); )
+    {
+        std::size_t end = begin + 1;
+        while (end < cells.size() && cells[end].first == cells[begin].first)
+            ++end;
+        for (std::size_t a = begin; a < end; ++a)
+        {
+            const std::size_t i = cells[a].second;
+            for (std::size_t b = begin; b < a; ++b)
+            {
+                const std::size_t j = cells[b].second;
+                if (i == j)
+                    continue; // distinct cells with the same key
+                bool overlap = true;
+                int corner[3];
+                for (int d = 0; d < 3 && overlap; ++d)
+                {
+                    overlap = bbMin[i][d] <= bbMax[j][d] && bbMin[j][d] <= bbMax[i][d];
+                    corner[d] = std::max(cellMin[i][d], cellMin[j][d]);
+                }
+                if (overlap && cellKey(corner) == cells[a].first)
+                    candidates.push_back(std::make_pair(std::max(i, j), std::min(i, j)));
+            }
+        }
+        begin = end;
+    }
+
+    // models without bounding box or covering too many cells are tested against all the others
+    for (std::size_t l = 0; l < largeModels.size(); ++l)
+    {
+        const std::size_t i = largeModels[l];
+        for (std::size_t j = 0; j < nbModels; ++j)
+        {
+            if (j != i)
+                candidates.push_back(std::make_pair(std::max(i, j), std::min(i, j)));
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    for (std::size_t c = 0; c < candidates.size(); ++c)
+        addPotentialCollisionPair(collisionModels[candidates[c].first], collisionModels[candidates[c].second]);
+
+    d_nbTestedPairs.setValue(unsigned(candidates.size()));
+}
+
+core::collision::ElementIntersector* ParallelSpatialHashDetection::findIntersector(core::CollisionModel* cm1, core::CollisionModel* cm2, bool& swapModels)
+{
+    std::lock_guard<std::mutex> lock(m_intersectorMutex);
+    return intersectionMethod->findIntersector(cm1, cm2, swapModels);
+}
+
+void ParallelSpatialHashDetection::addCollisionPairs(const sofa::helper::vector< std::pair<core::CollisionModel*, core::CollisionModel*> >& v)
+{
+    // the detection outputs are created sequentially...
+    helper::vector<CollisionPairTests> tests;
+    tests.reserve(v.size());
+    for (std::size_t i = 0; i < v.size(); ++i)
+    {
+        CollisionPairTests pairTests;
+        if (prepareCollisionPair(v[i], pairTests))
+            tests.push_back(pairTests);
+    }
+    m_primitiveTestCount = m_outputsMap.size();
+
+    // ... then each pair fills its own outputs
+    simulation::TaskScheduler* scheduler = (d_parallelNarrowPhase.getValue() && tests.size() > 1) ? simulation::TaskScheduler::getInstance() : nullptr;
+    if (scheduler && scheduler->getThreadCount() > 1)
+    {
+        sofa::helper::ScopedAdvancedTimer timer("ParallelSpatialHashDetection::parallelNarrowPhase");
+
+        // a few tasks per thread to balance the pairs of different costs
+        const std::size_t grainSize = simulation::getParallelGrainSize(scheduler, tests.size(), 1, 4);
+        simulation::parallelForRange(scheduler, 0, tests.size(), grainSize, [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+                traverseCollisionPair(tests[i]);
+        });
+    }
+    else
+    {
+        for (std::size_t i = 0; i < tests.size(); ++i)
+            traverseCollisionPair(tests[i]);
+    }
+
+    // the messages are emitted from the main thread
+    for (std::size_t i = 0; i < tests.size(); ++i)
+        reportCollisionPairErrors(tests[i]);
+}
+
+} // namespace collision
+
+} // namespace component
+
+} // namespace sofa
@@ -0,0 +1,84 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#ifndef SOFA_COMPONENT_COLLISION_PARALLELSPATIALHASHDETECTION_H
+#define SOFA_COMPONENT_COLLISION_PARALLELSPATIALHASHDETECTION_H
+#include "config.h"
+
+#include <SofaBaseCollision/BruteForceDetection.h>
+#include <mutex>
+
+
+namespace sofa
+{
+
+namespace component
+{
+
+namespace collision
+{
+
+/**
+ * Collision detection using a uniform grid for the broad phase and a parallel narrow phase.
+ *
+ * The broad phase hashes the bounding box of the root element of each collision model in a uniform grid,
+ * rebuilt at each step, and only tests the pairs of models sharing a cell, instead of all the pairs of models.
+ * Models covering too many cells (e.g. a large floor) are tested against all the other ones.
+ *
+ * The narrow phase traverses the bounding trees of each pair of models as in BruteForceDetection,
+ * but the pairs are processed as tasks of the TaskScheduler. Each pair writes its own detection outputs,
+ * so the results are identical to the sequential ones.
+ */
+class SOFA_BASE_COLLISION_API ParallelSpatialHashDetection : public BruteForceDetection
+{
+public:
+    SOFA_CLASS(ParallelSpatialHashDetection, BruteForceDetection);
+
+    Data<SReal> d_cellSize; ///< size of the cells of the grid (0 to use the mean size of the bounding boxes of the models)
+    Data<unsigned int> d_maxCellsPerModel; ///< models covering more cells are tested against all the other models
+    Data<bool> d_parallelNarrowPhase; ///< compute the intersections of the pairs of models in parallel with the TaskScheduler
+    Data<unsigned int> d_nbTestedPairs; ///< number of pairs of models tested in the last broad phase (output)
+
+protected:
+    ParallelSpatialHashDetection();
+
+    ~ParallelSpatialHashDetection() override;
+
+    core::collision::ElementIntersector* findIntersector(core::CollisionModel* cm1, core::CollisionModel* cm2, bool& swapModels) override;
+
+    /// protect the intersector lookup, that can update the cache of the intersection method, during the parallel narrow phase
+    std::mutex m_intersectorMutex;
+
+public:
+
+    void addCollisionModel (core::CollisionModel *cm) override;
+    void endBroadPhase() override;
+
+    void addCollisionPairs(const sofa::helper::vector< std::pair<core::CollisionModel*, core::CollisionModel*> >& v) override;
+};
+
+} // namespace collision
+
+} // namespace component
+
+} // namespace sofa
+
+#endif
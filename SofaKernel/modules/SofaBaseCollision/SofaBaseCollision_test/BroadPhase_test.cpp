@@ -21,6 +21,7 @@
 ******************************************************************************/
 #include "BroadPhase_test.h"
 #include <SofaBaseCollision/BruteForceDetection.h>
+#include <SofaBaseCollision/ParallelSpatialHashDetection.h>
 
 typedef BroadPhaseTest<sofa::component::collision::BruteForceDetection> Brut;
 TEST_F(Brut, rand_sparse_test ) { ASSERT_TRUE( randSparse()); }
@@ -33,3 +34,14 @@ TEST_F(IncrSAPTest, rand_dense_test ) { ASSERT_TRUE( randDense()); }
 typedef BroadPhaseTest<sofa::component::collision::DirectSAP> DirectSAPTest;
 TEST_F(DirectSAPTest, rand_sparse_test ) { ASSERT_TRUE( randSparse()); }
 TEST_F(DirectSAPTest, rand_dense_test ) { ASSERT_TRUE( randDense()); }
+
+typedef BroadPhaseTest<sofa::component::collision::ParallelSpatialHashDetection> ParallelSpatialHashTest;
+TEST_F(ParallelSpatialHashTest, rand_sparse_test ) { ASSERT_TRUE( randSparse()); }
+TEST_F(ParallelSpatialHashTest, rand_dense_test ) { ASSERT_TRUE( randDense()); }
+
+TEST_F(ParallelSpatialHashTest, rand_far_test )
+{
+    // the cell coordinates of these boxes are beyond the range of the keys (and of int)
+    for(int i = 0 ; i < 100 ; ++i)
+        ASSERT_TRUE( randTest(i,2,1,Vector3(1e12,1e12,1e12),Vector3(1e12+5,1e12+5,1e12+5)) ) << "seed number " << i;
+}
@@ -370,6 +370,218 @@ public:
         compressed = true;
     }
 
+    /// @name Concurrent assembly
+    /// Each assembling thread fills its own BlocBuffer, which keeps the blocs unsorted and split
+    /// by ranges of block rows. Each range is then merged by mergeBlocBuffers(), concurrently with
+    /// the other ranges. Blocs which are already in the sparsity pattern are directly added in
+    /// place. If some are not, buildRowChunk() rebuilds each range and setRowChunks() concatenates them.
+    /// @{
+
+    /// Write-only matrix storing the blocs added by one thread, to be merged later in a CompressedRowSparseMatrix
+    class BlocBuffer : public defaulttype::BaseMatrix
+    {
+    public:
+        BlocBuffer() : nRow(0), nCol(0), nBlocRow(1), unsupported(false) {}
+
+        /// Empty the buffer and split the block rows in nbRanges ranges of the same size
+        void reset(Index nbRow, Index nbCol, Index nbBRow, Index nbRanges)
+        {
+            nRow = nbRow;
+            nCol = nbCol;
+            nBlocRow = std::max(nbBRow, (Index)1);
+            ranges.resize(nbRanges);
+            for (VecIndexedBloc& r : ranges)
+                r.clear();
+            groupBegin.assign(nbRanges, 0);
+            unsupported = false;
+        }
+
+        Index getNbRanges() const { return (Index)ranges.size(); }
+        const VecIndexedBloc& getRange(Index r) const { return ranges[r]; }
+
+        /// First block row of the given range
+        Index getRangeBegin(Index r) const { return (Index)((long long)r * nBlocRow / (Index)ranges.size()); }
+
+        /// true if an operation other than add() was used, the buffer cannot be merged then
+        bool hasUnsupportedOperation() const { return unsupported; }
+        void setUnsupportedOperation() { unsupported = true; }
+
+        /// Start a new group of additions, which can be cancelled by discardGroup()
+        void beginGroup()
+        {
+            groupBegin.resize(ranges.size());
+            for (std::size_t r = 0; r < ranges.size(); ++r)
+                groupBegin[r] = ranges[r].size();
+        }
+
+        /// Discard the blocs added since beginGroup(), and the unsupported operations
+        void discardGroup()
+        {
+            for (std::size_t r = 0; r < ranges.size(); ++r)
+                ranges[r].resize(groupBegin[r]);
+            unsupported = false;
+        }
+
+        Index rowSize() const override { return nRow; }
+        Index colSize() const override { return nCol; }
+        SReal element(Index, Index) const override { unsupported = true; return 0; }
+        void resize(Index nbRow, Index nbCol) override { nRow = nbRow; nCol = nbCol; }
+        void clear() override { unsupported = true; }
+        void set(Index, Index, double) override { unsupported = true; }
+        void clear(Index, Index) override { unsupported = true; }
+        void clearRow(Index) override { unsupported = true; }
+        void clearCol(Index) override { unsupported = true; }
+        void clearRowCol(Index) override { unsupported = true; }
+
+        using defaulttype::BaseMatrix::add;
+        void add(Index i, Index j, double v) override
+        {
+            Index bi=0, bj=0; split_row_index(i, bi); split_col_index(j, bj);
+            const Index r = rangeOf(i);
+            VecIndexedBloc& blocs = ranges[r];
+            // consecutive additions in the same bloc of a group are accumulated in place
+            if (blocs.size() <= groupBegin[r] || blocs.back().l != i || blocs.back().c != j)
+            {
+                blocs.push_back(IndexedBloc(i,j));
+                traits::clear(blocs.back().value);
+            }
+            traits::v(blocs.back().value, bi, bj) += (Real)v;
+        }
+
+    protected:
+        Index rangeOf(Index blocRow) const
+        {
+            const Index nbRanges = (Index)ranges.size();
+            Index r = std::min((Index)((long long)blocRow * nbRanges / nBlocRow), nbRanges-1);
+            while (r > 0 && getRangeBegin(r) > blocRow) --r;
+            while (r+1 < nbRanges && getRangeBegin(r+1) <= blocRow) ++r;
+            return r;
+        }
+
+        Index nRow, nCol, nBlocRow;
+        helper::vector<VecIndexedBloc> ranges;
+        helper::vector<std::size_t> groupBegin;
+        mutable bool unsupported;
+    };
+
+    /// Compressed rows of one range of block rows, built by buildRowChunk()
+    struct RowChunk
+    {
+        VecIndex rowIndex;
+        VecIndex rowBegin; ///< relative to the beginning of the chunk
+        VecIndex colsIndex;
+        VecBloc colsValue;
+    };
+
+    /// Add the blocs of the given range of all the buffers. The blocs found in the current sparsity
+    /// pattern are added in place, the other ones are appended to newBlocs. Different ranges can be
+    /// merged concurrently, as they do not share any row. The matrix must be compressed.
+    void mergeBlocBuffers(const helper::vector<BlocBuffer*>& buffers, Index range, VecIndexedBloc& newBlocs)
+    {
+        Index rowId = 0, colId = 0;
+        for (const BlocBuffer* buffer : buffers)
+        {
+            for (const IndexedBloc& b : buffer->getRange(range))
+            {
+                if (sortedFind(rowIndex, b.l, rowId))
+                {
+                    Range rowRange(rowBegin[rowId], rowBegin[rowId+1]);
+                    if (sortedFind(colsIndex, rowRange, b.c, colId))
+                    {
+                        colsValue[colId] += b.value;
+                        continue;
+                    }
+                }
+                newBlocs.push_back(b);
+            }
+        }
+    }
+
+    /// Build the compressed rows of [beginRow,endRow), merging the current rows with newBlocs
+    void buildRowChunk(Index beginRow, Index endRow, VecIndexedBloc& newBlocs, RowChunk& chunk) const
+    {
+        std::sort(newBlocs.begin(), newBlocs.end());
+        chunk.rowIndex.clear();
+        chunk.rowBegin.clear();
+        chunk.colsIndex.clear();
+        chunk.colsValue.clear();
+
+        Index oldRowId = (Index)(std::lower_bound(rowIndex.begin(), rowIndex.end(), beginRow) - rowIndex.begin());
+        typename VecIndexedBloc::const_iterator it = newBlocs.begin(), itend = newBlocs.end();
+        for (;;)
+        {
+            const Index oldRow = (oldRowId < (Index)rowIndex.size() && rowIndex[oldRowId] < endRow) ? rowIndex[oldRowId] : endRow;
+            const Index newRow = (it != itend) ? it->l : endRow;
+            const Index row = std::min(oldRow, newRow);
+            if (row == endRow) break;
+
+            chunk.rowIndex.push_back(row);
+            chunk.rowBegin.push_back((Index)chunk.colsIndex.size());
+            Index k = 0, kend = 0;
+            if (row == oldRow)
+            {
+                k = rowBegin[oldRowId];
+                kend = rowBegin[oldRowId+1];
+                ++oldRowId;
+            }
+            while (k < kend || (it != itend && it->l == row))
+            {
+                const Index oldCol = (k < kend) ? colsIndex[k] : nBlocCol;
+                const Index newCol = (it != itend && it->l == row) ? it->c : nBlocCol;
+                if (oldCol <= newCol)
+                {
+                    chunk.colsIndex.push_back(oldCol);
+                    chunk.colsValue.push_back(colsValue[k]);
+                    ++k;
+                }
+                else
+                {
+                    chunk.colsIndex.push_back(newCol);
+                    chunk.colsValue.push_back(it->value);
+                    ++it;
+                }
+                while (it != itend && it->l == row && it->c == chunk.colsIndex.back())
+                {
+                    chunk.colsValue.back() += it->value;
+                    ++it;
+                }
+            }
+        }
+    }
+
+    /// Replace the compressed data by the concatenation of the chunks, ordered by row
+    void setRowChunks(const helper::vector<RowChunk>& chunks)
+    {
+        std::size_t nbRows = 0, nbBlocs = 0;
+        for (const RowChunk& chunk : chunks)
+        {
+            nbRows += chunk.rowIndex.size();
+            nbBlocs += chunk.colsIndex.size();
+        }
+        rowIndex.clear();
+        rowBegin.clear();
+        colsIndex.clear();
+        colsValue.clear();
+        rowIndex.reserve(nbRows);
+        rowBegin.reserve(nbRows+1);
+        colsIndex.reserve(nbBlocs);
+        colsValue.reserve(nbBlocs);
+        for (const RowChunk& chunk : chunks)
+        {
+            const Index offset = (Index)colsIndex.size();
+            rowIndex.insert(rowIndex.end(), chunk.rowIndex.begin(), chunk.rowIndex.end());
+            for (Index b : chunk.rowBegin)
+                rowBegin.push_back(offset + b);
+            colsIndex.insert(colsIndex.end(), chunk.colsIndex.begin(), chunk.colsIndex.end());
+            colsValue.insert(colsValue.end(), chunk.colsValue.begin(), chunk.colsValue.end());
+        }
+        rowBegin.push_back((Index)colsIndex.size());
+        btemp.clear();
+        compressed = true;
+    }
+
+    /// @}
+
     void swap(Matrix& m)
     {
         Index t;
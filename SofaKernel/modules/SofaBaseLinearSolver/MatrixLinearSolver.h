@@ -34,6 +34,7 @@
 #include <SofaBaseLinearSolver/SparseMatrix.h>
 #include <SofaBaseLinearSolver/CompressedRowSparseMatrix.h>
 #include <SofaBaseLinearSolver/DiagonalMatrix.h>
+#include <SofaBaseLinearSolver/ParallelMatrixAssembly.h>
 #include <sofa/core/behavior/RotationMatrix.h>
 
 namespace sofa
@@ -178,6 +179,8 @@ public:
     typedef typename MatrixLinearSolverInternalData<Vector>::JMatrixType JMatrixType;
     typedef typename MatrixLinearSolverInternalData<Vector>::ResMatrixType ResMatrixType;
 
+    Data<bool> d_parallelAssembly; ///< assemble the force fields in parallel with the TaskScheduler (CompressedRowSparseMatrix only)
+
     MatrixLinearSolver();
     ~MatrixLinearSolver() override ;
 
@@ -327,6 +330,11 @@ protected:
 
     virtual MatrixInvertData * createInvertData();
 
+    /// Add the M,B,K contributions of the scene to the current system matrix
+    void addMBK_ToSystemMatrix(const core::MechanicalParams* mparams, simulation::common::MechanicalOperations& mops);
+
+    ParallelMatrixAssembly<Matrix> m_parallelAssembly;
+
     class GroupData
     {
     public:
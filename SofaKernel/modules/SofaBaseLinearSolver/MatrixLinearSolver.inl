@@ -36,6 +36,7 @@ namespace linearsolver {
 template<class Matrix, class Vector>
 MatrixLinearSolver<Matrix,Vector>::MatrixLinearSolver()
     : Inherit()
+    , d_parallelAssembly(initData(&d_parallelAssembly, false, "parallelAssembly", "assemble the force fields in parallel with the TaskScheduler (CompressedRowSparseMatrix only)"))
     , currentGroup(&defaultGroup)
 {
     invertData = nullptr;
@@ -129,12 +130,21 @@ void MatrixLinearSolver<Matrix,Vector>::setSystemMBKMatrix(const core::Mechanica
         currentGroup->matrixAccessor.setupMatrices();
         resizeSystem(currentGroup->matrixAccessor.getGlobalDimension());
         currentGroup->systemMatrix->clear();
-        mops.addMBK_ToMatrix(&(currentGroup->matrixAccessor), mparams->mFactor(), mparams->bFactor(), mparams->kFactor());
+        addMBK_ToSystemMatrix(mparams, mops);
         currentGroup->matrixAccessor.computeGlobalMatrix();
     }
 
 }
 
+template<class Matrix, class Vector>
+void MatrixLinearSolver<Matrix,Vector>::addMBK_ToSystemMatrix(const core::MechanicalParams* mparams, simulation::common::MechanicalOperations& mops)
+{
+    if (d_parallelAssembly.getValue()
+        && m_parallelAssembly.addMBK_ToMatrix(mparams, this->getContext(), &(currentGroup->matrixAccessor), *currentGroup->systemMatrix))
+        return;
+    mops.addMBK_ToMatrix(&(currentGroup->matrixAccessor), mparams->mFactor(), mparams->bFactor(), mparams->kFactor());
+}
+
 template<class Matrix, class Vector>
 void MatrixLinearSolver<Matrix,Vector>::rebuildSystem(double massFactor, double forceFactor)
 {
@@ -152,7 +162,7 @@ void MatrixLinearSolver<Matrix,Vector>::rebuildSystem(double massFactor, double
         currentGroup->matrixAccessor.setupMatrices();
         resizeSystem(currentGroup->matrixAccessor.getGlobalDimension());
         currentGroup->systemMatrix->clear();
-        mops.addMBK_ToMatrix(&(currentGroup->matrixAccessor), mparams.mFactor(), mparams.bFactor(), mparams.kFactor());
+        addMBK_ToSystemMatrix(&mparams, mops);
         currentGroup->matrixAccessor.computeGlobalMatrix();
     }
 
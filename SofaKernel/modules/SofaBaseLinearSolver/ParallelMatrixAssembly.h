@@ -0,0 +1,285 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#ifndef SOFA_COMPONENT_LINEARSOLVER_PARALLELMATRIXASSEMBLY_H
+#define SOFA_COMPONENT_LINEARSOLVER_PARALLELMATRIXASSEMBLY_H
+#include "config.h"
+
+#include <sofa/simulation/MechanicalVisitor.h>
+#include <sofa/simulation/VisitorExecuteFunc.h>
+#include <sofa/simulation/ParallelForRange.h>
+#include <sofa/core/behavior/MultiMatrixAccessor.h>
+#include <sofa/core/behavior/BaseForceField.h>
+#include <sofa/core/behavior/BaseProjectiveConstraintSet.h>
+#include <SofaBaseLinearSolver/CompressedRowSparseMatrix.h>
+#include <atomic>
+#include <set>
+
+namespace sofa
+{
+
+namespace component
+{
+
+namespace linearsolver
+{
+
+/// Assembly of the M,B,K contributions of the force fields by several threads.
+/// Only CompressedRowSparseMatrix supports it, other matrices are assembled serially.
+template<class TMatrix>
+class ParallelMatrixAssembly
+{
+public:
+    /// @return false if the matrix was not assembled and the serial assembly must be used
+    bool addMBK_ToMatrix(const core::MechanicalParams* /*mparams*/, core::objectmodel::BaseContext* /*context*/,
+                         const core::behavior::MultiMatrixAccessor* /*accessor*/, TMatrix& /*matrix*/)
+    {
+        return false;
+    }
+};
+
+/// Visitor listing the components called by MechanicalAddMBK_ToMatrixVisitor, in the same order
+class ParallelMatrixAssemblyComponentsVisitor : public simulation::MechanicalVisitor
+{
+public:
+    helper::vector<core::behavior::BaseForceField*> forceFields;
+    helper::vector<core::behavior::BaseProjectiveConstraintSet*> projectiveConstraints;
+
+    ParallelMatrixAssemblyComponentsVisitor(const core::MechanicalParams* mparams)
+        : simulation::MechanicalVisitor(mparams)
+    {}
+
+    const char* getClassName() const override { return "ParallelMatrixAssemblyComponentsVisitor"; }
+
+    Result fwdForceField(simulation::Node* /*node*/, core::behavior::BaseForceField* ff) override
+    {
+        forceFields.push_back(ff);
+        return RESULT_CONTINUE;
+    }
+
+    Result fwdProjectiveConstraintSet(simulation::Node* /*node*/, core::behavior::BaseProjectiveConstraintSet* c) override
+    {
+        projectiveConstraints.push_back(c);
+        return RESULT_CONTINUE;
+    }
+
+    bool stopAtMechanicalMapping(simulation::Node* /*node*/, core::BaseMapping* map) override
+    {
+        return !map->areMatricesMapped();
+    }
+};
+
+/// Parallel assembly in a CompressedRowSparseMatrix.
+///
+/// The force fields are shared between the threads, each thread adding their contributions in its own
+/// BlocBuffer. The buffers are then merged by ranges of rows: when the sparsity pattern did not change
+/// since the last step, the values are directly added in the existing blocs, otherwise the ranges are
+/// rebuilt in parallel and concatenated.
+///
+/// The force fields acting on a mapped state, or using other operations than additions, are detected
+/// during the parallel pass: their contributions are discarded, and they are assembled serially after
+/// the merge, on the accessor of the solver, as well as during the next steps. The projective
+/// constraints are applied last, once all the force fields are assembled.
+template<class TBloc, class TVecBloc, class TVecIndex>
+class ParallelMatrixAssembly< CompressedRowSparseMatrix<TBloc,TVecBloc,TVecIndex> >
+{
+public:
+    typedef CompressedRowSparseMatrix<TBloc,TVecBloc,TVecIndex> Matrix;
+    typedef typename Matrix::BlocBuffer BlocBuffer;
+    typedef typename Matrix::RowChunk RowChunk;
+    typedef typename Matrix::VecIndexedBloc VecIndexedBloc;
+    typedef defaulttype::BaseMatrix::Index Index;
+
+    /// @return false if the matrix was not assembled and the serial assembly must be used
+    bool addMBK_ToMatrix(const core::MechanicalParams* mparams, core::objectmodel::BaseContext* context,
+                         const core::behavior::MultiMatrixAccessor* accessor, Matrix& matrix)
+    {
+        ParallelMatrixAssemblyComponentsVisitor components(mparams);
+        simulation::common::VisitorExecuteFunc executeVisitor(*context);
+        executeVisitor(&components);
+
+        helper::vector<core::behavior::BaseForceField*> parallelForceFields, serialForceFields;
+        for (core::behavior::BaseForceField* ff : components.forceFields)
+        {
+            if (m_serialForceFields.count(ff))
+                serialForceFields.push_back(ff);
+            else
+                parallelForceFields.push_back(ff);
+        }
+        if (parallelForceFields.size() < 2)
+            return false;
+
+        simulation::TaskScheduler* scheduler = simulation::TaskScheduler::getInstance();
+        const int nbThreads = (int)std::min<std::size_t>(std::max(scheduler->getThreadCount(), 1u), parallelForceFields.size());
+        const int nbRanges = 2*nbThreads;
+
+        matrix.compress();
+        if ((int)m_threads.size() < nbThreads)
+            m_threads.resize(nbThreads);
+        helper::vector<BlocBuffer*> buffers(nbThreads);
+        for (int t = 0; t < nbThreads; ++t)
+        {
+            m_threads[t].reset(accessor, matrix.rowSize(), matrix.colSize(), matrix.rowBSize(), nbRanges);
+            buffers[t] = &m_threads[t].buffer;
+        }
+
+        // contributions of the force fields
+        std::atomic<std::size_t> nextForceField(0);
+        auto assemble = [&](int t)
+        {
+            ThreadData& thread = m_threads[t];
+            for (std::size_t i = nextForceField++; i < parallelForceFields.size(); i = nextForceField++)
+            {
+                thread.buffer.beginGroup();
+                thread.rejected = false;
+                parallelForceFields[i]->addMBKToMatrix(mparams, &thread.accessor);
+                if (thread.rejected || thread.buffer.hasUnsupportedOperation())
+                {
+                    thread.buffer.discardGroup();
+                    thread.rejectedForceFields.push_back(parallelForceFields[i]);
+                }
+            }
+        };
+        runTasks(scheduler, nbThreads, assemble);
+
+        // merge of the buffers
+        m_newBlocs.resize(nbRanges);
+        auto merge = [&](int r)
+        {
+            m_newBlocs[r].clear();
+            matrix.mergeBlocBuffers(buffers, r, m_newBlocs[r]);
+        };
+        runTasks(scheduler, nbRanges, merge);
+
+        bool patternChanged = false;
+        for (const VecIndexedBloc& blocs : m_newBlocs)
+            patternChanged = patternChanged || !blocs.empty();
+        if (patternChanged)
+        {
+            m_chunks.resize(nbRanges);
+            const BlocBuffer& ranges = *buffers[0];
+            auto build = [&](int r)
+            {
+                const Index end = (r+1 < nbRanges) ? ranges.getRangeBegin(r+1) : matrix.rowBSize();
+                matrix.buildRowChunk(ranges.getRangeBegin(r), end, m_newBlocs[r], m_chunks[r]);
+            };
+            runTasks(scheduler, nbRanges, build);
+            matrix.setRowChunks(m_chunks);
+        }
+
+        // components which must be assembled serially
+        for (int t = 0; t < nbThreads; ++t)
+        {
+            for (core::behavior::BaseForceField* ff : m_threads[t].rejectedForceFields)
+            {
+                m_serialForceFields.insert(ff);
+                ff->addMBKToMatrix(mparams, accessor);
+            }
+        }
+        for (core::behavior::BaseForceField* ff : serialForceFields)
+            ff->addMBKToMatrix(mparams, accessor);
+        for (core::behavior::BaseProjectiveConstraintSet* c : components.projectiveConstraints)
+            c->applyConstraint(mparams, accessor);
+
+        return true;
+    }
+
+protected:
+
+    /// Accessor giving the BlocBuffer of a thread for the non mapped states
+    class ThreadAccessor : public core::behavior::MultiMatrixAccessor
+    {
+    public:
+        const core::behavior::MultiMatrixAccessor* accessor { nullptr };
+        BlocBuffer* buffer { nullptr };
+        bool* rejected { nullptr };
+
+        int getGlobalDimension() const override { return accessor->getGlobalDimension(); }
+        int getGlobalOffset(const core::behavior::BaseMechanicalState* mstate) const override { return accessor->getGlobalOffset(mstate); }
+
+        MatrixRef getMatrix(const core::behavior::BaseMechanicalState* mstate) const override
+        {
+            MatrixRef r;
+            r.matrix = buffer;
+            const int offset = accessor->getGlobalOffset(mstate);
+            if (offset >= 0)
+                r.offset = (unsigned int)offset;
+            else
+                *rejected = true;
+            return r;
+        }
+
+        InteractionMatrixRef getMatrix(const core::behavior::BaseMechanicalState* mstate1, const core::behavior::BaseMechanicalState* mstate2) const override
+        {
+            InteractionMatrixRef r;
+            r.matrix = buffer;
+            const int offset1 = accessor->getGlobalOffset(mstate1);
+            const int offset2 = accessor->getGlobalOffset(mstate2);
+            if (offset1 >= 0 && offset2 >= 0)
+            {
+                r.offRow = (unsigned int)offset1;
+                r.offCol = (unsigned int)offset2;
+            }
+            else
+                *rejected = true;
+            return r;
+        }
+    };
+
+    struct ThreadData
+    {
+        BlocBuffer buffer;
+        ThreadAccessor accessor;
+        bool rejected { false };
+        helper::vector<core::behavior::BaseForceField*> rejectedForceFields;
+
+        void reset(const core::behavior::MultiMatrixAccessor* globalAccessor, Index nbRow, Index nbCol, Index nbBRow, Index nbRanges)
+        {
+            buffer.reset(nbRow, nbCol, nbBRow, nbRanges);
+            accessor.accessor = globalAccessor;
+            accessor.buffer = &buffer;
+            accessor.rejected = &rejected;
+            rejected = false;
+            rejectedForceFields.clear();
+        }
+    };
+
+    template<class Function>
+    static void runTasks(simulation::TaskScheduler* scheduler, int nbTasks, const Function& func)
+    {
+        simulation::parallelForRange(scheduler, 0, nbTasks, 1, [&](std::size_t t, std::size_t) { func(int(t)); });
+    }
+
+    helper::vector<ThreadData> m_threads;
+    helper::vector<VecIndexedBloc> m_newBlocs;
+    helper::vector<RowChunk> m_chunks;
+
+    /// force fields which cannot be assembled in a BlocBuffer
+    std::set<const core::behavior::BaseForceField*> m_serialForceFields;
+};
+
+} // namespace linearsolver
+
+} // namespace component
+
+} // namespace sofa
+
+#endif
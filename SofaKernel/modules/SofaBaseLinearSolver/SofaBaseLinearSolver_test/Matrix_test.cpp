@@ -387,6 +387,55 @@ struct TestSparseMatrices : public Sofa_test<_Real>
         ASSERT_TRUE( Sofa_test<_Real>::matrixMaxDiff(ma,mb) < 100*Sofa_test<_Real>::epsilon() );
     }
 
+    /** Check the concurrent assembly of a CompressedRowSparseMatrix from several BlocBuffers,
+     * first building the sparsity pattern, then adding the values in place. */
+    bool checkCompressedRowSparseMatrixBlocBuffers()
+    {
+        const unsigned nbRanges = 3;
+        CRSMatrixMN crs;
+        crs.resize(NROWS,NCOLS);
+        typename CRSMatrixMN::BlocBuffer buffer1, buffer2;
+        helper::vector<typename CRSMatrixMN::BlocBuffer*> buffers { &buffer1, &buffer2 };
+
+        for (unsigned pass = 0; pass < 2; ++pass)
+        {
+            crs.clear();
+            buffer1.reset(NROWS,NCOLS,crs.rowBSize(),nbRanges);
+            buffer2.reset(NROWS,NCOLS,crs.rowBSize(),nbRanges);
+            for (int j=0; j<mat.nbCols; j++)
+                for (int i=0; i<mat.nbLines; i++)
+                    if (mat(i,j)!=0)
+                    {
+                        // each entry is split between the two buffers
+                        buffer1.add(i,j,mat(i,j)/2);
+                        buffer2.add(i,j,mat(i,j)/2);
+                    }
+
+            helper::vector<typename CRSMatrixMN::VecIndexedBloc> newBlocs(nbRanges);
+            helper::vector<typename CRSMatrixMN::RowChunk> chunks(nbRanges);
+            bool patternChanged = false;
+            for (unsigned r=0; r<nbRanges; r++)
+            {
+                crs.mergeBlocBuffers(buffers, r, newBlocs[r]);
+                patternChanged = patternChanged || !newBlocs[r].empty();
+            }
+            if (patternChanged != (pass == 0))
+                return false;
+            if (patternChanged)
+            {
+                for (unsigned r=0; r<nbRanges; r++)
+                {
+                    const int end = (r+1<nbRanges) ? buffer1.getRangeBegin(r+1) : crs.rowBSize();
+                    crs.buildRowChunk(buffer1.getRangeBegin(r), end, newBlocs[r], chunks[r]);
+                }
+                crs.setRowChunks(chunks);
+            }
+            if (Sofa_test<_Real>::matrixMaxDiff(mat,crs) > 100*Sofa_test<_Real>::epsilon())
+                return false;
+        }
+        return true;
+    }
+
     bool checkEigenMatrixBlockFromCompressedRowSparseMatrix()
     {
         return Sofa_test<_Real>::matrixMaxDiff(crs1,eiBlock3) < 100*Sofa_test<_Real>::epsilon();
@@ -23,6 +23,7 @@
 #define SOFA_COMPONENT_MAPPING_BARYCENTRICMAPPERMESHTOPOLOGY_H
 
 #include <SofaBaseMechanics/BarycentricMappers/TopologyBarycentricMapper.h>
+#include <SofaBaseMechanics/BarycentricMappers/BarycentricWeights.h>
 
 namespace sofa
 {
@@ -107,6 +108,14 @@ protected:
 
     MatrixType* m_matrixJ {nullptr};
     bool        m_updateJ {false};
+
+    /// compressed weights of the three maps, used by the parallel products
+    BarycentricWeights m_weights;
+    bool        m_updateWeights {true};
+    int         m_weightsTopologyRevision {-1};
+
+    /// Rebuild the compressed weights if the maps or the topology changed
+    void updateWeights();
 private:
     void clearMap1dAndReserve(int size=0);
     void clearMap2dAndReserve(int size=0);
@@ -81,6 +81,7 @@ template <class In, class Out>
 void BarycentricMapperMeshTopology<In,Out>::init ( const typename Out::VecCoord& out, const typename In::VecCoord& in )
 {
     m_updateJ = true;
+    m_updateWeights = true;
 
     const SeqTetrahedra& tetras = this->m_fromTopology->getTetrahedra();
     const SeqHexahedra& hexas = this->m_fromTopology->getHexahedra();
@@ -237,6 +238,7 @@ template <class In, class Out>
 void BarycentricMapperMeshTopology<In,Out>::clearMap1dAndReserve ( int size )
 {
     m_updateJ = true;
+    m_updateWeights = true;
     m_map1d.clear();
     if ( size>0 ) m_map1d.reserve ( size );
 }
@@ -246,6 +248,7 @@ template <class In, class Out>
 void BarycentricMapperMeshTopology<In,Out>::clearMap2dAndReserve ( int size )
 {
     m_updateJ = true;
+    m_updateWeights = true;
     m_map2d.clear();
     if ( size>0 ) m_map2d.reserve ( size );
 }
@@ -255,6 +258,7 @@ template <class In, class Out>
 void BarycentricMapperMeshTopology<In,Out>::clearMap3dAndReserve ( int size )
 {
     m_updateJ = true;
+    m_updateWeights = true;
     m_map3d.clear();
     if ( size>0 ) m_map3d.reserve ( size );
 }
@@ -264,6 +268,7 @@ template <class In, class Out>
 void BarycentricMapperMeshTopology<In,Out>::clear ( int size )
 {
     m_updateJ = true;
+    m_updateWeights = true;
     clearMap1dAndReserve(size);
     clearMap2dAndReserve(size);
     clearMap3dAndReserve(size);
@@ -273,6 +278,7 @@ void BarycentricMapperMeshTopology<In,Out>::clear ( int size )
 template <class In, class Out>
 int BarycentricMapperMeshTopology<In,Out>::addPointInLine ( const int lineIndex, const SReal* baryCoords )
 {
+    m_updateWeights = true;
     m_map1d.resize ( m_map1d.size() +1 );
     MappingData1D& data = *m_map1d.rbegin();
     data.in_index = lineIndex;
@@ -284,6 +290,7 @@ int BarycentricMapperMeshTopology<In,Out>::addPointInLine ( const int lineIndex,
 template <class In, class Out>
 int BarycentricMapperMeshTopology<In,Out>::addPointInTriangle ( const int triangleIndex, const SReal* baryCoords )
 {
+    m_updateWeights = true;
     m_map2d.resize ( m_map2d.size() +1 );
     MappingData2D& data = *m_map2d.rbegin();
     data.in_index = triangleIndex;
@@ -296,6 +303,7 @@ int BarycentricMapperMeshTopology<In,Out>::addPointInTriangle ( const int triang
 template <class In, class Out>
 int BarycentricMapperMeshTopology<In,Out>::addPointInQuad ( const int quadIndex, const SReal* baryCoords )
 {
+    m_updateWeights = true;
     m_map2d.resize ( m_map2d.size() +1 );
     MappingData2D& data = *m_map2d.rbegin();
     data.in_index = quadIndex + this->m_fromTopology->getNbTriangles();
@@ -308,6 +316,7 @@ int BarycentricMapperMeshTopology<In,Out>::addPointInQuad ( const int quadIndex,
 template <class In, class Out>
 int BarycentricMapperMeshTopology<In,Out>::addPointInTetra ( const int tetraIndex, const SReal* baryCoords )
 {
+    m_updateWeights = true;
     m_map3d.resize ( m_map3d.size() +1 );
     MappingData3D& data = *m_map3d.rbegin();
     data.in_index = tetraIndex;
@@ -321,6 +330,7 @@ int BarycentricMapperMeshTopology<In,Out>::addPointInTetra ( const int tetraInde
 template <class In, class Out>
 int BarycentricMapperMeshTopology<In,Out>::addPointInCube ( const int cubeIndex, const SReal* baryCoords )
 {
+    m_updateWeights = true;
     m_map3d.resize ( m_map3d.size() +1 );
     MappingData3D& data = *m_map3d.rbegin();
     data.in_index = cubeIndex + this->m_fromTopology->getNbTetrahedra();
@@ -690,6 +700,102 @@ void BarycentricMapperMeshTopology<In,Out>::draw  (const core::visual::VisualPar
     vparams->drawTool()->drawLines ( points, 1, sofa::defaulttype::Vec<4,float> ( 0,1,0,1 ) );
 }
 
+template <class In, class Out>
+void BarycentricMapperMeshTopology<In,Out>::updateWeights()
+{
+    const int topologyRevision = this->m_fromTopology->getRevision();
+    if (!m_updateWeights && m_weightsTopologyRevision == topologyRevision)
+        return;
+
+    const SeqLines& lines = this->m_fromTopology->getLines();
+    const SeqTriangles& triangles = this->m_fromTopology->getTriangles();
+    const SeqQuads& quads = this->m_fromTopology->getQuads();
+    const SeqTetrahedra& tetrahedra = this->m_fromTopology->getTetrahedra();
+    const SeqHexahedra& cubes = this->m_fromTopology->getHexahedra();
+
+    // same parents, weights and order as in apply, applyJ and applyJT
+    BarycentricWeights::Index parents[8];
+    SReal weights[8];
+    m_weights.clear();
+
+    // 1D elements
+    for ( size_t i=0; i<m_map1d.size(); i++ )
+    {
+        const Real fx = m_map1d[i].baryCoords[0];
+        const Edge& line = lines[m_map1d[i].in_index];
+        parents[0] = line[0]; weights[0] = ( 1-fx );
+        parents[1] = line[1]; weights[1] = fx;
+        m_weights.addRow(parents, weights, 2);
+    }
+    // 2D elements
+    {
+        const size_t c0 = triangles.size();
+        for ( size_t i=0; i<m_map2d.size(); i++ )
+        {
+            const Real fx = m_map2d[i].baryCoords[0];
+            const Real fy = m_map2d[i].baryCoords[1];
+            size_t index = m_map2d[i].in_index;
+            if ( index<c0 )
+            {
+                const Triangle& triangle = triangles[index];
+                parents[0] = triangle[0]; weights[0] = ( 1-fx-fy );
+                parents[1] = triangle[1]; weights[1] = fx;
+                parents[2] = triangle[2]; weights[2] = fy;
+                m_weights.addRow(parents, weights, 3);
+            }
+            else if ( index-c0<quads.size() )
+            {
+                const Quad& quad = quads[index-c0];
+                parents[0] = quad[0]; weights[0] = ( ( 1-fx ) * ( 1-fy ) );
+                parents[1] = quad[1]; weights[1] = ( ( fx ) * ( 1-fy ) );
+                parents[2] = quad[3]; weights[2] = ( ( 1-fx ) * ( fy ) );
+                parents[3] = quad[2]; weights[3] = ( ( fx ) * ( fy ) );
+                m_weights.addRow(parents, weights, 4);
+            }
+            else
+                m_weights.addEmptyRow();
+        }
+    }
+    // 3D elements
+    {
+        const size_t c0 = tetrahedra.size();
+        for ( size_t i=0; i<m_map3d.size(); i++ )
+        {
+            const Real fx = m_map3d[i].baryCoords[0];
+            const Real fy = m_map3d[i].baryCoords[1];
+            const Real fz = m_map3d[i].baryCoords[2];
+            size_t index = m_map3d[i].in_index;
+            if ( index<c0 )
+            {
+                const Tetra& tetra = tetrahedra[index];
+                parents[0] = tetra[0]; weights[0] = ( 1-fx-fy-fz );
+                parents[1] = tetra[1]; weights[1] = fx;
+                parents[2] = tetra[2]; weights[2] = fy;
+                parents[3] = tetra[3]; weights[3] = fz;
+                m_weights.addRow(parents, weights, 4);
+            }
+            else
+            {
+                const Hexa& cube = cubes[index-c0];
+                parents[0] = cube[0]; weights[0] = ( ( 1-fx ) * ( 1-fy ) * ( 1-fz ) );
+                parents[1] = cube[1]; weights[1] = ( ( fx ) * ( 1-fy ) * ( 1-fz ) );
+                parents[2] = cube[3]; weights[2] = ( ( 1-fx ) * ( fy ) * ( 1-fz ) );
+                parents[3] = cube[2]; weights[3] = ( ( fx ) * ( fy ) * ( 1-fz ) );
+                parents[4] = cube[4]; weights[4] = ( ( 1-fx ) * ( 1-fy ) * ( fz ) );
+                parents[5] = cube[5]; weights[5] = ( ( fx ) * ( 1-fy ) * ( fz ) );
+                parents[6] = cube[7]; weights[6] = ( ( 1-fx ) * ( fy ) * ( fz ) );
+                parents[7] = cube[6]; weights[7] = ( ( fx ) * ( fy ) * ( fz ) );
+                m_weights.addRow(parents, weights, 8);
+            }
+        }
+    }
+    m_weights.compress();
+
+    m_updateWeights = false;
+    m_weightsTopologyRevision = topologyRevision;
+}
+
+
 template <class In, class Out>
 const sofa::defaulttype::BaseMatrix* BarycentricMapperMeshTopology<In,Out>::getJ(int outSize, int inSize)
 {
@@ -798,6 +904,13 @@ const sofa::defaulttype::BaseMatrix* BarycentricMapperMeshTopology<In,Out>::getJ
 template <class In, class Out>
 void BarycentricMapperMeshTopology<In,Out>::applyJT ( typename In::VecDeriv& out, const typename Out::VecDeriv& in )
 {
+    if (this->m_parallel)
+    {
+        updateWeights();
+        m_weights.template applyJT<Out>(out, in, *this->maskTo, *this->maskFrom, this->maskTo->size(), true);
+        return;
+    }
+
     const SeqLines& lines = this->m_fromTopology->getLines();
     const SeqTriangles& triangles = this->m_fromTopology->getTriangles();
     const SeqQuads& quads = this->m_fromTopology->getQuads();
@@ -918,6 +1031,13 @@ void BarycentricMapperMeshTopology<In,Out>::applyJT ( typename In::VecDeriv& out
 template <class In, class Out>
 void BarycentricMapperMeshTopology<In,Out>::applyJ ( typename Out::VecDeriv& out, const typename In::VecDeriv& in )
 {
+    if (this->m_parallel)
+    {
+        updateWeights();
+        m_weights.template applyJ<Out>(out, in, *this->maskTo, this->maskTo->size(), true);
+        return;
+    }
+
     out.resize( m_map1d.size() +m_map2d.size() +m_map3d.size() );
 
     const SeqLines& lines = this->m_fromTopology->getLines();
@@ -1021,6 +1141,13 @@ void BarycentricMapperMeshTopology<In,Out>::resize( core::State<Out>* toModel )
 template <class In, class Out>
 void BarycentricMapperMeshTopology<In,Out>::apply ( typename Out::VecCoord& out, const typename In::VecCoord& in )
 {
+    if (this->m_parallel)
+    {
+        updateWeights();
+        m_weights.template apply<Out>(out, in, true);
+        return;
+    }
+
     out.resize( m_map1d.size() +m_map2d.size() +m_map3d.size() );
 
     const SeqLines& lines = this->m_fromTopology->getLines();
@@ -1112,6 +1239,7 @@ std::istream& operator >> ( std::istream& in, BarycentricMapperMeshTopology<In,
     unsigned int size_vec;
     in >> size_vec;
     b.m_map1d.clear();
+    b.m_updateWeights = true;
     typename BarycentricMapperMeshTopology<In, Out>::MappingData1D value1d;
     for (unsigned int i=0; i<size_vec; i++)
     {
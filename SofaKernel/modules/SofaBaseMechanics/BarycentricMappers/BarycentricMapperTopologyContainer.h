@@ -24,6 +24,7 @@
 
 #include <SofaBaseTopology/TopologyData.inl>
 #include <SofaBaseMechanics/BarycentricMappers/TopologyBarycentricMapper.h>
+#include <SofaBaseMechanics/BarycentricMappers/BarycentricWeights.h>
 #include <unordered_map>
 
 namespace sofa
@@ -143,6 +144,11 @@ protected:
     MatrixType* m_matrixJ {nullptr};
     bool m_updateJ {false};
 
+    /// compressed barycentric weights, rebuilt when the map or the elements change
+    BarycentricWeights m_weights;
+    int m_weightsMapCounter {-1};
+    int m_weightsTopologyRevision {-1};
+
     helper::vector<Mat3x3d> m_bases;
     helper::vector<Vector3> m_centers;
 
@@ -176,6 +182,9 @@ protected:
                                   NearestParams& nearestParams);
 
 
+    /// Rebuild the compressed weights from d_map if it, or the elements, changed since the last call
+    void updateWeights();
+
     /// Compute the datas needed to find the nearest element
     /// \param in is the vector of points
     void computeBasesAndCenters( const typename In::VecCoord& in );
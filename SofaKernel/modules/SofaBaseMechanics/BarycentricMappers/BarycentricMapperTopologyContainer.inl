@@ -245,11 +245,40 @@ void BarycentricMapperTopologyContainer<In,Out,MappingDataType,Element>::checkDi
 };
 
 
+template <class In, class Out, class MappingDataType, class Element>
+void BarycentricMapperTopologyContainer<In,Out,MappingDataType,Element>::updateWeights()
+{
+    const int topologyRevision = m_fromTopology->getRevision();
+    if (m_weightsMapCounter == d_map.getCounter() && m_weightsTopologyRevision == topologyRevision)
+        return;
+
+    const helper::vector<MappingDataType>& map = d_map.getValue();
+    const helper::vector<Element> elements = getElements();
+
+    m_weights.clear();
+    for (const MappingDataType& data : map)
+    {
+        const Element& element = elements[data.in_index];
+        const helper::vector<SReal> baryCoef = getBaryCoef(data.baryCoords);
+        BarycentricWeights::Index parents[Element::static_size];
+        for (unsigned int j=0; j<element.size(); j++)
+            parents[j] = element[j];
+        m_weights.addRow(parents, baryCoef.data(), element.size());
+    }
+    m_weights.compress();
+
+    m_weightsMapCounter = d_map.getCounter();
+    m_weightsTopologyRevision = topologyRevision;
+    m_updateJ = true;
+}
+
+
 template <class In, class Out, class MappingDataType, class Element>
 void BarycentricMapperTopologyContainer<In,Out,MappingDataType,Element>::applyJT ( typename In::MatrixDeriv& out, const typename Out::MatrixDeriv& in )
 {
+    updateWeights();
+
     typename Out::MatrixDeriv::RowConstIterator rowItEnd = in.end();
-    const helper::vector< Element >& elements = getElements();
 
     for (typename Out::MatrixDeriv::RowConstIterator rowIt = in.begin(); rowIt != rowItEnd; ++rowIt)
     {
@@ -265,11 +294,8 @@ void BarycentricMapperTopologyContainer<In,Out,MappingDataType,Element>::applyJT
                 unsigned indexIn = colIt.index();
                 InDeriv data = InDeriv(Out::getDPos(colIt.val()));
 
-                const Element& element = elements[d_map.getValue()[indexIn].in_index];
-
-                helper::vector<SReal> baryCoef = getBaryCoef(d_map.getValue()[indexIn].baryCoords);
-                for (unsigned int j=0; j<element.size(); j++)
-                    o.addCol(element[j], data*baryCoef[j]);
+                for (unsigned int k=m_weights.rowBegin(indexIn); k<m_weights.rowEnd(indexIn); k++)
+                    o.addCol(m_weights.column(k), data*m_weights.weight(k));
             }
         }
     }
@@ -280,6 +306,7 @@ void BarycentricMapperTopologyContainer<In,Out,MappingDataType,Element>::applyJT
 template <class In, class Out, class MappingDataType, class Element>
 const defaulttype::BaseMatrix* BarycentricMapperTopologyContainer<In,Out,MappingDataType, Element>::getJ(int outSize, int inSize)
 {
+    updateWeights();
     if (m_matrixJ && !m_updateJ)
         return m_matrixJ;
 
@@ -289,17 +316,12 @@ const defaulttype::BaseMatrix* BarycentricMapperTopologyContainer<In,Out,Mapping
     else
         m_matrixJ->clear();
 
-    const helper::vector<Element>& elements = getElements();
-
     for( size_t outId=0 ; outId<this->maskTo->size() ; ++outId)
     {
         if( !this->maskTo->getEntry(outId) ) continue;
 
-        const Element& element = elements[d_map.getValue()[outId].in_index];
-
-        helper::vector<SReal> baryCoef = getBaryCoef(d_map.getValue()[outId].baryCoords);
-        for (unsigned int j=0; j<element.size(); j++)
-            this->addMatrixContrib(m_matrixJ, outId, element[j], baryCoef[j]);
+        for (unsigned int k=m_weights.rowBegin(outId); k<m_weights.rowEnd(outId); k++)
+            this->addMatrixContrib(m_matrixJ, outId, m_weights.column(k), m_weights.weight(k));
     }
 
     m_matrixJ->compress();
@@ -311,47 +333,15 @@ const defaulttype::BaseMatrix* BarycentricMapperTopologyContainer<In,Out,Mapping
 template <class In, class Out, class MappingDataType, class Element>
 void BarycentricMapperTopologyContainer<In,Out,MappingDataType,Element>::applyJT ( typename In::VecDeriv& out, const typename Out::VecDeriv& in )
 {
-    const helper::vector<Element>& elements = getElements();
-
-    ForceMask& mask = *this->maskFrom;
-    for( size_t i=0 ; i<this->maskTo->size() ; ++i)
-    {
-        if( !this->maskTo->getEntry(i) ) continue;
-
-        int index = d_map.getValue()[i].in_index;
-        const Element& element = elements[index];
-
-        const typename Out::DPos inPos = Out::getDPos(in[i]);
-        helper::vector<SReal> baryCoef = getBaryCoef(d_map.getValue()[i].baryCoords);
-        for (unsigned int j=0; j<element.size(); j++)
-        {
-            out[element[j]] += inPos * baryCoef[j];
-            mask.insertEntry(element[j]);
-        }
-    }
+    updateWeights();
+    m_weights.template applyJT<Out>(out, in, *this->maskTo, *this->maskFrom, this->maskTo->size(), this->m_parallel);
 }
 
 template <class In, class Out, class MappingDataType, class Element>
 void BarycentricMapperTopologyContainer<In,Out,MappingDataType,Element>::applyJ ( typename Out::VecDeriv& out, const typename In::VecDeriv& in )
 {
-    out.resize( d_map.getValue().size() );
-
-    const helper::vector<Element>& elements = getElements();
-
-    for( size_t i=0 ; i<this->maskTo->size() ; ++i)
-    {
-        if( this->maskTo->isActivated() && !this->maskTo->getEntry(i) ) continue;
-
-        int index = d_map.getValue()[i].in_index;
-        const Element& element = elements[index];
-
-        helper::vector<SReal> baryCoef = getBaryCoef(d_map.getValue()[i].baryCoords);
-        InDeriv inPos{0.,0.,0.};
-        for (unsigned int j=0; j<element.size(); j++)
-            inPos += in[element[j]] * baryCoef[j];
-
-        Out::setDPos(out[i] , inPos);
-    }
+    updateWeights();
+    m_weights.template applyJ<Out>(out, in, *this->maskTo, this->maskTo->size(), this->m_parallel);
 }
 
 
@@ -372,21 +362,8 @@ bool BarycentricMapperTopologyContainer<In,Out,MappingDataType,Element>::isEmpty
 template <class In, class Out, class MappingDataType, class Element>
 void BarycentricMapperTopologyContainer<In,Out,MappingDataType,Element>::apply ( typename Out::VecCoord& out, const typename In::VecCoord& in )
 {
-    out.resize( d_map.getValue().size() );
-
-    const helper::vector<Element>& elements = getElements();
-    for ( unsigned int i=0; i<d_map.getValue().size(); i++ )
-    {
-        int index = d_map.getValue()[i].in_index;
-        const Element& element = elements[index];
-
-        helper::vector<SReal> baryCoef = getBaryCoef(d_map.getValue()[i].baryCoords);
-        InDeriv inPos{0.,0.,0.};
-        for (unsigned int j=0; j<element.size(); j++)
-            inPos += in[element[j]] * baryCoef[j];
-
-        Out::setCPos(out[i] , inPos);
-    }
+    updateWeights();
+    m_weights.template apply<Out>(out, in, this->m_parallel);
 }
 
 
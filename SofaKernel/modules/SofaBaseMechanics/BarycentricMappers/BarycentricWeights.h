@@ -0,0 +1,222 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#ifndef SOFA_COMPONENT_MAPPING_BARYCENTRICWEIGHTS_H
+#define SOFA_COMPONENT_MAPPING_BARYCENTRICWEIGHTS_H
+#include <SofaBaseMechanics/config.h>
+#include <sofa/helper/vector.h>
+#include <sofa/simulation/ParallelForRange.h>
+#include <algorithm>
+#include <type_traits>
+
+namespace sofa
+{
+
+namespace component
+{
+
+namespace mapping
+{
+
+/// Barycentric weights of a mapping, stored as a compressed sparse matrix J:
+/// each mapped point (row) has the list of its parents (columns) with their weight.
+/// The transposed structure is also kept, so that J^T can be applied in parallel by
+/// gathering the contributions of each parent, without concurrent writes.
+/// Both structures store the entries in the order of the original loops, so the
+/// serial and parallel products give exactly the same results.
+class BarycentricWeights
+{
+public:
+    typedef unsigned int Index;
+
+    /// minimum number of rows (or columns) processed by a task
+    enum { MinGrainSize = 1024 };
+
+    void clear()
+    {
+        m_rowBegin.clear();
+        m_rowBegin.push_back(0);
+        m_columns.clear();
+        m_weights.clear();
+        m_colBegin.clear();
+        m_colRows.clear();
+        m_colWeights.clear();
+    }
+
+    /// add a row with the n given parents and weights
+    void addRow(const Index* parents, const SReal* weights, std::size_t n)
+    {
+        m_columns.insert(m_columns.end(), parents, parents + n);
+        m_weights.insert(m_weights.end(), weights, weights + n);
+        m_rowBegin.push_back(Index(m_columns.size()));
+    }
+
+    /// add an empty row (point not mapped)
+    void addEmptyRow() { m_rowBegin.push_back(Index(m_columns.size())); }
+
+    /// build the transposed structure, once every row is added
+    void compress()
+    {
+        Index nbCols = 0;
+        for (Index c : m_columns)
+            nbCols = std::max(nbCols, c + 1);
+
+        m_colBegin.assign(nbCols + 1, 0);
+        for (Index c : m_columns)
+            ++m_colBegin[c + 1];
+        for (Index c = 0; c < nbCols; ++c)
+            m_colBegin[c + 1] += m_colBegin[c];
+
+        m_colRows.resize(m_columns.size());
+        m_colWeights.resize(m_columns.size());
+        helper::vector<Index> fill(m_colBegin.begin(), m_colBegin.end() - 1);
+        for (Index i = 0; i < nbRows(); ++i)
+        {
+            for (Index k = m_rowBegin[i]; k < m_rowBegin[i + 1]; ++k)
+            {
+                const Index pos = fill[m_columns[k]]++;
+                m_colRows[pos] = i;
+                m_colWeights[pos] = m_weights[k];
+            }
+        }
+    }
+
+    Index nbRows() const { return m_rowBegin.empty() ? 0 : Index(m_rowBegin.size() - 1); }
+    Index nbColumns() const { return m_colBegin.empty() ? 0 : Index(m_colBegin.size() - 1); }
+    std::size_t nbEntries() const { return m_columns.size(); }
+
+    Index rowBegin(Index i) const { return m_rowBegin[i]; }
+    Index rowEnd(Index i) const { return m_rowBegin[i + 1]; }
+    Index column(Index k) const { return m_columns[k]; }
+    SReal weight(Index k) const { return m_weights[k]; }
+
+    /// out[i] = sum_j J(i,j) in[j]
+    template<class Out, class VecOut, class VecIn>
+    void apply(VecOut& out, const VecIn& in, bool parallel) const
+    {
+        typedef typename std::decay<decltype(Out::getCPos(out[0]))>::type OutPos;
+        typedef typename std::decay<decltype(in[0]*SReal())>::type Value;
+        out.resize(nbRows());
+        forEachRange(nbRows(), parallel, [&](Index begin, Index end)
+        {
+            for (Index i = begin; i < end; ++i)
+            {
+                Value v = Value();
+                for (Index k = m_rowBegin[i]; k < m_rowBegin[i + 1]; ++k)
+                    v += in[m_columns[k]] * m_weights[k];
+                Out::setCPos(out[i], OutPos(v));
+            }
+        });
+    }
+
+    /// out[i] = sum_j J(i,j) in[j] for the first nbMapped rows, skipping the rows out of the mask when it is activated
+    template<class Out, class VecOut, class VecIn, class Mask>
+    void applyJ(VecOut& out, const VecIn& in, const Mask& maskTo, Index nbMapped, bool parallel) const
+    {
+        typedef typename std::decay<decltype(Out::getDPos(out[0]))>::type OutPos;
+        typedef typename std::decay<decltype(in[0]*SReal())>::type Value;
+        out.resize(nbRows());
+        const bool masked = maskTo.isActivated();
+        forEachRange(std::min(nbMapped, nbRows()), parallel, [&](Index begin, Index end)
+        {
+            for (Index i = begin; i < end; ++i)
+            {
+                if (masked && !maskTo.getEntry(i)) continue;
+                Value v = Value();
+                for (Index k = m_rowBegin[i]; k < m_rowBegin[i + 1]; ++k)
+                    v += in[m_columns[k]] * m_weights[k];
+                Out::setDPos(out[i], OutPos(v));
+            }
+        });
+    }
+
+    /// out[j] += sum_i J(i,j) in[i] for the first nbMapped rows which are in maskTo, inserting the modified parents in maskFrom.
+    /// The parallel version gathers the contributions of each parent through the transposed structure.
+    template<class Out, class VecOut, class VecIn, class Mask>
+    void applyJT(VecOut& out, const VecIn& in, const Mask& maskTo, Mask& maskFrom, Index nbMapped, bool parallel) const
+    {
+        nbMapped = std::min(nbMapped, nbRows());
+        if (!parallel || nbColumns() < Index(MinGrainSize))
+        {
+            for (Index i = 0; i < nbMapped; ++i)
+            {
+                if (!maskTo.getEntry(i)) continue;
+                const auto f = Out::getDPos(in[i]);
+                for (Index k = m_rowBegin[i]; k < m_rowBegin[i + 1]; ++k)
+                {
+                    out[m_columns[k]] += f * m_weights[k];
+                    maskFrom.insertEntry(m_columns[k]);
+                }
+            }
+            return;
+        }
+
+        // the mask is not safe for concurrent writes: the modified parents are collected, then inserted serially
+        m_touched.assign(nbColumns(), 0);
+        forEachRange(nbColumns(), true, [&](Index begin, Index end)
+        {
+            for (Index j = begin; j < end; ++j)
+            {
+                for (Index k = m_colBegin[j]; k < m_colBegin[j + 1]; ++k)
+                {
+                    const Index i = m_colRows[k];
+                    if (i >= nbMapped || !maskTo.getEntry(i)) continue;
+                    out[j] += Out::getDPos(in[i]) * m_colWeights[k];
+                    m_touched[j] = 1;
+                }
+            }
+        });
+        for (Index j = 0; j < nbColumns(); ++j)
+            if (m_touched[j])
+                maskFrom.insertEntry(j);
+    }
+
+protected:
+
+    /// call func on contiguous ranges covering [0,n), dispatched on the TaskScheduler when parallel is set
+    template<class RangeFunction>
+    static void forEachRange(Index n, bool parallel, const RangeFunction& func)
+    {
+        simulation::TaskScheduler* scheduler = parallel ? simulation::TaskScheduler::getInstance() : nullptr;
+        simulation::parallelForRange(scheduler, 0, n, simulation::getParallelGrainSize(scheduler, n, MinGrainSize), [&](std::size_t begin, std::size_t end)
+        {
+            func(Index(begin), Index(end));
+        });
+    }
+
+    helper::vector<Index> m_rowBegin { 0 };
+    helper::vector<Index> m_columns;
+    helper::vector<SReal> m_weights;
+
+    helper::vector<Index> m_colBegin;
+    helper::vector<Index> m_colRows;
+    helper::vector<SReal> m_colWeights;
+
+    mutable helper::vector<char> m_touched;
+};
+
+} // namespace mapping
+
+} // namespace component
+
+} // namespace sofa
+
+#endif // SOFA_COMPONENT_MAPPING_BARYCENTRICWEIGHTS_H
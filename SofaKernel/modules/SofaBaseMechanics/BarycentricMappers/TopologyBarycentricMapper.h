@@ -77,6 +77,10 @@ public:
     const topology::PointSetTopologyContainer *getToTopology() const {return m_toTopology;}
 
     virtual void updateForceMask(){/*mask is already filled in the mapper's applyJT*/}
+
+    /// apply the mapping and its transpose in parallel, with the TaskScheduler
+    void setParallel(bool parallel) { m_parallel = parallel; }
+    bool isParallel() const { return m_parallel; }
     virtual void resize( core::State<Out>* toModel ) = 0;
 
     void processTopologicalChanges(const typename Out::VecCoord& out, const typename In::VecCoord& in, core::topology::Topology* t) {
@@ -96,6 +100,7 @@ protected:
 
     core::topology::BaseMeshTopology*    m_fromTopology;
     topology::PointSetTopologyContainer* m_toTopology;
+    bool m_parallel {false};
 };
 
 #if !defined(SOFA_COMPONENT_MAPPING_TOPOLOGYBARYCENTRICMAPPER_CPP)
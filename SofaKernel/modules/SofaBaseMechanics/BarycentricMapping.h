@@ -82,6 +82,7 @@ public:
     SingleLink<BarycentricMapping<In,Out>,Mapper,BaseLink::FLAG_STRONGLINK> d_mapper;
     SingleLink<BarycentricMapping<In,Out>,BaseMeshTopology,BaseLink::FLAG_STRONGLINK> d_input_topology;
     SingleLink<BarycentricMapping<In,Out>,BaseMeshTopology,BaseLink::FLAG_STRONGLINK> d_output_topology;
+    Data< bool > d_parallel; ///< Apply the mapping and its transpose in parallel, with the TaskScheduler
 
     void init() override;
     void reinit() override;
@@ -100,6 +100,7 @@ BarycentricMapping<TIn, TOut>::BarycentricMapping(core::State<In>* from, core::S
     , d_mapper(initLink("mapper","Internal mapper created depending on the type of topology"), mapper)
     , d_input_topology(initLink("input_topology", "Input topology container (usually the surrounding domain)."))
     , d_output_topology(initLink("output_topology", "Output topology container (usually the immersed domain)."))
+    , d_parallel(initData(&d_parallel, false, "parallel", "Apply the mapping and its transpose in parallel, with the TaskScheduler"))
 
 
 {
@@ -113,6 +114,7 @@ BarycentricMapping<TIn, TOut>::BarycentricMapping (core::State<In>* from, core::
     , d_mapper (initLink("mapper","Internal mapper created depending on the type of topology"))
     , d_input_topology(initLink("input_topology", "Input topology container (usually the surrounding domain)."))
     , d_output_topology(initLink("output_topology", "Output topology container (usually the immersed domain)."))
+    , d_parallel(initData(&d_parallel, false, "parallel", "Apply the mapping and its transpose in parallel, with the TaskScheduler"))
 {
     if (input_topology) {
         d_input_topology.set(input_topology);
@@ -277,6 +279,8 @@ void BarycentricMapping<TIn, TOut>::init()
     if (!this->toModel)
         return;
 
+    d_mapper->setParallel(d_parallel.getValue());
+
     if (useRestPosition.getValue())
         d_mapper->init ( ((const core::State<Out> *)this->toModel)->read(core::ConstVecCoordId::restPosition())->getValue(), ((const core::State<In> *)this->fromModel)->read(core::ConstVecCoordId::restPosition())->getValue() );
     else
@@ -290,6 +294,7 @@ void BarycentricMapping<TIn, TOut>::reinit()
 {
     if ( d_mapper != nullptr )
     {
+        d_mapper->setParallel(d_parallel.getValue());
         d_mapper->clear();
         d_mapper->init (((const core::State<Out> *)this->toModel)->read(core::ConstVecCoordId::position())->getValue(), ((const core::State<In> *)this->fromModel)->read(core::ConstVecCoordId::position())->getValue() );
     }
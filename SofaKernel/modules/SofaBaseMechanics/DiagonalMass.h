@@ -187,12 +187,17 @@ public:
 
     Data< float > d_showAxisSize; ///< factor length of the axis displayed (only used for rigids)
     core::objectmodel::DataFileName d_fileMass; ///< an Xsp3.0 file to specify the mass parameters
+    Data< bool > d_parallel; ///< compute addMDx and accFromF in parallel with the TaskScheduler
 
     DMassPointHandler* m_pointHandler;
 
     /// value defining the initialization process of the mass (0 : totalMass, 1 : massDensity, 2 : vertexMass)
     int m_initializationProcess;
 
+    /// Apply func to the indices [0,n), in parallel if requested
+    template<class IndexFunction>
+    void forEachVertex(std::size_t n, const IndexFunction& func);
+
     /// Link to be set to the topology container in the component graph. 
     SingleLink<DiagonalMass<DataTypes, TMassType>, sofa::core::topology::BaseMeshTopology, BaseLink::FLAG_STOREPATH | BaseLink::FLAG_STRONGLINK> l_topology;
 
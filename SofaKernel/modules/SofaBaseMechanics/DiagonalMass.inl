@@ -30,6 +30,9 @@
 #include <SofaBaseTopology/RegularGridTopology.h>
 #include <SofaBaseMechanics/AddMToMatrixFunctor.h>
 #include <sofa/simulation/AnimateEndEvent.h>
+#include <sofa/simulation/ParallelForRange.h>
+
+#include <algorithm>
 
 namespace sofa::component::mass
 {
@@ -49,6 +52,7 @@ DiagonalMass<DataTypes, MassType>::DiagonalMass()
     , d_showCenterOfGravity( initData(&d_showCenterOfGravity, false, "showGravityCenter", "Display the center of gravity of the system" ) )
     , d_showAxisSize( initData(&d_showAxisSize, 1.0f, "showAxisSizeFactor", "Factor length of the axis displayed (only used for rigids)" ) )
     , d_fileMass( initData(&d_fileMass,  "filename", "Xsp3.0 file to specify the mass parameters" ) )
+    , d_parallel( initData(&d_parallel, false, "parallel", "compute addMDx and accFromF in parallel with the TaskScheduler" ) )
     , m_pointHandler(nullptr)
     , l_topology(initLink("topology", "link to the topology container"))
     , m_topologyType(TOPOLOGY_UNKNOWN)
@@ -582,6 +586,21 @@ void DiagonalMass<DataTypes, MassType>::resize(int vsize)
 }
 
 // -- Mass interface
+template <class DataTypes, class MassType>
+template <class IndexFunction>
+void DiagonalMass<DataTypes, MassType>::forEachVertex(std::size_t n, const IndexFunction& func)
+{
+    const std::size_t minGrainSize = 4096;
+    simulation::TaskScheduler* scheduler = d_parallel.getValue() ? simulation::TaskScheduler::getInstance() : nullptr;
+
+    // one chunk per thread, unless it gets smaller than the grain size
+    simulation::parallelForRange(scheduler, 0, n, simulation::getParallelGrainSize(scheduler, n, minGrainSize), [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            func(i);
+    });
+}
+
 template <class DataTypes, class MassType>
 void DiagonalMass<DataTypes, MassType>::addMDx(const core::MechanicalParams* /*mparams*/, DataVecDeriv& res, const DataVecDeriv& dx, SReal factor)
 {
@@ -592,19 +611,22 @@ void DiagonalMass<DataTypes, MassType>::addMDx(const core::MechanicalParams* /*m
     size_t n = masses.size();
     if (_dx.size() < n) n = _dx.size();
     if (_res.size() < n) n = _res.size();
+
+    VecDeriv& r = _res.wref();
+    const VecDeriv& x = _dx.ref();
     if (factor == 1.0)
     {
-        for (size_t i=0; i<n; i++)
+        forEachVertex(n, [&](std::size_t i)
         {
-            _res[i] += _dx[i] * masses[i];
-        }
+            r[i] += x[i] * masses[i];
+        });
     }
     else
     {
-        for (size_t i=0; i<n; i++)
+        forEachVertex(n, [&](std::size_t i)
         {
-            _res[i] += (_dx[i] * masses[i]) * Real(factor);
-        }
+            r[i] += (x[i] * masses[i]) * Real(factor);
+        });
     }
 }
 
@@ -618,10 +640,11 @@ void DiagonalMass<DataTypes, MassType>::accFromF(const core::MechanicalParams* /
     helper::WriteOnlyAccessor< DataVecDeriv > _a = a;
     const VecDeriv& _f = f.getValue();
 
-    for (unsigned int i=0; i<masses.size(); i++)
+    VecDeriv& acc = _a.wref();
+    forEachVertex(masses.size(), [&](std::size_t i)
     {
-        _a[i] = _f[i] / masses[i];
-    }
+        acc[i] = _f[i] / masses[i];
+    });
 }
 
 template <class DataTypes, class MassType>
@@ -146,6 +146,8 @@ public:
 
     Data< bool >  d_useTopology; ///< Shall this object rely on any active topology to initialize its size and positions
 
+    Data< bool >  d_flatVectorOps; ///< Compute vOp, vMultiOp and vDot on the flat arrays of scalars of the vectors (Vec types only)
+
     Data< bool >  showObject; ///< Show objects. (default=false)
     Data< float > showObjectScale; ///< Scale for object display. (default=0.1)
     Data< bool >  showIndices; ///< Show indices. (default=false)
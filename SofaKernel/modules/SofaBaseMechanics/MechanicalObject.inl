@@ -90,6 +90,7 @@ MechanicalObject<DataTypes>::MechanicalObject()
     , reset_velocity(initData(&reset_velocity, "reset_velocity", "reset velocity coordinates of the degrees of freedom"))
     , restScale(initData(&restScale, (SReal)1.0, "restScale", "optional scaling of rest position coordinates (to simulated pre-existing internal tension).(default = 1.0)"))
     , d_useTopology(initData(&d_useTopology, true, "useTopology", "Shall this object rely on any active topology to initialize its size and positions"))
+    , d_flatVectorOps(initData(&d_flatVectorOps, false, "flatVectorOps", "Compute vOp, vMultiOp and vDot with vectorizable loops over the flat arrays of scalars of the vectors, only used for Vec types. Dot products are accumulated in several partial sums."))
     , showObject(initData(&showObject, (bool) false, "showObject", "Show objects. (default=false)"))
     , showObjectScale(initData(&showObjectScale, (float) 0.1, "showObjectScale", "Scale for object display. (default=0.1)"))
     , showIndices(initData(&showIndices, (bool) false, "showIndices", "Show indices. (default=false)"))
@@ -1810,6 +1811,205 @@ void MechanicalObject<DataTypes>::vInit(const core::ExecParams* params,
     }
 }
 
+/// Vector operations on the flat array of scalars of the state vectors.
+/// Only available when Coord and Deriv are the same Vec type, so that all the vectors of the
+/// MechanicalObject are contiguous arrays of Real that the compiler can vectorize.
+template <class DataTypes>
+struct MechanicalObjectFlatVecOps
+{
+    static bool vOp(MechanicalObject<DataTypes>*, core::VecId, core::ConstVecId, core::ConstVecId, SReal, int) { return false; }
+    static bool vMultiOp(MechanicalObject<DataTypes>*, const typename MechanicalObject<DataTypes>::VMultiOp&) { return false; }
+    static bool vDot(MechanicalObject<DataTypes>*, core::ConstVecId, core::ConstVecId, SReal&) { return false; }
+};
+
+template <int N, class Real>
+struct MechanicalObjectFlatVecOps< defaulttype::StdVectorTypes< defaulttype::Vec<N,Real>, defaulttype::Vec<N,Real>, Real > >
+{
+    typedef defaulttype::StdVectorTypes< defaulttype::Vec<N,Real>, defaulttype::Vec<N,Real>, Real > DataTypes;
+    typedef MechanicalObject<DataTypes> MO;
+    typedef typename DataTypes::VecCoord VecReal; // VecCoord and VecDeriv are the same type
+    typedef typename MO::VMultiOp VMultiOp;
+
+    static Data<VecReal>* write(MO* mo, core::VecId v)
+    {
+        return v.type == sofa::core::V_COORD ? mo->write(core::VecCoordId(v)) : mo->write(core::VecDerivId(v));
+    }
+
+    static const Data<VecReal>* read(MO* mo, core::ConstVecId v)
+    {
+        return v.type == sofa::core::V_COORD ? mo->read(core::ConstVecCoordId(v)) : mo->read(core::ConstVecDerivId(v));
+    }
+
+    static Real* ptr(VecReal& v) { return v.empty() ? nullptr : v[0].ptr(); }
+    static const Real* ptr(const VecReal& v) { return v.empty() ? nullptr : v[0].ptr(); }
+
+    /// Same operations as MechanicalObject::vOp, with the same validity rules
+    static bool vOp(MO* mo, core::VecId v, core::ConstVecId a, core::ConstVecId b, SReal f, int size)
+    {
+        const Real rf = (Real)f;
+        if (a.isNull())
+        {
+            if (b.isNull())
+            {
+                // v = 0
+                helper::WriteOnlyAccessor< Data<VecReal> > vv( *write(mo, v) );
+                vv.resize(size);
+                Real* pv = ptr(vv.wref());
+                const std::size_t n = vv.size() * N;
+                for (std::size_t i=0; i<n; ++i) pv[i] = 0;
+                return true;
+            }
+            if (b.type != v.type) return false;
+            if (v == b)
+            {
+                // v *= f
+                helper::WriteAccessor< Data<VecReal> > vv( *write(mo, v) );
+                Real* pv = ptr(vv.wref());
+                const std::size_t n = vv.size() * N;
+                for (std::size_t i=0; i<n; ++i) pv[i] *= rf;
+                return true;
+            }
+            // v = b*f
+            helper::WriteAccessor< Data<VecReal> > vv( *write(mo, v) );
+            helper::ReadAccessor< Data<VecReal> > vb( *read(mo, b) );
+            vv.resize(vb.size());
+            Real* pv = ptr(vv.wref());
+            const Real* pb = ptr(vb.ref());
+            const std::size_t n = vv.size() * N;
+            for (std::size_t i=0; i<n; ++i) pv[i] = pb[i] * rf;
+            return true;
+        }
+
+        if (a.type != v.type) return false;
+        if (!b.isNull() && b.type != v.type && v.type != sofa::core::V_COORD) return false;
+
+        if (b.isNull())
+        {
+            // v = a
+            helper::WriteOnlyAccessor< Data<VecReal> > vv( *write(mo, v) );
+            helper::ReadAccessor< Data<VecReal> > va( *read(mo, a) );
+            vv.resize(va.size());
+            std::copy(va.begin(), va.end(), vv.begin());
+            return true;
+        }
+
+        if (v == a || v == b)
+        {
+            // v += o*f, or v = o+v*f
+            const core::ConstVecId o = (v == a) ? b : a;
+            helper::WriteAccessor< Data<VecReal> > vv( *write(mo, v) );
+            helper::ReadAccessor< Data<VecReal> > vo( *read(mo, o) );
+            if (v == a || f == 1.0)
+            {
+                if (vo.size() > vv.size())
+                    vv.resize(vo.size());
+                Real* pv = ptr(vv.wref());
+                const Real* po = ptr(vo.ref());
+                const std::size_t n = vo.size() * N;
+                if (f == 1.0)
+                    for (std::size_t i=0; i<n; ++i) pv[i] += po[i];
+                else
+                    for (std::size_t i=0; i<n; ++i) pv[i] += po[i] * rf;
+            }
+            else
+            {
+                vv.resize(vo.size());
+                Real* pv = ptr(vv.wref());
+                const Real* po = ptr(vo.ref());
+                const std::size_t n = vo.size() * N;
+                for (std::size_t i=0; i<n; ++i) pv[i] = pv[i] * rf + po[i];
+            }
+            return true;
+        }
+
+        // v = a+b*f
+        helper::WriteOnlyAccessor< Data<VecReal> > vv( *write(mo, v) );
+        helper::ReadAccessor< Data<VecReal> > va( *read(mo, a) );
+        helper::ReadAccessor< Data<VecReal> > vb( *read(mo, b) );
+        vv.resize(va.size());
+        Real* pv = ptr(vv.wref());
+        const Real* pa = ptr(va.ref());
+        const Real* pb = ptr(vb.ref());
+        const std::size_t n = vv.size() * N;
+        if (f == 1.0)
+            for (std::size_t i=0; i<n; ++i) pv[i] = pa[i] + pb[i];
+        else
+            for (std::size_t i=0; i<n; ++i) pv[i] = pa[i] + pb[i] * rf;
+        return true;
+    }
+
+    /// Integration case v = v*f_v_v + a*f_v_a, x = x*f_x_x + v*f_x_v in a single pass
+    static bool vMultiOp(MO* mo, const VMultiOp& ops)
+    {
+        if (!(ops.size() == 2
+              && ops[0].second.size() == 2
+              && ops[0].first.getId(mo) == ops[0].second[0].first.getId(mo)
+              && ops[0].first.getId(mo).type == sofa::core::V_DERIV
+              && ops[0].second[1].first.getId(mo).type == sofa::core::V_DERIV
+              && ops[1].second.size() == 2
+              && ops[1].first.getId(mo) == ops[1].second[0].first.getId(mo)
+              && ops[0].first.getId(mo) == ops[1].second[1].first.getId(mo)
+              && ops[1].first.getId(mo).type == sofa::core::V_COORD))
+            return false;
+
+        helper::ReadAccessor< Data<VecReal> > va( *mo->read(core::ConstVecDerivId(ops[0].second[1].first.getId(mo))) );
+        helper::WriteAccessor< Data<VecReal> > vv( *mo->write(core::VecDerivId(ops[0].first.getId(mo))) );
+        helper::WriteAccessor< Data<VecReal> > vx( *mo->write(core::VecCoordId(ops[1].first.getId(mo))) );
+
+        const std::size_t n = vx.size() * N;
+        const Real* pa = ptr(va.ref());
+        Real* pv = ptr(vv.wref());
+        Real* px = ptr(vx.wref());
+        const Real f_v_v = (Real)(ops[0].second[0].second);
+        const Real f_v_a = (Real)(ops[0].second[1].second);
+        const Real f_x_x = (Real)(ops[1].second[0].second);
+        const Real f_x_v = (Real)(ops[1].second[1].second);
+
+        if (f_v_v == 1.0 && f_x_x == 1.0)
+        {
+            for (std::size_t i=0; i<n; ++i)
+            {
+                pv[i] += pa[i] * f_v_a;
+                px[i] += pv[i] * f_x_v;
+            }
+        }
+        else
+        {
+            for (std::size_t i=0; i<n; ++i)
+            {
+                pv[i] = pv[i] * f_v_v + pa[i] * f_v_a;
+                px[i] = px[i] * f_x_x + pv[i] * f_x_v;
+            }
+        }
+        return true;
+    }
+
+    static bool vDot(MO* mo, core::ConstVecId a, core::ConstVecId b, SReal& r)
+    {
+        if (a.type != b.type) return false;
+
+        const VecReal& va = read(mo, a)->getValue();
+        const VecReal& vb = read(mo, b)->getValue();
+        const Real* pa = ptr(va);
+        const Real* pb = ptr(vb);
+        const std::size_t n = va.size() * N;
+
+        // independent partial sums so that the additions are not serialized
+        Real r0 = 0, r1 = 0, r2 = 0, r3 = 0;
+        std::size_t i = 0;
+        for (; i+4<=n; i+=4)
+        {
+            r0 += pa[i  ] * pb[i  ];
+            r1 += pa[i+1] * pb[i+1];
+            r2 += pa[i+2] * pb[i+2];
+            r3 += pa[i+3] * pb[i+3];
+        }
+        for (; i<n; ++i) r0 += pa[i] * pb[i];
+        r = (r0 + r1) + (r2 + r3);
+        return true;
+    }
+};
+
 template <class DataTypes>
 void MechanicalObject<DataTypes>::vOp(const core::ExecParams* params, core::VecId v,
                                       core::ConstVecId a,
@@ -1823,6 +2023,8 @@ void MechanicalObject<DataTypes>::vOp(const core::ExecParams* params, core::VecI
         msg_error() << "Invalid vOp operation 1 ("<<v<<','<<a<<','<<b<<','<<f<<")";
         return;
     }
+    if (d_flatVectorOps.getValue() && MechanicalObjectFlatVecOps<DataTypes>::vOp(this, v, a, b, f, d_size.getValue()))
+        return;
     if (a.isNull())
     {
         if (b.isNull())
@@ -2189,6 +2391,9 @@ void MechanicalObject<DataTypes>::vOp(const core::ExecParams* params, core::VecI
 template <class DataTypes>
 void MechanicalObject<DataTypes>::vMultiOp(const core::ExecParams* params, const VMultiOp& ops)
 {
+    if (d_flatVectorOps.getValue() && MechanicalObjectFlatVecOps<DataTypes>::vMultiOp(this, ops))
+        return;
+
     // optimize common integration case: v += a*dt, x += v*dt
     if (ops.size() == 2
             && ops[0].second.size() == 2
@@ -2317,6 +2522,10 @@ void MechanicalObject<DataTypes>::vThreshold(core::VecId v, SReal t)
 template <class DataTypes>
 SReal MechanicalObject<DataTypes>::vDot(const core::ExecParams*, core::ConstVecId a, core::ConstVecId b)
 {
+    SReal flatResult = 0.0;
+    if (d_flatVectorOps.getValue() && MechanicalObjectFlatVecOps<DataTypes>::vDot(this, a, b, flatResult))
+        return flatResult;
+
     Real r = 0.0;
 
     if (a.type == sofa::core::V_COORD && b.type == sofa::core::V_COORD)
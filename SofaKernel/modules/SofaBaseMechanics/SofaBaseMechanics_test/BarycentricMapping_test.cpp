@@ -144,3 +144,102 @@ TEST_F(BarycentricMapperTriangleSetTopologyTest_d, initHashing)
 }
 
 
+
+/// Check that the parallel products, computed from the compressed weights, give the same results as the serial ones
+template <class In, class Out>
+struct BarycentricMapperParallelTest :  public Test, public BarycentricMapperTriangleSetTopology<In,Out>
+{
+    typedef BarycentricMapperTriangleSetTopology<In,Out> Inherit;
+    typedef typename In::Real Real;
+    typedef typename Inherit::ForceMask ForceMask;
+
+    using Inherit::m_fromTopology;
+    using Inherit::addPointInTriangle;
+
+    TriangleSetTopologyContainer::SPtr m_topology;
+    ForceMask m_maskFrom;
+    ForceMask m_maskTo;
+    typename In::VecCoord m_in;
+    typename In::VecDeriv m_dx;
+    typename Out::VecDeriv m_f;
+
+    void SetUp() override
+    {
+        // regular grid of size x size points, large enough to use several tasks
+        const unsigned int size = 50;
+        m_topology = New<TriangleSetTopologyContainer>();
+        m_fromTopology = m_topology.get();
+        for (unsigned int j=0; j<size-1; j++)
+        {
+            for (unsigned int i=0; i<size-1; i++)
+            {
+                const unsigned int p = j*size+i;
+                m_fromTopology->addTriangle(p, p+1, p+size);
+                m_fromTopology->addTriangle(p+1, p+size+1, p+size);
+            }
+        }
+        for (unsigned int p=0; p<size*size; p++)
+        {
+            m_in.push_back(Vector3(p%size, p/size, 0.01*(p%7)));
+            m_dx.push_back(Vector3(0.1*(p%3), -0.2*(p%5), 0.3));
+        }
+
+        const unsigned int nbTriangles = m_fromTopology->getNbTriangles();
+        const unsigned int nbPoints = 3*nbTriangles;
+        for (unsigned int i=0; i<nbPoints; i++)
+        {
+            const SReal baryCoords[2] = { 0.1*(i%5), 0.15*(i%4) };
+            addPointInTriangle((i*7919)%nbTriangles, baryCoords);
+            m_f.push_back(Vector3(1.0, 0.5*(i%3), -0.25*(i%11)));
+        }
+
+        m_maskFrom.assign(m_in.size(), false);
+        m_maskTo.assign(nbPoints, true);
+        this->maskFrom = &m_maskFrom;
+        this->maskTo = &m_maskTo;
+    }
+
+    void products(bool parallel, typename Out::VecCoord& x, typename Out::VecDeriv& v, typename In::VecDeriv& f)
+    {
+        this->setParallel(parallel);
+        this->apply(x, m_in);
+        this->applyJ(v, m_dx);
+        f.assign(m_in.size(), Vector3(1.0, 2.0, 3.0));
+        this->applyJT(f, m_f);
+    }
+
+    void parallel_test()
+    {
+        typename Out::VecCoord xSerial, xParallel;
+        typename Out::VecDeriv vSerial, vParallel;
+        typename In::VecDeriv fSerial, fParallel;
+        products(false, xSerial, vSerial, fSerial);
+        products(true, xParallel, vParallel, fParallel);
+
+        ASSERT_EQ(xSerial.size(), m_f.size());
+        ASSERT_EQ(xParallel.size(), m_f.size());
+        ASSERT_EQ(vParallel.size(), m_f.size());
+        for (unsigned int i=0; i<m_f.size(); i++)
+        {
+            EXPECT_EQ(xSerial[i], xParallel[i]);
+            EXPECT_EQ(vSerial[i], vParallel[i]);
+        }
+        for (unsigned int i=0; i<m_in.size(); i++)
+            EXPECT_EQ(fSerial[i], fParallel[i]);
+
+        // J^T is the transpose of J
+        Real vf = 0, dxf = 0;
+        for (unsigned int i=0; i<m_f.size(); i++)
+            vf += vParallel[i] * m_f[i];
+        for (unsigned int i=0; i<m_in.size(); i++)
+            dxf += m_dx[i] * (fParallel[i] - Vector3(1.0, 2.0, 3.0));
+        EXPECT_NEAR(vf, dxf, 1e-8 * std::abs(vf));
+    }
+};
+
+typedef BarycentricMapperParallelTest< Vec3dTypes, Vec3dTypes> BarycentricMapperParallelTest_d;
+
+TEST_F(BarycentricMapperParallelTest_d, parallel)
+{
+    parallel_test();
+}
@@ -40,6 +40,7 @@ using sofa::core::ExecParams ;
 using sofa::simulation::Node ;
 
 #include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/TaskScheduler.h>
 #include <SofaSimulationGraph/DAGSimulation.h>
 
 #include <SofaSimulationGraph/SimpleApi.h>
@@ -207,6 +208,64 @@ public:
         return ;
     }
 
+    /// The products computed by ranges of vertices in parallel are the same as the serial ones
+    void checkParallelProduct_Hexa(){
+        string scene =
+                "<?xml version='1.0'?>                                                                             "
+                "<Node  name='Root' gravity='0 0 0' time='0' animate='0'   >                                       "
+                "    <MechanicalObject />                                                                          "
+                "    <RegularGrid nx='20' ny='20' nz='20' xmin='0' xmax='2' ymin='0' ymax='2' zmin='0' zmax='2' /> "
+                "    <HexahedronSetGeometryAlgorithms />                                                           "
+                "    <DiagonalMass name='m_mass' massDensity='1.0' />                                              "
+                "</Node>                                                                                           " ;
+
+        Node::SPtr root = SceneLoaderXML::loadFromMemory ("loadWithNoParam",
+                                                          scene.c_str(),
+                                                          scene.size()) ;
+
+        ASSERT_NE(root.get(), nullptr) ;
+        root->init(ExecParams::defaultInstance()) ;
+
+        TheDiagonalMass* mass = root->getTreeObject<TheDiagonalMass>() ;
+        ASSERT_TRUE( mass != nullptr ) ;
+
+        // more vertices than the grain size, split between the threads
+        const size_t nbPoints = size_t(mass->getMassCount());
+        ASSERT_EQ( nbPoints, size_t(8000) ) ;
+
+        simulation::TaskScheduler* scheduler = simulation::TaskScheduler::getInstance();
+        const unsigned int nbThreads = scheduler->getThreadCount();
+        scheduler->init(4);
+
+        typename TheDiagonalMass::VecDeriv dxValue(nbPoints);
+        for (size_t i = 0 ; i < nbPoints ; i++)
+            dxValue[i] = typename TheDiagonalMass::Deriv(SReal(i % 7), SReal(i % 5), 1.0);
+        typename TheDiagonalMass::DataVecDeriv dx, fSerial, fParallel, aSerial, aParallel;
+        dx.setValue(dxValue);
+
+        for (SReal factor : { 1.0, 2.0 })
+        {
+            fSerial.setValue(typename TheDiagonalMass::VecDeriv(nbPoints));
+            fParallel.setValue(typename TheDiagonalMass::VecDeriv(nbPoints));
+            aSerial.setValue(typename TheDiagonalMass::VecDeriv(nbPoints));
+            aParallel.setValue(typename TheDiagonalMass::VecDeriv(nbPoints));
+            mass->d_parallel.setValue(false);
+            mass->addMDx(nullptr, fSerial, dx, factor);
+            mass->accFromF(nullptr, aSerial, dx);
+            mass->d_parallel.setValue(true);
+            mass->addMDx(nullptr, fParallel, dx, factor);
+            mass->accFromF(nullptr, aParallel, dx);
+
+            for (size_t i = 0 ; i < nbPoints ; i++)
+            {
+                EXPECT_EQ(fSerial.getValue()[i], fParallel.getValue()[i]) ;
+                EXPECT_EQ(aSerial.getValue()[i], aParallel.getValue()[i]) ;
+            }
+        }
+        mass->d_parallel.setValue(false);
+        scheduler->init(nbThreads);
+    }
+
     void checkMassDensityFromTotalMass_Hexa(){
         string scene =
                 "<?xml version='1.0'?>                                                                          "
@@ -781,6 +840,10 @@ TEST_F(DiagonalMass3_test, checkTotalMassFromMassDensity_Hexa){
     checkTotalMassFromMassDensity_Hexa();
 }
 
+TEST_F(DiagonalMass3_test, checkParallelProduct_Hexa){
+    checkParallelProduct_Hexa();
+}
+
 TEST_F(DiagonalMass3_test, checkMassDensityFromTotalMass_Hexa){
     checkMassDensityFromTotalMass_Hexa();
 }
@@ -110,6 +110,69 @@ TYPED_TEST(MechanicalObject_test, checkThatPositionDefaultValueIsAVectorOfValueI
     TestHelpers::CheckPosition(this->mechanicalObject);
 }
 
+TYPED_TEST(MechanicalObject_test, checkThatFlatVectorOperationsGiveTheSameResults)
+{
+    typedef typename TypeParam::VecCoord VecCoord;
+    typedef typename TypeParam::VecDeriv VecDeriv;
+    typedef typename TypeParam::Real Real;
+    using core::VecCoordId;
+    using core::VecDerivId;
+    const core::ExecParams* params = core::ExecParams::defaultInstance();
+
+    StubMechanicalObject<TypeParam> flat;
+    StubMechanicalObject<TypeParam>* objects[2] = { &this->mechanicalObject, &flat };
+    flat.d_flatVectorOps.setValue(true);
+
+    for (StubMechanicalObject<TypeParam>* mo : objects)
+    {
+        mo->resize(7);
+        VecCoord& x = *mo->write(VecCoordId::position())->beginEdit();
+        VecDeriv& v = *mo->write(VecDerivId::velocity())->beginEdit();
+        VecDeriv& f = *mo->write(VecDerivId::force())->beginEdit();
+        for (unsigned i = 0; i < x.size(); ++i)
+            for (unsigned c = 0; c < TypeParam::coord_total_size; ++c)
+            {
+                x[i][c] = (Real)(0.5 * i - c);
+                v[i][c] = (Real)(1.0 + i * c);
+                f[i][c] = (Real)(0.25 * c - i);
+            }
+        mo->write(VecCoordId::position())->endEdit();
+        mo->write(VecDerivId::velocity())->endEdit();
+        mo->write(VecDerivId::force())->endEdit();
+
+        mo->vOp(params, VecDerivId::dx(), VecDerivId::force(), VecDerivId::velocity(), 0.5);    // dx = f + v*0.5
+        mo->vOp(params, VecDerivId::dx(), VecDerivId::dx(), VecDerivId::force(), -2.0);        // dx += f*-2
+        mo->vOp(params, VecDerivId::force(), VecDerivId::velocity(), VecDerivId::force(), 3.0); // f = v + f*3
+        mo->vOp(params, VecDerivId::velocity(), core::ConstVecId::null(), VecDerivId::velocity(), 0.1); // v *= 0.1
+        mo->vOp(params, VecCoordId::position(), VecCoordId::position(), VecDerivId::velocity(), 0.01); // x += v*0.01
+
+        core::behavior::BaseMechanicalState::VMultiOp ops(2);
+        ops[0].first = core::VecDerivId::velocity();
+        ops[0].second.push_back(std::make_pair(core::ConstVecDerivId::velocity(), 1.0));
+        ops[0].second.push_back(std::make_pair(core::ConstVecDerivId::dx(), 0.2));
+        ops[1].first = core::VecCoordId::position();
+        ops[1].second.push_back(std::make_pair(core::ConstVecCoordId::position(), 1.0));
+        ops[1].second.push_back(std::make_pair(core::ConstVecDerivId::velocity(), 0.2));
+        mo->vMultiOp(params, ops);
+    }
+
+    const Real eps = std::numeric_limits<Real>::epsilon() * 100;
+    EXPECT_NEAR(this->mechanicalObject.vDot(params, VecDerivId::dx(), VecDerivId::force()),
+                flat.vDot(params, VecDerivId::dx(), VecDerivId::force()), eps);
+
+    const VecCoord& x0 = this->mechanicalObject.read(core::ConstVecCoordId::position())->getValue();
+    const VecCoord& x1 = flat.read(core::ConstVecCoordId::position())->getValue();
+    const VecDeriv& v0 = this->mechanicalObject.read(core::ConstVecDerivId::velocity())->getValue();
+    const VecDeriv& v1 = flat.read(core::ConstVecDerivId::velocity())->getValue();
+    ASSERT_EQ(x0.size(), x1.size());
+    for (unsigned i = 0; i < x0.size(); ++i)
+        for (unsigned c = 0; c < TypeParam::coord_total_size; ++c)
+        {
+            EXPECT_NEAR(x0[i][c], x1[i][c], eps);
+            EXPECT_NEAR(v0[i][c], v1[i][c], eps);
+        }
+}
+
 } // namespace
 
 } // namespace sofa
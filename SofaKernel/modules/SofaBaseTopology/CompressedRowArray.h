@@ -0,0 +1,207 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#ifndef SOFA_COMPONENT_TOPOLOGY_COMPRESSEDROWARRAY_H
+#define SOFA_COMPONENT_TOPOLOGY_COMPRESSEDROWARRAY_H
+#include "config.h"
+
+#include <sofa/helper/vector.h>
+#include <sofa/simulation/ParallelForRange.h>
+
+#include <algorithm>
+
+namespace sofa
+{
+
+namespace component
+{
+
+namespace topology
+{
+
+/** Immutable adjacency stored in compressed rows (CSR): the indices of all the rows
+ * in one flat array, and the offset of each row in it.
+ *
+ * Used for the "around vertex" arrays of the topology containers: row v lists, in
+ * increasing order, the elements having v as vertex. The whole array is built at once
+ * by a counting sort (in parallel when a TaskScheduler is running), which replaces one
+ * heap allocation per row by two allocations.
+ */
+template<class TIndex>
+class CompressedRowArray
+{
+public:
+    typedef TIndex Index;
+
+    /// Read-only view on the indices of one row
+    class Row
+    {
+    public:
+        Row(const Index* begin, const Index* end) : m_begin(begin), m_end(end) {}
+
+        const Index* begin() const { return m_begin; }
+        const Index* end() const { return m_end; }
+        std::size_t size() const { return std::size_t(m_end - m_begin); }
+        bool empty() const { return m_begin == m_end; }
+        const Index& operator[](std::size_t i) const { return m_begin[i]; }
+
+    private:
+        const Index* m_begin;
+        const Index* m_end;
+    };
+
+    CompressedRowArray() : m_revision(-1), m_nbElements(0) {}
+
+    std::size_t size() const { return m_offsets.empty() ? 0 : m_offsets.size() - 1; }
+    bool empty() const { return size() == 0; }
+
+    Row operator[](std::size_t row) const
+    {
+        return Row(m_indices.data() + m_offsets[row], m_indices.data() + m_offsets[row + 1]);
+    }
+
+    const sofa::helper::vector<Index>& getOffsets() const { return m_offsets; }
+    const sofa::helper::vector<Index>& getIndices() const { return m_indices; }
+
+    /// Memory used by the offsets and the indices, in bytes
+    std::size_t getMemorySize() const { return (m_offsets.capacity() + m_indices.capacity()) * sizeof(Index); }
+
+    void clear()
+    {
+        m_offsets.clear();
+        m_indices.clear();
+        m_revision = -1;
+        m_nbElements = 0;
+    }
+
+    /// True if the array was built for this topology revision and these sizes
+    bool isUpToDate(int revision, std::size_t nbRows, std::size_t nbElements) const
+    {
+        return m_revision == revision && !m_offsets.empty() && size() == nbRows && m_nbElements == nbElements;
+    }
+
+    /** Build the rows of nbRows vertices from an array of elements (each one an array of vertex indices):
+     * row v receives the index of every element having v as vertex.
+     * Vertex indices out of [0, nbRows) are ignored, and their number is returned.
+     */
+    template<class ElementArray>
+    std::size_t build(std::size_t nbRows, const ElementArray& elements, int revision = -1)
+    {
+        const std::size_t nbElements = elements.size();
+        const std::size_t nbChunks = getNbChunks(nbElements);
+        const std::size_t chunkSize = nbChunks ? (nbElements + nbChunks - 1) / nbChunks : 0;
+
+        // count the entries of each row in each chunk of elements
+        sofa::helper::vector<Index> counts(std::max<std::size_t>(nbChunks, 1) * nbRows, Index(0));
+        sofa::helper::vector<std::size_t> ignored(std::max<std::size_t>(nbChunks, 1), 0);
+        auto countChunk = [&](std::size_t c)
+        {
+            Index* chunkCounts = counts.data() + c * nbRows;
+            const std::size_t last = std::min(nbElements, (c + 1) * chunkSize);
+            for (std::size_t e = c * chunkSize; e < last; ++e)
+                for (const auto v : elements[e])
+                {
+                    if (std::size_t(v) < nbRows) ++chunkCounts[v];
+                    else ++ignored[c];
+                }
+        };
+        forEachChunk(nbChunks, countChunk);
+
+        // offsets of the rows, and start of each chunk inside each row: the elements keep their order
+        m_offsets.resize(nbRows + 1);
+        Index offset = 0;
+        for (std::size_t v = 0; v < nbRows; ++v)
+        {
+            m_offsets[v] = offset;
+            for (std::size_t c = 0; c < nbChunks; ++c)
+            {
+                const Index n = counts[c * nbRows + v];
+                counts[c * nbRows + v] = offset;
+                offset += n;
+            }
+        }
+        m_offsets[nbRows] = offset;
+
+        m_indices.resize(offset);
+        auto fillChunk = [&](std::size_t c)
+        {
+            Index* cursors = counts.data() + c * nbRows;
+            const std::size_t last = std::min(nbElements, (c + 1) * chunkSize);
+            for (std::size_t e = c * chunkSize; e < last; ++e)
+                for (const auto v : elements[e])
+                    if (std::size_t(v) < nbRows)
+                        m_indices[cursors[v]++] = Index(e);
+        };
+        forEachChunk(nbChunks, fillChunk);
+
+        m_revision = revision;
+        m_nbElements = nbElements;
+
+        std::size_t nbIgnored = 0;
+        for (std::size_t n : ignored) nbIgnored += n;
+        return nbIgnored;
+    }
+
+    /// Copy the rows into an array of vectors, each one allocated at its exact size
+    template<class Rows>
+    void copyTo(sofa::helper::vector<Rows>& rows) const
+    {
+        rows.resize(size());
+        for (std::size_t v = 0; v < size(); ++v)
+        {
+            const Row row = (*this)[v];
+            rows[v].assign(row.begin(), row.end());
+        }
+    }
+
+protected:
+    /// Minimal number of elements per chunk, below it the build is done in one chunk
+    static constexpr std::size_t MinChunkSize = 32768;
+
+    static std::size_t getNbChunks(std::size_t nbElements)
+    {
+        if (nbElements == 0) return 0;
+        simulation::TaskScheduler* scheduler = simulation::TaskScheduler::getInstance();
+        const std::size_t nbThreads = scheduler ? scheduler->getThreadCount() : 1;
+        if (nbThreads <= 1) return 1;
+        return std::max<std::size_t>(1, std::min(nbThreads, nbElements / MinChunkSize));
+    }
+
+    template<class Func>
+    static void forEachChunk(std::size_t nbChunks, const Func& func)
+    {
+        simulation::TaskScheduler* scheduler = nbChunks > 1 ? simulation::TaskScheduler::getInstance() : nullptr;
+        simulation::parallelForRange(scheduler, 0, nbChunks, 1, [&](std::size_t c, std::size_t) { func(c); });
+    }
+
+    sofa::helper::vector<Index> m_offsets;
+    sofa::helper::vector<Index> m_indices;
+    int m_revision;
+    std::size_t m_nbElements;
+};
+
+} // namespace topology
+
+} // namespace component
+
+} // namespace sofa
+
+#endif // SOFA_COMPONENT_TOPOLOGY_COMPRESSEDROWARRAY_H
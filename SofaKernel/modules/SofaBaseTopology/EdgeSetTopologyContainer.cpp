@@ -118,25 +118,13 @@ void EdgeSetTopologyContainer::createEdgesAroundVertexArray()
         return;
     }
 
-    int nbPoints = getNbPoints();
-    if (nbPoints == 0) // in case only Data have been copied and not going thourgh AddTriangle methods.
+    if (getNbPoints() == 0) // in case only Data have been copied and not going thourgh AddTriangle methods.
         this->setNbPoints(d_initPoints.getValue().size());
 
-    m_edgesAroundVertex.resize(getNbPoints());
-    for (unsigned int edgeId=0; edgeId<edges.size(); ++edgeId)
-    {
-        const Edge& edge = edges[edgeId];
-        // adding edge in the edge shell of both points
-        
-        if (edge[0] >= unsigned(nbPoints) || edge[1] >= unsigned(nbPoints))
-        {
-            msg_warning() << "EdgesAroundVertex creation failed, Edge buffer is not concistent with number of points: Edge: " << edge << " for: " << nbPoints << " points.";
-            continue;
-        }
-
-        m_edgesAroundVertex[ edge[0] ].push_back(edgeId);
-        m_edgesAroundVertex[ edge[1] ].push_back(edgeId);
-    }
+    // counting sort of the edges by vertex, then one allocation per vertex at its final size
+    const size_t nbIgnored = m_compressedEdgesAroundVertex.build(getNbPoints(), edges.ref(), d_edge.getCounter());
+    msg_warning_when(nbIgnored > 0) << "EdgesAroundVertex creation: " << nbIgnored << " edge ends are not consistent with the number of points: " << getNbPoints() << " points.";
+    m_compressedEdgesAroundVertex.copyTo(m_edgesAroundVertex);
 
     if (m_checkConnexity.getValue())
         this->checkConnexity();
@@ -498,6 +486,14 @@ const sofa::helper::vector< sofa::helper::vector<EdgeSetTopologyContainer::EdgeI
     return m_edgesAroundVertex;
 }
 
+const EdgeSetTopologyContainer::CompressedEdgesAroundVertex& EdgeSetTopologyContainer::getCompressedEdgesAroundVertexArray()
+{
+    helper::ReadAccessor< Data< sofa::helper::vector<Edge> > > elements = d_edge;
+    if (!m_compressedEdgesAroundVertex.isUpToDate(d_edge.getCounter(), getNbPoints(), elements.size()))
+        m_compressedEdgesAroundVertex.build(getNbPoints(), elements.ref(), d_edge.getCounter());
+    return m_compressedEdgesAroundVertex;
+}
+
 const EdgeSetTopologyContainer::EdgesAroundVertex& EdgeSetTopologyContainer::getEdgesAroundVertex(PointID id)
 {
     if(id < m_edgesAroundVertex.size())
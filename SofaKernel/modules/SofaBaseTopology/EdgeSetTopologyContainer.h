@@ -24,6 +24,7 @@
 #include "config.h"
 
 #include <SofaBaseTopology/PointSetTopologyContainer.h>
+#include <SofaBaseTopology/CompressedRowArray.h>
 
 namespace sofa
 {
@@ -48,6 +49,7 @@ public:
     typedef BaseMeshTopology::Edge                  Edge;
     typedef BaseMeshTopology::SeqEdges              SeqEdges;
     typedef BaseMeshTopology::EdgesAroundVertex     EdgesAroundVertex;
+    typedef CompressedRowArray<EdgeID>              CompressedEdgesAroundVertex;
     typedef sofa::helper::vector<EdgeID>            VecEdgeID;
 
 
@@ -153,6 +155,11 @@ public:
      */
     virtual const sofa::helper::vector< sofa::helper::vector<EdgeID> >& getEdgesAroundVertexArray();
 
+    /** \brief Returns the EdgesAroundVertex adjacency in compressed rows (i.e. one flat array of indices
+     * and the offset of each vertex in it). It is rebuilt at once when the edges have changed.
+     */
+    const CompressedEdgesAroundVertex& getCompressedEdgesAroundVertexArray();
+
 
     bool hasEdges() const;
 
@@ -232,6 +239,9 @@ protected:
     /** the array that stores the set of edge-vertex shells, ie for each vertex gives the set of adjacent edges */
     sofa::helper::vector< EdgesAroundVertex > m_edgesAroundVertex;
 
+    /// compressed rows of the EdgesAroundVertex adjacency, see getCompressedEdgesAroundVertexArray()
+    CompressedEdgesAroundVertex m_compressedEdgesAroundVertex;
+
 
     /// Boolean used to know if the topology Data of this container is dirty
     bool m_edgeTopologyDirty;
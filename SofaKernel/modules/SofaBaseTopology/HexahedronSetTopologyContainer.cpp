@@ -418,16 +418,11 @@ void HexahedronSetTopologyContainer::createHexahedraAroundVertexArray()
     if (getNbPoints() == 0) // in case only Data have been copied and not going thourgh AddTriangle methods.
         this->setNbPoints(d_initPoints.getValue().size());
 
-    m_hexahedraAroundVertex.resize( getNbPoints() );
     helper::ReadAccessor< Data< sofa::helper::vector<Hexahedron> > > m_hexahedron = d_hexahedron;
 
-    for(size_t i=0; i<m_hexahedron.size(); ++i)
-    {
-        HexahedronID hexaID = (HexahedronID)i;
-        // adding vertex i in the vertex shell
-        for(unsigned int j=0; j<8; ++j)
-            m_hexahedraAroundVertex[ m_hexahedron[i][j]  ].push_back(hexaID);
-    }
+    // counting sort of the hexahedra by vertex, then one allocation per vertex at its final size
+    m_compressedHexahedraAroundVertex.build(getNbPoints(), m_hexahedron.ref(), d_hexahedron.getCounter());
+    m_compressedHexahedraAroundVertex.copyTo(m_hexahedraAroundVertex);
 }
 
 void HexahedronSetTopologyContainer::createHexahedraAroundEdgeArray ()
@@ -570,6 +565,14 @@ const sofa::helper::vector< HexahedronSetTopologyContainer::HexahedraAroundVerte
     return m_hexahedraAroundVertex;
 }
 
+const HexahedronSetTopologyContainer::CompressedHexahedraAroundVertex& HexahedronSetTopologyContainer::getCompressedHexahedraAroundVertexArray()
+{
+    helper::ReadAccessor< Data< sofa::helper::vector<Hexahedron> > > elements = d_hexahedron;
+    if (!m_compressedHexahedraAroundVertex.isUpToDate(d_hexahedron.getCounter(), getNbPoints(), elements.size()))
+        m_compressedHexahedraAroundVertex.build(getNbPoints(), elements.ref(), d_hexahedron.getCounter());
+    return m_compressedHexahedraAroundVertex;
+}
+
 const sofa::helper::vector< HexahedronSetTopologyContainer::HexahedraAroundEdge > &HexahedronSetTopologyContainer::getHexahedraAroundEdgeArray()
 {
     return m_hexahedraAroundEdge;
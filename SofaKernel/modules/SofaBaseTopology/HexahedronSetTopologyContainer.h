@@ -76,6 +76,7 @@ public:
     typedef core::topology::BaseMeshTopology::Hexa				         Hexa;
     typedef core::topology::BaseMeshTopology::SeqHexahedra			      SeqHexahedra;
     typedef core::topology::BaseMeshTopology::HexahedraAroundVertex		HexahedraAroundVertex;
+    typedef CompressedRowArray<HexahedronID>		CompressedHexahedraAroundVertex;
     typedef core::topology::BaseMeshTopology::HexahedraAroundEdge		HexahedraAroundEdge;
     typedef core::topology::BaseMeshTopology::HexahedraAroundQuad		HexahedraAroundQuad;
     typedef core::topology::BaseMeshTopology::EdgesInHexahedron		   EdgesInHexahedron;
@@ -296,6 +297,11 @@ public:
     /** \brief Returns the HexahedraAroundVertex array (i.e. provide the hexahedron indices adjacent to each vertex).*/
     const sofa::helper::vector< HexahedraAroundVertex > &getHexahedraAroundVertexArray() ;
 
+    /** \brief Returns the HexahedraAroundVertex adjacency in compressed rows (i.e. one flat array of indices
+     * and the offset of each vertex in it). It is rebuilt at once when the hexahedra have changed.
+     */
+    const CompressedHexahedraAroundVertex& getCompressedHexahedraAroundVertexArray();
+
 
     /** \brief Returns the HexahedraAroundEdge array (i.e. provide the hexahedron indices adjacent to each edge). */
     const sofa::helper::vector< HexahedraAroundEdge > &getHexahedraAroundEdgeArray() ;
@@ -452,6 +458,9 @@ protected:
     /// for each vertex provides the set of hexahedra adjacent to that vertex.
     sofa::helper::vector< HexahedraAroundVertex > m_hexahedraAroundVertex;
 
+    /// compressed rows of the HexahedraAroundVertex adjacency, see getCompressedHexahedraAroundVertexArray()
+    CompressedHexahedraAroundVertex m_compressedHexahedraAroundVertex;
+
     /// for each edge provides the set of hexahedra adjacent to that edge.
     sofa::helper::vector< HexahedraAroundEdge > m_hexahedraAroundEdge;
 
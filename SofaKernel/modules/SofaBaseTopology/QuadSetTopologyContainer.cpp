@@ -116,15 +116,9 @@ void QuadSetTopologyContainer::createQuadsAroundVertexArray()
     if (getNbPoints() == 0) // in case only Data have been copied and not going thourgh AddTriangle methods.
         this->setNbPoints(d_initPoints.getValue().size());
 
-    m_quadsAroundVertex.resize(getNbPoints());
-    for (size_t i=0; i<m_quad.size(); ++i)
-    {
-        // adding quad i in the quad shell of all points
-        for (size_t j=0; j<4; ++j)
-        {
-            m_quadsAroundVertex[ m_quad[i][j] ].push_back((QuadID)i);
-        }
-    }
+    // counting sort of the quads by vertex, then one allocation per vertex at its final size
+    m_compressedQuadsAroundVertex.build(getNbPoints(), m_quad.ref(), d_quad.getCounter());
+    m_compressedQuadsAroundVertex.copyTo(m_quadsAroundVertex);
 }
 
 void QuadSetTopologyContainer::createQuadsAroundEdgeArray()
@@ -329,6 +323,14 @@ const sofa::helper::vector< QuadSetTopologyContainer::QuadsAroundVertex > &QuadS
     return m_quadsAroundVertex;
 }
 
+const QuadSetTopologyContainer::CompressedQuadsAroundVertex& QuadSetTopologyContainer::getCompressedQuadsAroundVertexArray()
+{
+    helper::ReadAccessor< Data< sofa::helper::vector<Quad> > > elements = d_quad;
+    if (!m_compressedQuadsAroundVertex.isUpToDate(d_quad.getCounter(), getNbPoints(), elements.size()))
+        m_compressedQuadsAroundVertex.build(getNbPoints(), elements.ref(), d_quad.getCounter());
+    return m_compressedQuadsAroundVertex;
+}
+
 const sofa::helper::vector< QuadSetTopologyContainer::QuadsAroundEdge > &QuadSetTopologyContainer::getQuadsAroundEdgeArray()
 {
     return m_quadsAroundEdge;
@@ -52,6 +52,7 @@ public:
     typedef BaseMeshTopology::SeqQuads			SeqQuads;
     typedef BaseMeshTopology::EdgesInQuad			EdgesInQuad;
     typedef BaseMeshTopology::QuadsAroundVertex		QuadsAroundVertex;
+    typedef CompressedRowArray<QuadID>		CompressedQuadsAroundVertex;
     typedef BaseMeshTopology::QuadsAroundEdge		QuadsAroundEdge;
     typedef sofa::helper::vector<QuadID>                  VecQuadID;
 
@@ -209,6 +210,11 @@ public:
     /** \brief Returns the QuadsAroundVertex array (i.e. provide the quad indices adjacent to each vertex). */
     const sofa::helper::vector< QuadsAroundVertex > &getQuadsAroundVertexArray();
 
+    /** \brief Returns the QuadsAroundVertex adjacency in compressed rows (i.e. one flat array of indices
+     * and the offset of each vertex in it). It is rebuilt at once when the quads have changed.
+     */
+    const CompressedQuadsAroundVertex& getCompressedQuadsAroundVertexArray();
+
 
     /** \brief Returns the QuadsAroundEdge array (i.e. provide the quad indices adjacent to each edge). */
     const sofa::helper::vector< QuadsAroundEdge > &getQuadsAroundEdgeArray() ;
@@ -316,6 +322,9 @@ protected:
     /// for each vertex provides the set of quads adjacent to that vertex.
     sofa::helper::vector< QuadsAroundVertex > m_quadsAroundVertex;
 
+    /// compressed rows of the QuadsAroundVertex adjacency, see getCompressedQuadsAroundVertexArray()
+    CompressedQuadsAroundVertex m_compressedQuadsAroundVertex;
+
     /// for each edge provides the set of quads adjacent to that edge.
     sofa::helper::vector< QuadsAroundEdge > m_quadsAroundEdge;
 
@@ -23,8 +23,10 @@
 #include <SofaBaseTopology/SofaBaseTopology_test/fake_TopologyScene.h>
 #include <sofa/helper/testing/BaseTest.h>
 #include <SofaBaseTopology/TetrahedronSetTopologyContainer.h>
+#include <SofaBaseTopology/TetrahedronSetTopologyModifier.h>
 #include <SofaBaseTopology/TetrahedronSetGeometryAlgorithms.h>
 #include <sofa/helper/system/FileRepository.h>
+#include <sofa/simulation/TaskScheduler.h>
 
 using namespace sofa::component::topology;
 using namespace sofa::helper::testing;
@@ -38,6 +40,8 @@ public:
     bool testTriangleBuffers();
     bool testEdgeBuffers();
     bool testVertexBuffers();
+    bool testCompressedVertexBuffers();
+    bool testTetrahedraChangeSet();
     bool checkTopology();
     bool testTetrahedronGeometry();
 
@@ -390,6 +394,120 @@ bool TetrahedronSetTopology_test::testVertexBuffers()
 
 
 
+bool TetrahedronSetTopology_test::testCompressedVertexBuffers()
+{
+    fake_TopologyScene* scene = new fake_TopologyScene("mesh/cube_low_res.msh", sofa::core::topology::TopologyObjectType::TETRAHEDRON);
+    TetrahedronSetTopologyContainer* topoCon = dynamic_cast<TetrahedronSetTopologyContainer*>(scene->getNode().get()->getMeshTopology());
+
+    if (topoCon == nullptr)
+    {
+        if (scene != nullptr)
+            delete scene;
+        return false;
+    }
+
+    // the compressed rows give the same adjacency than the vector of vectors
+    const sofa::helper::vector< TetrahedronSetTopologyContainer::TetrahedraAroundVertex >& elemAroundVertices = topoCon->getTetrahedraAroundVertexArray();
+    const TetrahedronSetTopologyContainer::CompressedTetrahedraAroundVertex& compressed = topoCon->getCompressedTetrahedraAroundVertexArray();
+    EXPECT_EQ(compressed.size(), nbrVertex);
+    EXPECT_EQ(compressed.getIndices().size(), nbrTetrahedron * elemSize);
+    for (size_t v = 0; v < elemAroundVertices.size(); v++)
+    {
+        const auto row = compressed[v];
+        EXPECT_EQ(row.size(), elemAroundVertices[v].size());
+        if (row.size() != elemAroundVertices[v].size())
+            return false;
+        for (size_t i = 0; i < row.size(); i++)
+            EXPECT_EQ(row[i], elemAroundVertices[v][i]);
+    }
+
+    // large enough to be built in parallel chunks: the order of the elements is kept in each row
+    sofa::simulation::TaskScheduler::getInstance()->init(4);
+    const size_t nbVertices = 1000;
+    sofa::helper::vector<TetrahedronSetTopologyContainer::Tetrahedron> tetrahedra(200000);
+    sofa::helper::vector< sofa::helper::vector<unsigned int> > expected(nbVertices);
+    for (size_t t = 0; t < tetrahedra.size(); t++)
+        for (unsigned int j = 0; j < 4; j++)
+        {
+            tetrahedra[t][j] = (unsigned int)((t * 7 + j * 131) % nbVertices);
+            expected[tetrahedra[t][j]].push_back((unsigned int)t);
+        }
+
+    CompressedRowArray<unsigned int> parallelRows;
+    EXPECT_EQ(parallelRows.build(nbVertices, tetrahedra), 0u);
+    EXPECT_EQ(parallelRows.size(), nbVertices);
+    for (size_t v = 0; v < nbVertices; v++)
+    {
+        const auto row = parallelRows[v];
+        EXPECT_EQ(row.size(), expected[v].size());
+        if (row.size() != expected[v].size())
+            return false;
+        for (size_t i = 0; i < row.size(); i++)
+            EXPECT_EQ(row[i], expected[v][i]);
+    }
+
+    delete scene;
+    return true;
+}
+
+
+bool TetrahedronSetTopology_test::testTetrahedraChangeSet()
+{
+    fake_TopologyScene* scene = new fake_TopologyScene("mesh/cube_low_res.msh", sofa::core::topology::TopologyObjectType::TETRAHEDRON);
+    TetrahedronSetTopologyContainer* topoCon = dynamic_cast<TetrahedronSetTopologyContainer*>(scene->getNode().get()->getMeshTopology());
+    TetrahedronSetTopologyModifier* topoMod = nullptr;
+    scene->getNode()->get(topoMod);
+    sofa::core::behavior::BaseMechanicalState* dof = scene->getNode()->getMechanicalState();
+
+    if (topoCon == nullptr || topoMod == nullptr || dof == nullptr)
+    {
+        if (scene != nullptr)
+            delete scene;
+        return false;
+    }
+
+    // the tetrahedra are compared by the positions of their vertices, as isolated vertices are removed too
+    typedef sofa::defaulttype::Vec3d Vec3d;
+    auto getCorners = [&](const TetrahedronSetTopologyContainer::Tetrahedron& tetra)
+    {
+        sofa::helper::vector<Vec3d> corners;
+        for (unsigned int j = 0; j < 4; j++)
+            corners.push_back(Vec3d(dof->getPX(tetra[j]), dof->getPY(tetra[j]), dof->getPZ(tetra[j])));
+        return corners;
+    };
+    sofa::helper::vector< sofa::helper::vector<Vec3d> > before;
+    for (size_t t = 0; t < topoCon->getNumberOfTetrahedra(); t++)
+        before.push_back(getCorners(topoCon->getTetrahedron(t)));
+    const TetrahedronSetTopologyContainer::Tetrahedron added = topoCon->getTetrahedron(5);
+
+    // the removals are given with the indices at the opening, in any order and repeated
+    topoMod->beginTetrahedraChangeSet();
+    EXPECT_TRUE(topoMod->isTetrahedraChangeSetOpen());
+    topoMod->queueTetrahedraRemoval({ 10, 3 });
+    topoMod->queueTetrahedraRemoval({ 40, 10, 0 });
+    topoMod->queueTetrahedraAddition({ added });
+    const sofa::helper::vector<TetrahedronSetTopologyContainer::TetrahedronID> renumbering = topoMod->commitTetrahedraChangeSet();
+    EXPECT_FALSE(topoMod->isTetrahedraChangeSetOpen());
+
+    EXPECT_EQ(topoCon->getNumberOfTetrahedra(), nbrTetrahedron - 4 + 1);
+    EXPECT_EQ(renumbering.size(), nbrTetrahedron);
+    if (renumbering.size() != size_t(nbrTetrahedron))
+        return false;
+
+    for (size_t t = 0; t < renumbering.size(); t++)
+    {
+        const bool removed = (t == 0 || t == 3 || t == 10 || t == 40);
+        EXPECT_EQ(renumbering[t] == sofa::core::topology::Topology::InvalidID, removed);
+        if (!removed && renumbering[t] < topoCon->getNumberOfTetrahedra())
+            EXPECT_EQ(getCorners(topoCon->getTetrahedron(renumbering[t])), before[t]);
+    }
+    EXPECT_EQ(getCorners(topoCon->getTetrahedron(nbrTetrahedron - 4)), before[5]);
+
+    delete scene;
+    return true;
+}
+
+
 bool TetrahedronSetTopology_test::checkTopology()
 {
     fake_TopologyScene* scene = new fake_TopologyScene("mesh/cube_low_res.msh", sofa::core::topology::TopologyObjectType::TETRAHEDRON);
@@ -468,6 +586,16 @@ TEST_F(TetrahedronSetTopology_test, testVertexBuffers)
     ASSERT_TRUE(testVertexBuffers());
 }
 
+TEST_F(TetrahedronSetTopology_test, testCompressedVertexBuffers)
+{
+    ASSERT_TRUE(testCompressedVertexBuffers());
+}
+
+TEST_F(TetrahedronSetTopology_test, testTetrahedraChangeSet)
+{
+    ASSERT_TRUE(testTetrahedraChangeSet());
+}
+
 TEST_F(TetrahedronSetTopology_test, checkTopology)
 {
     ASSERT_TRUE(checkTopology());
@@ -345,17 +345,11 @@ void TetrahedronSetTopologyContainer::createTetrahedraAroundVertexArray()
     if (getNbPoints() == 0) // in case only Data have been copied and not going thourgh AddTriangle methods.
         this->setNbPoints(d_initPoints.getValue().size());
 
-    m_tetrahedraAroundVertex.resize( getNbPoints() );
     helper::ReadAccessor< Data< sofa::helper::vector<Tetrahedron> > > m_tetrahedron = d_tetrahedron;
 
-    for (size_t i = 0; i < getNumberOfTetrahedra(); ++i)
-    {
-        // adding edge i in the edge shell of both points
-        for (PointID j=0; j<4; ++j)
-        {
-            m_tetrahedraAroundVertex[ m_tetrahedron[i][j]  ].push_back( (TetrahedronID)i );
-        }
-    }
+    // counting sort of the tetrahedra by vertex, then one allocation per vertex at its final size
+    m_compressedTetrahedraAroundVertex.build(getNbPoints(), m_tetrahedron.ref(), d_tetrahedron.getCounter());
+    m_compressedTetrahedraAroundVertex.copyTo(m_tetrahedraAroundVertex);
 }
 
 void TetrahedronSetTopologyContainer::createTetrahedraAroundEdgeArray ()
@@ -502,6 +496,14 @@ const sofa::helper::vector< TetrahedronSetTopologyContainer::TetrahedraAroundVer
     return m_tetrahedraAroundVertex;
 }
 
+const TetrahedronSetTopologyContainer::CompressedTetrahedraAroundVertex& TetrahedronSetTopologyContainer::getCompressedTetrahedraAroundVertexArray()
+{
+    helper::ReadAccessor< Data< sofa::helper::vector<Tetrahedron> > > elements = d_tetrahedron;
+    if (!m_compressedTetrahedraAroundVertex.isUpToDate(d_tetrahedron.getCounter(), getNbPoints(), elements.size()))
+        m_compressedTetrahedraAroundVertex.build(getNbPoints(), elements.ref(), d_tetrahedron.getCounter());
+    return m_compressedTetrahedraAroundVertex;
+}
+
 const sofa::helper::vector< TetrahedronSetTopologyContainer::TetrahedraAroundEdge > &TetrahedronSetTopologyContainer::getTetrahedraAroundEdgeArray()
 {
     return m_tetrahedraAroundEdge;
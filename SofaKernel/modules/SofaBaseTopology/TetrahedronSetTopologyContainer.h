@@ -56,6 +56,7 @@ public:
     typedef core::topology::BaseMeshTopology::Tetra                       Tetra;
     typedef core::topology::BaseMeshTopology::SeqTetrahedra               SeqTetrahedra;
     typedef core::topology::BaseMeshTopology::TetrahedraAroundVertex      TetrahedraAroundVertex;
+    typedef CompressedRowArray<TetrahedronID>                             CompressedTetrahedraAroundVertex;
     typedef core::topology::BaseMeshTopology::TetrahedraAroundEdge        TetrahedraAroundEdge;
     typedef core::topology::BaseMeshTopology::TetrahedraAroundTriangle    TetrahedraAroundTriangle;
     typedef core::topology::BaseMeshTopology::EdgesInTetrahedron          EdgesInTetrahedron;
@@ -271,6 +272,11 @@ public:
     /** \brief Returns the TetrahedraAroundVertex array (i.e. provide the tetrahedron indices adjacent to each vertex). */
     const sofa::helper::vector< TetrahedraAroundVertex > &getTetrahedraAroundVertexArray() ;
 
+    /** \brief Returns the TetrahedraAroundVertex adjacency in compressed rows (i.e. one flat array of indices
+     * and the offset of each vertex in it). It is rebuilt at once when the tetrahedra have changed.
+     */
+    const CompressedTetrahedraAroundVertex& getCompressedTetrahedraAroundVertexArray();
+
 
     /** \brief Returns the TetrahedraAroundEdge array (i.e. provide the tetrahedron indices adjacent to each edge). */
     const sofa::helper::vector< TetrahedraAroundEdge > &getTetrahedraAroundEdgeArray() ;
@@ -484,6 +490,9 @@ protected:
     /// for each vertex provides the set of tetrahedra adjacent to that vertex.
     sofa::helper::vector< TetrahedraAroundVertex > m_tetrahedraAroundVertex;
 
+    /// compressed rows of the TetrahedraAroundVertex adjacency, see getCompressedTetrahedraAroundVertexArray()
+    CompressedTetrahedraAroundVertex m_compressedTetrahedraAroundVertex;
+
     /// for each edge provides the set of tetrahedra adjacent to that edge.
     sofa::helper::vector< TetrahedraAroundEdge > m_tetrahedraAroundEdge;
 
@@ -637,6 +637,63 @@ void TetrahedronSetTopologyModifier::removeItems(const sofa::helper::vector< Tet
     removeTetrahedra(items);
 }
 
+void TetrahedronSetTopologyModifier::beginTetrahedraChangeSet()
+{
+    if (m_tetrahedraChangeSet.isOpen())
+        msg_warning() << "A change set of tetrahedra is already open, its queued changes are discarded.";
+    m_tetrahedraChangeSet.open(m_container->getNumberOfTetrahedra());
+}
+
+void TetrahedronSetTopologyModifier::queueTetrahedraRemoval(const sofa::helper::vector< TetrahedronID >& tetrahedraIds)
+{
+    if (!m_tetrahedraChangeSet.isOpen())
+    {
+        msg_error() << "queueTetrahedraRemoval: no change set of tetrahedra is open, call beginTetrahedraChangeSet first.";
+        return;
+    }
+    const size_t nbIgnored = m_tetrahedraChangeSet.queueRemoval(tetrahedraIds);
+    dmsg_warning_when(nbIgnored > 0) << nbIgnored << " tetrahedra are out of bound and won't be removed.";
+}
+
+void TetrahedronSetTopologyModifier::queueTetrahedraAddition(const sofa::helper::vector< Tetrahedron >& tetrahedra)
+{
+    if (!m_tetrahedraChangeSet.isOpen())
+    {
+        msg_error() << "queueTetrahedraAddition: no change set of tetrahedra is open, call beginTetrahedraChangeSet first.";
+        return;
+    }
+    m_tetrahedraChangeSet.queueAddition(tetrahedra);
+}
+
+const sofa::helper::vector< TetrahedronSetTopologyModifier::TetrahedronID >& TetrahedronSetTopologyModifier::commitTetrahedraChangeSet()
+{
+    if (!m_tetrahedraChangeSet.isOpen())
+    {
+        msg_error() << "commitTetrahedraChangeSet: no change set of tetrahedra is open.";
+        return m_tetrahedraChangeSet.getRenumbering();
+    }
+
+    if (m_tetrahedraChangeSet.getNbElements() != m_container->getNumberOfTetrahedra())
+    {
+        msg_error() << "commitTetrahedraChangeSet: the tetrahedra were modified outside of the change set, its queued changes are discarded.";
+        m_tetrahedraChangeSet.close();
+        return m_tetrahedraChangeSet.getRenumbering();
+    }
+
+    sofa::helper::AdvancedTimer::stepBegin("commitTetrahedraChangeSet");
+
+    const sofa::helper::vector< TetrahedronID > removed = m_tetrahedraChangeSet.getRemovals();
+    m_tetrahedraChangeSet.computeRenumbering(removed);
+    if (!removed.empty())
+        removeTetrahedra(removed);
+    if (!m_tetrahedraChangeSet.getAdditions().empty())
+        addTetrahedra(m_tetrahedraChangeSet.getAdditions());
+    m_tetrahedraChangeSet.close();
+
+    sofa::helper::AdvancedTimer::stepEnd("commitTetrahedraChangeSet");
+    return m_tetrahedraChangeSet.getRenumbering();
+}
+
 void TetrahedronSetTopologyModifier::renumberPoints( const sofa::helper::vector<PointID> &index,
         const sofa::helper::vector<PointID> &inv_index)
 {
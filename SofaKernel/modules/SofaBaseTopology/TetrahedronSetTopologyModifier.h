@@ -205,6 +205,21 @@ public:
     */
     void removeItems(const sofa::helper::vector<TetrahedronID> &items) override;
 
+    /// Change set of tetrahedra, see TopologyChangeSet: the queued removals (given with the indices
+    /// at the opening of the change set) and additions are applied at once by the commit.
+    /// @{
+    void beginTetrahedraChangeSet();
+    bool isTetrahedraChangeSetOpen() const { return m_tetrahedraChangeSet.isOpen(); }
+    void queueTetrahedraRemoval(const sofa::helper::vector< TetrahedronID >& tetrahedraIds);
+    void queueTetrahedraAddition(const sofa::helper::vector< Tetrahedron >& tetrahedra);
+
+    /** \brief Remove the queued tetrahedra, then add the queued ones.
+    * @return for each tetrahedron at the opening of the change set, its index after the commit (InvalidID if removed).
+    * The added tetrahedra follow the remaining ones.
+    */
+    const sofa::helper::vector< TetrahedronID >& commitTetrahedraChangeSet();
+    /// @}
+
     /** \brief  Removes all tetrahedra in the ball of center "ind_ta" and of radius dist(ind_ta, ind_tb)
     */
     void RemoveTetraBall(TetrahedronID ind_ta, TetrahedronID ind_tb);
@@ -217,6 +232,7 @@ public:
 
 private:
     TetrahedronSetTopologyContainer* 	m_container;
+    TopologyChangeSet<TetrahedronID, Tetrahedron> m_tetrahedraChangeSet;
 };
 
 } // namespace topology
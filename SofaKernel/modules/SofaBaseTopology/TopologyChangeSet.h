@@ -0,0 +1,141 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#ifndef SOFA_COMPONENT_TOPOLOGY_TOPOLOGYCHANGESET_H
+#define SOFA_COMPONENT_TOPOLOGY_TOPOLOGYCHANGESET_H
+#include "config.h"
+
+#include <sofa/core/topology/Topology.h>
+#include <sofa/helper/vector.h>
+
+#include <algorithm>
+
+namespace sofa
+{
+
+namespace component
+{
+
+namespace topology
+{
+
+/** Change set of a topology modifier: while it is open, the removals and additions of
+ * elements are only queued, and the modifier applies them at once when it is committed
+ * (one removal event and one propagation, whatever the number of queued operations).
+ *
+ * The queued removals refer to the elements as they were when the change set was opened,
+ * so the caller does not have to follow the renumbering of the elements between two
+ * operations. After the commit, getRenumbering() gives the new index of each of them.
+ */
+template<class TElementID, class TElement>
+class TopologyChangeSet
+{
+public:
+    typedef TElementID ElementID;
+    typedef TElement Element;
+
+    TopologyChangeSet() : m_open(false), m_nbElements(0) {}
+
+    bool isOpen() const { return m_open; }
+
+    /// Number of elements when the change set was opened
+    std::size_t getNbElements() const { return m_nbElements; }
+
+    void open(std::size_t nbElements)
+    {
+        m_open = true;
+        m_nbElements = nbElements;
+        m_removed.clear();
+        m_added.clear();
+    }
+
+    void close()
+    {
+        m_open = false;
+        m_removed.clear();
+        m_added.clear();
+    }
+
+    /// Queue the removal of elements, returns the number of indices out of bounds (ignored)
+    std::size_t queueRemoval(const sofa::helper::vector<ElementID>& ids)
+    {
+        std::size_t nbIgnored = 0;
+        for (const ElementID id : ids)
+        {
+            if (std::size_t(id) < m_nbElements) m_removed.push_back(id);
+            else ++nbIgnored;
+        }
+        return nbIgnored;
+    }
+
+    void queueAddition(const sofa::helper::vector<Element>& elements)
+    {
+        m_added.insert(m_added.end(), elements.begin(), elements.end());
+    }
+
+    /// The queued removals, sorted and without repetition
+    sofa::helper::vector<ElementID> getRemovals() const
+    {
+        sofa::helper::vector<ElementID> removed = m_removed;
+        std::sort(removed.begin(), removed.end());
+        removed.erase(std::unique(removed.begin(), removed.end()), removed.end());
+        return removed;
+    }
+
+    const sofa::helper::vector<Element>& getAdditions() const { return m_added; }
+
+    /** Compute the new index of each element after the removal of the given (sorted) ones,
+     * done as the modifiers do it: in decreasing order, each removed element is replaced by
+     * the last one. The removed elements get InvalidID.
+     */
+    void computeRenumbering(const sofa::helper::vector<ElementID>& sortedRemovals)
+    {
+        sofa::helper::vector<ElementID> elementAt(m_nbElements);
+        for (std::size_t i = 0; i < m_nbElements; ++i)
+            elementAt[i] = ElementID(i);
+
+        std::size_t last = m_nbElements;
+        for (auto it = sortedRemovals.rbegin(); it != sortedRemovals.rend(); ++it)
+            elementAt[*it] = elementAt[--last];
+
+        m_renumbering.assign(m_nbElements, ElementID(sofa::core::topology::Topology::InvalidID));
+        for (std::size_t i = 0; i < last; ++i)
+            m_renumbering[elementAt[i]] = ElementID(i);
+    }
+
+    /// For each element at the opening of the last committed change set, its index after the commit (InvalidID if removed)
+    const sofa::helper::vector<ElementID>& getRenumbering() const { return m_renumbering; }
+
+protected:
+    bool m_open;
+    std::size_t m_nbElements;
+    sofa::helper::vector<ElementID> m_removed;
+    sofa::helper::vector<Element> m_added;
+    sofa::helper::vector<ElementID> m_renumbering;
+};
+
+} // namespace topology
+
+} // namespace component
+
+} // namespace sofa
+
+#endif // SOFA_COMPONENT_TOPOLOGY_TOPOLOGYCHANGESET_H
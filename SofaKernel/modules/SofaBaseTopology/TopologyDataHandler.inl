@@ -109,10 +109,17 @@ void TopologyDataHandler <TopologyElementType, VecT>::remove( const sofa::helper
 	if (data.size()>0) {
 		unsigned int last = (unsigned)data.size() -1;
 
+		// the same swaps as swap(), but within this single edit of the data: the whole
+		// removal is notified once instead of once per removed element
 		for (unsigned int i = 0; i < index.size(); ++i)
 		{
 			this->applyDestroyFunction( index[i], data[index[i]] );
-			this->swap( index[i], last );
+			if (index[i] != last)
+			{
+				value_type tmp = data[index[i]];
+				data[index[i]] = data[last];
+				data[last] = tmp;
+			}
 			--last;
 		}
 
@@ -24,6 +24,8 @@
 
 #include <SofaBaseTopology/TopologySubsetDataHandler.h>
 
+#include <unordered_map>
+
 namespace sofa
 {
 
@@ -100,8 +102,67 @@ void TopologySubsetDataHandler <TopologyElementType, VecT>::remove( const sofa::
     unsigned int it1;
     unsigned int it2;
 
+    // For large removals, the position of each element in the subset is kept in a map, so that
+    // each removal is done in constant time instead of two searches in the subset.
+    std::unordered_map<unsigned int, unsigned int> position;
+    auto buildPositions = [&]() -> bool
+    {
+        position.clear();
+        position.reserve(data.size());
+        for (unsigned int p = 0; p < data.size(); ++p)
+            if (!position.emplace((unsigned int)data[p], p).second)
+                return false; // repeated element: the searches give the first occurrence
+        return true;
+    };
+    auto find = [&](unsigned int elem) -> unsigned int
+    {
+        auto it = position.find(elem);
+        return (it == position.end()) ? (unsigned int)data.size() : it->second;
+    };
+    auto write = [&](unsigned int p, unsigned int elem)
+    {
+        auto it = position.find((unsigned int)data[p]);
+        if (it != position.end() && it->second == p)
+            position.erase(it);
+        data[p] = elem;
+        position[elem] = p;
+    };
+    bool usePositions = index.size() > 8 && buildPositions();
+
     for (unsigned int i = 0; i < index.size(); ++i)
     {
+        if (usePositions)
+        {
+            it1 = find(index[i]);
+            it2 = find(this->lastElementIndex);
+            if (it1<data.size())
+            {
+                if (it2<data.size())
+                    write(it2, index[i]);
+                write(it1, (unsigned int)data[data.size()-1]);
+                size_t size_before = data.size();
+
+                // Call destroy function implemented in specific component
+                this->applyDestroyFunction(index[i], data[data.size()-1]);
+
+                if (size_before == data.size())
+                {
+                    auto it = position.find((unsigned int)data[data.size()-1]);
+                    if (it != position.end() && it->second == data.size()-1)
+                        position.erase(it);
+                    data.resize(data.size() - 1);
+                }
+                else
+                    usePositions = buildPositions();
+            }
+            else if (it2<data.size())
+            {
+                write(it2, index[i]);
+            }
+            --this->lastElementIndex;
+            continue;
+        }
+
         it1=0;
         while(it1<data.size())
         {
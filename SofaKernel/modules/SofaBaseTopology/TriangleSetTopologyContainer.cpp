@@ -125,13 +125,9 @@ void TriangleSetTopologyContainer::createTrianglesAroundVertexArray()
     if (nbPoints == 0) // in case only Data have been copied and not going thourgh AddTriangle methods.
         this->setNbPoints(d_initPoints.getValue().size());
 
-    m_trianglesAroundVertex.resize(getNbPoints());
-    for (size_t i = 0; i < m_triangle.size(); ++i)
-    {
-        // adding edge i in the edge shell of both points
-        for (unsigned int j=0; j<3; ++j)
-            m_trianglesAroundVertex[ m_triangle[i][j]  ].push_back( (TriangleID)i );
-    }
+    // counting sort of the triangles by vertex, then one allocation per vertex at its final size
+    m_compressedTrianglesAroundVertex.build(getNbPoints(), m_triangle.ref(), d_triangle.getCounter());
+    m_compressedTrianglesAroundVertex.copyTo(m_trianglesAroundVertex);
 }
 
 void TriangleSetTopologyContainer::createTrianglesAroundEdgeArray ()
@@ -505,6 +501,14 @@ const sofa::helper::vector< TriangleSetTopologyContainer::TrianglesAroundVertex
     return m_trianglesAroundVertex;
 }
 
+const TriangleSetTopologyContainer::CompressedTrianglesAroundVertex& TriangleSetTopologyContainer::getCompressedTrianglesAroundVertexArray()
+{
+    helper::ReadAccessor< Data< sofa::helper::vector<Triangle> > > elements = d_triangle;
+    if (!m_compressedTrianglesAroundVertex.isUpToDate(d_triangle.getCounter(), getNbPoints(), elements.size()))
+        m_compressedTrianglesAroundVertex.build(getNbPoints(), elements.ref(), d_triangle.getCounter());
+    return m_compressedTrianglesAroundVertex;
+}
+
 const sofa::helper::vector< TriangleSetTopologyContainer::TrianglesAroundEdge > &TriangleSetTopologyContainer::getTrianglesAroundEdgeArray()
 {
     return m_trianglesAroundEdge;
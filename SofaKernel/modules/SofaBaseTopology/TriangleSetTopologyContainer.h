@@ -54,6 +54,7 @@ public:
     typedef core::topology::BaseMeshTopology::SeqTriangles                 SeqTriangles;
     typedef core::topology::BaseMeshTopology::EdgesInTriangle              EdgesInTriangle;
     typedef core::topology::BaseMeshTopology::TrianglesAroundVertex        TrianglesAroundVertex;
+    typedef CompressedRowArray<TriangleID>                                 CompressedTrianglesAroundVertex;
     typedef core::topology::BaseMeshTopology::TrianglesAroundEdge          TrianglesAroundEdge;
     typedef sofa::helper::vector<TriangleID>                               VecTriangleID;
 
@@ -188,6 +189,11 @@ public:
     /** \brief Returns the TrianglesAroundVertex array (i.e. provide the triangles indices adjacent to each vertex). */
     const sofa::helper::vector< TrianglesAroundVertex > &getTrianglesAroundVertexArray();
 
+    /** \brief Returns the TrianglesAroundVertex adjacency in compressed rows (i.e. one flat array of indices
+     * and the offset of each vertex in it). It is rebuilt at once when the triangles have changed.
+     */
+    const CompressedTrianglesAroundVertex& getCompressedTrianglesAroundVertexArray();
+
 
     /** \brief Returns the TrianglesAroundEdge array (i.e. provide the triangles indices adjacent to each edge). */
     const sofa::helper::vector< TrianglesAroundEdge > &getTrianglesAroundEdgeArray() ;
@@ -346,6 +352,9 @@ protected:
     /// for each vertex provides the set of triangles adjacent to that vertex.
     sofa::helper::vector< TrianglesAroundVertex > m_trianglesAroundVertex;
 
+    /// compressed rows of the TrianglesAroundVertex adjacency, see getCompressedTrianglesAroundVertexArray()
+    CompressedTrianglesAroundVertex m_compressedTrianglesAroundVertex;
+
     /// for each edge provides the set of triangles adjacent to that edge.
     sofa::helper::vector< TrianglesAroundEdge > m_trianglesAroundEdge;
 
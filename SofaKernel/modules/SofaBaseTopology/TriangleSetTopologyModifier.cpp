@@ -351,6 +351,69 @@ void TriangleSetTopologyModifier::removeTriangles(const sofa::helper::vector<Tri
 }
 
 
+void TriangleSetTopologyModifier::beginTrianglesChangeSet(const bool removeIsolatedEdges, const bool removeIsolatedPoints)
+{
+    if (m_trianglesChangeSet.isOpen())
+        msg_warning() << "A change set of triangles is already open, its queued changes are discarded.";
+    m_trianglesChangeSet.open(m_container->getNumberOfTriangles());
+    m_changeSetRemovesIsolatedEdges = removeIsolatedEdges;
+    m_changeSetRemovesIsolatedPoints = removeIsolatedPoints;
+}
+
+void TriangleSetTopologyModifier::queueTrianglesRemoval(const sofa::helper::vector< TriangleID >& triangleIds)
+{
+    if (!m_trianglesChangeSet.isOpen())
+    {
+        msg_error() << "queueTrianglesRemoval: no change set of triangles is open, call beginTrianglesChangeSet first.";
+        return;
+    }
+    const size_t nbIgnored = m_trianglesChangeSet.queueRemoval(triangleIds);
+    dmsg_warning_when(nbIgnored > 0) << nbIgnored << " triangles are out of bound and won't be removed.";
+}
+
+void TriangleSetTopologyModifier::queueTrianglesAddition(const sofa::helper::vector< Triangle >& triangles)
+{
+    if (!m_trianglesChangeSet.isOpen())
+    {
+        msg_error() << "queueTrianglesAddition: no change set of triangles is open, call beginTrianglesChangeSet first.";
+        return;
+    }
+    m_trianglesChangeSet.queueAddition(triangles);
+}
+
+const sofa::helper::vector< TriangleSetTopologyModifier::TriangleID >& TriangleSetTopologyModifier::commitTrianglesChangeSet()
+{
+    if (!m_trianglesChangeSet.isOpen())
+    {
+        msg_error() << "commitTrianglesChangeSet: no change set of triangles is open.";
+        return m_trianglesChangeSet.getRenumbering();
+    }
+
+    if (m_trianglesChangeSet.getNbElements() != m_container->getNumberOfTriangles())
+    {
+        msg_error() << "commitTrianglesChangeSet: the triangles were modified outside of the change set, its queued changes are discarded.";
+        m_trianglesChangeSet.close();
+        return m_trianglesChangeSet.getRenumbering();
+    }
+
+    sofa::helper::AdvancedTimer::stepBegin("commitTrianglesChangeSet");
+
+    const sofa::helper::vector< TriangleID > removed = m_trianglesChangeSet.getRemovals();
+    m_trianglesChangeSet.computeRenumbering(removed);
+    if (!removed.empty())
+    {
+        removeTriangles(removed, m_changeSetRemovesIsolatedEdges, m_changeSetRemovesIsolatedPoints);
+        if (m_container->getNumberOfTriangles() + removed.size() != m_trianglesChangeSet.getNbElements()) // preconditions not fulfilled
+            m_trianglesChangeSet.computeRenumbering(sofa::helper::vector< TriangleID >());
+    }
+    if (!m_trianglesChangeSet.getAdditions().empty())
+        addTriangles(m_trianglesChangeSet.getAdditions());
+    m_trianglesChangeSet.close();
+
+    sofa::helper::AdvancedTimer::stepEnd("commitTrianglesChangeSet");
+    return m_trianglesChangeSet.getRenumbering();
+}
+
 void TriangleSetTopologyModifier::removeTrianglesWarning(sofa::helper::vector<TriangleID> &triangles)
 {
     m_container->setTriangleTopologyToDirty();
@@ -24,6 +24,7 @@
 #include "config.h"
 
 #include <SofaBaseTopology/EdgeSetTopologyModifier.h>
+#include <SofaBaseTopology/TopologyChangeSet.h>
 
 namespace sofa
 {
@@ -51,6 +52,8 @@ public:
 protected:
     TriangleSetTopologyModifier()
         : list_Out(initData(&list_Out,"list_Out","triangles with at least one null values."))
+        , m_changeSetRemovesIsolatedEdges(true)
+        , m_changeSetRemovesIsolatedPoints(true)
     {}
 
     ~TriangleSetTopologyModifier() override {}
@@ -159,6 +162,21 @@ public:
             const bool removeIsolatedEdges,
             const bool removeIsolatedPoints);
 
+    /// Change set of triangles, see TopologyChangeSet: the queued removals (given with the indices
+    /// at the opening of the change set) and additions are applied at once by the commit.
+    /// @{
+    void beginTrianglesChangeSet(const bool removeIsolatedEdges = true, const bool removeIsolatedPoints = true);
+    bool isTrianglesChangeSetOpen() const { return m_trianglesChangeSet.isOpen(); }
+    void queueTrianglesRemoval(const sofa::helper::vector< TriangleID >& triangleIds);
+    void queueTrianglesAddition(const sofa::helper::vector< Triangle >& triangles);
+
+    /** \brief Remove the queued triangles, then add the queued ones.
+     * @return for each triangle at the opening of the change set, its index after the commit (InvalidID if removed).
+     * The added triangles follow the remaining ones.
+     */
+    const sofa::helper::vector< TriangleID >& commitTrianglesChangeSet();
+    /// @}
+
 
     /** \brief Sends a message to warn that some triangles are about to be deleted.
      *
@@ -288,6 +306,9 @@ protected:
     Data<sofa::helper::vector <TriangleID> > list_Out; ///< triangles with at least one null values.
 private:
     TriangleSetTopologyContainer*	m_container;
+    TopologyChangeSet<TriangleID, Triangle> m_trianglesChangeSet;
+    bool m_changeSetRemovesIsolatedEdges;
+    bool m_changeSetRemovesIsolatedPoints;
 };
 
 } // namespace topology
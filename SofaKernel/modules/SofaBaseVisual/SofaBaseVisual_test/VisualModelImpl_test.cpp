@@ -120,4 +120,101 @@ TEST( VisualModelImpl_test , checkThatMembersAreCorrectlyConstructed )
     ASSERT_EQ(1u, visualModel.xforms.size());
 }
 
+/// Grid of size x size vertices in the plane z=0, with triangles on one half and quads on the other
+void createGrid(StubVisualModelImpl& visualModel, unsigned int size)
+{
+    typedef component::visualmodel::VisualModelImpl VisualModelImpl;
+    VisualModelImpl::VecCoord positions;
+    for (unsigned int j = 0; j < size; ++j)
+        for (unsigned int i = 0; i < size; ++i)
+            positions.push_back(VisualModelImpl::Coord(i, j, 0.1 * ((i * j) % 3)));
+
+    VisualModelImpl::VecTriangle triangles;
+    VisualModelImpl::VecQuad quads;
+    for (unsigned int j = 0; j < size - 1; ++j)
+        for (unsigned int i = 0; i < size - 1; ++i)
+        {
+            const unsigned int p = j * size + i;
+            if (j < size / 2)
+            {
+                triangles.push_back(VisualModelImpl::Triangle(p, p + 1, p + size));
+                triangles.push_back(VisualModelImpl::Triangle(p + 1, p + size + 1, p + size));
+            }
+            else
+                quads.push_back(VisualModelImpl::Quad(p, p + 1, p + size + 1, p + size));
+        }
+
+    visualModel.setVertices(&positions);
+    visualModel.setTriangles(&triangles);
+    visualModel.setQuads(&quads);
+    visualModel.m_updateTangents.setValue(false);
+}
+
+void moveVertex(StubVisualModelImpl& visualModel, unsigned int index, const component::visualmodel::VisualModelImpl::Coord& dx)
+{
+    helper::WriteAccessor< Data<component::visualmodel::VisualModelImpl::VecCoord> > x = *visualModel.write(core::VecCoordId::position());
+    x[index] += dx;
+}
+
+// Normals computed incrementally and in parallel must be identical to the ones of the serial computation
+TEST( VisualModelImpl_test , checkIncrementalNormals )
+{
+    typedef component::visualmodel::VisualModelImpl VisualModelImpl;
+    const unsigned int size = 100;
+
+    StubVisualModelImpl reference;
+    StubVisualModelImpl visualModel;
+    createGrid(reference, size);
+    createGrid(visualModel, size);
+    visualModel.d_parallel.setValue(true);
+    visualModel.d_incrementalUpdate.setValue(true);
+
+    reference.modified = visualModel.modified = true;
+    reference.updateVisual();
+    visualModel.updateVisual();
+    ASSERT_EQ(size * size, visualModel.getVnormals().size());
+    for (unsigned int i = 0; i < size * size; ++i)
+        ASSERT_EQ(reference.getVnormals()[i], visualModel.getVnormals()[i]);
+
+    VisualModelImpl::VecVertexRange ranges;
+    visualModel.getDirtyPositionRanges(ranges);
+    ASSERT_EQ(1u, ranges.size());
+    EXPECT_EQ(VisualModelImpl::VertexRange(0, size * size), ranges[0]);
+    visualModel.clearDirtyVertices();
+
+    // move a vertex in the triangles and one in the quads
+    for (StubVisualModelImpl* m : { &reference, &visualModel })
+    {
+        moveVertex(*m, 5 * size + 5, VisualModelImpl::Coord(0.1, 0.2, 0.3));
+        moveVertex(*m, 80 * size + 40, VisualModelImpl::Coord(-0.3, 0.0, 0.5));
+        m->updateVisual();
+    }
+    for (unsigned int i = 0; i < size * size; ++i)
+        ASSERT_EQ(reference.getVnormals()[i], visualModel.getVnormals()[i]);
+
+    visualModel.getDirtyPositionRanges(ranges);
+    ASSERT_EQ(2u, ranges.size());
+    EXPECT_EQ(VisualModelImpl::VertexRange(5 * size + 5, 5 * size + 6), ranges[0]);
+    EXPECT_EQ(VisualModelImpl::VertexRange(80 * size + 40, 80 * size + 41), ranges[1]);
+
+    // normals of the neighbours of the moved vertices
+    visualModel.getDirtyNormalRanges(ranges);
+    ASSERT_FALSE(ranges.empty());
+    std::size_t nbDirtyNormals = 0;
+    for (const VisualModelImpl::VertexRange& r : ranges)
+        nbDirtyNormals += r.second - r.first;
+    EXPECT_LT(nbDirtyNormals, 200u);
+    EXPECT_LE(ranges.front().first, 4 * size + 5);
+    EXPECT_GE(ranges.back().second, 81 * size + 41);
+
+    // nothing moved
+    visualModel.clearDirtyVertices();
+    visualModel.modified = true;
+    visualModel.updateVisual();
+    visualModel.getDirtyPositionRanges(ranges);
+    EXPECT_TRUE(ranges.empty());
+    visualModel.getDirtyNormalRanges(ranges);
+    EXPECT_TRUE(ranges.empty());
+}
+
 } //sofa
@@ -42,6 +42,8 @@
 #include <sofa/helper/io/MeshOBJ.h>
 #include <sofa/helper/rmath.h>
 #include <sofa/helper/accessor.h>
+#include <sofa/simulation/ParallelForRange.h>
+#include <algorithm>
 #include <sstream>
 #include <map>
 #include <memory>
@@ -193,6 +195,8 @@ VisualModelImpl::VisualModelImpl() //const std::string &name, std::string filena
     , m_handleDynamicTopology (initData   (&m_handleDynamicTopology, true, "handleDynamicTopology", "True if topological changes should be handled"))
     , m_fixMergedUVSeams (initData   (&m_fixMergedUVSeams, true, "fixMergedUVSeams", "True if UV seams should be handled even when duplicate UVs are merged"))
     , m_keepLines (initData   (&m_keepLines, false, "keepLines", "keep and draw lines (false by default)"))
+    , d_parallel (initData   (&d_parallel, false, "parallel", "Compute the normals in parallel, with the TaskScheduler"))
+    , d_incrementalUpdate (initData   (&d_incrementalUpdate, false, "incrementalUpdate", "Only recompute the normals and the buffers of the vertices moved since the last update (the positions are compared to the previous ones)"))
     , m_vertices2       (initData   (&m_vertices2, "vertices", "vertices of the model (only if vertices have multiple normals/texcoords, otherwise positions are used)"))
     , m_vtexcoords      (initData   (&m_vtexcoords, "texcoords", "coordinates of the texture"))
     , m_vtangents       (initData   (&m_vtangents, "tangents", "tangents for normal mapping"))
@@ -916,6 +920,12 @@ void VisualModelImpl::computeNormals()
     //const VecCoord& vertices = m_vertices2.getValue();
     if (vertices.empty() || (!m_updateNormals.getValue() && (m_vnormals.getValue()).size() == (vertices).size())) return;
 
+    if (d_parallel.getValue() || d_incrementalUpdate.getValue())
+    {
+        computeNormalsFromAdjacency();
+        return;
+    }
+
     const VecTriangle& triangles = m_triangles.getValue();
     const VecQuad& quads = m_quads.getValue();
     const helper::vector<int> &vertNormIdx = m_vertNormIdx.getValue();
@@ -1022,6 +1032,289 @@ void VisualModelImpl::computeNormals()
     }
 }
 
+namespace
+{
+
+/// Call func(i) for i in [0,n), with the TaskScheduler if parallel is set
+template<class IndexFunction>
+void forEachIndex(std::size_t n, bool parallel, const IndexFunction& func)
+{
+    const std::size_t minGrainSize = 4096;
+    simulation::TaskScheduler* scheduler = parallel ? simulation::TaskScheduler::getInstance() : nullptr;
+    simulation::parallelForRange(scheduler, 0, n, simulation::getParallelGrainSize(scheduler, n, minGrainSize), [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            func(i);
+    });
+}
+
+/// Exact comparison, Vec::operator== uses a tolerance
+bool samePosition(const VisualModelImpl::Coord& a, const VisualModelImpl::Coord& b)
+{
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+}
+
+} // namespace
+
+bool VisualModelImpl::updateNormalAdjacency()
+{
+    const VecCoord& vertices = getVertices();
+    const VecTriangle& triangles = m_triangles.getValue();
+    const VecQuad& quads = m_quads.getValue();
+    const helper::vector<int>& vertNormIdx = m_vertNormIdx.getValue();
+
+    if (m_adjacencyTrianglesCounter == m_triangles.getCounter() && m_adjacencyQuadsCounter == m_quads.getCounter()
+            && m_adjacencyNormIdxCounter == m_vertNormIdx.getCounter() && m_adjacencyNbVertices == vertices.size()
+            && !m_normalCornersBegin.empty())
+        return false;
+
+    const std::size_t nbVertices = vertices.size();
+    const std::size_t nbTriangles = triangles.size();
+    std::size_t nbNormals = nbVertices;
+    if (!vertNormIdx.empty())
+    {
+        nbNormals = 0;
+        for (int n : vertNormIdx)
+            nbNormals = std::max(nbNormals, std::size_t(n + 1));
+    }
+    auto normalIndex = [&](unsigned int v) -> std::size_t { return vertNormIdx.empty() ? v : vertNormIdx[v]; };
+
+    // corners around each normal, triangles first then quads, as in the serial computation
+    m_normalCornersBegin.assign(nbNormals + 1, 0);
+    m_vertexFacesBegin.assign(nbVertices + 1, 0);
+    for (const Triangle& t : triangles)
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            ++m_normalCornersBegin[normalIndex(t[j]) + 1];
+            ++m_vertexFacesBegin[t[j] + 1];
+        }
+    for (const Quad& q : quads)
+        for (unsigned int j = 0; j < 4; ++j)
+        {
+            ++m_normalCornersBegin[normalIndex(q[j]) + 1];
+            ++m_vertexFacesBegin[q[j] + 1];
+        }
+    for (std::size_t n = 0; n < nbNormals; ++n)
+        m_normalCornersBegin[n + 1] += m_normalCornersBegin[n];
+    for (std::size_t v = 0; v < nbVertices; ++v)
+        m_vertexFacesBegin[v + 1] += m_vertexFacesBegin[v];
+
+    m_normalCorners.resize(m_normalCornersBegin[nbNormals]);
+    m_vertexFaces.resize(m_vertexFacesBegin[nbVertices]);
+    helper::vector<unsigned int> cornerFill(m_normalCornersBegin.begin(), m_normalCornersBegin.end() - 1);
+    helper::vector<unsigned int> faceFill(m_vertexFacesBegin.begin(), m_vertexFacesBegin.end() - 1);
+    for (std::size_t i = 0; i < nbTriangles; ++i)
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            m_normalCorners[cornerFill[normalIndex(triangles[i][j])]++] = (unsigned int)i;
+            m_vertexFaces[faceFill[triangles[i][j]]++] = (unsigned int)i;
+        }
+    for (std::size_t i = 0; i < quads.size(); ++i)
+        for (unsigned int j = 0; j < 4; ++j)
+        {
+            m_normalCorners[cornerFill[normalIndex(quads[i][j])]++] = (unsigned int)(nbTriangles + 4 * i + j);
+            m_vertexFaces[faceFill[quads[i][j]]++] = (unsigned int)(nbTriangles + i);
+        }
+
+    m_cornerNormals.resize(nbTriangles + 4 * quads.size());
+    m_normalsBuffer.resize(vertNormIdx.empty() ? 0 : nbNormals);
+
+    m_adjacencyTrianglesCounter = m_triangles.getCounter();
+    m_adjacencyQuadsCounter = m_quads.getCounter();
+    m_adjacencyNormIdxCounter = m_vertNormIdx.getCounter();
+    m_adjacencyNbVertices = nbVertices;
+    return true;
+}
+
+void VisualModelImpl::computeNormalsFromAdjacency()
+{
+    const VecCoord& vertices = getVertices();
+    const VecTriangle& triangles = m_triangles.getValue();
+    const VecQuad& quads = m_quads.getValue();
+    const helper::vector<int>& vertNormIdx = m_vertNormIdx.getValue();
+    const bool parallel = d_parallel.getValue();
+
+    const bool rebuilt = updateNormalAdjacency();
+    const std::size_t nbTriangles = triangles.size();
+    const std::size_t nbNormals = m_normalCornersBegin.size() - 1;
+
+    // only the faces around the moved vertices need to be updated, if the previous normals are still valid
+    const bool incremental = d_incrementalUpdate.getValue() && m_movedVerticesValid && !rebuilt
+            && m_vnormals.getValue().size() == vertices.size();
+    if (incremental && m_movedVertices.empty())
+        return;
+
+    auto computeFace = [&](std::size_t f)
+    {
+        if (f < nbTriangles)
+        {
+            const Coord& v1 = vertices[triangles[f][0]];
+            const Coord& v2 = vertices[triangles[f][1]];
+            const Coord& v3 = vertices[triangles[f][2]];
+            m_cornerNormals[f] = cross(v2-v1, v3-v1);
+        }
+        else
+        {
+            const Quad& q = quads[f - nbTriangles];
+            const Coord & v1 = vertices[q[0]];
+            const Coord & v2 = vertices[q[1]];
+            const Coord & v3 = vertices[q[2]];
+            const Coord & v4 = vertices[q[3]];
+            Coord* n = &m_cornerNormals[nbTriangles + 4 * (f - nbTriangles)];
+            n[0] = cross(v2-v1, v4-v1);
+            n[1] = cross(v3-v2, v1-v2);
+            n[2] = cross(v4-v3, v2-v3);
+            n[3] = cross(v1-v4, v3-v4);
+        }
+    };
+
+    VecDeriv& vnormals = *(m_vnormals.beginEdit());
+    vnormals.resize(vertices.size());
+    VecCoord& normals = vertNormIdx.empty() ? vnormals : m_normalsBuffer;
+
+    // same summation order as the serial computation, so the results are identical
+    auto computeNormal = [&](std::size_t n)
+    {
+        Coord normal;
+        for (unsigned int k = m_normalCornersBegin[n]; k < m_normalCornersBegin[n + 1]; ++k)
+            normal += m_cornerNormals[m_normalCorners[k]];
+        normal.normalize();
+        normals[n] = normal;
+    };
+
+    if (!incremental)
+    {
+        forEachIndex(nbTriangles + quads.size(), parallel, computeFace);
+        forEachIndex(nbNormals, parallel, computeNormal);
+        if (!vertNormIdx.empty())
+        {
+            forEachIndex(vertices.size(), parallel, [&](std::size_t i) { vnormals[i] = m_normalsBuffer[vertNormIdx[i]]; });
+        }
+        m_allNormalsDirty = true;
+        m_vnormals.endEdit();
+        return;
+    }
+
+    // faces around the moved vertices
+    helper::vector<char> faceMark(nbTriangles + quads.size(), 0);
+    helper::vector<unsigned int> faces;
+    for (unsigned int v : m_movedVertices)
+        for (unsigned int k = m_vertexFacesBegin[v]; k < m_vertexFacesBegin[v + 1]; ++k)
+            if (!faceMark[m_vertexFaces[k]])
+            {
+                faceMark[m_vertexFaces[k]] = 1;
+                faces.push_back(m_vertexFaces[k]);
+            }
+    forEachIndex(faces.size(), parallel, [&](std::size_t i) { computeFace(faces[i]); });
+
+    // normals of the vertices of these faces
+    helper::vector<char> normalMark(nbNormals, 0);
+    helper::vector<unsigned int> modifiedNormals;
+    auto markVertex = [&](unsigned int v)
+    {
+        const unsigned int n = vertNormIdx.empty() ? v : vertNormIdx[v];
+        if (!normalMark[n])
+        {
+            normalMark[n] = 1;
+            modifiedNormals.push_back(n);
+        }
+    };
+    for (unsigned int f : faces)
+    {
+        if (f < nbTriangles)
+            for (unsigned int j = 0; j < 3; ++j) markVertex(triangles[f][j]);
+        else
+            for (unsigned int j = 0; j < 4; ++j) markVertex(quads[f - nbTriangles][j]);
+    }
+    forEachIndex(modifiedNormals.size(), parallel, [&](std::size_t i) { computeNormal(modifiedNormals[i]); });
+
+    m_dirtyNormals.resize(vertices.size(), 0);
+    if (vertNormIdx.empty())
+    {
+        for (unsigned int n : modifiedNormals)
+            m_dirtyNormals[n] = 1;
+    }
+    else
+    {
+        for (std::size_t i = 0; i < vertices.size(); ++i)
+            if (normalMark[vertNormIdx[i]])
+            {
+                vnormals[i] = m_normalsBuffer[vertNormIdx[i]];
+                m_dirtyNormals[i] = 1;
+            }
+    }
+    m_vnormals.endEdit();
+}
+
+void VisualModelImpl::detectMovedVertices()
+{
+    const VecCoord& vertices = getVertices();
+    m_movedVertices.clear();
+
+    if (m_previousVertices.size() != vertices.size())
+    {
+        m_previousVertices = vertices;
+        m_allPositionsDirty = true;
+        m_movedVerticesValid = false;
+        return;
+    }
+
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+    {
+        if (!samePosition(vertices[i], m_previousVertices[i]))
+        {
+            m_previousVertices[i] = vertices[i];
+            m_movedVertices.push_back((unsigned int)i);
+        }
+    }
+
+    m_dirtyPositions.resize(vertices.size(), 0);
+    for (unsigned int i : m_movedVertices)
+        m_dirtyPositions[i] = 1;
+    m_movedVerticesValid = true;
+}
+
+void VisualModelImpl::getDirtyRanges(const helper::vector<char>& dirty, bool allDirty, std::size_t size, VecVertexRange& ranges) const
+{
+    ranges.clear();
+    if (size == 0)
+        return;
+    if (!d_incrementalUpdate.getValue() || allDirty || dirty.size() != size)
+    {
+        ranges.push_back(VertexRange(0, size));
+        return;
+    }
+
+    // close ranges are merged, a few more vertices are cheaper to upload than an additional call
+    const std::size_t maxGap = 16;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        if (!dirty[i]) continue;
+        if (!ranges.empty() && i - ranges.back().second <= maxGap)
+            ranges.back().second = i + 1;
+        else
+            ranges.push_back(VertexRange(i, i + 1));
+    }
+}
+
+void VisualModelImpl::getDirtyPositionRanges(VecVertexRange& ranges) const
+{
+    getDirtyRanges(m_dirtyPositions, m_allPositionsDirty, getVertices().size(), ranges);
+}
+
+void VisualModelImpl::getDirtyNormalRanges(VecVertexRange& ranges) const
+{
+    getDirtyRanges(m_dirtyNormals, m_allNormalsDirty, getVnormals().size(), ranges);
+}
+
+void VisualModelImpl::clearDirtyVertices()
+{
+    std::fill(m_dirtyPositions.begin(), m_dirtyPositions.end(), 0);
+    std::fill(m_dirtyNormals.begin(), m_dirtyNormals.end(), 0);
+    m_allPositionsDirty = false;
+    m_allNormalsDirty = false;
+}
+
 VisualModelImpl::Coord VisualModelImpl::computeTangent(const Coord &v1, const Coord &v2, const Coord &v3,
                                                        const TexCoord &t1, const TexCoord &t2, const TexCoord &t3)
 {
@@ -1284,6 +1577,9 @@ void VisualModelImpl::updateVisual()
         computePositions();
         sofa::helper::AdvancedTimer::stepEnd("VisualModelImpl::computePositions");
 
+        if (d_incrementalUpdate.getValue())
+            detectMovedVertices();
+
         sofa::helper::AdvancedTimer::stepBegin("VisualModelImpl::updateBuffers");
         updateBuffers();
         sofa::helper::AdvancedTimer::stepEnd("VisualModelImpl::updateBuffers");
@@ -1299,6 +1595,7 @@ void VisualModelImpl::updateVisual()
             sofa::helper::AdvancedTimer::stepEnd("VisualModelImpl::computeTangents");
         }
         modified = false;
+        m_movedVerticesValid = false;
 
         if (m_vtexcoords.getValue().size() == 0)
             computeUVSphereProjection();
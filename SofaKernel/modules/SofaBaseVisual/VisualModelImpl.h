@@ -117,6 +117,8 @@ public:
     Data<bool> m_handleDynamicTopology; ///< True if topological changes should be handled
     Data<bool> m_fixMergedUVSeams; ///< True if UV seams should be handled even when duplicate UVs are merged
     Data<bool> m_keepLines; ///< keep and draw lines (false by default)
+    Data<bool> d_parallel; ///< Compute the normals in parallel, with the TaskScheduler
+    Data<bool> d_incrementalUpdate; ///< Only recompute the normals and the buffers of the vertices moved since the last update
 
     Data< VecCoord > m_vertices2; ///< vertices of the model (only if vertices have multiple normals/texcoords, otherwise positions are used)
     topology::PointData< VecTexCoord > m_vtexcoords; ///< coordinates of the texture
@@ -386,6 +388,18 @@ public:
 
     virtual void updateBuffers() {}
 
+    /// Range [first, last) of vertices
+    typedef std::pair<std::size_t, std::size_t> VertexRange;
+    typedef helper::vector<VertexRange> VecVertexRange;
+
+    /// Ranges of the vertices whose position (resp. normal) changed since the last call to clearDirtyVertices().
+    /// Without incrementalUpdate every vertex is reported.
+    void getDirtyPositionRanges(VecVertexRange& ranges) const;
+    void getDirtyNormalRanges(VecVertexRange& ranges) const;
+
+    /// To be called once the modified vertices are uploaded
+    void clearDirtyVertices();
+
     void updateVisual() override;
 
     /// Handle topological changes
@@ -415,6 +429,45 @@ public:
     static Coord computeBitangent(const Coord &v1, const Coord &v2, const Coord &v3,
             const TexCoord &t1, const TexCoord &t2, const TexCoord &t3);
 
+protected:
+    /// Compute the normals from the face corners around each vertex, only around the moved vertices if possible
+    void computeNormalsFromAdjacency();
+
+    /// Rebuild the adjacency between normals and face corners if the mesh changed, returns true if it was rebuilt
+    bool updateNormalAdjacency();
+
+    /// Compare the vertices with their previous values, to find the ones moved by this update
+    void detectMovedVertices();
+
+    void getDirtyRanges(const helper::vector<char>& dirty, bool allDirty, std::size_t size, VecVertexRange& ranges) const;
+
+    /// Normal of each triangle, followed by the normals of the four corners of each quad
+    VecCoord m_cornerNormals;
+    /// Corners contributing to each normal, in compressed form and in the order of the serial computation
+    helper::vector<unsigned int> m_normalCornersBegin;
+    helper::vector<unsigned int> m_normalCorners;
+    /// Faces (triangles, then quads) around each vertex, in compressed form
+    helper::vector<unsigned int> m_vertexFacesBegin;
+    helper::vector<unsigned int> m_vertexFaces;
+    /// Normals indexed by m_vertNormIdx, when it is used
+    VecCoord m_normalsBuffer;
+    int m_adjacencyTrianglesCounter {-1};
+    int m_adjacencyQuadsCounter {-1};
+    int m_adjacencyNormIdxCounter {-1};
+    std::size_t m_adjacencyNbVertices {0};
+
+    /// Vertices moved by the current update, valid only during updateVisual
+    VecCoord m_previousVertices;
+    helper::vector<unsigned int> m_movedVertices;
+    bool m_movedVerticesValid {false};
+
+    /// Vertices modified since the last upload
+    helper::vector<char> m_dirtyPositions;
+    helper::vector<char> m_dirtyNormals;
+    bool m_allPositionsDirty {true};
+    bool m_allNormalsDirty {true};
+
+public:
     /// Temporary added here from RigidState deprecated inheritance
     sofa::defaulttype::Rigid3fTypes::VecCoord xforms;
     bool xformsModified;
@@ -183,3 +183,89 @@ TEST_F(DDGNode_test, propagationScenario3)
     EXPECT_EQ(m_ddgnode1.m_cpt, 1);
     EXPECT_EQ(m_ddgnode2.m_cpt, 1);
 }
+
+/// Counts the notifications and forwards them to its outputs
+class DDGNodeNotifyClass : public DDGNode
+{
+public:
+    int m_cptNotify {0};
+
+    void update() override {}
+    void notifyEndEdit() override
+    {
+        m_cptNotify++;
+        DDGNode::notifyEndEdit();
+    }
+};
+
+TEST(DDGNodePropagation_test, longChainAndCycle)
+{
+    // deep enough to overflow the stack with a recursive propagation
+    std::vector<DDGNodeTestClass> nodes(200000);
+    for (std::size_t i = 1; i < nodes.size(); ++i)
+        nodes[i].addInput(&nodes[i-1]);
+    // cycle
+    nodes[0].addInput(&nodes.back());
+    for (DDGNodeTestClass& node : nodes)
+        node.cleanDirty();
+
+    nodes[0].setDirtyOutputs();
+    for (std::size_t i = 1; i < nodes.size(); ++i)
+        ASSERT_TRUE(nodes[i].isDirty());
+    EXPECT_TRUE(nodes[0].isDirty());
+
+    nodes[0].delInput(&nodes.back());
+}
+
+TEST(DDGNodePropagation_test, batchedNotifications)
+{
+    // diamond: 1 -> 2, 1 -> 3, 2 -> 4, 3 -> 4
+    DDGNodeNotifyClass n1, n2, n3, n4;
+    n2.addInput(&n1);
+    n3.addInput(&n1);
+    n4.addInput(&n2);
+    n4.addInput(&n3);
+
+    n1.notifyEndEdit();
+    n1.notifyEndEdit();
+    EXPECT_EQ(2, n2.m_cptNotify);
+    EXPECT_EQ(4, n4.m_cptNotify);
+
+    DDGNode::setNotificationBatchEnabled(true);
+    {
+        DDGNode::NotificationBatch batch;
+        n1.notifyEndEdit();
+        n1.notifyEndEdit();
+        n2.notifyEndEdit();
+        EXPECT_EQ(3, n2.m_cptNotify);
+        EXPECT_EQ(4, n4.m_cptNotify);
+    }
+    DDGNode::setNotificationBatchEnabled(false);
+
+    // notified once each at the end of the batch
+    EXPECT_EQ(3, n2.m_cptNotify);
+    EXPECT_EQ(3, n3.m_cptNotify);
+    EXPECT_EQ(5, n4.m_cptNotify);
+}
+
+TEST(DDGNodePropagation_test, statistics)
+{
+    DDGNodeTestClass n1, n2;
+    n2.addInput(&n1);
+    n2.cleanDirty();
+
+    DDGNode::setStatisticsEnabled(true);
+    n1.setDirtyOutputs();
+    n1.setDirtyOutputs();
+    n2.updateIfDirty();
+    n2.cleanDirty();
+    n2.updateIfDirty();
+    DDGNode::setStatisticsEnabled(false);
+
+    // setDirtyValue and setDirtyOutputs of n2
+    EXPECT_EQ(2u, n1.getStatistics().nbSetDirty);
+    EXPECT_EQ(2u, n2.getStatistics().nbSetDirty);
+    EXPECT_EQ(1u, n2.getStatistics().nbUpdate);
+    n2.resetStatistics();
+    EXPECT_EQ(0u, n2.getStatistics().nbUpdate);
+}
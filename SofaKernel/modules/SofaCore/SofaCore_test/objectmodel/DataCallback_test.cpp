@@ -202,4 +202,38 @@ TEST_F(DataCallback_test, testDataCallback_All)
 }
 
 
+/// A Data edited by a callback while the batched notifications are flushed notifies
+/// again the callbacks which were already notified in this flush.
+TEST_F(DataCallback_test, editDuringBatchedNotifications)
+{
+    Data<int> a;
+    Data<int> b;
+    DataCallback observer;
+    DataCallback doubler;
+    // the observer is notified by a before the doubler modifies b
+    observer.addInputs({&a,&b});
+    doubler.addInput(&a);
+
+    std::vector<int> observed;
+    int nbDoubled = 0;
+    observer.addCallback([&b, &observed](){ observed.push_back(b.getValue()); });
+    doubler.addCallback([&a, &b, &nbDoubled](){ ++nbDoubled; b.setValue(2 * a.getValue()); });
+
+    sofa::core::objectmodel::DDGNode::setNotificationBatchEnabled(true);
+    {
+        sofa::core::objectmodel::DDGNode::NotificationBatch batch;
+        a.setValue(5);
+        EXPECT_TRUE(observed.empty());
+        EXPECT_EQ(0, nbDoubled);
+    }
+    sofa::core::objectmodel::DDGNode::setNotificationBatchEnabled(false);
+
+    EXPECT_EQ(1, nbDoubled);
+    EXPECT_EQ(10, b.getValue());
+    ASSERT_EQ(size_t(2), observed.size());
+    EXPECT_EQ(0, observed[0]);
+    EXPECT_EQ(10, observed[1]);
+}
+
+
 }// namespace sofa
@@ -99,6 +99,78 @@ TEST_F(DataLink_test , testDataLink )
     this->testDataLink();
 }
 
+/// A vector linked to its parent aliases its storage, and with the shared buffers the parent
+/// is then modified in place instead of being copied.
+TEST(DataSharedBuffer_test, editInPlace)
+{
+    typedef sofa::helper::vector<sofa::defaulttype::Vec3> VecCoord;
+    Data<VecCoord> parent;
+    Data<VecCoord> child;
+    Data<VecCoord> grandChild;
+    child.setParent(&parent);
+    grandChild.setParent(&child);
+
+    parent.setValue(VecCoord(1000, sofa::defaulttype::Vec3(1,2,3)));
+    EXPECT_EQ(&parent.getValue(), &child.getValue());
+    EXPECT_EQ(&parent.getValue(), &grandChild.getValue());
+
+    // by default the shared value is duplicated
+    std::size_t copiedBytes = BaseData::getCopiedBytes();
+    { helper::WriteAccessor< Data<VecCoord> > x = parent; x[0] = sofa::defaulttype::Vec3(4,5,6); }
+    EXPECT_EQ(1000 * sizeof(sofa::defaulttype::Vec3), BaseData::getCopiedBytes() - copiedBytes);
+    EXPECT_EQ(sofa::defaulttype::Vec3(4,5,6), grandChild.getValue()[0]);
+
+    BaseData::setSharedBufferEnabled(true);
+    copiedBytes = BaseData::getCopiedBytes();
+    const VecCoord* storage = &parent.getValue();
+    { helper::WriteAccessor< Data<VecCoord> > x = parent; x[1] = sofa::defaulttype::Vec3(7,8,9); }
+    EXPECT_EQ(0u, BaseData::getCopiedBytes() - copiedBytes);
+    EXPECT_EQ(storage, &parent.getValue());
+    EXPECT_TRUE(child.isDirty());
+    EXPECT_EQ(sofa::defaulttype::Vec3(7,8,9), grandChild.getValue()[1]);
+    EXPECT_EQ(storage, &grandChild.getValue());
+
+    // a child modifying the value gets its own copy
+    { helper::WriteAccessor< Data<VecCoord> > x = child; x[2] = sofa::defaulttype::Vec3(0,0,0); }
+    EXPECT_EQ(1000 * sizeof(sofa::defaulttype::Vec3), BaseData::getCopiedBytes() - copiedBytes);
+    EXPECT_EQ(sofa::defaulttype::Vec3(1,2,3), parent.getValue()[2]);
+
+    // a Data no longer linked keeps its own value
+    child.setParent(nullptr);
+    Data<VecCoord> other;
+    other.setParent(&parent);
+    other.getValue();
+    other.setParent(nullptr);
+    { helper::WriteAccessor< Data<VecCoord> > x = parent; x[3] = sofa::defaulttype::Vec3(0,0,0); }
+    EXPECT_EQ(sofa::defaulttype::Vec3(1,2,3), other.getValue()[3]);
+    BaseData::setSharedBufferEnabled(false);
+}
+
+/// During a parallel traversal, another thread may read a linked Data: the shared value is copied.
+TEST(DataSharedBuffer_test, noEditInPlaceDuringParallelTraversal)
+{
+    typedef sofa::helper::vector<sofa::defaulttype::Vec3> VecCoord;
+    Data<VecCoord> parent;
+    Data<VecCoord> child;
+    child.setParent(&parent);
+    parent.setValue(VecCoord(1000, sofa::defaulttype::Vec3(1,2,3)));
+    const VecCoord* storage = &child.getValue();
+
+    BaseData::setSharedBufferEnabled(true);
+    {
+        BaseData::ParallelTraversalScope parallelTraversal;
+        EXPECT_FALSE(BaseData::canEditSharedBufferInPlace());
+        std::size_t copiedBytes = BaseData::getCopiedBytes();
+        { helper::WriteAccessor< Data<VecCoord> > x = parent; x[0] = sofa::defaulttype::Vec3(4,5,6); }
+        EXPECT_EQ(1000 * sizeof(sofa::defaulttype::Vec3), BaseData::getCopiedBytes() - copiedBytes);
+        EXPECT_NE(storage, &parent.getValue());
+        EXPECT_EQ(sofa::defaulttype::Vec3(1,2,3), (*storage)[0]);
+    }
+    EXPECT_TRUE(BaseData::canEditSharedBufferInPlace());
+    BaseData::setSharedBufferEnabled(false);
+    EXPECT_FALSE(BaseData::canEditSharedBufferInPlace());
+}
+
 /** Test suite for vectorData
  *
  * @author Thomas Lemaire @date 2014
@@ -89,7 +89,8 @@ public:
     virtual bool isAsyncSolver() { return false; }
 
     /// Indicate if the solver updated the system after the last call of setSystemMBKMatrix (should return true if isParallelSolver return false)
-    virtual bool hasUpdatedMatrix() { return true; }
+    /// A frozen solver keeps its previous system, and its previous factorization.
+    virtual bool hasUpdatedMatrix() { return !frozen; }
 
     /// This function is use for the preconditioner it must be called at each time step event if setSystemMBKMatrix is not called
     virtual void updateSystemMatrix() {}
@@ -194,6 +195,9 @@ public:
     /// Ask the solver to no longer update the system matrix
     virtual void freezeSystemMatrix() { frozen = true; }
 
+    /// Ask the solver to update the system matrix again at the next call of setSystemMBKMatrix
+    virtual void unfreezeSystemMatrix() { frozen = false; }
+
 
 
 protected:
@@ -25,6 +25,8 @@
 #include <sofa/helper/StringUtils.h>
 #include <sofa/helper/logging/Messaging.h>
 
+#include <atomic>
+
 namespace sofa
 {
 
@@ -171,10 +173,7 @@ void BaseData::update()
     cleanDirty();
     for(DDGLinkIterator it=inputs.begin(); it!=inputs.end(); ++it)
     {
-        if ((*it)->isDirty())
-        {
-            (*it)->update();
-        }
+        (*it)->updateIfDirty();
     }
     if (parentBaseData)
     {
@@ -191,6 +190,50 @@ void BaseData::update()
     }
 }
 
+namespace
+{
+/// edit in place the values only shared with linked Data (see BaseData::setSharedBufferEnabled)
+std::atomic<bool> s_sharedBufferEnabled(false);
+/// number of graph traversals currently executed in parallel
+std::atomic<int> s_parallelTraversals(0);
+std::atomic<std::size_t> s_copiedBytes(0);
+}
+
+void BaseData::setSharedBufferEnabled(bool enabled)
+{
+    s_sharedBufferEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool BaseData::isSharedBufferEnabled()
+{
+    return s_sharedBufferEnabled.load(std::memory_order_relaxed);
+}
+
+bool BaseData::canEditSharedBufferInPlace()
+{
+    return isSharedBufferEnabled() && s_parallelTraversals.load(std::memory_order_acquire) == 0;
+}
+
+BaseData::ParallelTraversalScope::ParallelTraversalScope()
+{
+    s_parallelTraversals.fetch_add(1, std::memory_order_acq_rel);
+}
+
+BaseData::ParallelTraversalScope::~ParallelTraversalScope()
+{
+    s_parallelTraversals.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+std::size_t BaseData::getCopiedBytes()
+{
+    return s_copiedBytes.load(std::memory_order_relaxed);
+}
+
+void BaseData::addCopiedBytes(std::size_t bytes)
+{
+    s_copiedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
 /// Update this Data from the value of its parent
 bool BaseData::updateFromParentValue(const BaseData* parent)
 {
@@ -273,6 +316,8 @@ bool BaseData::updateFromParentValue(const BaseData* parent)
                 dataInfo->setTextValue(dataValue, l*outSize+c, parentInfo->getTextValue(parentValue, l*inSize+c));
     }
 
+    addCopiedBytes(nbl * copySize * dataInfo->byteSize());
+
     std::string m = msgs.str();
     if (m_owner
 #ifdef NDEBUG
@@ -290,6 +290,35 @@ public:
     /// Update the value of this %Data
     void update() override;
 
+    /// @name Buffers shared between linked Data
+    /// @{
+
+    /// When enabled, editing a copy-on-write value (e.g. a vector) which is only shared with the Data
+    /// linked to it modifies it in place instead of duplicating it: the linked Data, set dirty by the
+    /// edition, keep aliasing the same storage.
+    static void setSharedBufferEnabled(bool enabled);
+    static bool isSharedBufferEnabled();
+
+    /// Return true if the shared buffers are enabled and no parallel traversal is running:
+    /// a linked Data may be read by another thread while the value is modified in place.
+    static bool canEditSharedBufferInPlace();
+
+    /// Mark the execution of a traversal of the graph in parallel: while at least one scope
+    /// exists, the shared values are duplicated before being edited.
+    class SOFA_CORE_API ParallelTraversalScope
+    {
+    public:
+        ParallelTraversalScope();
+        ~ParallelTraversalScope();
+        ParallelTraversalScope(const ParallelTraversalScope&) = delete;
+        ParallelTraversalScope& operator=(const ParallelTraversalScope&) = delete;
+    };
+
+    /// Number of bytes copied through the Data links and by the copy-on-write since the beginning
+    static std::size_t getCopiedBytes();
+
+    /// @}
+
     /// @name Links management
     /// @{
 
@@ -331,6 +360,9 @@ protected:
     /// Update this %Data from the value of its parent
     virtual bool updateFromParentValue(const BaseData* parent);
 
+    /// Account bytes copied by a Data link or by the copy-on-write (see getCopiedBytes)
+    static void addCopiedBytes(std::size_t bytes);
+
     /// Help message
     std::string help {""};
     /// Owner class
@@ -20,13 +20,43 @@
 * Contact information: contact@sofa-framework.org                             *
 ******************************************************************************/
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <cassert>
+#include <vector>
 #include <sofa/core/objectmodel/DDGNode.h>
 #include <sofa/helper/BackTrace.h>
 namespace sofa::core::objectmodel
 {
 
+namespace
+{
+std::atomic<bool> s_notificationBatchEnabled(false);
+std::atomic<bool> s_statisticsEnabled(false);
+
+/// Per thread state of the dirty propagation and of the notification batches
+struct PropagationState
+{
+    /// Nodes whose outputs remain to be set dirty
+    std::vector<DDGNode*> dirtyStack;
+    bool propagating {false};
+
+    /// Nodes whose outputs remain to be notified
+    std::vector<DDGNode*> notifications;
+    unsigned int batchDepth {0};
+    unsigned int epoch {1};
+    bool flushing {false};
+    /// Node notified by flushNotifications
+    DDGNode* flushed {nullptr};
+};
+
+PropagationState& getPropagationState()
+{
+    static thread_local PropagationState state;
+    return state;
+}
+}
+
 /// Constructor
 DDGNode::DDGNode()
 {
@@ -46,6 +76,8 @@ DDGNode::~DDGNode()
 
 void DDGNode::setDirtyValue()
 {
+    if (s_statisticsEnabled.load(std::memory_order_relaxed))
+        ++m_statistics.nbSetDirty;
     bool& dirtyValue = dirtyFlags.dirtyValue;
     if (!dirtyValue)
     {
@@ -56,15 +88,32 @@ void DDGNode::setDirtyValue()
 
 void DDGNode::setDirtyOutputs()
 {
+    if (s_statisticsEnabled.load(std::memory_order_relaxed))
+        ++m_statistics.nbSetDirty;
     bool& dirtyOutputs = dirtyFlags.dirtyOutputs;
-    if (!dirtyOutputs)
+    if (dirtyOutputs)
+        return;
+    dirtyOutputs = true;
+
+    // The outputs are visited iteratively: the nodes reached while a propagation is in progress
+    // are stacked instead of recursing. The dirty flags stop the traversal on cycles.
+    PropagationState& state = getPropagationState();
+    if (state.propagating)
     {
-        dirtyOutputs = true;
-        for(DDGLinkIterator it=outputs.begin(), itend=outputs.end(); it != itend; ++it)
-        {
-            (*it)->setDirtyValue();
-        }
+        state.dirtyStack.push_back(this);
+        return;
     }
+
+    state.propagating = true;
+    state.dirtyStack.push_back(this);
+    while (!state.dirtyStack.empty())
+    {
+        DDGNode* node = state.dirtyStack.back();
+        state.dirtyStack.pop_back();
+        for (DDGNode* output : node->outputs)
+            output->setDirtyValue();
+    }
+    state.propagating = false;
 }
 
 void DDGNode::cleanDirty()
@@ -79,8 +128,89 @@ void DDGNode::cleanDirty()
 
 void DDGNode::notifyEndEdit()
 {
-    for(auto it : outputs)
-        it->notifyEndEdit();
+    PropagationState& state = getPropagationState();
+    if (state.flushing)
+    {
+        if (this != state.flushed)
+        {
+            // edited during the flush (e.g. by a DataCallback): the nodes already notified
+            // depend on the new value and are notified again, except the one editing it
+            ++state.epoch;
+            if (state.flushed)
+                state.flushed->m_notificationEpoch = state.epoch;
+        }
+        state.notifications.push_back(this);
+    }
+    else if (state.batchDepth > 0)
+    {
+        if (m_notificationEpoch != state.epoch)
+        {
+            m_notificationEpoch = state.epoch;
+            state.notifications.push_back(this);
+        }
+    }
+    else
+    {
+        for(auto it : outputs)
+            it->notifyEndEdit();
+    }
+}
+
+void DDGNode::flushNotifications()
+{
+    PropagationState& state = getPropagationState();
+    state.flushing = true;
+    while (!state.notifications.empty())
+    {
+        DDGNode* node = state.notifications.back();
+        state.notifications.pop_back();
+        for (DDGNode* output : node->outputs)
+        {
+            if (output->m_notificationEpoch != state.epoch)
+            {
+                output->m_notificationEpoch = state.epoch;
+                DDGNode* flushed = state.flushed;
+                state.flushed = output;
+                output->notifyEndEdit();
+                state.flushed = flushed;
+            }
+        }
+    }
+    state.flushing = false;
+    ++state.epoch;
+}
+
+DDGNode::NotificationBatch::NotificationBatch()
+    : m_active(s_notificationBatchEnabled.load(std::memory_order_relaxed))
+{
+    if (m_active)
+        ++getPropagationState().batchDepth;
+}
+
+DDGNode::NotificationBatch::~NotificationBatch()
+{
+    if (m_active && --getPropagationState().batchDepth == 0)
+        flushNotifications();
+}
+
+void DDGNode::setNotificationBatchEnabled(bool enabled)
+{
+    s_notificationBatchEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool DDGNode::isNotificationBatchEnabled()
+{
+    return s_notificationBatchEnabled.load(std::memory_order_relaxed);
+}
+
+void DDGNode::setStatisticsEnabled(bool enabled)
+{
+    s_statisticsEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool DDGNode::isStatisticsEnabled()
+{
+    return s_statisticsEnabled.load(std::memory_order_relaxed);
 }
 
 void DDGNode::cleanDirtyOutputsOfInputs()
@@ -146,6 +276,8 @@ void DDGNode::updateIfDirty() const
 {
     if (isDirty())
     {
+        if (s_statisticsEnabled.load(std::memory_order_relaxed))
+            ++m_statistics.nbUpdate;
         const_cast <DDGNode*> (this)->update();
     }
 }
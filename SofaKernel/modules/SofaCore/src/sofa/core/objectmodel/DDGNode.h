@@ -98,6 +98,46 @@ public:
     virtual void notifyEndEdit(const core::ExecParams*) final { notifyEndEdit(); }
     virtual void notifyEndEdit();
 
+    /// @name Batched notifications
+    /// @{
+
+    /// Within a batch, notifyEndEdit() only records the modified nodes. The nodes depending on them
+    /// are notified once each, when the outermost batch of the current thread ends. A node edited
+    /// while they are notified (e.g. by a DataCallback) notifies them again.
+    /// Batches are only opened when enabled (see setNotificationBatchEnabled).
+    class SOFA_CORE_API NotificationBatch
+    {
+    public:
+        NotificationBatch();
+        ~NotificationBatch();
+    private:
+        bool m_active;
+    };
+
+    static void setNotificationBatchEnabled(bool enabled);
+    static bool isNotificationBatchEnabled();
+
+    /// @}
+
+    /// @name Statistics
+    /// @{
+
+    /// Number of calls to setDirtyValue()/setDirtyOutputs() and to update() since the last reset,
+    /// counted only when the statistics are enabled.
+    struct Statistics
+    {
+        unsigned int nbSetDirty {0};
+        unsigned int nbUpdate {0};
+    };
+
+    const Statistics& getStatistics() const { return m_statistics; }
+    void resetStatistics() { m_statistics = Statistics(); }
+
+    static void setStatisticsEnabled(bool enabled);
+    static bool isStatisticsEnabled();
+
+    /// @}
+
     /// Utility method to call update if necessary. This method should be called before reading of writing the value of this node.
     [[deprecated("2020-03-25: Aspect have been deprecated for complete removal in PR #1269. You can probably update your code by removing aspect related calls. If the feature was important to you contact sofa-dev. ")]]
     void updateIfDirty(const core::ExecParams*) const { updateIfDirty(); }
@@ -125,6 +165,14 @@ private:
         bool dirtyOutputs {false};
     };
     DirtyFlags dirtyFlags;
+
+    /// Epoch of the batch in which this node was last notified
+    unsigned int m_notificationEpoch {0};
+
+    mutable Statistics m_statistics;
+
+    /// Notify the outputs of the nodes recorded by the batch, once each
+    static void flushNotifications();
 };
 
 } // namespace sofa::core::objectmodel
@@ -132,6 +132,14 @@ protected:
 };
 
 
+/// Approximate size in bytes of a Data value, used to account the copies
+template <class T>
+std::size_t dataValueByteSize(const T& value)
+{
+    typedef sofa::defaulttype::DataTypeInfo<T> Info;
+    return Info::ValidInfo ? Info::size(value) * Info::byteSize() : sizeof(T);
+}
+
 /// To handle the Data link:
 /// - CopyOnWrite==false: an independent copy (duplicated memory)
 /// - CopyOnWrite==true: shared memory while the Data is not modified (in that case the memory is duplicated to get an independent copy)
@@ -166,8 +174,12 @@ public:
     }
 
     T* beginEdit() { return &data; }
+    T* beginEditInPlace() { return &data; }
     void endEdit() {}
     const T& getValue() const { return data; }
+    bool isShared() const { return false; }
+    long useCount() const { return 1; }
+    bool sharesWith(const DataValue&) const { return false; }
     void setValue(const T& value)
     {
         data = value;
@@ -223,6 +235,12 @@ public:
         return ptr.get();
     }
 
+    /// Modify the value even if it is shared
+    T* beginEditInPlace()
+    {
+        return ptr.get();
+    }
+
     void endEdit()
     {
     }
@@ -232,6 +250,21 @@ public:
         return *ptr;
     }
 
+    bool isShared() const
+    {
+        return ptr.use_count() > 1;
+    }
+
+    long useCount() const
+    {
+        return ptr.use_count();
+    }
+
+    bool sharesWith(const DataValue& value) const
+    {
+        return ptr == value.ptr;
+    }
+
     void setValue(const T& value)
     {
         if(!ptr.unique())
@@ -382,7 +415,7 @@ public:
         m_counter++;
         m_isSet = true;
         BaseData::setDirtyOutputs();
-        return m_value.beginEdit();
+        return editValue();
     }
 
     inline T* beginWriteOnly()
@@ -390,7 +423,7 @@ public:
         m_counter++;
         m_isSet=true;
         BaseData::setDirtyOutputs();
-        return m_value.beginEdit();
+        return editValue();
     }
 
     inline void endEdit()
@@ -456,6 +489,8 @@ public:
         const Data<T>* d = dynamic_cast< const Data<T>* >(&bd);
         if (d)
         {
+            if (!sofa::defaulttype::DataTypeInfo<T>::CopyOnWrite)
+                BaseData::addCopiedBytes(dataValueByteSize(d->m_value.getValue()));
             m_value = d->m_value;
             m_counter++;
             m_isSet = true;
@@ -496,6 +531,32 @@ protected:
     /// Value
     ValueType m_value;
 
+    /// Value to modify, duplicated first if it is shared (copy-on-write)
+    T* editValue()
+    {
+        if (m_value.isShared())
+        {
+            // the Data linked to this one are dirty and will alias the modified value
+            if (BaseData::canEditSharedBufferInPlace() && m_value.useCount() == 1 + countLinkedAliases(m_value))
+                return m_value.beginEditInPlace();
+            BaseData::addCopiedBytes(dataValueByteSize(m_value.getValue()));
+        }
+        return m_value.beginEdit();
+    }
+
+    /// Number of the Data linked to this one, directly or not, aliasing value
+    long countLinkedAliases(const ValueType& value)
+    {
+        long nb = 0;
+        for (DDGNode* output : this->getOutputs())
+        {
+            Data<T>* d = dynamic_cast<Data<T>*>(output);
+            if (d && d->getParent() == this && d->m_value.sharesWith(value))
+                nb += 1 + d->countLinkedAliases(value);
+        }
+        return nb;
+    }
+
 private:
     Data(const Data& );
     Data& operator=(const Data& );
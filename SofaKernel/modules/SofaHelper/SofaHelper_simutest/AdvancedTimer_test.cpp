@@ -29,6 +29,11 @@ using sofa::core::ExecParams;
 #include <SofaSimulationGraph/testing/BaseSimulationTest.h>
 using sofa::helper::testing::BaseSimulationTest ;
 
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <thread>
+
 namespace sofa {
 
 /**
@@ -104,5 +109,112 @@ TEST_F(AdvancedTimerTest, End)
 	EXPECT_NO_FATAL_FAILURE(AdvancedTimer::end("validId", nullptr));
 }
 
+TEST_F(AdvancedTimerTest, IdsAreSharedByThreads)
+{
+	using namespace sofa::helper;
+
+	const AdvancedTimer::IdStep a("stepA");
+	const AdvancedTimer::IdStep b(std::string("stepB"));
+	ASSERT_NE(a, b);
+	ASSERT_EQ(a, AdvancedTimer::IdStep(std::string("stepA")));
+	ASSERT_EQ(std::string("stepB"), (std::string)b);
+	ASSERT_EQ(a, SOFA_ADVANCEDTIMER_STEP_ID("stepA"));
+
+	unsigned int idInThread = 0;
+	std::thread thread([&idInThread]() { idInThread = AdvancedTimer::IdStep("stepB"); });
+	thread.join();
+	ASSERT_EQ((unsigned int)b, idInThread);
+}
+
+TEST_F(AdvancedTimerTest, RecordsOfOtherThreads)
+{
+	using namespace sofa::helper;
+
+	AdvancedTimer::setEnabled("threadTimer", true);
+	ASSERT_FALSE(AdvancedTimer::isRecording());
+
+	AdvancedTimer::begin("threadTimer");
+	ASSERT_TRUE(AdvancedTimer::isRecording());
+	AdvancedTimer::stepBegin("mainStep");
+	std::thread worker([]()
+	{
+		ScopedAdvancedTimer timer("workerStep");
+	});
+	worker.join();
+	AdvancedTimer::stepEnd("mainStep");
+	AdvancedTimer::end("threadTimer");
+	ASSERT_FALSE(AdvancedTimer::isRecording());
+
+	for (const Record& r : AdvancedTimer::getRecords("threadTimer"))
+	{
+		EXPECT_EQ(0u, r.thread);
+		EXPECT_NE(std::string("workerStep"), r.label);
+	}
+
+	const helper::vector<Record> threadRecords = AdvancedTimer::getThreadRecords("threadTimer");
+	ASSERT_EQ(2u, threadRecords.size());
+	EXPECT_EQ(Record::RSTEP_BEGIN, threadRecords[0].type);
+	EXPECT_EQ(Record::RSTEP_END, threadRecords[1].type);
+	for (const Record& r : threadRecords)
+	{
+		EXPECT_NE(0u, r.thread);
+		EXPECT_EQ(std::string("workerStep"), r.label);
+	}
+}
+
+TEST_F(AdvancedTimerTest, TraceOutput)
+{
+	using namespace sofa::helper;
+
+	const std::string filename = boost::filesystem::temp_directory_path().string() + "/AdvancedTimerTest_trace.json";
+
+	// skip the first execution and write the two next ones
+	AdvancedTimer::setTraceOutput("traceTimer", filename, 1, 2);
+	ASSERT_EQ(AdvancedTimer::TRACE, AdvancedTimer::getOutputType("traceTimer"));
+	ASSERT_TRUE(AdvancedTimer::isEnabled("traceTimer"));
+
+	for (int i = 0; i < 4; ++i)
+	{
+		AdvancedTimer::begin("traceTimer");
+		AdvancedTimer::stepBegin("traceStep", "traceObject");
+		std::thread worker([]()
+		{
+			ScopedAdvancedTimer timer("traceWorkerStep");
+		});
+		worker.join();
+		AdvancedTimer::valSet("traceValue", i);
+		AdvancedTimer::stepEnd("traceStep", "traceObject");
+		AdvancedTimer::end("traceTimer");
+	}
+	AdvancedTimer::closeTraceOutput("traceTimer");
+	ASSERT_EQ(AdvancedTimer::STDOUT, AdvancedTimer::getOutputType("traceTimer"));
+
+	std::ifstream file(filename.c_str());
+	ASSERT_TRUE(file.good());
+	const std::string trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	file.close();
+	boost::filesystem::remove(filename);
+
+	const auto count = [&trace](const std::string& pattern)
+	{
+		std::size_t n = 0;
+		for (std::size_t pos = trace.find(pattern); pos != std::string::npos; pos = trace.find(pattern, pos + 1))
+			++n;
+		return n;
+	};
+
+	EXPECT_EQ(0u, trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+	EXPECT_NE(std::string::npos, trace.rfind("]}"));
+	EXPECT_EQ(2u, count("{\"name\":\"traceTimer\",\"ph\":\"B\""));
+	EXPECT_EQ(2u, count("{\"name\":\"traceStep\",\"ph\":\"B\""));
+	EXPECT_EQ(2u, count("{\"name\":\"traceWorkerStep\",\"ph\":\"E\""));
+	EXPECT_EQ(4u, count("\"args\":{\"object\":\"traceObject\"}"));
+	EXPECT_EQ(2u, count("{\"name\":\"traceValue\",\"ph\":\"C\""));
+	EXPECT_EQ(1u, count("\"args\":{\"step\":1}"));
+	EXPECT_EQ(1u, count("\"args\":{\"step\":2}"));
+	// one lane for the timer thread, and one for the workers which reuse the buffer of the previous one
+	EXPECT_EQ(1u, count("\"args\":{\"name\":\"timer thread\"}"));
+	EXPECT_EQ(2u, count("{\"name\":\"thread_name\""));
+}
 
 } //namespace sofa
@@ -0,0 +1,206 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/helper/testing/BaseTest.h>
+using sofa::helper::testing::BaseTest ;
+
+#include <sofa/helper/io/TrajectoryFile.h>
+using sofa::helper::io::TrajectoryFrame;
+using sofa::helper::io::TrajectoryReader;
+using sofa::helper::io::TrajectoryWriter;
+
+#include <boost/filesystem.hpp>
+
+#include <cstdio>
+
+namespace
+{
+
+const unsigned int dimensions[TrajectoryFrame::NbVectors] = { 3, 3, 3, 3 };
+const std::size_t nbElements = 100;
+const unsigned int nbFrames = 50;
+const double dt = 0.01;
+
+class TrajectoryFile_test : public BaseTest
+{
+protected:
+    std::string m_fileName;
+
+    void SetUp() override
+    {
+        m_fileName = boost::filesystem::temp_directory_path().string() + "/TrajectoryFile_test.trj";
+    }
+
+    void TearDown() override
+    {
+        std::remove(m_fileName.c_str());
+    }
+
+    static SReal value(unsigned int frame, std::size_t i)
+    {
+        return (SReal)(frame * 0.5 + i * 0.125);
+    }
+
+    /// Write the positions of each frame, and the velocities of one frame in two
+    void writeFrames(TrajectoryWriter& writer)
+    {
+        TrajectoryFrame frame;
+        for (unsigned int f = 0; f < nbFrames; ++f)
+        {
+            frame.time = f * dt;
+            frame.nbElements = nbElements;
+            frame.values[TrajectoryFrame::Position].resize(nbElements * 3);
+            for (std::size_t i = 0; i < nbElements * 3; ++i)
+                frame.values[TrajectoryFrame::Position][i] = value(f, i);
+            frame.values[TrajectoryFrame::Velocity].clear();
+            if (f % 2 == 0)
+                frame.values[TrajectoryFrame::Velocity].assign(nbElements * 3, (SReal)f);
+            writer.addFrame(frame);
+        }
+    }
+
+    void checkFrames(TrajectoryReader& reader, SReal tolerance)
+    {
+        ASSERT_EQ(reader.getNbFrames(), nbFrames);
+        ASSERT_EQ(reader.getDimension(TrajectoryFrame::Position), 3u);
+
+        EXPECT_EQ(reader.findFrame(-1.0), -1);
+        EXPECT_EQ(reader.findFrame(0.0), 0);
+        EXPECT_EQ(reader.findFrame(10.5 * dt), 10);
+        EXPECT_EQ(reader.findFrame(100.0), (int)nbFrames - 1);
+
+        // read the frames backwards, to check the random access
+        TrajectoryFrame frame;
+        for (int f = nbFrames - 1; f >= 0; f -= 3)
+        {
+            ASSERT_TRUE(reader.readFrame(f, frame));
+            EXPECT_EQ(frame.time, f * dt);
+            ASSERT_EQ(frame.nbElements, nbElements);
+            ASSERT_TRUE(frame.has(TrajectoryFrame::Position));
+            EXPECT_FALSE(frame.has(TrajectoryFrame::RestPosition));
+            EXPECT_EQ(frame.has(TrajectoryFrame::Velocity), f % 2 == 0);
+            for (std::size_t i = 0; i < nbElements * 3; ++i)
+                ASSERT_NEAR(frame.values[TrajectoryFrame::Position][i], value(f, i), tolerance);
+        }
+    }
+
+    void writeAndRead(const TrajectoryWriter::Options& options, SReal tolerance)
+    {
+        {
+            TrajectoryWriter writer;
+            ASSERT_TRUE(writer.open(m_fileName, dimensions, options));
+            writeFrames(writer);
+        }
+        ASSERT_TRUE(TrajectoryReader::isTrajectoryFile(m_fileName));
+        TrajectoryReader reader;
+        ASSERT_TRUE(reader.open(m_fileName));
+        checkFrames(reader, tolerance);
+    }
+};
+
+TEST_F(TrajectoryFile_test, synchronous)
+{
+    TrajectoryWriter::Options options;
+    options.asynchronous = false;
+    options.compress = false;
+    writeAndRead(options, 0);
+}
+
+TEST_F(TrajectoryFile_test, asynchronousCompressed)
+{
+    TrajectoryWriter::Options options;
+    options.framesPerChunk = 7;
+    options.maxPendingChunks = 1;
+    writeAndRead(options, 0);
+}
+
+TEST_F(TrajectoryFile_test, float32)
+{
+    TrajectoryWriter::Options options;
+    options.float32 = true;
+    writeAndRead(options, 1e-5);
+}
+
+TEST_F(TrajectoryFile_test, missingIndex)
+{
+    TrajectoryWriter::Options options;
+    options.framesPerChunk = 10;
+    TrajectoryWriter writer;
+    ASSERT_TRUE(writer.open(m_fileName, dimensions, options));
+    writeFrames(writer);
+    writer.flush();
+
+    // the file is not closed: the index is rebuilt from the chunks
+    {
+        EXPECT_MSG_EMIT(Warning);
+        TrajectoryReader reader;
+        ASSERT_TRUE(reader.open(m_fileName));
+        checkFrames(reader, 0);
+    }
+    writer.close();
+}
+
+TEST_F(TrajectoryFile_test, invalidFile)
+{
+    EXPECT_FALSE(TrajectoryReader::isTrajectoryFile(m_fileName + ".missing"));
+    TrajectoryReader reader;
+    EXPECT_FALSE(reader.open(m_fileName + ".missing"));
+}
+
+#ifdef __linux__
+/// writing to /dev/full fails when the chunks are flushed: the failure is reported once
+void writeToFullDevice(const TrajectoryWriter::Options& options)
+{
+    TrajectoryWriter writer;
+    ASSERT_TRUE(writer.open("/dev/full", dimensions, options));
+    EXPECT_TRUE(writer.good());
+    {
+        EXPECT_MSG_EMIT(Error);
+        TrajectoryFrame frame;
+        for (unsigned int f = 0; f < nbFrames; ++f)
+        {
+            frame.time = f * dt;
+            frame.nbElements = nbElements;
+            frame.values[TrajectoryFrame::Position].assign(nbElements * 3, (SReal)f);
+            writer.addFrame(frame);
+        }
+        writer.flush();
+        EXPECT_FALSE(writer.good());
+        writer.close();
+    }
+}
+
+TEST_F(TrajectoryFile_test, writeFailureSynchronous)
+{
+    TrajectoryWriter::Options options;
+    options.asynchronous = false;
+    writeToFullDevice(options);
+}
+
+TEST_F(TrajectoryFile_test, writeFailureAsynchronous)
+{
+    TrajectoryWriter::Options options;
+    options.framesPerChunk = 4;
+    writeToFullDevice(options);
+}
+#endif
+
+} // namespace
@@ -33,8 +33,13 @@
 #include <stack>
 #include <algorithm>
 #include <cctype>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <set>
 
 #define DEFAULT_INTERVAL 100
+#define DEFAULT_TRACE_MAX_EVENTS 1000000
 
 using namespace sofa::core::objectmodel;
 using json = sofa::helper::json;
@@ -48,11 +53,192 @@ namespace helper
 typedef sofa::helper::system::thread::ctime_t ctime_t;
 typedef sofa::helper::system::thread::CTime CTime;
 
+template<class Base>
+AdvancedTimer::Id<Base>::IdFactory::IdFactory()
+{
+    idsList.push_back(std::string("0")); // ID 0 == "0" or empty string
+}
+
+template<class Base>
+unsigned int AdvancedTimer::Id<Base>::IdFactory::getID(const std::string& name)
+{
+    if (name.empty())
+        return 0;
+    IdFactory& idfac = getInstance();
+    {
+        std::shared_lock<std::shared_mutex> lock(idfac.mutex);
+        typename std::unordered_map<std::string, unsigned int>::const_iterator it = idfac.idsMap.find(name);
+        if (it != idfac.idsMap.end())
+            return it->second;
+    }
+    std::unique_lock<std::shared_mutex> lock(idfac.mutex);
+    // another thread may have added it meanwhile
+    std::pair<typename std::unordered_map<std::string, unsigned int>::iterator, bool> inserted =
+            idfac.idsMap.insert(std::make_pair(name, (unsigned int)idfac.idsList.size()));
+    if (inserted.second)
+        idfac.idsList.push_back(name);
+    return inserted.first->second;
+}
+
+template<class Base>
+std::size_t AdvancedTimer::Id<Base>::IdFactory::getLastID()
+{
+    IdFactory& idfac = getInstance();
+    std::shared_lock<std::shared_mutex> lock(idfac.mutex);
+    return idfac.idsList.size()-1;
+}
+
+template<class Base>
+std::string AdvancedTimer::Id<Base>::IdFactory::getName(unsigned int id)
+{
+    IdFactory& idfac = getInstance();
+    std::shared_lock<std::shared_mutex> lock(idfac.mutex);
+    if (id < idfac.idsList.size())
+        return idfac.idsList[id];
+    else
+        return "";
+}
+
+template<class Base>
+typename AdvancedTimer::Id<Base>::IdFactory& AdvancedTimer::Id<Base>::IdFactory::getInstance()
+{
+    static IdFactory instance;
+    return instance;
+}
+
 template class SOFA_HELPER_API AdvancedTimer::Id<AdvancedTimer::Timer>;
 template class SOFA_HELPER_API AdvancedTimer::Id<AdvancedTimer::Step>;
 template class SOFA_HELPER_API AdvancedTimer::Id<AdvancedTimer::Obj>;
 template class SOFA_HELPER_API AdvancedTimer::Id<AdvancedTimer::Val>;
 
+/// Streams the records of a timer to a file in the Chrome trace-event format, which can be
+/// opened in chrome://tracing or https://ui.perfetto.dev. Each recording thread gets its own lane.
+/// Events are written at the end of each execution of the timer, so the memory used does not
+/// depend on the length of the capture.
+class TraceWriter
+{
+public:
+    TraceWriter(const std::string& filename, unsigned int firstStep, unsigned int nbSteps, std::size_t maxEvents)
+        : filename(filename), firstStep(firstStep), nbSteps(nbSteps), maxEvents(maxEvents)
+        , step(0), nbEvents(0), t0(0), out(filename.c_str())
+    {
+        if (!out)
+        {
+            msg_error("AdvancedTimer") << "Unable to open trace file " << filename;
+            return;
+        }
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    }
+
+    ~TraceWriter()
+    {
+        close();
+    }
+
+    bool isOpen() const { return out.is_open(); }
+
+    /// write one execution of the timer, if it is inside the captured window
+    void write(const helper::vector<Record>& records, const helper::vector<Record>& threadRecords)
+    {
+        if (!isOpen() || records.empty()) return;
+        const unsigned int currentStep = step++;
+        if (currentStep < firstStep) return;
+        if (nbEvents == 0)
+            t0 = records.front().time;
+
+        ticksToMicroseconds = 1.0e6 / (double)CTime::getTicksPerSec();
+        values.clear();
+        for (const Record& r : records)
+            writeEvent(r, currentStep);
+        for (const Record& r : threadRecords)
+            writeEvent(r, currentStep);
+
+        if (nbEvents >= maxEvents)
+            msg_info("AdvancedTimer") << "Trace " << filename << " reached " << maxEvents << " events and was closed";
+        if (nbEvents >= maxEvents || (nbSteps != 0 && step >= firstStep + nbSteps))
+            close();
+        else
+            out.flush();
+    }
+
+    void close()
+    {
+        if (!isOpen()) return;
+        out << "\n]}\n";
+        out.close();
+    }
+
+protected:
+    void writeEvent(const Record& r, unsigned int currentStep)
+    {
+        if (nbEvents >= maxEvents) return;
+
+        if (namedThreads.insert(r.thread).second)
+        {
+            const std::string threadName = (r.thread == 0) ? std::string("timer thread") : "thread " + std::to_string(r.thread);
+            out << (nbEvents ? ",\n" : "\n")
+                << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << r.thread
+                << ",\"args\":{\"name\":" << json(threadName).dump() << "}}";
+            out << ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << r.thread
+                << ",\"args\":{\"sort_index\":" << r.thread << "}}";
+            ++nbEvents;
+        }
+
+        std::string name;
+        const char* phase = nullptr;
+        double value = 0;
+        switch (r.type)
+        {
+        case Record::RBEGIN:
+        case Record::REND:
+            name = AdvancedTimer::IdTimer::IdFactory::getName(r.id);
+            phase = (r.type == Record::RBEGIN) ? "B" : "E";
+            break;
+        case Record::RSTEP_BEGIN:
+        case Record::RSTEP_END:
+        case Record::RSTEP:
+            name = AdvancedTimer::IdStep::IdFactory::getName(r.id);
+            phase = (r.type == Record::RSTEP_BEGIN) ? "B" : (r.type == Record::RSTEP_END) ? "E" : "i";
+            break;
+        case Record::RVAL_SET:
+        case Record::RVAL_ADD:
+            name = AdvancedTimer::IdVal::IdFactory::getName(r.id);
+            phase = "C";
+            value = (r.type == Record::RVAL_SET) ? r.val : values[r.id] + r.val;
+            values[r.id] = value;
+            break;
+        default:
+            return;
+        }
+
+        out << ",\n{\"name\":" << json(name).dump() << ",\"ph\":\"" << phase
+            << "\",\"ts\":" << std::fixed << (double)(r.time - t0) * ticksToMicroseconds << std::defaultfloat
+            << ",\"pid\":1,\"tid\":" << r.thread;
+        if (r.type == Record::RSTEP)
+            out << ",\"s\":\"t\"";
+        if (r.type == Record::RVAL_SET || r.type == Record::RVAL_ADD)
+            out << ",\"args\":{\"value\":" << value << "}";
+        else if (r.type == Record::RBEGIN)
+            out << ",\"args\":{\"step\":" << currentStep << "}";
+        else if (r.obj != 0)
+            out << ",\"args\":{\"object\":" << json(AdvancedTimer::IdObj::IdFactory::getName(r.obj)).dump() << "}";
+        out << "}";
+        ++nbEvents;
+    }
+
+    const std::string filename;
+    const unsigned int firstStep;
+    const unsigned int nbSteps;
+    const std::size_t maxEvents;
+    unsigned int step;
+    std::size_t nbEvents;
+    ctime_t t0;
+    double ticksToMicroseconds { 1.0 };
+    std::set<unsigned int> namedThreads;
+    std::map<unsigned int, double> values;
+    std::ofstream out;
+};
+
 class TimerData
 {
 public:
@@ -82,6 +268,12 @@ public:
     std::map<AdvancedTimer::IdVal, ValData> valData;
     helper::vector<AdvancedTimer::IdVal> vals;
 
+    /// records of the other threads during the last execution of the timer
+    helper::vector<Record> threadRecords;
+
+    /// trace file written when the output type is TRACE
+    std::shared_ptr<TraceWriter> trace;
+
     TimerData()
         : nbIter(0), interval(0), defaultInterval(DEFAULT_INTERVAL), timerOutputType(AdvancedTimer::STDOUT)
     {
@@ -103,6 +295,7 @@ public:
     }
     void clear();
     void process();
+    void writeTrace();
     void print();
     void print(std::ostream& result);
     json getJson(std::string stepNumber);
@@ -112,7 +305,7 @@ public:
 
 std::map< AdvancedTimer::IdTimer, TimerData > timers;
 
-std::atomic<int> activeTimers;
+std::atomic<int> AdvancedTimer::s_activeTimers(0);
 SOFA_THREAD_SPECIFIC_PTR(std::stack<AdvancedTimer::IdTimer>, curTimerThread);
 SOFA_THREAD_SPECIFIC_PTR(helper::vector<Record>, curRecordsThread);
 
@@ -129,21 +322,132 @@ std::stack<AdvancedTimer::IdTimer>& getCurTimer()
 
 helper::vector<Record>* getCurRecords()
 {
-    if (!activeTimers) return nullptr;
+    if (!AdvancedTimer::isRecording()) return nullptr;
     return curRecordsThread;
 }
 
+/// Bounded ring buffer of the records of a thread which does not run the active timer.
+/// It is only written by its thread and only read by the thread ending the timer, so no lock is needed.
+class ThreadRecordBuffer
+{
+public:
+    enum { Capacity = 1 << 13 };
+
+    explicit ThreadRecordBuffer(unsigned int thread)
+        : thread(thread), inUse(true), head(0), tail(0), records(Capacity)
+    {
+    }
+
+    /// called by the owner thread only, the record is dropped if the buffer is full
+    void push(const Record& r)
+    {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= (std::size_t)Capacity)
+            return;
+        records[h & (Capacity-1)] = r;
+        records[h & (Capacity-1)].thread = thread;
+        head.store(h+1, std::memory_order_release);
+    }
+
+    /// move all the pending records at the end of out, or discard them if out is null
+    void pop(helper::vector<Record>* out)
+    {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        const std::size_t h = head.load(std::memory_order_acquire);
+        if (out)
+            for (; t != h; ++t)
+                out->push_back(records[t & (Capacity-1)]);
+        tail.store(h, std::memory_order_release);
+    }
+
+    const unsigned int thread;
+
+    /// false once the owner thread exited, the buffer can then be reused by a new thread
+    std::atomic<bool> inUse;
+
+protected:
+    std::atomic<std::size_t> head;
+    std::atomic<std::size_t> tail;
+    std::vector<Record> records;
+};
+
+std::mutex threadRecordBuffersMutex;
+std::vector< std::unique_ptr<ThreadRecordBuffer> > threadRecordBuffers;
+
+/// Buffer owned by the current thread, given back when the thread exits so that
+/// short-lived threads do not make the number of buffers grow
+class ThreadRecordBufferOwner
+{
+public:
+    ~ThreadRecordBufferOwner()
+    {
+        if (buffer) buffer->inUse = false;
+    }
+
+    ThreadRecordBuffer* buffer = nullptr;
+};
+
+ThreadRecordBuffer& getThreadRecordBuffer()
+{
+    static thread_local ThreadRecordBufferOwner owner;
+    if (!owner.buffer)
+    {
+        std::lock_guard<std::mutex> lock(threadRecordBuffersMutex);
+        for (std::unique_ptr<ThreadRecordBuffer>& buffer : threadRecordBuffers)
+        {
+            if (!buffer->inUse)
+            {
+                buffer->inUse = true;
+                owner.buffer = buffer.get();
+                break;
+            }
+        }
+        if (!owner.buffer)
+        {
+            threadRecordBuffers.emplace_back(new ThreadRecordBuffer((unsigned int)threadRecordBuffers.size()+1));
+            owner.buffer = threadRecordBuffers.back().get();
+        }
+    }
+    return *owner.buffer;
+}
+
+void collectThreadRecords(helper::vector<Record>* out)
+{
+    std::lock_guard<std::mutex> lock(threadRecordBuffersMutex);
+    for (std::unique_ptr<ThreadRecordBuffer>& buffer : threadRecordBuffers)
+        buffer->pop(out);
+}
+
 void setCurRecords(helper::vector<Record>* ptr)
 {
     helper::vector<Record>* prev = curRecordsThread;
     curRecordsThread = ptr;
-    if (ptr && !prev) ++activeTimers;
-    else if (!ptr && prev) --activeTimers;
+    if (ptr && !prev) ++AdvancedTimer::s_activeTimers;
+    else if (!ptr && prev) --AdvancedTimer::s_activeTimers;
 }
 
 AdvancedTimer::SyncCallBack syncCallBack = nullptr;
 void* syncCallBackData = nullptr;
 
+/// Add a record to the active timer of the current thread, or to the ring buffer of the
+/// current thread if the active timer runs on another thread
+void addRecord(Record::Type type, unsigned int id, unsigned int obj = 0, double val = 0.0, bool sync = false)
+{
+    if (!AdvancedTimer::isRecording()) return;
+    helper::vector<Record>* curRecords = curRecordsThread;
+    if (curRecords && sync && syncCallBack) (*syncCallBack)(syncCallBackData);
+    Record r;
+    r.time = CTime::getTime();
+    r.type = type;
+    r.id = id;
+    r.obj = obj;
+    r.val = val;
+    if (curRecords)
+        curRecords->push_back(r);
+    else
+        getThreadRecordBuffer().push(r);
+}
+
 std::pair<AdvancedTimer::SyncCallBack,void*> AdvancedTimer::setSyncCallBack(SyncCallBack cb, void* userData)
 {
     std::pair<AdvancedTimer::SyncCallBack,void*> old;
@@ -161,7 +465,7 @@ void AdvancedTimer::clear()
     if (ptr)
         while (!ptr->empty())
             ptr->pop();
-    if (activeTimers == 0)
+    if (s_activeTimers == 0)
         timers.clear();
 }
 
@@ -226,6 +530,8 @@ void AdvancedTimer::begin(IdTimer id)
     helper::vector<Record>* curRecords = &(data.records);
     setCurRecords(curRecords);
     curRecords->clear();
+    data.threadRecords.clear();
+    collectThreadRecords(nullptr);
     if (syncCallBack) (*syncCallBack)(syncCallBackData);
     Record r;
     r.time = CTime::getTime();
@@ -259,11 +565,19 @@ void AdvancedTimer::end(IdTimer id, std::ostream& result)
         curRecords->push_back(r);
 
         TimerData& data = timers[curTimer.top()];
-        data.process();
-        if (data.nbIter == data.interval)
+        collectThreadRecords(&data.threadRecords);
+        if (data.timerOutputType == TRACE)
         {
-            data.print(result);
-            data.clear();
+            data.writeTrace();
+        }
+        else
+        {
+            data.process();
+            if (data.nbIter == data.interval)
+            {
+                data.print(result);
+                data.clear();
+            }
         }
     }
     curTimer.pop();
@@ -311,11 +625,19 @@ void AdvancedTimer::end(IdTimer id)
         curRecords->push_back(r);
 
         TimerData& data = timers[curTimer.top()];
-        data.process();
-        if (data.nbIter == data.interval)
+        collectThreadRecords(&data.threadRecords);
+        if (data.timerOutputType == TRACE)
         {
-            data.print();
-            data.clear();
+            data.writeTrace();
+        }
+        else
+        {
+            data.process();
+            if (data.nbIter == data.interval)
+            {
+                data.print();
+                data.clear();
+            }
         }
     }
     curTimer.pop();
@@ -359,113 +681,48 @@ bool AdvancedTimer::isActive()
 
 void AdvancedTimer::stepBegin(IdStep id)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    Record r;
-    r.time = CTime::getTime();
-    r.type = Record::RSTEP_BEGIN;
-    r.id = id;
-    curRecords->push_back(r);
+    addRecord(Record::RSTEP_BEGIN, id);
 }
 
 void AdvancedTimer::stepBegin(IdStep id, IdObj obj)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    Record r;
-    r.time = CTime::getTime();
-    r.type = Record::RSTEP_BEGIN;
-    r.id = id;
-    r.obj = obj;
-    curRecords->push_back(r);
+    addRecord(Record::RSTEP_BEGIN, id, obj);
 }
 
 void AdvancedTimer::stepEnd  (IdStep id)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    if (syncCallBack) (*syncCallBack)(syncCallBackData);
-    Record r;
-    r.time = CTime::getTime();
-    r.type = Record::RSTEP_END;
-    r.id = id;
-    curRecords->push_back(r);
+    addRecord(Record::RSTEP_END, id, 0, 0.0, true);
 }
 
 void AdvancedTimer::stepEnd  (IdStep id, IdObj obj)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    Record r;
-    r.time = CTime::getTime();
-    r.type = Record::RSTEP_END;
-    r.id = id;
-    r.obj = obj;
-    curRecords->push_back(r);
+    addRecord(Record::RSTEP_END, id, obj);
 }
 
 void AdvancedTimer::stepNext (IdStep prevId, IdStep nextId)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    Record r;
-    if (syncCallBack) (*syncCallBack)(syncCallBackData);
-    r.time = CTime::getTime();
-    r.type = Record::RSTEP_END;
-    r.id = prevId;
-    curRecords->push_back(r);
-    r.type = Record::RSTEP_BEGIN;
-    r.id = nextId;
-    curRecords->push_back(r);
+    addRecord(Record::RSTEP_END, prevId, 0, 0.0, true);
+    addRecord(Record::RSTEP_BEGIN, nextId);
 }
 
 void AdvancedTimer::step     (IdStep id)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    if (syncCallBack) (*syncCallBack)(syncCallBackData);
-    Record r;
-    r.time = CTime::getTime();
-    r.type = Record::RSTEP;
-    r.id = id;
-    curRecords->push_back(r);
+    addRecord(Record::RSTEP, id, 0, 0.0, true);
 }
 
 void AdvancedTimer::step     (IdStep id, IdObj obj)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    if (syncCallBack) (*syncCallBack)(syncCallBackData);
-    Record r;
-    r.time = CTime::getTime();
-    r.type = Record::RSTEP;
-    r.id = id;
-    r.obj = obj;
-    curRecords->push_back(r);
+    addRecord(Record::RSTEP, id, obj, 0.0, true);
 }
 
 void AdvancedTimer::valSet(IdVal id, double val)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    Record r;
-    r.time = CTime::getTime();
-    r.type = Record::RVAL_SET;
-    r.id = id;
-    r.val = val;
-    curRecords->push_back(r);
+    addRecord(Record::RVAL_SET, id, 0, val);
 }
 
 void AdvancedTimer::valAdd(IdVal id, double val)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
-    Record r;
-    r.time = CTime::getTime();
-    r.type = Record::RVAL_ADD;
-    r.id = id;
-    r.val = val;
-    curRecords->push_back(r);
+    addRecord(Record::RVAL_ADD, id, 0, val);
 }
 
 // API using strings instead of Id, to remove the need for Id creation when no timing is recorded
@@ -482,85 +739,73 @@ void AdvancedTimer::end(const char* idStr)
 
 void AdvancedTimer::stepBegin(const char* idStr)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!isRecording()) return;
     stepBegin(IdStep(idStr));
 }
 
 void AdvancedTimer::stepBegin(const char* idStr, const char* objStr)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!isRecording()) return;
     stepBegin(IdStep(idStr), IdObj(objStr));
 }
 
 void AdvancedTimer::stepBegin(const char* idStr, const std::string& objStr)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!isRecording()) return;
     stepBegin(IdStep(idStr), IdObj(objStr));
 }
 
 void AdvancedTimer::stepEnd  (const char* idStr)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!isRecording()) return;
     stepEnd  (IdStep(idStr));
 }
 
 void AdvancedTimer::stepEnd  (const char* idStr, const char* objStr)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!isRecording()) return;
     stepEnd  (IdStep(idStr), IdObj(objStr));
 }
 
 void AdvancedTimer::stepEnd  (const char* idStr, const std::string& objStr)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!isRecording()) return;
     stepEnd  (IdStep(idStr), IdObj(objStr));
 }
 
 void AdvancedTimer::stepNext (const char* prevIdStr, const char* nextIdStr)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!isRecording()) return;
     stepNext (IdStep(prevIdStr), IdStep(nextIdStr));
 }
 
 void AdvancedTimer::step     (const char* idStr)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!isRecording()) return;
     step     (IdStep(idStr));
 }
 
 void AdvancedTimer::step     (const char* idStr, const char* objStr)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!isRecording()) return;
     step     (IdStep(idStr), IdObj(objStr));
 }
 
 void AdvancedTimer::step     (const char* idStr, const std::string& objStr)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!isRecording()) return;
     step     (IdStep(idStr), IdObj(objStr));
 }
 
 void AdvancedTimer::valSet(const char* idStr, double val)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!isRecording()) return;
     valSet(IdVal(idStr),val);
 }
 
 void AdvancedTimer::valAdd(const char* idStr, double val)
 {
-    helper::vector<Record>* curRecords = getCurRecords();
-    if (!curRecords) return;
+    if (!isRecording()) return;
     valAdd(IdVal(idStr),val);
 }
 
@@ -573,6 +818,13 @@ void TimerData::clear()
     valData.clear();
 }
 
+void TimerData::writeTrace()
+{
+    if (!trace)
+        trace = std::make_shared<TraceWriter>((std::string)id + "_trace.json", 0, 0, DEFAULT_TRACE_MAX_EVENTS);
+    trace->write(records, threadRecords);
+}
+
 void TimerData::process()
 {
     if (records.empty()) return;
@@ -938,9 +1190,11 @@ AdvancedTimer::outputType AdvancedTimer::convertOutputType(std::string type)
 		return STDOUT;
     else if(type.compare("gui") == 0)
         return GUI;
+    else if(type.compare("trace") == 0)
+        return TRACE;
 	else // Add your own outputTypes before the else
 	{
-		msg_warning("AdvancedTimer") << "Unable to set output type to " << type << ". Switching to the default 'stdout' output. Valid types are [stdout, json, ljson].";
+		msg_warning("AdvancedTimer") << "Unable to set output type to " << type << ". Switching to the default 'stdout' output. Valid types are [stdout, json, ljson, trace].";
 		return STDOUT;
 	}
 }
@@ -963,6 +1217,26 @@ AdvancedTimer::outputType AdvancedTimer::getOutputType(IdTimer id)
 	return data.timerOutputType;
 }
 
+void AdvancedTimer::setTraceOutput(IdTimer id, const std::string& filename, unsigned int firstStep, unsigned int nbSteps, std::size_t maxEvents)
+{
+    TimerData& data = timers[id];
+    if (!data.id)
+    {
+        data.init(id);
+    }
+    data.timerOutputType = TRACE;
+    data.trace = std::make_shared<TraceWriter>(filename, firstStep, nbSteps, maxEvents);
+    setEnabled(id, true);
+}
+
+void AdvancedTimer::closeTraceOutput(IdTimer id)
+{
+    TimerData& data = timers[id];
+    data.trace.reset();
+    if (data.timerOutputType == TRACE)
+        data.timerOutputType = STDOUT;
+}
+
 // -------------------------------
 // Methods used for JSON output
 
@@ -1403,39 +1677,52 @@ std::map<AdvancedTimer::IdStep, StepData> AdvancedTimer::getStepData(IdTimer id,
     return data.stepData;
 }
 
+void setRecordLabel(Record& r)
+{
+    switch (r.type) {
+        case Record::RBEGIN: // Timer begins
+        case Record::REND: // Timer ends
+            r.label = AdvancedTimer::IdTimer::IdFactory::getName(r.id);
+            if (r.obj != 0 || (!AdvancedTimer::IdObj::IdFactory::getName(r.obj).empty() && AdvancedTimer::IdObj::IdFactory::getName(r.obj) != "0")) {
+                r.label += " (" + AdvancedTimer::IdObj::IdFactory::getName(r.obj) + ")";
+            }
+            break;
+        case Record::RSTEP_BEGIN: // Step begins
+        case Record::RSTEP_END: // Step ends
+        case Record::RSTEP: // Step
+            r.label = AdvancedTimer::IdStep::IdFactory::getName(r.id);
+            if (r.obj != 0 || (!AdvancedTimer::IdObj::IdFactory::getName(r.obj).empty() && AdvancedTimer::IdObj::IdFactory::getName(r.obj) != "0")) {
+                r.label += " (" + AdvancedTimer::IdObj::IdFactory::getName(r.obj) + ")";
+            }
+            break;
+        case Record::RVAL_SET: // Sets a value
+        case Record::RVAL_ADD: // Adds a value
+            r.label = AdvancedTimer::IdVal::IdFactory::getName(r.id);
+            break;
+        default:
+            r.label = "Unknown";
+            break;
+    }
+}
+
 helper::vector<Record> AdvancedTimer::getRecords(IdTimer id)
 {
     TimerData& data = timers[id];
-    for (Record & r : data.records) {
-        switch (r.type) {
-            case Record::RBEGIN: // Timer begins
-            case Record::REND: // Timer ends
-                r.label = IdTimer::IdFactory::getName(r.id);
-                if (r.obj != 0 || (!IdObj::IdFactory::getName(r.obj).empty() && IdObj::IdFactory::getName(r.obj) != "0")) {
-                    r.label += " (" + IdObj::IdFactory::getName(r.obj) + ")";
-                }
-                break;
-            case Record::RSTEP_BEGIN: // Step begins
-            case Record::RSTEP_END: // Step ends
-            case Record::RSTEP: // Step
-                r.label = IdStep::IdFactory::getName(r.id);
-                if (r.obj != 0 || (!IdObj::IdFactory::getName(r.obj).empty() && IdObj::IdFactory::getName(r.obj) != "0")) {
-                    r.label += " (" + IdObj::IdFactory::getName(r.obj) + ")";
-                }
-                break;
-            case Record::RVAL_SET: // Sets a value
-            case Record::RVAL_ADD: // Adds a value
-                r.label = IdVal::IdFactory::getName(r.id);
-                break;
-            default:
-                r.label = "Unknown";
-                break;
-        }
-    }
+    for (Record & r : data.records)
+        setRecordLabel(r);
 
     return data.records;
 }
 
+helper::vector<Record> AdvancedTimer::getThreadRecords(IdTimer id)
+{
+    TimerData& data = timers[id];
+    for (Record & r : data.threadRecords)
+        setRecordLabel(r);
+
+    return data.threadRecords;
+}
+
 void AdvancedTimer::clearData(IdTimer id)
 {
     TimerData& data = timers[id];
@@ -1480,6 +1767,7 @@ std::string AdvancedTimer::getTimeAnalysis(IdTimer id, simulation::Node* node)
         curRecords->push_back(r);
 
         TimerData& data = timers[curTimer.top()];
+        collectThreadRecords(&data.threadRecords);
         data.process();
         if (data.nbIter == data.interval)
         {
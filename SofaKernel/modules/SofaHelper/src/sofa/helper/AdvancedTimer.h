@@ -25,8 +25,11 @@
 #include <sofa/simulation/Simulation.h>
 #include <sofa/helper/system/thread/thread_specific_ptr.h>
 
+#include <atomic>
 #include <iostream>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 
@@ -78,6 +81,13 @@ namespace helper
   * When reloading/reseting the simulation:
     AdvancedTimer::clear();
 
+  * In code called very often, the id of a step can be interned once per call site:
+    AdvancedTimer::stepBegin(SOFA_ADVANCEDTIMER_STEP_ID("ComputeForce"));
+
+  The records of the threads which do not run the timer (i.e. TaskScheduler workers)
+  are stored in per-thread ring buffers while the timer is active, and are gathered
+  when the timer ends. They are available with AdvancedTimer::getThreadRecords().
+
 
   The produced stats will looks like:
 
@@ -130,7 +140,8 @@ public:
     unsigned int id;
     unsigned int obj;
     double val;
-    Record() : type(RNONE), id(0), obj(0), val(0) {}
+    unsigned int thread; ///< 0 for the thread running the timer, otherwise the index of the recording thread
+    Record() : type(RNONE), id(0), obj(0), val(0), thread(0) {}
 };
 
 class StepData
@@ -165,64 +176,29 @@ public:
             /// the list of the id names. the Ids are the indices in the vector
             std::vector<std::string> idsList;
 
-            IdFactory()
-            {
-                idsList.push_back(std::string("0")); // ID 0 == "0" or empty string
-            }
-            
+            /// index of the ids by name, so that finding an id does not depend on the number of ids
+            std::unordered_map<std::string, unsigned int> idsMap;
+
+            /// the ids are shared by all the threads, so that the records of all threads can be merged
+            std::shared_mutex mutex;
+
+            IdFactory();
+
         public:
-            
+
             /**
                @return the Id corresponding to the name of the id given in parameter
                If the name isn't found in the list, it is added to it and return the new id.
             */
-            static unsigned int getID(const std::string& name)
-            {
-                if (name.empty())
-                    return 0;
-                IdFactory& idfac = getInstance();
-                std::vector<std::string>::iterator it = idfac.idsList.begin();
-                unsigned int i = 0;
-
-                while (it != idfac.idsList.end() && (*it) != name)
-                {
-                    ++it;
-                    i++;
-                }
-
-                if (it!=idfac.idsList.end())
-                    return i;
-                else
-                {
-                    idfac.idsList.push_back(name);
-                    return i;
-                }
-            }
-
-            static std::size_t getLastID()
-            {
-                return getInstance().idsList.size()-1;
-            }
+            static unsigned int getID(const std::string& name);
+
+            static std::size_t getLastID();
 
             /// return the name corresponding to the id in parameter
-            static std::string getName(unsigned int id)
-            {
-                if (id < getInstance().idsList.size())
-                    return getInstance().idsList[id];
-                else
-                    return "";
-            }
+            static std::string getName(unsigned int id);
 
             /// return the instance of the factory. Creates it if doesn't exist yet.
-            static IdFactory& getInstance()
-            {
-                SOFA_THREAD_SPECIFIC_PTR(IdFactory, instance);
-                if (instance == nullptr)
-                {
-                    instance = new IdFactory;
-                }
-                return *instance;
-            }
+            static IdFactory& getInstance();
         };
 
         Id() : id(0) {}
@@ -293,7 +269,8 @@ public:
         STDOUT,
         LJSON,
         JSON,
-        GUI
+        GUI,
+        TRACE
     };
 
 
@@ -323,6 +300,25 @@ public:
 	 */
 	static AdvancedTimer::outputType getOutputType(IdTimer id);
 
+    /**
+     * @brief setTraceOutput Stream the records of the given AdvancedTimer to a file in the Chrome
+     * trace-event format (viewable in chrome://tracing or https://ui.perfetto.dev), with one lane per
+     * recording thread. It sets the output type to "trace" and enables the timer.
+     * @param id IdTimer, id of the timer
+     * @param filename std::string, trace file to write
+     * @param firstStep unsigned int, number of executions of the timer to skip before writing
+     * @param nbSteps unsigned int, number of executions to write (0 means until the trace is closed)
+     * @param maxEvents std::size_t, the trace is closed once this number of events is written
+     **/
+    static void setTraceOutput(IdTimer id, const std::string& filename, unsigned int firstStep = 0,
+                               unsigned int nbSteps = 0, std::size_t maxEvents = 1000000);
+
+    /**
+     * @brief closeTraceOutput Terminate the trace file of the given AdvancedTimer and go back to the "stdout" output.
+     * @param id IdTimer, id of the timer
+     **/
+    static void closeTraceOutput(IdTimer id);
+
 
     /**
      * @brief getTimeAnalysis Return the result of the AdvancedTimer
@@ -377,6 +373,10 @@ public:
 
     static bool isActive();
 
+    /// true when a timer records on any thread. This is checked inline by the scoped helpers
+    /// so that the timer costs almost nothing when it is disabled.
+    static bool isRecording() { return s_activeTimers.load(std::memory_order_relaxed) != 0; }
+
     class TimerVar
     {
     public:
@@ -458,7 +458,8 @@ public:
         }
         StepVar(const char* idStr) : idStr(idStr), objStr(nullptr)
         {
-            stepBegin(idStr);
+            if (isRecording())
+                stepBegin(idStr);
         }
         StepVar(IdStep id, IdObj obj) : id(id), idStr(nullptr), obj(obj), objStr(nullptr)
         {
@@ -466,7 +467,8 @@ public:
         }
         StepVar(const char* idStr, const char* objStr) : idStr(idStr), objStr(objStr)
         {
-            stepBegin(idStr, objStr);
+            if (isRecording())
+                stepBegin(idStr, objStr);
         }
         template<class T>
         StepVar(IdStep id, T* obj) : id(id), idStr(nullptr), obj(IdObj(obj->getName())), objStr(nullptr)
@@ -480,6 +482,8 @@ public:
         }
         ~StepVar()
         {
+            if (!isRecording())
+                return;
             if (obj)
                 stepEnd(id, obj);
             else if (id)
@@ -501,8 +505,25 @@ public:
     typedef void (*SyncCallBack)(void* userData);
     static std::pair<SyncCallBack,void*> setSyncCallBack(SyncCallBack cb, void* userData = nullptr);
 
+    /**
+     * @brief getThreadRecords the records of the other threads during the last execution of the timer
+     * @param id IdTimer, id of the timer
+     * @return The records of each thread, in chronological order for each thread
+     */
+    static helper::vector<Record> getThreadRecords(IdTimer id);
+
+protected:
+    /// number of threads with an active timer
+    static std::atomic<int> s_activeTimers;
+
+    friend void setCurRecords(helper::vector<Record>* ptr);
+
 };
 
+/// Step id created once per call site, avoiding the lookup of the name at each call
+#define SOFA_ADVANCEDTIMER_STEP_ID(name) \
+    ([]() -> const sofa::helper::AdvancedTimer::IdStep& { static const sofa::helper::AdvancedTimer::IdStep stepId(name); return stepId; }())
+
 #if  !defined(SOFA_HELPER_ADVANCEDTIMER_CPP)
 extern template class SOFA_HELPER_API AdvancedTimer::Id<AdvancedTimer::Timer>;
 extern template class SOFA_HELPER_API AdvancedTimer::Id<AdvancedTimer::Step>;
@@ -525,12 +546,14 @@ struct ScopedAdvancedTimer {
     ScopedAdvancedTimer( const char* message )
     : message( message )
     {
-        AdvancedTimer::stepBegin( message );
+        if (AdvancedTimer::isRecording())
+            AdvancedTimer::stepBegin( message );
     }
 
     ~ScopedAdvancedTimer()
     {
-        AdvancedTimer::stepEnd( message );
+        if (AdvancedTimer::isRecording())
+            AdvancedTimer::stepEnd( message );
     }
 };
 
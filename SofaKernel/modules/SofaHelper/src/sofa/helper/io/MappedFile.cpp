@@ -0,0 +1,152 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/helper/io/MappedFile.h>
+
+#include <fstream>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sofa
+{
+
+namespace helper
+{
+
+namespace io
+{
+
+MappedFile::MappedFile()
+    : m_data(nullptr), m_size(0), m_isOpen(false), m_mapping(nullptr)
+{
+}
+
+MappedFile::MappedFile(const std::string& fileName)
+    : MappedFile()
+{
+    open(fileName);
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string& fileName)
+{
+    close();
+
+#ifdef WIN32
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping != nullptr)
+            {
+                m_mapping = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                CloseHandle(mapping); // the view keeps the mapping alive
+                if (m_mapping != nullptr)
+                    m_size = std::size_t(size.QuadPart);
+            }
+        }
+        CloseHandle(file);
+    }
+#else
+    const int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+        {
+            void* mapping = mmap(nullptr, std::size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED)
+            {
+                madvise(mapping, std::size_t(st.st_size), MADV_SEQUENTIAL);
+                m_mapping = mapping;
+                m_size = std::size_t(st.st_size);
+            }
+        }
+        ::close(fd); // the mapping stays valid
+    }
+#endif
+
+    if (m_mapping != nullptr)
+    {
+        m_data = static_cast<const char*>(m_mapping);
+        m_isOpen = true;
+        return true;
+    }
+
+    // empty file, or the file can't be mapped: read it
+    std::ifstream file(fileName, std::ios::in | std::ios::binary);
+    if (!file.good())
+        return false;
+    file.seekg(0, std::ios::end);
+    const std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (size > 0)
+    {
+        m_buffer.resize(std::size_t(size));
+        file.read(m_buffer.data(), size);
+        if (!file)
+        {
+            m_buffer.clear();
+            return false;
+        }
+    }
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+    m_isOpen = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (m_mapping != nullptr)
+    {
+#ifdef WIN32
+        UnmapViewOfFile(m_mapping);
+#else
+        munmap(m_mapping, m_size);
+#endif
+        m_mapping = nullptr;
+    }
+    std::vector<char>().swap(m_buffer);
+    m_data = nullptr;
+    m_size = 0;
+    m_isOpen = false;
+}
+
+} // namespace io
+
+} // namespace helper
+
+} // namespace sofa
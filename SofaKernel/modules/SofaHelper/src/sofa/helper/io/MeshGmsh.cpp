@@ -21,12 +21,14 @@
 ******************************************************************************/
 #include <sofa/helper/io/File.h>
 #include <sofa/helper/io/MeshGmsh.h>
+#include <sofa/helper/io/MappedFile.h>
+#include <sofa/helper/io/TextParsing.h>
 #include <sofa/helper/system/FileRepository.h>
 #include <sofa/helper/system/SetDirectory.h>
 #include <sofa/helper/system/Locale.h>
 #include <sofa/helper/logging/Messaging.h>
-#include <istream>
-#include <fstream>
+#include <set>
+#include <sstream>
 #include <string>
 
 namespace sofa
@@ -52,44 +54,40 @@ void MeshGmsh::init (std::string filename)
     }
     loaderType = "gmsh";
 
-    std::ifstream file(filename);
-    if (!file.good()) return;
+    MappedFile file(filename);
+    if (!file.isOpen()) return;
 
+    const char* p = file.begin();
+    const char* end = file.end();
     unsigned int gmshFormat = 0;
-    std::string cmd;
 
     // -- Looking for Gmsh version of this file.
-    std::getline(file, cmd); //Version
-    std::istringstream versionReader(cmd);
-    std::string version;
-    versionReader >> version;
-    if (version == "$MeshFormat") // Reading gmsh 2.0 file
+    std::string cmd = readToken(p, end); //Version
+    if (cmd == "$MeshFormat") // Reading gmsh 2.0 file
     {
         gmshFormat = 2;
-        std::string line;
-        std::getline(file, line); // we don't nedd this line
-        std::getline(file, cmd);
-        std::istringstream endMeshReader(cmd);
-        std::string endMesh;
-        endMeshReader >> endMesh;
-
-        if (endMesh != std::string("$EndMeshFormat")) // it should end with $EndMeshFormat
-        {
-            file.close();
+        p = text::skipLine(p, end); // end of the version line
+        p = text::skipLine(p, end); // we don't need this line
+        if (readToken(p, end) != "$EndMeshFormat") // it should end with $EndMeshFormat
             return;
-        }
-        else
-        {
-            std::getline(file, cmd); // First Command
-        }
+        cmd = readToken(p, end); // First Command
     }
     else
     {
         gmshFormat = 1;
     }
+    p = text::skipLine(p, end);
+
+    readGmsh(p, end, gmshFormat);
+}
+
 
-    readGmsh(file, gmshFormat);
-    file.close();
+std::string MeshGmsh::readToken(const char*& p, const char* end)
+{
+    if (p == nullptr) return std::string();
+    const char* token = text::skipSpaces(p, end);
+    p = text::skipToken(token, end);
+    return std::string(token, p);
 }
 
 
@@ -119,8 +117,17 @@ void MeshGmsh::normalizeGroup(helper::vector< sofa::core::loader::PrimitiveGroup
 }
 
 
-bool MeshGmsh::readGmsh(std::ifstream &file, const unsigned int gmshFormat)
+bool MeshGmsh::readGmsh(const char* p, const char* end, const unsigned int gmshFormat)
 {
+    // read an integer, a missing or invalid number reads as 0 (and the next reads fail)
+    int value = 0;
+    auto readInt = [&]() -> int
+    {
+        const char* next = p ? text::readNumber(p, end, value) : nullptr;
+        p = next;
+        return next ? value : 0;
+    };
+
     int npoints = 0;
     int nlines = 0;
     int ntris = 0;
@@ -131,20 +138,29 @@ bool MeshGmsh::readGmsh(std::ifstream &file, const unsigned int gmshFormat)
     std::string cmd;
 
     // --- Loading Vertices ---
-    file >> npoints; //nb points
+    npoints = readInt(); //nb points
 
     std::vector<int> pmap; // map for reordering vertices possibly not well sorted
-    for (int i = 0; i<npoints; ++i)
+    m_vertices.reserve(npoints > 0 ? npoints : 0);
+    for (int i = 0; i<npoints && p; ++i)
     {
-        int index = i;
-        double x, y, z;
-        file >> index >> x >> y >> z;
+        int index = readInt();
+        double x = 0, y = 0, z = 0;
+        if (p) p = text::readNumber(p, end, x);
+        if (p) p = text::readNumber(p, end, y);
+        if (p) p = text::readNumber(p, end, z);
+        if (!p)
+        {
+            msg_error("MeshGmsh") << "Invalid node " << i << ", " << npoints << " nodes expected.";
+            return false;
+        }
         m_vertices.push_back(sofa::defaulttype::Vector3(x, y, z));
+        if (index < 0) index = 0;
         if ((int)pmap.size() <= index) pmap.resize(index + 1);
         pmap[index] = i; // In case of hole or swit
     }
-    
-    file >> cmd;
+
+    cmd = readToken(p, end);
     if (cmd != "$ENDNOD" && cmd != "$EndNodes")
     {
         msg_error("MeshGmsh") << "'$ENDNOD' or '$EndNodes' expected, found '" << cmd << "'";
@@ -152,15 +168,14 @@ bool MeshGmsh::readGmsh(std::ifstream &file, const unsigned int gmshFormat)
     }
 
     // --- Loading Elements ---
-    file >> cmd;
+    cmd = readToken(p, end);
     if (cmd != "$ELM" && cmd != "$Elements")
     {
         msg_error("MeshGmsh") << "'$ELM' or '$Elements' expected, found '" << cmd << "'";
         return false;
     }
 
-    int nelems = 0;
-    file >> nelems;
+    int nelems = readInt();
 
     for (int i = 0; i<nelems; ++i) // for each elem
     {
@@ -169,18 +184,23 @@ bool MeshGmsh::readGmsh(std::ifstream &file, const unsigned int gmshFormat)
         {
             // version 1.0 format is
             // elm-number elm-type reg-phys reg-elem number-of-nodes <node-number-list ...>
-            int rphys = -1, relem = -1;
-            file >> index >> etype >> rphys >> relem >> nnodes;
+            index = readInt();
+            etype = readInt();
+            readInt(); // reg-phys
+            readInt(); // reg-elem
+            nnodes = readInt();
         }
         else /*if (gmshFormat == 2)*/
         {
             // version 2.0 format is
             // elm-number elm-type number-of-tags < tag > ... node-number-list
-            file >> index >> etype >> ntags;
+            index = readInt();
+            etype = readInt();
+            ntags = readInt();
 
             for (int t = 0; t<ntags; t++)
             {
-                file >> tag;
+                tag = readInt();
                 // read the tag but don't use it
             }
 
@@ -227,8 +247,7 @@ bool MeshGmsh::readGmsh(std::ifstream &file, const unsigned int gmshFormat)
         size_t j;
         for (int n = 0; n<nnodes; ++n)
         {
-            int t = 0;
-            file >> t;
+            const int t = readInt();
             nodes[n] = (((unsigned int)t)<pmap.size()) ? pmap[t] : 0;
         }
 
@@ -322,8 +341,12 @@ bool MeshGmsh::readGmsh(std::ifstream &file, const unsigned int gmshFormat)
             break;
         default:
             //if the type is not handled, skip rest of the line
-            std::string tmp;
-            std::getline(file, tmp);
+            if (p) p = text::skipLine(p, end);
+        }
+        if (!p)
+        {
+            msg_error("MeshGmsh") << "Invalid element " << i << ", " << nelems << " elements expected.";
+            return false;
         }
     }
 
@@ -332,7 +355,7 @@ bool MeshGmsh::readGmsh(std::ifstream &file, const unsigned int gmshFormat)
     normalizeGroup(m_tetrahedraGroups);
     normalizeGroup(m_hexahedraGroups);
 
-    file >> cmd;
+    cmd = readToken(p, end);
     if (cmd != "$ENDELM" && cmd != "$EndElements")
     {
         msg_error("MeshGmsh") << "'$ENDELM' or '$EndElements' expected, found '" << cmd << "'";
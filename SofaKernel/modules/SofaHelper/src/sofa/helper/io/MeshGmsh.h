@@ -23,7 +23,7 @@
 #define SOFA_HELPER_IO_MESHGMSH_H
 
 #include <sofa/helper/io/Mesh.h>
-#include <istream>
+#include <string>
 
 namespace sofa
 {
@@ -47,7 +47,11 @@ public:
 
 protected:
 
-    bool readGmsh(std::ifstream &file, const unsigned int gmshFormat);
+    /// read the nodes and the elements of the file content [p, end), p being after the $Nodes (or $NOD) line
+    bool readGmsh(const char* p, const char* end, const unsigned int gmshFormat);
+
+    /// read the token following p, and move p after it
+    static std::string readToken(const char*& p, const char* end);
 
     void addInGroup(helper::vector< sofa::core::loader::PrimitiveGroup>& group, int tag, int eid);
 
@@ -0,0 +1,221 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#ifndef SOFA_HELPER_IO_TEXTPARSING_H
+#define SOFA_HELPER_IO_TEXTPARSING_H
+
+#include <sofa/helper/config.h>
+
+#include <charconv>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <streambuf>
+#include <type_traits>
+#include <vector>
+
+namespace sofa
+{
+
+namespace helper
+{
+
+namespace io
+{
+
+/// Fast parsing of the text files loaded in memory (e.g. with a MappedFile).
+///
+/// The functions work on [p, end) ranges which don't need to be null-terminated, and
+/// return the position after what they read. The numbers are parsed with std::from_chars:
+/// unlike the streams, they don't depend on the locale and don't allocate.
+namespace text
+{
+
+inline bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+inline bool isSpace(char c) { return isBlank(c) || c == '\n'; }
+
+/// skip the spaces on the current line
+inline const char* skipBlanks(const char* p, const char* end)
+{
+    while (p < end && isBlank(*p)) ++p;
+    return p;
+}
+
+/// skip the spaces, including the line ends
+inline const char* skipSpaces(const char* p, const char* end)
+{
+    while (p < end && isSpace(*p)) ++p;
+    return p;
+}
+
+/// end of the current line (position of its '\n', or end)
+inline const char* findLineEnd(const char* p, const char* end)
+{
+    const void* eol = (p < end) ? std::memchr(p, '\n', std::size_t(end - p)) : nullptr;
+    return eol ? static_cast<const char*>(eol) : end;
+}
+
+/// beginning of the next line
+inline const char* skipLine(const char* p, const char* end)
+{
+    p = findLineEnd(p, end);
+    return p < end ? p + 1 : end;
+}
+
+/// end of the token starting at p
+inline const char* skipToken(const char* p, const char* end)
+{
+    while (p < end && !isSpace(*p)) ++p;
+    return p;
+}
+
+/// @brief Parse the number starting at p.
+/// @return the position after the number, or nullptr if p is not at a number.
+template<class T>
+inline const char* parseNumber(const char* p, const char* end, T& value)
+{
+    static_assert(std::is_arithmetic<T>::value, "parseNumber only parses arithmetic types");
+    if (p < end && *p == '+') ++p; // accepted by the streams, not by from_chars
+    if constexpr (std::is_integral<T>::value)
+    {
+        const std::from_chars_result r = std::from_chars(p, end, value);
+        return r.ec == std::errc() ? r.ptr : nullptr;
+    }
+    else
+    {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        const std::from_chars_result r = std::from_chars(p, end, value);
+        return r.ec == std::errc() ? r.ptr : nullptr;
+#else
+        // no floating point from_chars in this standard library: strtod on a null-terminated copy
+        char buffer[64];
+        const std::size_t length = std::min<std::size_t>(std::size_t(skipToken(p, end) - p), sizeof(buffer) - 1);
+        std::memcpy(buffer, p, length);
+        buffer[length] = '\0';
+        char* last = nullptr;
+        const double v = std::strtod(buffer, &last);
+        if (last == buffer) return nullptr;
+        value = T(v);
+        return p + (last - buffer);
+#endif
+    }
+}
+
+/// @brief Skip the spaces (including the line ends) and parse the following number.
+/// @return the position after the number, or nullptr if there is no number.
+template<class T>
+inline const char* readNumber(const char* p, const char* end, T& value)
+{
+    return parseNumber(skipSpaces(p, end), end, value);
+}
+
+/// @brief Split [begin, end) in nbBlocks ranges of whole lines, of similar sizes.
+/// @return the nbBlocks+1 boundaries of the ranges, some ranges may be empty.
+inline std::vector<const char*> splitLines(const char* begin, const char* end, std::size_t nbBlocks)
+{
+    std::vector<const char*> bounds(nbBlocks + 1, end);
+    bounds[0] = begin;
+    const std::size_t size = std::size_t(end - begin);
+    for (std::size_t i = 1; i < nbBlocks; ++i)
+    {
+        const char* p = begin + size * i / nbBlocks;
+        if (p < bounds[i - 1]) p = bounds[i - 1];
+        bounds[i] = (p == begin || p[-1] == '\n') ? p : skipLine(p, end);
+    }
+    return bounds;
+}
+
+/// Range of whole lines holding the tokens [first, first+count) of a list of tokens
+struct TokenBlock
+{
+    const char* begin;
+    const char* end;
+    std::size_t first;
+    std::size_t count;
+};
+
+/// @brief Find the lines holding the n tokens starting at begin, and split them in blocks
+/// of about blockSize tokens, to be parsed separately.
+/// The tokens of the last line after the n-th are ignored, as the streams reading line by line do.
+/// @return the beginning of the line following the n-th token, or nullptr if there are less than n tokens.
+inline const char* splitTokens(const char* begin, const char* end, std::size_t n, std::size_t blockSize,
+                               std::vector<TokenBlock>& blocks)
+{
+    blocks.clear();
+    std::size_t nbTokens = 0;
+    const char* p = begin;
+    TokenBlock block { begin, begin, 0, 0 };
+    while (nbTokens < n)
+    {
+        if (p >= end) return nullptr;
+        // count the tokens of the line
+        const char* eol = findLineEnd(p, end);
+        for (const char* c = skipBlanks(p, eol); c < eol && nbTokens < n; c = skipBlanks(skipToken(c, eol), eol))
+            ++nbTokens;
+        p = (eol < end) ? eol + 1 : end;
+        if (nbTokens - block.first >= blockSize || nbTokens == n)
+        {
+            block.end = p;
+            block.count = nbTokens - block.first;
+            blocks.push_back(block);
+            block = TokenBlock { p, p, nbTokens, 0 };
+        }
+    }
+    return p;
+}
+
+/// @brief Parse the count numbers of a TokenBlock into values.
+/// @return false if a token is not a number.
+template<class T>
+inline bool parseTokens(const TokenBlock& block, T* values)
+{
+    const char* p = block.begin;
+    for (std::size_t i = 0; i < block.count; ++i)
+    {
+        p = readNumber(p, block.end, values[i]);
+        if (p == nullptr) return false;
+    }
+    return true;
+}
+
+/// Stream buffer reading [begin, end) without copy, to use the stream operators on a part of the text.
+class StreamBuffer : public std::streambuf
+{
+public:
+    StreamBuffer(const char* begin, const char* end)
+    {
+        char* b = const_cast<char*>(begin); // only read
+        setg(b, b, const_cast<char*>(end));
+    }
+
+    /// position of the next character to read
+    const char* position() const { return gptr(); }
+};
+
+} // namespace text
+
+} // namespace io
+
+} // namespace helper
+
+} // namespace sofa
+
+#endif // SOFA_HELPER_IO_TEXTPARSING_H
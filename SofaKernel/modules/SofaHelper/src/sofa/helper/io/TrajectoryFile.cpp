@@ -0,0 +1,631 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/helper/io/TrajectoryFile.h>
+#include <sofa/helper/logging/Messaging.h>
+
+#if SOFAHELPER_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+namespace sofa
+{
+
+namespace helper
+{
+
+namespace io
+{
+
+namespace
+{
+
+/// Layout of a trajectory file:
+///   FileHeader
+///   for each chunk: ChunkHeader, nbFrames FrameEntry, the (compressed) frames
+///   nbFrames index entries (time, chunk offset, frame offset), Trailer
+/// A frame is a FrameHeader followed by the values of the vectors set in its mask.
+const char fileMagic[8] = { 'S','O','F','A','T','R','A','J' };
+const char chunkMagic[4] = { 'C','H','N','K' };
+const char indexMagic[8] = { 'S','O','F','A','T','I','D','X' };
+const uint32_t fileVersion = 1;
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t scalarSize;
+    uint32_t dimensions[TrajectoryFrame::NbVectors];
+    uint32_t reserved[2];
+};
+
+struct ChunkHeader
+{
+    char magic[4];
+    uint32_t nbFrames;
+    uint64_t rawSize;
+    uint64_t storedSize;    ///< smaller than rawSize if the chunk is compressed
+};
+
+struct FrameEntry
+{
+    double time;
+    uint64_t offset;        ///< offset of the frame in the uncompressed chunk
+};
+
+struct FrameHeader
+{
+    uint32_t mask;
+    uint32_t reserved;
+    uint64_t nbElements;
+};
+
+struct Trailer
+{
+    uint64_t nbFrames;
+    uint64_t indexOffset;
+    char magic[8];
+};
+
+int seekFile(std::FILE* file, uint64_t offset, int origin = SEEK_SET)
+{
+#ifdef WIN32
+    return _fseeki64(file, (__int64)offset, origin);
+#else
+    return fseeko(file, (off_t)offset, origin);
+#endif
+}
+
+uint64_t tellFile(std::FILE* file)
+{
+#ifdef WIN32
+    return (uint64_t)_ftelli64(file);
+#else
+    return (uint64_t)ftello(file);
+#endif
+}
+
+template<class T>
+bool readStruct(std::FILE* file, T& value)
+{
+    return std::fread(&value, sizeof(T), 1, file) == 1;
+}
+
+template<class T>
+bool writeValues(std::FILE* file, const T* values, std::size_t count)
+{
+    return std::fwrite(values, sizeof(T), count, file) == count;
+}
+
+template<class Real>
+void encodeValues(const std::vector<SReal>& values, char* dest)
+{
+    Real* out = reinterpret_cast<Real*>(dest);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        out[i] = (Real)values[i];
+}
+
+template<class Real>
+void decodeValues(const char* src, std::size_t n, std::vector<SReal>& values)
+{
+    const Real* in = reinterpret_cast<const Real*>(src);
+    values.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+        values[i] = (SReal)in[i];
+}
+
+} // namespace
+
+
+//////////////////////////////// TrajectoryWriter ////////////////////////////////
+
+TrajectoryWriter::TrajectoryWriter()
+    : m_file(nullptr)
+    , m_dimensions{0, 0, 0, 0}
+    , m_writing(false)
+    , m_stop(false)
+    , m_failed(false)
+    , m_failureReported(false)
+{
+}
+
+TrajectoryWriter::~TrajectoryWriter()
+{
+    close();
+}
+
+bool TrajectoryWriter::hasCompression()
+{
+#if SOFAHELPER_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool TrajectoryWriter::open(const std::string& fileName, const unsigned int dimensions[TrajectoryFrame::NbVectors], const Options& options)
+{
+    close();
+
+    m_file = std::fopen(fileName.c_str(), "wb");
+    if (!m_file)
+    {
+        msg_error("TrajectoryWriter") << "Unable to create file " << fileName;
+        return false;
+    }
+
+    m_fileName = fileName;
+    m_options = options;
+    m_options.framesPerChunk = std::max(1u, m_options.framesPerChunk);
+    m_options.maxPendingChunks = std::max(1u, m_options.maxPendingChunks);
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version = fileVersion;
+    header.scalarSize = m_options.float32 ? sizeof(float) : sizeof(double);
+    for (unsigned int v = 0; v < TrajectoryFrame::NbVectors; ++v)
+        header.dimensions[v] = m_dimensions[v] = dimensions[v];
+    if (!writeValues(m_file, &header, 1))
+    {
+        msg_error("TrajectoryWriter") << "Unable to write the header of file " << fileName;
+        std::fclose(m_file);
+        m_file = nullptr;
+        return false;
+    }
+
+    m_index.clear();
+    m_chunk.clear();
+    m_stop = false;
+    m_writing = false;
+    m_failed = false;
+    m_failureReported = false;
+    if (m_options.asynchronous)
+        m_thread = std::thread(&TrajectoryWriter::run, this);
+    return true;
+}
+
+bool TrajectoryWriter::good()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_failed;
+}
+
+void TrajectoryWriter::reportFailure()
+{
+    if (m_failureReported || good()) return;
+    m_failureReported = true;
+    msg_error("TrajectoryWriter") << "Unable to write to file " << m_fileName << ", "
+                                  << m_index.size() << " frames are written, the next ones are dropped";
+}
+
+void TrajectoryWriter::addFrame(TrajectoryFrame& frame)
+{
+    if (!m_file) return;
+
+    for (unsigned int v = 0; v < TrajectoryFrame::NbVectors; ++v)
+    {
+        if (frame.has(TrajectoryFrame::Vector(v)) && frame.values[v].size() != frame.nbElements * m_dimensions[v])
+        {
+            msg_error("TrajectoryWriter") << "Invalid size of vector " << v << " at time " << frame.time
+                                          << ": " << frame.values[v].size() << " values instead of "
+                                          << frame.nbElements * m_dimensions[v] << ", the frame is not written";
+            return;
+        }
+    }
+
+    m_chunk.emplace_back();
+    std::swap(m_chunk.back(), frame);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_freeFrames.empty())
+        {
+            std::swap(frame, m_freeFrames.back());
+            m_freeFrames.pop_back();
+        }
+    }
+
+    if (m_chunk.size() >= m_options.framesPerChunk)
+        pushChunk();
+}
+
+void TrajectoryWriter::pushChunk()
+{
+    if (m_chunk.empty()) return;
+
+    if (!m_options.asynchronous)
+    {
+        if (good() && !writeChunk(m_chunk))
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_failed = true;
+        }
+        m_freeFrames.swap(m_chunk);
+        m_chunk.clear();
+        reportFailure();
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this]() { return m_pendingChunks.size() < m_options.maxPendingChunks; });
+        m_pendingChunks.push_back(std::move(m_chunk));
+        m_chunk.clear();
+        m_condition.notify_all();
+    }
+    reportFailure();
+}
+
+void TrajectoryWriter::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_condition.wait(lock, [this]() { return m_stop || !m_pendingChunks.empty(); });
+        if (m_pendingChunks.empty())
+            break;
+
+        std::vector<TrajectoryFrame> frames = std::move(m_pendingChunks.front());
+        m_pendingChunks.pop_front();
+        m_writing = true;
+        m_condition.notify_all();
+
+        // after a failure, the next chunks are dropped so that the file keeps only complete chunks
+        const bool failed = m_failed;
+        lock.unlock();
+        const bool written = !failed && writeChunk(frames);
+        lock.lock();
+
+        m_failed = !written;
+        m_writing = false;
+        // keep the buffers of one chunk to be reused by the next frames
+        if (m_freeFrames.size() < m_options.framesPerChunk)
+            m_freeFrames.swap(frames);
+        m_condition.notify_all();
+    }
+}
+
+bool TrajectoryWriter::writeChunk(std::vector<TrajectoryFrame>& frames)
+{
+    const std::size_t scalarSize = m_options.float32 ? sizeof(float) : sizeof(double);
+
+    std::vector<FrameEntry> entries(frames.size());
+    std::size_t rawSize = 0;
+    for (std::size_t f = 0; f < frames.size(); ++f)
+    {
+        entries[f].time = frames[f].time;
+        entries[f].offset = rawSize;
+        rawSize += sizeof(FrameHeader);
+        for (unsigned int v = 0; v < TrajectoryFrame::NbVectors; ++v)
+            rawSize += frames[f].values[v].size() * scalarSize;
+    }
+
+    m_raw.resize(rawSize);
+    for (std::size_t f = 0; f < frames.size(); ++f)
+    {
+        const TrajectoryFrame& frame = frames[f];
+        char* out = m_raw.data() + entries[f].offset;
+
+        FrameHeader header;
+        header.mask = 0;
+        header.reserved = 0;
+        header.nbElements = frame.nbElements;
+        for (unsigned int v = 0; v < TrajectoryFrame::NbVectors; ++v)
+            if (frame.has(TrajectoryFrame::Vector(v)))
+                header.mask |= (1u << v);
+        std::memcpy(out, &header, sizeof(header));
+        out += sizeof(header);
+
+        for (unsigned int v = 0; v < TrajectoryFrame::NbVectors; ++v)
+        {
+            if (m_options.float32)
+                encodeValues<float>(frame.values[v], out);
+            else
+                encodeValues<double>(frame.values[v], out);
+            out += frame.values[v].size() * scalarSize;
+        }
+    }
+
+    const char* stored = m_raw.data();
+    std::size_t storedSize = rawSize;
+#if SOFAHELPER_HAVE_ZLIB
+    if (m_options.compress)
+    {
+        uLongf compressedSize = compressBound((uLong)rawSize);
+        m_stored.resize(compressedSize);
+        if (compress2((Bytef*)m_stored.data(), &compressedSize, (const Bytef*)m_raw.data(), (uLong)rawSize, Z_BEST_SPEED) == Z_OK
+                && compressedSize < rawSize)
+        {
+            stored = m_stored.data();
+            storedSize = compressedSize;
+        }
+    }
+#endif
+
+    ChunkHeader header;
+    std::memcpy(header.magic, chunkMagic, sizeof(chunkMagic));
+    header.nbFrames = (uint32_t)frames.size();
+    header.rawSize = rawSize;
+    header.storedSize = storedSize;
+
+    const uint64_t chunkOffset = tellFile(m_file);
+    // only complete chunks are on the disk if the application stops
+    if (!writeValues(m_file, &header, 1)
+            || !writeValues(m_file, entries.data(), entries.size())
+            || !writeValues(m_file, stored, storedSize)
+            || std::fflush(m_file) != 0)
+        return false;
+
+    for (const FrameEntry& e : entries)
+        m_index.push_back({ e.time, chunkOffset, e.offset });
+    return true;
+}
+
+void TrajectoryWriter::flush()
+{
+    if (!m_file) return;
+    pushChunk();
+    if (m_options.asynchronous)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this]() { return m_pendingChunks.empty() && !m_writing; });
+    }
+    reportFailure();
+}
+
+void TrajectoryWriter::close()
+{
+    if (!m_file) return;
+
+    pushChunk();
+    if (m_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_condition.notify_all();
+        m_thread.join();
+    }
+
+    Trailer trailer;
+    trailer.nbFrames = m_index.size();
+    trailer.indexOffset = tellFile(m_file);
+    std::memcpy(trailer.magic, indexMagic, sizeof(indexMagic));
+    reportFailure();
+    // without index, the reader rebuilds it from the complete chunks
+    const bool indexWritten = writeValues(m_file, m_index.data(), m_index.size())
+            && writeValues(m_file, &trailer, 1);
+    if (std::fclose(m_file) != 0 || !indexWritten)
+        msg_error("TrajectoryWriter") << "Unable to write the index of file " << m_fileName;
+
+    m_file = nullptr;
+    m_index.clear();
+    m_freeFrames.clear();
+    m_raw.clear();
+    m_stored.clear();
+}
+
+
+//////////////////////////////// TrajectoryReader ////////////////////////////////
+
+TrajectoryReader::TrajectoryReader()
+    : m_file(nullptr)
+    , m_scalarSize(0)
+    , m_dimensions{0, 0, 0, 0}
+    , m_chunkOffset(0)
+{
+}
+
+TrajectoryReader::~TrajectoryReader()
+{
+    close();
+}
+
+bool TrajectoryReader::isTrajectoryFile(const std::string& fileName)
+{
+    std::FILE* file = std::fopen(fileName.c_str(), "rb");
+    if (!file) return false;
+    char magic[sizeof(fileMagic)];
+    const bool valid = std::fread(magic, sizeof(magic), 1, file) == 1
+            && std::memcmp(magic, fileMagic, sizeof(fileMagic)) == 0;
+    std::fclose(file);
+    return valid;
+}
+
+bool TrajectoryReader::open(const std::string& fileName)
+{
+    close();
+
+    m_file = std::fopen(fileName.c_str(), "rb");
+    if (!m_file)
+        return false;
+
+    FileHeader header;
+    if (!readStruct(m_file, header) || std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0
+            || header.version != fileVersion
+            || (header.scalarSize != sizeof(float) && header.scalarSize != sizeof(double)))
+    {
+        msg_error("TrajectoryReader") << "Invalid trajectory file " << fileName;
+        close();
+        return false;
+    }
+    m_scalarSize = header.scalarSize;
+    for (unsigned int v = 0; v < TrajectoryFrame::NbVectors; ++v)
+        m_dimensions[v] = header.dimensions[v];
+
+    if (!readIndex())
+    {
+        msg_warning("TrajectoryReader") << "The index of " << fileName << " is missing, the trajectory was not closed properly. "
+                                        << "Rebuilding it from the chunks.";
+        rebuildIndex();
+    }
+    return true;
+}
+
+void TrajectoryReader::close()
+{
+    if (m_file)
+        std::fclose(m_file);
+    m_file = nullptr;
+    m_index.clear();
+    m_chunkOffset = 0;
+    m_raw.clear();
+    m_stored.clear();
+}
+
+bool TrajectoryReader::readIndex()
+{
+    Trailer trailer;
+    if (seekFile(m_file, 0, SEEK_END) != 0) return false;
+    const uint64_t fileSize = tellFile(m_file);
+    if (fileSize < sizeof(FileHeader) + sizeof(Trailer)) return false;
+    if (seekFile(m_file, fileSize - sizeof(Trailer)) != 0 || !readStruct(m_file, trailer)) return false;
+    if (std::memcmp(trailer.magic, indexMagic, sizeof(indexMagic)) != 0
+            || trailer.indexOffset + trailer.nbFrames * sizeof(IndexEntry) + sizeof(Trailer) != fileSize)
+        return false;
+
+    m_index.resize(trailer.nbFrames);
+    if (seekFile(m_file, trailer.indexOffset) != 0
+            || std::fread(m_index.data(), sizeof(IndexEntry), m_index.size(), m_file) != m_index.size())
+    {
+        m_index.clear();
+        return false;
+    }
+    return true;
+}
+
+void TrajectoryReader::rebuildIndex()
+{
+    m_index.clear();
+    seekFile(m_file, 0, SEEK_END);
+    const uint64_t fileSize = tellFile(m_file);
+
+    uint64_t offset = sizeof(FileHeader);
+    std::vector<FrameEntry> entries;
+    while (offset + sizeof(ChunkHeader) <= fileSize)
+    {
+        ChunkHeader header;
+        if (seekFile(m_file, offset) != 0 || !readStruct(m_file, header)
+                || std::memcmp(header.magic, chunkMagic, sizeof(chunkMagic)) != 0)
+            break;
+        const uint64_t chunkEnd = offset + sizeof(ChunkHeader) + header.nbFrames * sizeof(FrameEntry) + header.storedSize;
+        if (chunkEnd > fileSize)
+            break; // truncated chunk
+
+        entries.resize(header.nbFrames);
+        if (std::fread(entries.data(), sizeof(FrameEntry), entries.size(), m_file) != entries.size())
+            break;
+        for (const FrameEntry& e : entries)
+            m_index.push_back({ e.time, offset, e.offset });
+        offset = chunkEnd;
+    }
+}
+
+int TrajectoryReader::findFrame(double time) const
+{
+    auto it = std::upper_bound(m_index.begin(), m_index.end(), time,
+                               [](double t, const IndexEntry& e) { return t < e.time; });
+    return (int)(it - m_index.begin()) - 1;
+}
+
+bool TrajectoryReader::loadChunk(uint64_t chunkOffset)
+{
+    if (chunkOffset == m_chunkOffset && !m_raw.empty())
+        return true;
+    m_chunkOffset = 0;
+
+    ChunkHeader header;
+    if (seekFile(m_file, chunkOffset) != 0 || !readStruct(m_file, header)
+            || seekFile(m_file, header.nbFrames * sizeof(FrameEntry), SEEK_CUR) != 0)
+        return false;
+
+    m_raw.resize(header.rawSize);
+    if (header.storedSize == header.rawSize)
+    {
+        if (std::fread(m_raw.data(), 1, m_raw.size(), m_file) != m_raw.size())
+            return false;
+    }
+    else
+    {
+#if SOFAHELPER_HAVE_ZLIB
+        m_stored.resize(header.storedSize);
+        if (std::fread(m_stored.data(), 1, m_stored.size(), m_file) != m_stored.size())
+            return false;
+        uLongf rawSize = (uLongf)header.rawSize;
+        if (uncompress((Bytef*)m_raw.data(), &rawSize, (const Bytef*)m_stored.data(), (uLong)m_stored.size()) != Z_OK
+                || rawSize != header.rawSize)
+            return false;
+#else
+        msg_error("TrajectoryReader") << "The trajectory is compressed, but SofaHelper was built without zlib";
+        return false;
+#endif
+    }
+    m_chunkOffset = chunkOffset;
+    return true;
+}
+
+bool TrajectoryReader::readFrame(std::size_t frame, TrajectoryFrame& result)
+{
+    if (!m_file || frame >= m_index.size()) return false;
+
+    const IndexEntry& entry = m_index[frame];
+    if (!loadChunk(entry.chunkOffset))
+    {
+        msg_error("TrajectoryReader") << "Unable to read the frame at time " << entry.time;
+        return false;
+    }
+
+    FrameHeader header;
+    if (entry.frameOffset + sizeof(FrameHeader) > m_raw.size())
+        return false;
+    std::memcpy(&header, m_raw.data() + entry.frameOffset, sizeof(header));
+
+    std::size_t offset = entry.frameOffset + sizeof(FrameHeader);
+    result.time = entry.time;
+    result.nbElements = header.nbElements;
+    for (unsigned int v = 0; v < TrajectoryFrame::NbVectors; ++v)
+    {
+        if (!(header.mask & (1u << v)))
+        {
+            result.values[v].clear();
+            continue;
+        }
+        const std::size_t n = header.nbElements * m_dimensions[v];
+        if (offset + n * m_scalarSize > m_raw.size())
+            return false;
+        if (m_scalarSize == sizeof(float))
+            decodeValues<float>(m_raw.data() + offset, n, result.values[v]);
+        else
+            decodeValues<double>(m_raw.data() + offset, n, result.values[v]);
+        offset += n * m_scalarSize;
+    }
+    return true;
+}
+
+} // namespace io
+
+} // namespace helper
+
+} // namespace sofa
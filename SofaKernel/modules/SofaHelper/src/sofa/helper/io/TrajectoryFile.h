@@ -0,0 +1,194 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#ifndef SOFA_HELPER_IO_TRAJECTORYFILE_H
+#define SOFA_HELPER_IO_TRAJECTORYFILE_H
+
+#include <sofa/helper/config.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sofa
+{
+
+namespace helper
+{
+
+namespace io
+{
+
+/// @brief State vectors of a mechanical object at a given time, stored in a trajectory file.
+///
+/// Each vector is stored as nbElements*dimension scalars, the vectors which are not
+/// recorded are left empty.
+struct SOFA_HELPER_API TrajectoryFrame
+{
+    enum Vector { Position = 0, RestPosition, Velocity, Force, NbVectors };
+
+    double time { 0 };
+    std::size_t nbElements { 0 };
+    std::vector<SReal> values[NbVectors];
+
+    bool has(Vector v) const { return !values[v].empty(); }
+};
+
+/// @brief Write a binary trajectory file.
+///
+/// The frames are grouped in chunks, each chunk being optionally compressed, and
+/// the file ends with an index of the frame times used by TrajectoryReader to
+/// seek any frame in O(log n). If the index is missing (e.g. the simulation crashed),
+/// the reader rebuilds it from the chunk headers.
+///
+/// In asynchronous mode, the chunks are converted, compressed and written by a
+/// separate thread: adding a frame only moves its buffers in the queue.
+class SOFA_HELPER_API TrajectoryWriter
+{
+public:
+    struct Options
+    {
+        bool float32 { false };             ///< store the values in single precision
+        bool compress { true };             ///< compress the chunks (if zlib is available)
+        unsigned int framesPerChunk { 16 };
+        bool asynchronous { true };         ///< write the chunks from a separate thread
+        unsigned int maxPendingChunks { 4 };///< adding a frame waits when this number of chunks are waiting to be written
+    };
+
+    TrajectoryWriter();
+    ~TrajectoryWriter();
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+    /// @brief Create the file.
+    /// @param dimensions number of scalars per element of each vector
+    bool open(const std::string& fileName, const unsigned int dimensions[TrajectoryFrame::NbVectors], const Options& options);
+    bool isOpen() const { return m_file != nullptr; }
+
+    /// Return false if writing to the file failed: the frames after the failure are not written.
+    bool good();
+
+    /// @brief Add a frame at the end of the trajectory.
+    /// The content of the frame is taken, and the frame is given back the buffers of an
+    /// already written frame, to be reused without reallocation.
+    void addFrame(TrajectoryFrame& frame);
+
+    /// @brief Write the current chunk, even if not full, and wait until all the chunks are written.
+    void flush();
+
+    /// @brief Write the remaining frames and the index, then close the file.
+    void close();
+
+    /// Return true if the chunks can be compressed in this build
+    static bool hasCompression();
+
+protected:
+    struct IndexEntry
+    {
+        double time;
+        uint64_t chunkOffset;
+        uint64_t frameOffset;
+    };
+
+    void pushChunk();
+    /// @return false if the chunk could not be completely written
+    bool writeChunk(std::vector<TrajectoryFrame>& frames);
+    void run();
+    /// Report a write failure once, from the thread adding the frames
+    void reportFailure();
+
+    std::FILE* m_file;
+    std::string m_fileName;
+    Options m_options;
+    unsigned int m_dimensions[TrajectoryFrame::NbVectors];
+    std::vector<TrajectoryFrame> m_chunk;
+    std::vector<IndexEntry> m_index;
+    std::vector<char> m_raw, m_stored;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque< std::vector<TrajectoryFrame> > m_pendingChunks;
+    std::vector<TrajectoryFrame> m_freeFrames;
+    bool m_writing;
+    bool m_stop;
+    bool m_failed;          ///< a write failed, protected by m_mutex
+    bool m_failureReported;
+};
+
+/// @brief Read a binary trajectory file written by TrajectoryWriter, with random access to the frames.
+class SOFA_HELPER_API TrajectoryReader
+{
+public:
+    TrajectoryReader();
+    ~TrajectoryReader();
+    TrajectoryReader(const TrajectoryReader&) = delete;
+    TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+
+    /// Return true if the file exists and starts with a trajectory header
+    static bool isTrajectoryFile(const std::string& fileName);
+
+    bool open(const std::string& fileName);
+    bool isOpen() const { return m_file != nullptr; }
+    void close();
+
+    std::size_t getNbFrames() const { return m_index.size(); }
+    double getFrameTime(std::size_t frame) const { return m_index[frame].time; }
+    unsigned int getDimension(TrajectoryFrame::Vector v) const { return m_dimensions[v]; }
+
+    /// Index of the last frame at or before the given time, -1 if the first frame is after it
+    int findFrame(double time) const;
+
+    /// Read the given frame, only decoding its chunk if it is not the last decoded one
+    bool readFrame(std::size_t frame, TrajectoryFrame& result);
+
+protected:
+    struct IndexEntry
+    {
+        double time;
+        uint64_t chunkOffset;
+        uint64_t frameOffset;
+    };
+
+    bool readIndex();
+    void rebuildIndex();
+    bool loadChunk(uint64_t chunkOffset);
+
+    std::FILE* m_file;
+    unsigned int m_scalarSize;
+    unsigned int m_dimensions[TrajectoryFrame::NbVectors];
+    std::vector<IndexEntry> m_index;
+    uint64_t m_chunkOffset;
+    std::vector<char> m_raw, m_stored;
+};
+
+} // namespace io
+
+} // namespace helper
+
+} // namespace sofa
+
+#endif
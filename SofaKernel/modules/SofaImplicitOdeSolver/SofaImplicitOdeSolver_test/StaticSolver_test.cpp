@@ -0,0 +1,110 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaTest/Sofa_test.h>
+#include <SceneCreator/SceneCreator.h>
+#include <SceneCreator/SceneUtils.h>
+#include <SofaImplicitOdeSolver/StaticSolver.h>
+#include <SofaBaseLinearSolver/CGLinearSolver.h>
+#include <SofaBaseMechanics/MechanicalObject.h>
+#include <SofaBoundaryCondition/FixedConstraint.h>
+
+#include <sofa/simulation/Simulation.h>
+
+#include <SofaTest/TestMessageHandler.h>
+
+
+namespace sofa {
+
+using namespace modeling;
+using namespace defaulttype;
+
+using sofa::component::projectiveconstraintset::FixedConstraint;
+using sofa::component::odesolver::StaticSolver;
+typedef component::linearsolver::CGLinearSolver<component::linearsolver::GraphScatteredMatrix, component::linearsolver::GraphScatteredVector> CGLinearSolver;
+
+
+/** Test the static solution of a mass-spring string composed of two particles in gravity, one is fixed,
+ * with the plain newton iterations and with the modified newton, line search and adaptive linear tolerance.
+ */
+struct StaticSolver_test : public Sofa_test<>
+{
+    /// Solve one static step and return the position of the free particle
+    Vec3d solveStatic(const std::map<std::string, std::string>& options, sofa::helper::vector<double>& residuals)
+    {
+        EXPECT_MSG_NOEMIT(Error) ;
+        simulation::Node::SPtr root = modeling::initSofa();
+
+        StaticSolver::SPtr staticSolver = addNew<StaticSolver>(root);
+        staticSolver->findData("newton_iterations")->read("20");
+        staticSolver->findData("correction_tolerance_threshold")->read("1e-10");
+        staticSolver->findData("residual_tolerance_threshold")->read("1e-8");
+        for (const auto& option : options)
+            staticSolver->findData(option.first)->read(option.second);
+
+        CGLinearSolver::SPtr linearSolver = addNew<CGLinearSolver>(root);
+        linearSolver->f_maxIter.setValue(25);
+        linearSolver->f_tolerance.setValue(1e-10);
+        linearSolver->f_smallDenominatorThreshold.setValue(1e-20);
+
+        simulation::Node::SPtr string = massSpringString(
+                    root,
+                    0,1,0,     // first particle position
+                    0,0,0,     // last  particle position
+                    2,      // number of particles
+                    2.0,    // total mass
+                    1000.0, // stiffness
+                    0.1     // damping ratio
+                    );
+        FixedConstraint<Vec3Types>::SPtr fixed = modeling::addNew<FixedConstraint<Vec3Types> >(string,"fixedConstraint");
+        fixed->addConstraint(0);
+
+        initScene(root);
+        sofa::simulation::getSimulation()->animate(root.get(),1.0);
+
+        const Vector x = getVector( core::VecId::position() );
+        residuals = dynamic_cast<core::objectmodel::Data<sofa::helper::vector<double> >*>(staticSolver->findData("residuals"))->getValue();
+        EXPECT_EQ(dynamic_cast<core::objectmodel::Data<sofa::helper::vector<double> >*>(staticSolver->findData("iteration_times"))->getValue().size() + 1,
+                  residuals.size());
+        EXPECT_EQ(linearSolver->f_tolerance.getValue(), 1e-10); // restored after the adaptive tolerances
+
+        sofa::simulation::getSimulation()->unload(root);
+        return Vec3d(x[3], x[4], x[5]);
+    }
+};
+
+TEST_F(StaticSolver_test, newtonVariantsReachTheEquilibrium)
+{
+    const Vec3d expected(0,-0.00981,0);
+    sofa::helper::vector<double> residuals;
+
+    const Vec3d newton = solveStatic({}, residuals);
+    EXPECT_LT(vectorMaxDiff(expected, newton), 1e-5);
+    ASSERT_GE(residuals.size(), 2u);
+    EXPECT_LT(residuals.back(), 1e-8);
+
+    const Vec3d modified = solveStatic({ {"modified_newton", "1"}, {"line_search", "1"}, {"eisenstat_walker", "1"} }, residuals);
+    EXPECT_LT(vectorMaxDiff(expected, modified), 1e-5);
+    ASSERT_GE(residuals.size(), 2u);
+    EXPECT_LT(residuals.back(), 1e-8);
+}
+
+}// namespace sofa
@@ -22,11 +22,16 @@
 
 #include <SofaImplicitOdeSolver/StaticSolver.h>
 #include <sofa/core/ObjectFactory.h>
+#include <sofa/core/behavior/LinearSolver.h>
 #include <sofa/helper/AdvancedTimer.h>
+#include <sofa/helper/system/thread/CTime.h>
 #include <sofa/simulation/MechanicalOperations.h>
 #include <sofa/simulation/VectorOperations.h>
 #include <sofa/simulation/PropagateEventVisitor.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace sofa
 {
 
@@ -58,7 +63,50 @@ StaticSolver::StaticSolver()
             false,
             "should_diverge_when_residual_is_growing",
             "Divergence criterion: The newton iterations will stop when the residual is greater than the one from the previous iteration."))
-{}
+    , d_modified_newton( initData(&d_modified_newton,
+            false,
+            "modified_newton",
+            "Modified newton: the tangent stiffness matrix (and its factorization) is reused between the iterations, "
+            "and only updated when the convergence stalls."))
+    , d_stall_ratio( initData(&d_stall_ratio,
+            (double) 0.5,
+            "stall_ratio",
+            "Modified newton: the tangent matrix is updated at the next iteration when |f - K(x)| was reduced by less than this ratio."))
+    , d_line_search( initData(&d_line_search,
+            false,
+            "line_search",
+            "Backtracking line search: the correction is halved until the residual's norm decreases enough."))
+    , d_line_search_iterations( initData(&d_line_search_iterations,
+            (unsigned) 5,
+            "line_search_iterations",
+            "Maximum number of halvings of the correction by the line search."))
+    , d_eisenstat_walker( initData(&d_eisenstat_walker,
+            false,
+            "eisenstat_walker",
+            "Adapt the tolerance of an iterative linear solver at each newton iteration (Eisenstat-Walker forcing terms). "
+            "The linear solver must have a 'tolerance' data, relative to the norm of the right-hand side."))
+    , d_max_forcing_term( initData(&d_max_forcing_term,
+            (double) 0.5,
+            "max_forcing_term",
+            "Largest tolerance given to the iterative linear solver by the Eisenstat-Walker forcing terms."))
+    , d_residuals( initData(&d_residuals,
+            "residuals",
+            "Output: residual's norm |f - K(x)| before the first and after each newton iteration of the last time step."))
+    , d_iteration_times( initData(&d_iteration_times,
+            "iteration_times",
+            "Output: duration in milliseconds of each newton iteration of the last time step."))
+    , d_nb_tangent_updates( initData(&d_nb_tangent_updates,
+            (unsigned) 0,
+            "nb_tangent_updates",
+            "Output: number of assemblies of the tangent matrix during the last time step."))
+{
+    d_residuals.setReadOnly(true);
+    d_residuals.setGroup("Stats");
+    d_iteration_times.setReadOnly(true);
+    d_iteration_times.setGroup("Stats");
+    d_nb_tangent_updates.setReadOnly(true);
+    d_nb_tangent_updates.setGroup("Stats");
+}
 
 void StaticSolver::parse(sofa::core::objectmodel::BaseObjectDescription* arg)
 {
@@ -104,6 +152,9 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, double dt, sofa::
 
     SOFA_UNUSED(dt);
 
+    using sofa::helper::system::thread::CTime;
+    using sofa::helper::system::thread::ctime_t;
+
     sofa::simulation::common::VectorOperations vop( params, this->getContext() );
     sofa::simulation::common::MechanicalOperations mop( params, this->getContext() );
 
@@ -112,26 +163,77 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, double dt, sofa::
     MultiVecDeriv force( &vop, sofa::core::VecDerivId::force() );
     dx.realloc( &vop, true );
 
+    const bool lineSearch = d_line_search.getValue();
+    if (lineSearch)
+        x_previous.realloc( &vop, false, true );
+
     // MO vector dx is not allocated by default, it will seg fault if the CG is used (dx is taken by default) with an IdentityMapping
     MultiVecDeriv tempdx(&vop, sofa::core::VecDerivId::dx() ); tempdx.realloc( &vop, true, true );
 
     // Set implicit param to true to trigger nonlinear stiffness matrix recomputation
     mop->setImplicit(true);
 
+    // The modified newton freezes the linear solver between the updates of the tangent matrix,
+    // the Eisenstat-Walker forcing terms drive its tolerance
+    sofa::core::objectmodel::BaseContext* context = this->getContext();
+    LinearSolver* linearSolver = context->get<LinearSolver>(context->getTags(), sofa::core::objectmodel::BaseContext::SearchDown);
+    const bool modifiedNewton = d_modified_newton.getValue() && linearSolver != nullptr;
+
+    Data<SReal>* linearTolerance = nullptr;
+    if (d_eisenstat_walker.getValue() && linearSolver != nullptr)
+    {
+        linearTolerance = dynamic_cast<Data<SReal>*>(linearSolver->findData("tolerance"));
+        msg_warning_when(linearTolerance == nullptr) << "The linear solver '" << linearSolver->getName()
+                                                     << "' has no tolerance: the Eisenstat-Walker forcing terms are ignored.";
+    }
+    const SReal initialTolerance = linearTolerance ? linearTolerance->getValue() : SReal(0);
+    double forcingTerm = d_max_forcing_term.getValue();
+
     msg_info() << "======= Starting static ODE solver in time step " << this->getTime();
     msg_info() << "(doing a maximum of " << d_newton_iterations.getValue() << " newton iterations)";
 
     unsigned n_it=0;
     double dx_norm = -1.0, f_norm;
+    unsigned nbTangentUpdates = 0;
+    bool updateTangent = true;
+
+    sofa::helper::WriteOnlyAccessor<Data<sofa::helper::vector<double> > > residuals = d_residuals;
+    sofa::helper::WriteOnlyAccessor<Data<sofa::helper::vector<double> > > iterationTimes = d_iteration_times;
+    residuals.clear();
+    iterationTimes.clear();
+    const double millisecondsPerTick = 1000.0 / (double) CTime::getTicksPerSec();
 
     sofa::helper::AdvancedTimer::stepBegin("StaticSolver::Solve");
 
+    // Apply the correction x += alpha dx, and compute the new residual's norm
+    auto applyCorrection = [&](double alpha) -> double
+    {
+        if (lineSearch)
+            x.eq(x_previous, dx, alpha);
+        else
+            x.eq(x_start, dx, 1);
+        mop.solveConstraint(x, sofa::core::ConstraintParams::POS);
+
+        // Propagate positions to mapped nodes: taken from AnimateVisitor::processNodeTopDown executed by the animation loop
+        // calls apply, applyJ
+        sofa::core::MechanicalParams mp;
+        sofa::simulation::MechanicalPropagateOnlyPositionAndVelocityVisitor(&mp).execute(
+            this->getContext()); // propagate the changes to mappings below
+
+        // Compute addForce, in mapped: addForce + applyJT (vec)
+        force.clear();
+        mop.computeForce(force);
+        mop.projectResponse(force);
+        return sqrt(force.dot(force));
+    };
+
     // compute addForce, in mapped: addForce + applyJT (vec)
     // Initial computation
     force.clear();
     mop.computeForce(force);
     mop.projectResponse(force);
     f_norm = sqrt(force.dot(force));
+    residuals.push_back(f_norm);
 
     if (d_residual_tolerance_threshold.getValue() > 0 && f_norm <= d_residual_tolerance_threshold.getValue()) {
         msg_info() << "The ODE has already reached an equilibrium state";
@@ -140,7 +242,20 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, double dt, sofa::
         while (n_it < d_newton_iterations.getValue()) {
             std::string stepname = "step_" + std::to_string(n_it);
             sofa::helper::AdvancedTimer::stepBegin(stepname.c_str());
+            const ctime_t iterationStart = CTime::getTime();
+
+            if (modifiedNewton)
+            {
+                if (updateTangent)
+                    linearSolver->unfreezeSystemMatrix();
+                else
+                    linearSolver->freezeSystemMatrix();
+            }
+            if (updateTangent || !modifiedNewton)
+                ++nbTangentUpdates;
 
+            if (linearTolerance)
+                linearTolerance->setValue(std::max(initialTolerance, (SReal) forcingTerm));
 
             // Assemble matrix, CG: does nothing
             // LDL non-mapped: addKToMatrix added to system matrix
@@ -152,29 +267,48 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, double dt, sofa::
             // for LDL: solves the system, everything's already assembled
             matrix.solve(dx, force);
 
-            x.eq(x_start, dx, 1);
-            mop.solveConstraint(x, sofa::core::ConstraintParams::POS);
-
-            // Propagate positions to mapped nodes: taken from AnimateVisitor::processNodeTopDown executed by the animation loop
-            // calls apply, applyJ
-            sofa::core::MechanicalParams mp;
-            sofa::simulation::MechanicalPropagateOnlyPositionAndVelocityVisitor(&mp).execute(
-                this->getContext()); // propagate the changes to mappings below
-
-            // Compute addForce, in mapped: addForce + applyJT (vec)
-            force.clear();
-            mop.computeForce(force);
-            mop.projectResponse(force);
-            double f_cur_norm = sqrt(force.dot(force));
-
-            dx_norm = sqrt(dx.dot(dx));
+            if (lineSearch)
+                x_previous.eq(x_start);
+
+            double alpha = 1.0;
+            double f_cur_norm = applyCorrection(alpha);
+
+            // Backtracking on the sufficient decrease of the residual's norm
+            if (lineSearch)
+            {
+                for (unsigned i = 0; i < d_line_search_iterations.getValue() && f_cur_norm > (1.0 - 1e-4 * alpha) * f_norm; ++i)
+                {
+                    alpha *= 0.5;
+                    f_cur_norm = applyCorrection(alpha);
+                }
+                msg_info_when(alpha < 1.0) << "Line search: the correction is scaled by " << alpha;
+            }
 
+            dx_norm = alpha * sqrt(dx.dot(dx));
 
             msg_info() << "Newton iteration #" << n_it << ": |f - K(x0 + dx)| = " << f_cur_norm << " |dx| = " << dx_norm;
             sofa::helper::AdvancedTimer::valSet("residual", f_cur_norm);
             sofa::helper::AdvancedTimer::valSet("correction", dx_norm);
             sofa::helper::AdvancedTimer::stepEnd(stepname.c_str());
 
+            residuals.push_back(f_cur_norm);
+            iterationTimes.push_back((CTime::getTime() - iterationStart) * millisecondsPerTick);
+
+            // The tangent matrix is updated again only when the reused one does not reduce the residual enough
+            if (modifiedNewton)
+                updateTangent = f_cur_norm > d_stall_ratio.getValue() * f_norm;
+
+            // Eisenstat-Walker forcing term (choice 2, with its safeguard)
+            if (linearTolerance && f_norm > 0)
+            {
+                const double gamma = 0.9;
+                const double ratio = f_cur_norm / f_norm;
+                double nextForcingTerm = gamma * ratio * ratio;
+                if (gamma * forcingTerm * forcingTerm > 0.1)
+                    nextForcingTerm = std::max(nextForcingTerm, gamma * forcingTerm * forcingTerm);
+                forcingTerm = std::min(nextForcingTerm, d_max_forcing_term.getValue());
+            }
+
             if (d_should_diverge_when_residual_is_growing.getValue() && f_cur_norm > f_norm && n_it>1) {
                 msg_info() << "[DIVERGED] residual's norm increased";
                 break;
@@ -198,6 +332,12 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, double dt, sofa::
         } // End while (n_it < d_newton_iterations.getValue())
     }
 
+    if (modifiedNewton)
+        linearSolver->unfreezeSystemMatrix();
+    if (linearTolerance)
+        linearTolerance->setValue(initialTolerance);
+    d_nb_tangent_updates.setValue(nbTangentUpdates);
+
     if (n_it >= d_newton_iterations.getValue()) {
         n_it--;
         msg_info() << "[DIVERGED] The number of Newton iterations reached the threshold of " << d_newton_iterations << " iterations";
@@ -206,6 +346,7 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, double dt, sofa::
     sofa::helper::AdvancedTimer::valSet("nb_iterations", n_it+1);
     sofa::helper::AdvancedTimer::valSet("residual", f_norm);
     sofa::helper::AdvancedTimer::valSet("correction", dx_norm);
+    sofa::helper::AdvancedTimer::valSet("nb_tangent_updates", nbTangentUpdates);
     sofa::helper::AdvancedTimer::stepEnd("StaticSolver::Solve");
 }
 
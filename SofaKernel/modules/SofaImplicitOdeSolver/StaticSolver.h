@@ -27,6 +27,7 @@
 #include <sofa/core/behavior/OdeSolver.h>
 #include <sofa/simulation/MechanicalMatrixVisitor.h>
 #include <sofa/core/behavior/MultiVec.h>
+#include <sofa/helper/vector.h>
 
 namespace sofa
 {
@@ -128,10 +129,22 @@ protected:
     /// the solution vector is stored for warm-start
     sofa::core::behavior::MultiVecDeriv dx;
 
+    /// positions before the correction, used by the line search
+    sofa::core::behavior::MultiVecCoord x_previous;
+
     Data<unsigned> d_newton_iterations; ///< Number of newton iterations between each load increments (normally, one load increment per simulation time-step.
     Data<double> d_correction_tolerance_threshold; ///< Convergence criterion: The newton iterations will stop when the norm of correction |du| reach this threshold.
     Data<double> d_residual_tolerance_threshold; ///< Convergence criterion: The newton iterations will stop when the norm of the residual |f - K(u)| reach this threshold. Use a negative value to disable this criterion.
     Data<bool> d_should_diverge_when_residual_is_growing; ///< Divergence criterion: The newton iterations will stop when the residual is greater than the one from the previous iteration.
+    Data<bool> d_modified_newton; ///< Modified newton: the tangent stiffness matrix (and its factorization) is reused between the iterations, and only updated when the convergence stalls.
+    Data<double> d_stall_ratio; ///< Modified newton: the tangent matrix is updated at the next iteration when |f - K(x)| was reduced by less than this ratio.
+    Data<bool> d_line_search; ///< Backtracking line search: the correction is halved until the residual's norm decreases enough.
+    Data<unsigned> d_line_search_iterations; ///< Maximum number of halvings of the correction by the line search.
+    Data<bool> d_eisenstat_walker; ///< Adapt the tolerance of an iterative linear solver at each newton iteration (Eisenstat-Walker forcing terms).
+    Data<double> d_max_forcing_term; ///< Largest tolerance given to the iterative linear solver by the Eisenstat-Walker forcing terms.
+    Data<sofa::helper::vector<double> > d_residuals; ///< Output: residual's norm |f - K(x)| before the first and after each newton iteration of the last time step.
+    Data<sofa::helper::vector<double> > d_iteration_times; ///< Output: duration in milliseconds of each newton iteration of the last time step.
+    Data<unsigned> d_nb_tangent_updates; ///< Output: number of assemblies of the tangent matrix during the last time step.
 };
 
 } // namespace odesolver
@@ -45,7 +45,7 @@ namespace basevtkreader
 
 BaseVTKReader::BaseVTKReader(): inputPoints (nullptr), inputNormals (nullptr), inputPolygons(nullptr), inputCells(nullptr),
     inputCellOffsets(nullptr), inputCellTypes(nullptr),
-    numberOfPoints(0), numberOfCells(0)
+    parallel(false), numberOfPoints(0), numberOfCells(0)
 {}
 
 BaseVTKReader::BaseVTKDataIO* BaseVTKReader::newVTKDataIO(const string& typestr)
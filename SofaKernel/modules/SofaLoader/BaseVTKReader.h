@@ -74,6 +74,10 @@ public:
         virtual bool read(istream& f, int n, int binary) = 0;
         virtual bool read(const string& s, int n, int binary) = 0;
         virtual bool read(const string& s, int binary) = 0;
+        /// Read n ASCII values in the text [begin, end), the numbers being parsed by blocks
+        /// of lines, in parallel if requested. Return the beginning of the line following
+        /// the last value, or nullptr if the values can't be read.
+        virtual const char* read(const char* begin, const char* end, int n, bool parallel) = 0;
         virtual bool write(ofstream& f, int n, int groups, int binary) = 0;
         virtual const void* getData() = 0;
         virtual void swap() = 0;
@@ -101,6 +105,7 @@ public:
         virtual bool read(const string& s, int n, int binary) override;
         virtual bool read(const string& s, int binary) override;
         virtual bool read(istream& in, int n, int binary) override;
+        virtual const char* read(const char* begin, const char* end, int n, bool parallel) override;
         virtual bool write(ofstream& out, int n, int groups, int binary) override;
         BaseData* createSofaData() override ;
     };
@@ -117,6 +122,7 @@ public:
     helper::vector<BaseVTKDataIO*> inputPointDataVector;
     helper::vector<BaseVTKDataIO*> inputCellDataVector;
     bool isLittleEndian;
+    bool parallel; ///< parse the large ASCII arrays in parallel
 
     int numberOfPoints, numberOfCells, numberOfLines;
 
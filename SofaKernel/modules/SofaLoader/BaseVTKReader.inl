@@ -22,10 +22,14 @@
 #ifndef SOFA_COMPONENT_LOADER_BASEVTKREADER_INL
 #define SOFA_COMPONENT_LOADER_BASEVTKREADER_INL
 #include <SofaLoader/BaseVTKReader.h>
+#include <SofaLoader/ParallelParsing.h>
+#include <sofa/helper/io/TextParsing.h>
 
 #include <string>
 #include <istream>
 #include <fstream>
+#include <atomic>
+#include <type_traits>
 
 
 namespace sofa
@@ -169,6 +173,51 @@ bool BaseVTKReader::VTKDataIO<T>::read(istream& in, int n, int binary)
     return true;
 }
 
+template<class T>
+const char* BaseVTKReader::VTKDataIO<T>::read(const char* begin, const char* end, int n, bool parallel)
+{
+    namespace text = sofa::helper::io::text;
+
+    if constexpr (std::is_arithmetic<T>::value && sizeof(T) > 1)
+    {
+        // blocks of lines of 64k values, parsed separately and written at their place in data
+        std::vector<text::TokenBlock> blocks;
+        const char* next = text::splitTokens(begin, end, std::size_t(std::max(n, 0)), 1 << 16, blocks);
+        if (next == nullptr)
+        {
+            resize(0);
+            return nullptr;
+        }
+        resize(n);
+
+        std::atomic<bool> valid(true);
+        const std::size_t nbBlocks = std::min(blocks.size(), getNbParseBlocks(std::size_t(next - begin), parallel));
+        parseBlocks(nbBlocks, [&](std::size_t b)
+        {
+            for (std::size_t i = blocks.size() * b / nbBlocks; i < blocks.size() * (b + 1) / nbBlocks; ++i)
+            {
+                if (!text::parseTokens(blocks[i], data + blocks[i].first))
+                    valid = false;
+            }
+        });
+        if (!valid)
+        {
+            resize(0);
+            return nullptr;
+        }
+        return next;
+    }
+    else
+    {
+        // characters and vectors: read with the stream operators, as read(istream&)
+        text::StreamBuffer buffer(begin, end);
+        std::istream in(&buffer);
+        if (!read(in, n, 0))
+            return nullptr;
+        return buffer.position();
+    }
+}
+
 template<class T>
 bool BaseVTKReader::VTKDataIO<T>::write(ofstream& out, int n, int groups, int binary)
 {
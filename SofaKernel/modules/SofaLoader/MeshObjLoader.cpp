@@ -23,7 +23,11 @@
 #include <SofaLoader/MeshObjLoader.h>
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/helper/system/SetDirectory.h>
-#include <fstream>
+#include <sofa/helper/io/MappedFile.h>
+#include <sofa/helper/io/TextParsing.h>
+#include <SofaLoader/ParallelParsing.h>
+#include <sstream>
+#include <string_view>
 
 namespace sofa
 {
@@ -38,6 +42,104 @@ using namespace sofa::defaulttype;
 using namespace sofa::core::loader;
 using namespace sofa::helper::types;
 
+namespace
+{
+
+namespace text = sofa::helper::io::text;
+
+/// Content of a block of lines of an OBJ file, parsed independently of the other blocks
+struct ObjBlock
+{
+    /// mtllib, usemtl or g line, found before the face nbFaces of the block
+    struct Directive
+    {
+        std::size_t nbFaces;
+        std::string token;
+        std::string arguments;
+    };
+
+    helper::vector<Vector3> positions;
+    helper::vector<Vector2> texCoords;
+    helper::vector<Vector3> normals;
+    std::vector<unsigned int> faceSizes;
+    std::vector<int> corners;                   ///< position, texcoord and normal indices of each corner of the faces (-1 if missing)
+    std::vector<std::size_t> relativeCorners;   ///< corners given relative to the current end of the lists (negative in the file), which are counted from the beginning of the block
+    std::vector<Directive> directives;
+    std::size_t nbInvalidIndices { 0 };
+    int offsets[3] { 0, 0, 0 };                 ///< number of positions, texcoords and normals in the previous blocks
+
+    void parse(const char* p, const char* end)
+    {
+        while (p < end)
+        {
+            const char* eol = text::findLineEnd(p, end);
+            const char* token = text::skipBlanks(p, eol);
+            const char* tokenEnd = text::skipToken(token, eol);
+            const std::string_view keyword(token, std::size_t(tokenEnd - token));
+            const char* arguments = text::skipBlanks(tokenEnd, eol);
+
+            if (keyword == "v")
+                positions.push_back(readVector<Vector3>(arguments, eol));
+            else if (keyword == "vn")
+                normals.push_back(readVector<Vector3>(arguments, eol));
+            else if (keyword == "vt")
+                texCoords.push_back(readVector<Vector2>(arguments, eol));
+            else if (keyword == "f" || keyword == "l")
+                readFace(arguments, eol);
+            else if (keyword == "mtllib" || keyword == "usemtl" || keyword == "g")
+                directives.push_back(Directive { faceSizes.size(), std::string(keyword), std::string(arguments, eol) });
+
+            p = (eol < end) ? eol + 1 : end;
+        }
+    }
+
+    template<class V>
+    static V readVector(const char* p, const char* eol)
+    {
+        V v;
+        for (std::size_t i = 0; i < V::size() && p != nullptr; ++i)
+            p = text::readNumber(p, eol, v[i]);
+        return v;
+    }
+
+    /// corners of the face, as v, v/t, v//n or v/t/n
+    void readFace(const char* p, const char* eol)
+    {
+        unsigned int size = 0;
+        for (p = text::skipBlanks(p, eol); p < eol; p = text::skipBlanks(p, eol), ++size)
+        {
+            const char* cornerEnd = text::skipToken(p, eol);
+            for (int j = 0; j < 3; ++j)
+            {
+                int index = -1;
+                if (p < cornerEnd && *p != '/')
+                {
+                    int value = 0;
+                    if (text::parseNumber(p, cornerEnd, value) == nullptr)
+                        value = 0;
+                    if (value >= 1)
+                        index = value - 1; // -1 because the numerotation begins at 1 and a vector begins at 0
+                    else if (value < 0)
+                    {
+                        index = int((j == 0) ? positions.size() : (j == 1) ? texCoords.size() : normals.size()) + value;
+                        relativeCorners.push_back(corners.size());
+                    }
+                    else
+                        ++nbInvalidIndices;
+                }
+                corners.push_back(index);
+
+                while (p < cornerEnd && *p != '/') ++p;
+                if (p < cornerEnd) ++p;
+            }
+            p = cornerEnd;
+        }
+        faceSizes.push_back(size);
+    }
+};
+
+} // anonymous namespace
+
 int MeshObjLoaderClass = core::RegisterObject("Specific mesh loader for Obj file format.")
         .add< MeshObjLoader >()
         ;
@@ -61,6 +163,7 @@ MeshObjLoader::MeshObjLoader()
     , d_computeMaterialFaces(initData(&d_computeMaterialFaces, false, "computeMaterialFaces", "True to activate export of Data instances containing list of face indices for each material"))
     , d_vertPosIdx      (initData   (&d_vertPosIdx, "vertPosIdx", "If vertices have multiple normals/texcoords stores vertices position indices"))
     , d_vertNormIdx     (initData   (&d_vertNormIdx, "vertNormIdx", "If vertices have multiple normals/texcoords stores vertices normal indices"))
+    , d_parallel(initData(&d_parallel, false, "parallel", "Parse the file by blocks of lines in parallel, with the TaskScheduler"))
 {
     addAlias(&d_material, "material");
 
@@ -114,16 +217,16 @@ bool MeshObjLoader::load()
 
     // -- Loading file
     const char* filename = m_filename.getFullPath().c_str();
-    std::ifstream file(filename);
+    helper::io::MappedFile file(filename);
 
-    if (!file.good())
+    if (!file.isOpen())
     {
         msg_error() << "Error: MeshObjLoader: Cannot read file '" << m_filename << "'.";
         return false;
     }
 
     // -- Reading file
-    fileRead = this->readOBJ (file,filename);
+    fileRead = this->readOBJ (file.begin(), file.end(), filename);
     file.close();
 
     return fileRead;
@@ -155,9 +258,8 @@ void MeshObjLoader::addGroup (const PrimitiveGroup& g)
     d_quadsGroups.endEdit();
 }
 
-bool MeshObjLoader::readOBJ (std::ifstream &file, const char* filename)
+bool MeshObjLoader::readOBJ (const char* begin, const char* end, const char* filename)
 {
- 
     const bool handleSeams = d_handleSeams.getValue();
     helper::vector<sofa::defaulttype::Vector3>& my_positions = *(d_positions.beginEdit());
     helper::vector<sofa::defaulttype::Vector2>& my_texCoords = *(d_texCoordsList.beginEdit());
@@ -168,7 +270,6 @@ bool MeshObjLoader::readOBJ (std::ifstream &file, const char* filename)
     helper::SVector< helper::SVector <int> >& my_faceList = *(d_faceList.beginEdit() );
     helper::SVector< helper::SVector <int> >& my_normalsList = *(d_normalsIndexList.beginEdit());
     helper::SVector< helper::SVector <int> >& my_texturesList   = *(d_texIndexList.beginEdit());
-    helper::vector<int> nodes, nIndices, tIndices;
 
     helper::vector<Edge >& my_edges = *(d_edges.beginEdit());
     helper::vector<Triangle >& my_triangles = *(d_triangles.beginEdit());
@@ -190,8 +291,67 @@ bool MeshObjLoader::readOBJ (std::ifstream &file, const char* filename)
     d_trianglesGroups.beginEdit()->clear(); d_trianglesGroups.endEdit();
     d_quadsGroups.beginEdit()->clear(); d_quadsGroups.endEdit();
 
-    int vtn[3];
-    Vector3 result;
+    // -- Parsing, by blocks of lines (in parallel if requested)
+    const std::size_t nbBlocks = getNbParseBlocks(std::size_t(end - begin), d_parallel.getValue());
+    const std::vector<const char*> bounds = text::splitLines(begin, end, nbBlocks);
+    std::vector<ObjBlock> blocks(nbBlocks);
+    parseBlocks(nbBlocks, [&](std::size_t b) { blocks[b].parse(bounds[b], bounds[b + 1]); });
+
+    // -- Merge of the blocks, in the order of the file
+    std::size_t nbPositions = 0, nbTexCoords = 0, nbNormals = 0, nbFaceList = 0, nbInvalid = 0;
+    std::vector<std::size_t> faceOffsets(nbBlocks);
+    for (std::size_t b = 0; b < nbBlocks; ++b)
+    {
+        ObjBlock& block = blocks[b];
+        block.offsets[0] = int(nbPositions);
+        block.offsets[1] = int(nbTexCoords);
+        block.offsets[2] = int(nbNormals);
+        faceOffsets[b] = nbFaceList;
+        nbPositions += block.positions.size();
+        nbTexCoords += block.texCoords.size();
+        nbNormals += block.normals.size();
+        nbFaceList += block.faceSizes.size();
+        nbInvalid += block.nbInvalidIndices;
+    }
+    if (nbInvalid > 0)
+        msg_error() << nbInvalid << " invalid indices (0) in the faces, they are ignored.";
+
+    my_positions.reserve(nbPositions);
+    my_texCoords.reserve(nbTexCoords);
+    my_normals.reserve(nbNormals);
+    for (const ObjBlock& block : blocks)
+    {
+        my_positions.insert(my_positions.end(), block.positions.begin(), block.positions.end());
+        my_texCoords.insert(my_texCoords.end(), block.texCoords.begin(), block.texCoords.end());
+        my_normals.insert(my_normals.end(), block.normals.begin(), block.normals.end());
+    }
+
+    // the indices lists of the faces are filled by blocks, the relative indices being made absolute
+    my_faceList.resize(nbFaceList);
+    my_texturesList.resize(nbFaceList);
+    my_normalsList.resize(nbFaceList);
+    parseBlocks(nbBlocks, [&](std::size_t b)
+    {
+        ObjBlock& block = blocks[b];
+        for (const std::size_t c : block.relativeCorners)
+            block.corners[c] += block.offsets[c % 3];
+        const int* corner = block.corners.data();
+        for (std::size_t f = 0; f < block.faceSizes.size(); ++f)
+        {
+            const std::size_t fi = faceOffsets[b] + f;
+            const unsigned int size = block.faceSizes[f];
+            my_faceList[fi].resize(size);
+            my_texturesList[fi].resize(size);
+            my_normalsList[fi].resize(size);
+            for (unsigned int i = 0; i < size; ++i, corner += 3)
+            {
+                my_faceList[fi][i] = corner[0];
+                my_texturesList[fi][i] = corner[1];
+                my_normalsList[fi][i] = corner[2];
+            }
+        }
+    });
+
     helper::WriteAccessor<Data<helper::vector< PrimitiveGroup> > > my_faceGroups[NBFACETYPE] =
     {
         d_edgesGroups,
@@ -203,134 +363,74 @@ bool MeshObjLoader::readOBJ (std::ifstream &file, const char* filename)
     int curMaterialId = -1;
     int nbFaces[NBFACETYPE] = {0}; // number of edges, triangles, quads
     int groupF0[NBFACETYPE] = {0}; // first primitives indices in current group for edges, triangles, quads
-    std::string line;
-    while( std::getline(file,line) )
-    {
-        if (line.empty()) continue;
-        std::istringstream values(line);
-        std::string token;
-        values >> token;
 
-        if (token == "#")
-        {
-            // comment
-        }
-        else if (token == "v")
-        {
-            // vertex
-            values >> result[0] >> result[1] >> result[2];
-            my_positions.push_back(Vector3(result[0],result[1], result[2]));
-        }
-        else if (token == "vn")
-        {
-            // normal 
-            values >> result[0] >> result[1] >> result[2];
-            my_normals.push_back(Vector3(result[0],result[1], result[2]));
-        }
-        else if (token == "vt")
-        {
-            // texcoord
-            values >> result[0] >> result[1];
-            my_texCoords.push_back(Vector2(result[0],result[1]));
-        }
-        else if ((token == "mtllib") && d_loadMaterial.getValue())
+    // the mtllib, usemtl and g lines
+    auto applyDirective = [&](const ObjBlock::Directive& directive)
+    {
+        std::istringstream values(directive.arguments);
+        if (directive.token == "mtllib")
         {
-            while (!values.eof())
+            while (d_loadMaterial.getValue() && !values.eof())
             {
                 std::string materialLibaryName;
                 values >> materialLibaryName;
                 std::string mtlfile = sofa::helper::system::SetDirectory::GetRelativeFromFile(materialLibaryName.c_str(), filename);
                 this->readMTL(mtlfile.c_str(), my_materials);
             }
+            return;
         }
-        else if (token == "usemtl" || token == "g")
-        {
-            // end of current group
-            //curGroup.nbp = nbf - curGroup.p0;
-            for (int ft = 0; ft < NBFACETYPE; ++ft)
-                if (nbFaces[ft] > groupF0[ft])
-                {
-                    my_faceGroups[ft].push_back(PrimitiveGroup(groupF0[ft], nbFaces[ft]-groupF0[ft], curMaterialName, curGroupName, curMaterialId));
-                    groupF0[ft] = nbFaces[ft];
-                }
-            if (token == "usemtl")
+
+        // end of current group
+        for (int ft = 0; ft < NBFACETYPE; ++ft)
+            if (nbFaces[ft] > groupF0[ft])
             {
-                values >> curMaterialName;
-                curMaterialId = -1;
-                helper::vector<Material>::iterator it = my_materials.begin();
-                helper::vector<Material>::iterator itEnd = my_materials.end();
-                for (; it != itEnd; ++it)
-                {
-                    if (it->name == curMaterialName)
-                    {
-                        (*it).activated = true;
-                        if (!material.activated)
-                            material = *it;
-                        curMaterialId = it - my_materials.begin();
-                        break;
-                    }
-                }
+                my_faceGroups[ft].push_back(PrimitiveGroup(groupF0[ft], nbFaces[ft]-groupF0[ft], curMaterialName, curGroupName, curMaterialId));
+                groupF0[ft] = nbFaces[ft];
             }
-            else if (token == "g")
+        if (directive.token == "usemtl")
+        {
+            values >> curMaterialName;
+            curMaterialId = -1;
+            helper::vector<Material>::iterator it = my_materials.begin();
+            helper::vector<Material>::iterator itEnd = my_materials.end();
+            for (; it != itEnd; ++it)
             {
-                curGroupName.clear();
-                while (!values.eof())
+                if (it->name == curMaterialName)
                 {
-                    std::string g;
-                    values >> g;
-                    if (!curGroupName.empty())
-                        curGroupName += " ";
-                    curGroupName += g;
+                    (*it).activated = true;
+                    if (!material.activated)
+                        material = *it;
+                    curMaterialId = it - my_materials.begin();
+                    break;
                 }
             }
         }
-        else if (token == "l" || token == "f")
+        else if (directive.token == "g")
         {
-            // face
-            nodes.clear();
-            nIndices.clear();
-            tIndices.clear();
-
+            curGroupName.clear();
             while (!values.eof())
             {
-                std::string face;
-                values >> face;
-                if (face.empty()) continue;
-                for (int j = 0; j < 3; j++)
-                {
-                    vtn[j] = -1;
-                    std::string::size_type pos = face.find('/');
-                    std::string tmp = face.substr(0, pos);
-                    if (pos == std::string::npos)
-                        face = "";
-                    else
-                    {
-                        face = face.substr(pos + 1);
-                    }
-
-                    if (!tmp.empty())
-                    {
-                        vtn[j] = atoi(tmp.c_str());
-                        if (vtn[j] >= 1)
-                            vtn[j] -=1; // -1 because the numerotation begins at 1 and a vector begins at 0
-                        else if (vtn[j] < 0)
-                            vtn[j] += (j==0) ? my_positions.size() : (j==1) ? my_texCoords.size() : my_normals.size();
-                        else
-                        {
-                            msg_error() << "Invalid index " << tmp;
-                            vtn[j] = -1;
-                        }
-                    }
-                }
-
-                nodes.push_back(vtn[0]);
-                tIndices.push_back(vtn[1]);
-                nIndices.push_back(vtn[2]);
+                std::string g;
+                values >> g;
+                if (!curGroupName.empty())
+                    curGroupName += " ";
+                curGroupName += g;
             }
+        }
+    };
+
+    std::size_t fi = 0;
+    for (const ObjBlock& block : blocks)
+    {
+        auto directive = block.directives.begin();
+        for (std::size_t f = 0; f < block.faceSizes.size(); ++f, ++fi)
+        {
+            // the lines preceding the face
+            for (; directive != block.directives.end() && directive->nbFaces == f; ++directive)
+                applyDirective(*directive);
 
-            my_faceList.push_back(nodes);
-            my_normalsList.push_back(nIndices);
-            my_texturesList.push_back(tIndices);
+            // face
+            const helper::SVector<int>& nodes = my_faceList[fi];
 
             if (nodes.size() == 2) // Edge
             {
@@ -363,12 +463,9 @@ bool MeshObjLoader::readOBJ (std::ifstream &file, const char* filename)
                 ++nbFaces[MeshObjLoader::TRIANGLE];
                 faceType = MeshObjLoader::TRIANGLE;
             }
-
-        }
-        else
-        {
-
         }
+        for (; directive != block.directives.end(); ++directive)
+            applyDirective(*directive);
     }
 
     // end of current group
@@ -50,7 +50,8 @@ public:
     bool load() override;
 
 protected:
-    bool readOBJ (std::ifstream &file, const char* filename);
+    /// parse the content [begin, end) of the file
+    bool readOBJ (const char* begin, const char* end, const char* filename);
     bool readMTL (const char* filename, helper::vector <sofa::helper::types::Material>& d_materials);
     void addGroup (const sofa::core::loader::PrimitiveGroup& g);
 
@@ -81,6 +82,8 @@ public:
     /// If it is empty then each vertex correspond to one normal
     Data< helper::vector<int> > d_vertNormIdx;
 
+    Data< bool > d_parallel; ///< Parse the file by blocks of lines in parallel, with the TaskScheduler
+
     virtual std::string type() { return "The format of this mesh is OBJ."; }
 };
 
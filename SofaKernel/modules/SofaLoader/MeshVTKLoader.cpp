@@ -33,6 +33,8 @@ using sofa::component::loader::BaseVTKReader ;
 /// This is needed for template specialization.
 #include <SofaLoader/BaseVTKReader.inl>
 
+#include <sofa/helper/io/MappedFile.h>
+
 #include <tinyxml.h>
 
 //XML VTK Loader
@@ -64,6 +66,11 @@ class LegacyVTKReader : public BaseVTKReader
 {
 public:
     bool readFile(const char* filename) override;
+protected:
+    /// read n values at the current position of the file, the ASCII values being parsed in the mapped file
+    bool readData(std::ifstream& in, BaseVTKDataIO* data, int n, int binary);
+
+    helper::io::MappedFile m_text;
 };
 
 class XMLVTKReader : public BaseVTKReader
@@ -85,6 +92,7 @@ protected:
 ////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////// MeshVTKLoader IMPLEMENTATION //////////////////////////////////
 MeshVTKLoader::MeshVTKLoader() : MeshLoader()
+    , d_parallel(initData(&d_parallel, false, "parallel", "Parse the large ASCII arrays of legacy files in parallel, with the TaskScheduler"))
     , reader(nullptr)
 {
 }
@@ -165,6 +173,7 @@ bool MeshVTKLoader::load()
         return false;
     }
 
+    reader->parallel = d_parallel.getValue();
     fileRead = reader->readVTK (filename);
     this->setInputsMesh();
     this->setInputsData();
@@ -613,6 +622,9 @@ bool LegacyVTKReader::readFile(const char* filename)
         binary = 2;    // bytes will be swapped
     }
 
+    if (!binary)
+        m_text.open(filename);
+
 
     // Part 4
     do
@@ -655,7 +667,7 @@ bool LegacyVTKReader::readFile(const char* filename)
             {
                 return false;
             }
-            if (!inputPoints->read(inVTKFile, 3 * n, binary))
+            if (!readData(inVTKFile, inputPoints, 3 * n, binary))
             {
                 return false;
             }
@@ -668,7 +680,7 @@ bool LegacyVTKReader::readFile(const char* filename)
             msg_info() << n << " polygons ( " << (ni - 3 * n) << " triangles )" ;
             inputPolygons = new VTKDataIO<int>;
             inputPolygonsInt = dynamic_cast<VTKDataIO<int>* > (inputPolygons);
-            if (!inputPolygons->read(inVTKFile, ni, binary))
+            if (!readData(inVTKFile, inputPolygons, ni, binary))
             {
                 return false;
             }
@@ -680,7 +692,7 @@ bool LegacyVTKReader::readFile(const char* filename)
             msg_info() << "Found " << n << " cells" ;
             inputCells = new VTKDataIO<int>;
             inputCellsInt = dynamic_cast<VTKDataIO<int>* > (inputCells);
-            if (!inputCells->read(inVTKFile, ni, binary))
+            if (!readData(inVTKFile, inputCells, ni, binary))
             {
                 return false;
             }
@@ -693,7 +705,7 @@ bool LegacyVTKReader::readFile(const char* filename)
             msg_info() << "Found " << n << " lines" ;
             inputCells = new VTKDataIO<int>;
             inputCellsInt = dynamic_cast<VTKDataIO<int>* > (inputCellsInt);
-            if (!inputCells->read(inVTKFile, ni, binary))
+            if (!readData(inVTKFile, inputCells, ni, binary))
             {
                 return false;
             }
@@ -713,7 +725,7 @@ bool LegacyVTKReader::readFile(const char* filename)
             ln >> n;
             inputCellTypes = new VTKDataIO<int>;
             inputCellTypesInt = dynamic_cast<VTKDataIO<int>* > (inputCellTypes);
-            if (!inputCellTypes->read(inVTKFile, n, binary))
+            if (!readData(inVTKFile, inputCellTypes, n, binary))
             {
                 return false;
             }
@@ -768,7 +780,7 @@ bool LegacyVTKReader::readFile(const char* filename)
                                 inVTKFile.seekg(positionBeforeLookupTable);
                             }
                         }
-                        if (data->read(inVTKFile, nb_ele, binary))
+                        if (readData(inVTKFile, data, nb_ele, binary))
                         {
                             inputDataVector.push_back(data);
                             data->name = dataName;
@@ -798,7 +810,7 @@ bool LegacyVTKReader::readFile(const char* filename)
                     {
                         return false;
                     }
-                    if (!inputNormals->read(inVTKFile, 3 * nb_ele, binary))
+                    if (!readData(inVTKFile, inputNormals, 3 * nb_ele, binary))
                     {
                         return false;
                     }
@@ -810,7 +822,7 @@ bool LegacyVTKReader::readFile(const char* filename)
                     BaseVTKDataIO*  data = newVTKDataIO(dataType, 3);
                     if (data != nullptr)
                     {
-                        if (data->read(inVTKFile, nb_ele, binary))
+                        if (readData(inVTKFile, data, nb_ele, binary))
                         {
                             inputDataVector.push_back(data);
                             data->name = dataName;
@@ -852,7 +864,7 @@ bool LegacyVTKReader::readFile(const char* filename)
                         BaseVTKDataIO*  data = newVTKDataIO(dataType, nbComponents);
                         if (data != nullptr)
                         {
-                            if (data->read(inVTKFile, nbData, binary))
+                            if (readData(inVTKFile, data, nbData, binary))
                             {
                                 inputDataVector.push_back(data);
                                 data->name = dataName;
@@ -874,7 +886,7 @@ bool LegacyVTKReader::readFile(const char* filename)
                         BaseVTKDataIO* data = newVTKDataIO("UInt8", 4); // in the binary case there will be 4 unsigned chars per table entry
                         if (data)
                         {
-                            data->read(inVTKFile, nb_ele, binary);
+                            readData(inVTKFile, data, nb_ele, binary);
                         }
                         delete data;
                     }
@@ -883,7 +895,7 @@ bool LegacyVTKReader::readFile(const char* filename)
                         BaseVTKDataIO* data = newVTKDataIO("Float32", 4);
                         if (data)
                         {
-                            data->read(inVTKFile, nb_ele, binary);    // in the ascii case there will be 4 float32 per table entry
+                            readData(inVTKFile, data, nb_ele, binary);    // in the ascii case there will be 4 float32 per table entry
                         }
                         delete data;
                     }
@@ -956,6 +968,19 @@ bool LegacyVTKReader::readFile(const char* filename)
     return true;
 }
 
+bool LegacyVTKReader::readData(std::ifstream& in, BaseVTKDataIO* data, int n, int binary)
+{
+    const std::streamoff offset = in.tellg();
+    if (binary || !m_text.isOpen() || offset < 0 || std::size_t(offset) > m_text.size())
+        return data->read(in, n, binary);
+
+    const char* next = data->read(m_text.begin() + offset, m_text.end(), n, parallel);
+    if (next == nullptr)
+        return false;
+    in.seekg(std::streamoff(next - m_text.begin()));
+    return true;
+}
+
 bool XMLVTKReader::readFile(const char* filename)
 {
     TiXmlDocument vtkDoc(filename);
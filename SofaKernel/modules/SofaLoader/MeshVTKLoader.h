@@ -59,6 +59,8 @@ public:
     core::objectmodel::BaseData* tetrasData;
     core::objectmodel::BaseData* hexasData;
 
+    Data<bool> d_parallel; ///< Parse the large ASCII arrays of legacy files in parallel, with the TaskScheduler
+
     bool load() override;
 
 protected:
@@ -0,0 +1,64 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#ifndef SOFA_COMPONENT_LOADER_PARALLELPARSING_H
+#define SOFA_COMPONENT_LOADER_PARALLELPARSING_H
+#include "config.h"
+
+#include <sofa/simulation/ParallelForRange.h>
+
+#include <algorithm>
+
+namespace sofa
+{
+
+namespace component
+{
+
+namespace loader
+{
+
+/// Number of blocks to parse a text of the given size: a few per thread of the TaskScheduler
+/// to balance the load, of at least minBlockSize bytes each, or 1 if not parallel.
+inline std::size_t getNbParseBlocks(std::size_t size, bool parallel, std::size_t minBlockSize = 1 << 20)
+{
+    if (!parallel) return 1;
+    simulation::TaskScheduler* scheduler = simulation::TaskScheduler::getInstance();
+    const std::size_t nbThreads = scheduler ? scheduler->getThreadCount() : 1;
+    if (nbThreads <= 1) return 1;
+    return std::max<std::size_t>(1, std::min(4 * nbThreads, size / minBlockSize));
+}
+
+/// Call func(b) for each block b in [0, nbBlocks), on the TaskScheduler if there are several blocks.
+template<class Func>
+void parseBlocks(std::size_t nbBlocks, const Func& func)
+{
+    simulation::TaskScheduler* scheduler = nbBlocks > 1 ? simulation::TaskScheduler::getInstance() : nullptr;
+    simulation::parallelForRange(scheduler, 0, nbBlocks, 1, [&](std::size_t b, std::size_t) { func(b); });
+}
+
+} // namespace loader
+
+} // namespace component
+
+} // namespace sofa
+
+#endif // SOFA_COMPONENT_LOADER_PARALLELPARSING_H
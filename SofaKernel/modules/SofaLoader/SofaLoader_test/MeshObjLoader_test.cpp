@@ -24,6 +24,13 @@
 #include <SofaTest/Sofa_test.h>
 
 #include <SofaLoader/MeshObjLoader.h>
+#include <sofa/simulation/TaskScheduler.h>
+
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
 
 #include <sofa/helper/BackTrace.h>
 using sofa::helper::BackTrace ;
@@ -97,5 +104,89 @@ TEST_F(MeshObjLoader_test, LoadCall)
     loadTest("mesh/torus.obj", 800, 0, 1600,  0, 0, 0, 0, 0, 0, 861, 0);
 }
 
+template<class Element>
+bool sameElements(const helper::vector<Element>& a, const helper::vector<Element>& b)
+{
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const Element& x, const Element& y)
+    {
+        return std::equal(x.begin(), x.end(), y.begin());
+    });
+}
+
+/** MeshObjLoader::load() with parallel
+ * The file parsed by blocks of lines in parallel gives the same mesh as the serial parsing,
+ * including the groups and the indices given relatively to the end of the lists.
+ */
+TEST_F(MeshObjLoader_test, ParallelParsing)
+{
+    // grid of n x n vertices, large enough to be split in several blocks
+    const int n = 300;
+    const std::string fileName = boost::filesystem::temp_directory_path().string() + "/MeshObjLoader_test.obj";
+    {
+        std::ofstream file(fileName);
+        for (int j = 0; j < n; ++j)
+            for (int i = 0; i < n; ++i)
+                file << "v " << i * 0.1 << " " << j * 0.1 << " " << 0.5 * std::sin(i + j) << "\n";
+        for (int i = 0; i < n; ++i)
+            file << "vt " << i / double(n) << " 0.5\n";
+        for (int j = 0; j + 1 < n; ++j)
+        {
+            if (j % 37 == 0)
+                file << "g row " << j << "\n";
+            for (int i = 0; i + 1 < n; ++i)
+            {
+                const int v = j * n + i + 1;
+                if (i % 2)
+                    file << "f " << v << "/" << i + 1 << " " << v + 1 << "/" << i + 2 << " " << v + n + 1 << " " << v + n << "\n";
+                else // triangle with relative indices: -1 is the last vertex
+                {
+                    const int r = v - n * n - 1;
+                    file << "f " << r << " " << r + 1 << " " << r + n + 1 << "\n";
+                }
+            }
+        }
+    }
+
+    MeshObjLoader::SPtr serial = sofa::core::objectmodel::New<MeshObjLoader>();
+    MeshObjLoader::SPtr parallel = sofa::core::objectmodel::New<MeshObjLoader>();
+    serial->setFilename(fileName);
+    parallel->setFilename(fileName);
+    parallel->d_parallel.setValue(true);
+    sofa::simulation::TaskScheduler::getInstance()->init(4);
+
+    const bool serialRead = serial->load();
+    const bool parallelRead = parallel->load();
+    std::remove(fileName.c_str());
+    ASSERT_TRUE(serialRead);
+    ASSERT_TRUE(parallelRead);
+
+    ASSERT_EQ(size_t(n * n), serial->d_positions.getValue().size());
+    ASSERT_EQ(size_t((n - 1) * n / 2), serial->d_triangles.getValue().size());
+    ASSERT_EQ(size_t((n - 1) * (n - 2) / 2), serial->d_quads.getValue().size());
+    EXPECT_TRUE(sameElements(helper::vector<Triangle>{ Triangle(0, 1, n + 1) }, { serial->d_triangles.getValue()[0] }));
+    EXPECT_TRUE(sameElements(helper::vector<Quad>{ Quad(1, 2, n + 2, n + 1) }, { serial->d_quads.getValue()[0] }));
+
+    EXPECT_EQ(serial->d_positions.getValue(), parallel->d_positions.getValue());
+    EXPECT_EQ(serial->d_texCoordsList.getValue(), parallel->d_texCoordsList.getValue());
+    EXPECT_TRUE(sameElements(serial->d_triangles.getValue(), parallel->d_triangles.getValue()));
+    EXPECT_TRUE(sameElements(serial->d_quads.getValue(), parallel->d_quads.getValue()));
+    EXPECT_EQ(serial->d_faceList.getValue(), parallel->d_faceList.getValue());
+    EXPECT_EQ(serial->d_texIndexList.getValue(), parallel->d_texIndexList.getValue());
+
+    for (const auto groups : { &MeshObjLoader::d_trianglesGroups, &MeshObjLoader::d_quadsGroups })
+    {
+        const auto& serialGroups = ((*serial).*groups).getValue();
+        const auto& parallelGroups = ((*parallel).*groups).getValue();
+        EXPECT_EQ(size_t((n - 2) / 37 + 1), serialGroups.size());
+        ASSERT_EQ(serialGroups.size(), parallelGroups.size());
+        for (size_t g = 0; g < serialGroups.size(); ++g)
+        {
+            EXPECT_EQ(serialGroups[g].p0, parallelGroups[g].p0);
+            EXPECT_EQ(serialGroups[g].nbp, parallelGroups[g].nbp);
+            EXPECT_EQ(serialGroups[g].groupName, parallelGroups[g].groupName);
+        }
+    }
+}
+
 } // namespace meshobjloader_test
 } // namespace sofa
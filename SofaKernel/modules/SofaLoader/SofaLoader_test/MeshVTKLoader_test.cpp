@@ -32,6 +32,13 @@ using sofa::helper::BackTrace ;
 #include <sofa/helper/testing/BaseTest.h>
 using sofa::helper::testing::BaseTest ;
 
+#include <sofa/simulation/TaskScheduler.h>
+
+#include <boost/filesystem.hpp>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
 namespace sofa
 {
 namespace meshvtkloader_test
@@ -125,6 +132,53 @@ TEST_F(MeshVTKLoaderTest, loadLegacy_binary)
     EXPECT_TRUE(dynamic_cast<Data<helper::vector<defaulttype::Vec3f>>*>(vect2) != nullptr);
 }
 
+TEST_F(MeshVTKLoaderTest, loadLegacy_parallel)
+{
+    // grid of n x n points, with enough values to be parsed in several blocks
+    const unsigned n = 200;
+    const std::string filename = boost::filesystem::temp_directory_path().string() + "/MeshVTKLoader_test.vtk";
+    {
+        std::ofstream file(filename);
+        file << "# vtk DataFile Version 2.0\nMeshVTKLoader_test\nASCII\nDATASET POLYDATA\n";
+        file << "POINTS " << n * n << " float\n";
+        for (unsigned j = 0; j < n; ++j)
+            for (unsigned i = 0; i < n; ++i)
+                file << i * 0.1 << " " << j * 0.1 << " " << 0.5 * std::sin(i + j) << "\n";
+        file << "POLYGONS " << 2 * (n - 1) * (n - 1) << " " << 8 * (n - 1) * (n - 1) << "\n";
+        for (unsigned j = 0; j + 1 < n; ++j)
+            for (unsigned i = 0; i + 1 < n; ++i)
+            {
+                const unsigned p = j * n + i;
+                file << "3 " << p << " " << p + 1 << " " << p + n + 1 << "\n";
+                file << "3 " << p << " " << p + n + 1 << " " << p + n << "\n";
+            }
+    }
+
+    MeshVTKLoader::SPtr parallel = sofa::core::objectmodel::New<MeshVTKLoader>();
+    parallel->setFilename(filename);
+    parallel->d_parallel.setValue(true);
+    sofa::simulation::TaskScheduler::getInstance()->init(4);
+
+    testLoad(filename, n * n, 0, 2 * (n - 1) * (n - 1), 0, 0, 0, 0);
+    const bool parallelRead = parallel->load();
+    std::remove(filename.c_str());
+    ASSERT_TRUE(parallelRead);
+
+    EXPECT_EQ(d_positions.getValue(), parallel->d_positions.getValue());
+    ASSERT_EQ(d_triangles.getValue().size(), parallel->d_triangles.getValue().size());
+    size_t nbDifferentTriangles = 0;
+    for (size_t t = 0; t < d_triangles.getValue().size(); ++t)
+    {
+        for (unsigned j = 0; j < 3; ++j)
+            if (d_triangles.getValue()[t][j] != parallel->d_triangles.getValue()[t][j])
+            {
+                ++nbDifferentTriangles;
+                break;
+            }
+    }
+    EXPECT_EQ(nbDifferentTriangles, 0u);
+}
+
 TEST_F(MeshVTKLoaderTest, loadInvalidFilenames)
 {
     EXPECT_MSG_EMIT(Error) ;
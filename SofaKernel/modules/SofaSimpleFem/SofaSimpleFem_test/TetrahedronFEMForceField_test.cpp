@@ -133,6 +133,69 @@ struct TetrahedronFEMForceField_test : public ForceField_test<_TetrahedronFEMFor
 
         EXPECT_EQ(fem->getComponentState(), ComponentState::Invalid) ;
     }
+
+    /// The parallel mode must give the same forces as the serial one (up to the summation order)
+    void checkParallelComputation(const std::string& method)
+    {
+        this->clearSceneGraph();
+
+        std::stringstream scene ;
+        scene << "<?xml version='1.0'?>"
+                 "<Node 	name='Root' gravity='0 0 0'>                   \n"
+                 "  <RegularGridTopology name='grid' n='5 4 6' min='0 0 0' max='1 1 2'/>  \n"
+                 "  <MechanicalObject name='dofs'/>                     \n"
+                 "  <TetrahedronFEMForceField name='serial' method='" << method << "' youngModulus='1000' poissonRatio='0.3'/>\n"
+                 "  <TetrahedronFEMForceField name='parallel' method='" << method << "' youngModulus='1000' poissonRatio='0.3' parallel='1' parallelGrainSize='1'/>\n"
+                 "</Node>                                               \n" ;
+
+        Node::SPtr root = SceneLoaderXML::loadFromMemory ("testscene",
+                                                          scene.str().c_str(),
+                                                          scene.str().size()) ;
+        ASSERT_NE(root, nullptr) ;
+        sofa::simulation::getSimulation()->init(root.get());
+
+        ForceType* serial = dynamic_cast<ForceType*>(root->getObject("serial")) ;
+        ForceType* parallel = dynamic_cast<ForceType*>(root->getObject("parallel")) ;
+        ASSERT_NE(serial, nullptr) ;
+        ASSERT_NE(parallel, nullptr) ;
+        EXPECT_GT(parallel->d_nbColors.getValue(), 1u) ;
+
+        // deformed positions and an arbitrary displacement
+        DOF* dofs = dynamic_cast<DOF*>(root->getObject("dofs")) ;
+        ASSERT_NE(dofs, nullptr) ;
+        VecCoord position = dofs->readPositions().ref();
+        VecDeriv dx(position.size());
+        for (std::size_t i=0; i<position.size(); ++i)
+        {
+            DataTypes::set( position[i], position[i][0] + (Real)0.05*std::sin(Real(i)), position[i][1] + (Real)0.03*std::cos(Real(3*i)), position[i][2] - (Real)0.04*std::sin(Real(7*i)) );
+            DataTypes::set( dx[i], std::cos(Real(i)), std::sin(Real(5*i)), std::cos(Real(2*i)) );
+        }
+
+        core::MechanicalParams mparams;
+        mparams.setKFactor(1.0);
+
+        core::objectmodel::Data<VecCoord> dataX; dataX.setValue(position);
+        core::objectmodel::Data<VecDeriv> dataV; dataV.setValue(VecDeriv(position.size()));
+        core::objectmodel::Data<VecDeriv> dataDx; dataDx.setValue(dx);
+        core::objectmodel::Data<VecDeriv> serialF, parallelF, serialDf, parallelDf;
+
+        serial->addForce(&mparams, serialF, dataX, dataV);
+        parallel->addForce(&mparams, parallelF, dataX, dataV);
+        serial->addDForce(&mparams, serialDf, dataDx);
+        parallel->addDForce(&mparams, parallelDf, dataDx);
+
+        const VecDeriv& f0 = serialF.getValue();
+        const VecDeriv& f1 = parallelF.getValue();
+        const VecDeriv& df0 = serialDf.getValue();
+        const VecDeriv& df1 = parallelDf.getValue();
+        ASSERT_EQ(f0.size(), f1.size()) ;
+        ASSERT_EQ(df0.size(), df1.size()) ;
+        for (std::size_t i=0; i<f0.size(); ++i)
+        {
+            EXPECT_LT((f0[i]-f1[i]).norm(), 1e-8 * (1 + f0[i].norm())) << "force, point " << i ;
+            EXPECT_LT((df0[i]-df1[i]).norm(), 1e-8 * (1 + df0[i].norm())) << "dforce, point " << i ;
+        }
+    }
 };
 
 // ========= Define the list of types to instanciate.
@@ -169,4 +232,24 @@ TYPED_TEST(TetrahedronFEMForceField_test, checkGracefullHandlingWhenTopologyIsMi
     this->checkGracefullHandlingWhenTopologyIsMissing();
 }
 
+TYPED_TEST(TetrahedronFEMForceField_test, checkParallelComputationSmall)
+{
+    this->checkParallelComputation("small");
+}
+
+TYPED_TEST(TetrahedronFEMForceField_test, checkParallelComputationLarge)
+{
+    this->checkParallelComputation("large");
+}
+
+TYPED_TEST(TetrahedronFEMForceField_test, checkParallelComputationPolar)
+{
+    this->checkParallelComputation("polar");
+}
+
+TYPED_TEST(TetrahedronFEMForceField_test, checkParallelComputationSVD)
+{
+    this->checkParallelComputation("svd");
+}
+
 } // namespace sofa
@@ -228,6 +228,15 @@ public:
 
     Data<bool>  _updateStiffness; ///< udpate structures (precomputed in init) using stiffness parameters in each iteration (set listening=1)
 
+    /// @name Multithreaded computation of the forces
+    /// Elements are partitioned in colors such that two elements of a same color never share a vertex,
+    /// so each color can be processed by concurrent tasks without any synchronization on the node forces.
+    /// @{
+    Data<bool> d_parallel; ///< compute addForce/addDForce in parallel with the TaskScheduler, processing the elements color by color
+    Data<unsigned int> d_parallelGrainSize; ///< minimum number of elements computed by a single task
+    Data<unsigned int> d_nbColors; ///< number of colors of the element coloring used by the parallel computation (read-only)
+    /// @}
+
     /// Link to be set to the topology container in the component graph. 
     SingleLink<TetrahedronFEMForceField<DataTypes>, sofa::core::topology::BaseMeshTopology, BaseLink::FLAG_STOREPATH|BaseLink::FLAG_STRONGLINK> l_topology;
 
@@ -318,6 +327,20 @@ protected:
 
     void applyStiffnessCorotational( Vector& f, const Vector& x, int i=0, Index a=0,Index b=1,Index c=2,Index d=3, SReal fact=1.0  );
 
+    ////////////// parallel computation
+    helper::vector<Index> m_coloredElements; ///< element indices sorted by color
+    helper::vector<unsigned int> m_colorOffsets; ///< first position of each color in m_coloredElements, followed by the total size
+
+    /// Greedy vertex-based coloring of the elements, used by the parallel computation
+    void computeElementColoring();
+
+    /// The parallel path is used only when requested and when it does not need to write shared data
+    bool useParallelComputation() const;
+
+    /// Call func(elementIndex) on all the elements, one color after another, elements of a color being split in concurrent tasks
+    template<class ElementFunction>
+    void parallelForEachElement(const ElementFunction& func);
+
     void handleTopologyChange() override { needUpdateTopology = true; }
 
     void computeVonMisesStress();
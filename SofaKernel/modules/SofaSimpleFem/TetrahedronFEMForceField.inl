@@ -33,6 +33,9 @@
 #include <SofaBaseLinearSolver/CompressedRowSparseMatrix.h>
 #include <sofa/simulation/AnimateBeginEvent.h>
 #include <sofa/simulation/AnimateEndEvent.h>
+#include <sofa/simulation/ParallelForRange.h>
+#include <algorithm>
+#include <limits>
 
 
 namespace sofa
@@ -73,8 +76,12 @@ TetrahedronFEMForceField<DataTypes>::TetrahedronFEMForceField()
     , _showStressAlpha(initData(&_showStressAlpha, 1.0f, "showStressAlpha", "Alpha for vonMises visualisation"))
     , _showVonMisesStressPerNode(initData(&_showVonMisesStressPerNode,false,"showVonMisesStressPerNode","draw points  showing vonMises stress interpolated in nodes"))
     , _updateStiffness(initData(&_updateStiffness,false,"updateStiffness","udpate structures (precomputed in init) using stiffness parameters in each iteration (set listening=1)"))
+    , d_parallel(initData(&d_parallel,false,"parallel","compute the forces in parallel with the TaskScheduler, using a coloring of the elements (not used when computeGlobalMatrix is set)"))
+    , d_parallelGrainSize(initData(&d_parallelGrainSize,(unsigned int)256,"parallelGrainSize","minimum number of elements computed by a single task in parallel mode"))
+    , d_nbColors(initData(&d_nbColors,(unsigned int)0,"nbColors","number of colors of the element coloring used in parallel mode"))
     , l_topology(initLink("topology", "link to the tetrahedron topology container"))
 {
+    d_nbColors.setReadOnly(true);
     _poissonRatio.setRequired(true);
     _youngModulus.setRequired(true);
     _youngModulus.beginEdit()->push_back((Real)5000.);
@@ -1607,6 +1614,137 @@ inline void TetrahedronFEMForceField<DataTypes>::reinit()
         }
         computeVonMisesStress();
     }
+
+    if (d_parallel.getValue())
+    {
+        computeElementColoring();
+    }
+    else
+    {
+        // computed on demand if the parallel mode is activated later
+        m_coloredElements.clear();
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////
+////////////////////  parallel computation  //////////////////////////
+//////////////////////////////////////////////////////////////////////
+
+template<class DataTypes>
+void TetrahedronFEMForceField<DataTypes>::computeElementColoring()
+{
+    const VecElement& elements = *_indexedElements;
+    const std::size_t nbElements = elements.size();
+
+    m_coloredElements.clear();
+    m_colorOffsets.clear();
+    m_colorOffsets.push_back(0);
+    if (nbElements == 0)
+    {
+        d_nbColors.setValue(0);
+        return;
+    }
+
+    // elements around each vertex, stored in compressed form
+    std::size_t nbPoints = 0;
+    for (const Element& e : elements)
+        for (unsigned int v = 0; v < 4; ++v)
+            nbPoints = std::max<std::size_t>(nbPoints, e[v] + 1);
+
+    helper::vector<unsigned int> aroundBegin(nbPoints + 1, 0);
+    for (const Element& e : elements)
+        for (unsigned int v = 0; v < 4; ++v)
+            ++aroundBegin[e[v] + 1];
+    for (std::size_t p = 0; p < nbPoints; ++p)
+        aroundBegin[p + 1] += aroundBegin[p];
+
+    helper::vector<Index> around(aroundBegin[nbPoints]);
+    {
+        helper::vector<unsigned int> fill(aroundBegin.begin(), aroundBegin.end() - 1);
+        for (std::size_t i = 0; i < nbElements; ++i)
+            for (unsigned int v = 0; v < 4; ++v)
+                around[fill[elements[i][v]]++] = Index(i);
+    }
+
+    // greedy coloring: each element takes the first color not used by an element sharing one of its vertices
+    const unsigned int noColor = std::numeric_limits<unsigned int>::max();
+    helper::vector<unsigned int> elementColor(nbElements, noColor);
+    helper::vector<std::size_t> forbiddenBy; // forbiddenBy[c] == i+1 if color c is used by a neighbor of element i
+    helper::vector<unsigned int> colorSize;
+    for (std::size_t i = 0; i < nbElements; ++i)
+    {
+        for (unsigned int v = 0; v < 4; ++v)
+        {
+            const Index p = elements[i][v];
+            for (unsigned int k = aroundBegin[p]; k < aroundBegin[p + 1]; ++k)
+            {
+                const unsigned int c = elementColor[around[k]];
+                if (c != noColor)
+                    forbiddenBy[c] = i + 1;
+            }
+        }
+
+        unsigned int color = 0;
+        while (color < forbiddenBy.size() && forbiddenBy[color] == i + 1)
+            ++color;
+        if (color == forbiddenBy.size())
+        {
+            forbiddenBy.push_back(0);
+            colorSize.push_back(0);
+        }
+        elementColor[i] = color;
+        ++colorSize[color];
+    }
+
+    // sort the elements by color, keeping the original order inside a color
+    const unsigned int nbColors = (unsigned int)colorSize.size();
+    m_colorOffsets.resize(nbColors + 1);
+    for (unsigned int c = 0; c < nbColors; ++c)
+        m_colorOffsets[c + 1] = m_colorOffsets[c] + colorSize[c];
+
+    m_coloredElements.resize(nbElements);
+    helper::vector<unsigned int> fill(m_colorOffsets.begin(), m_colorOffsets.end() - 1);
+    for (std::size_t i = 0; i < nbElements; ++i)
+        m_coloredElements[fill[elementColor[i]]++] = Index(i);
+
+    d_nbColors.setValue(nbColors);
+    msg_info() << nbElements << " tetras split in " << nbColors << " colors for the parallel computation.";
+}
+
+template<class DataTypes>
+bool TetrahedronFEMForceField<DataTypes>::useParallelComputation() const
+{
+    // the assembling mode accumulates the element matrices in _stiffnesses, shared between elements
+    return d_parallel.getValue() && !_assembling.getValue();
+}
+
+template<class DataTypes>
+template<class ElementFunction>
+void TetrahedronFEMForceField<DataTypes>::parallelForEachElement(const ElementFunction& func)
+{
+    if (m_coloredElements.size() != _indexedElements->size())
+    {
+        computeElementColoring();
+    }
+
+    simulation::TaskScheduler* scheduler = simulation::TaskScheduler::getInstance();
+    const unsigned int nbColors = (unsigned int)m_colorOffsets.size() - 1;
+
+    for (unsigned int c = 0; c < nbColors; ++c)
+    {
+        const Index* first = m_coloredElements.data() + m_colorOffsets[c];
+        const std::size_t nbColorElements = m_colorOffsets[c + 1] - m_colorOffsets[c];
+
+        // one chunk per thread, unless it gets smaller than the grain size;
+        // all the tasks of a color must be done before starting the next one, since colors share vertices
+        const std::size_t grainSize = simulation::getParallelGrainSize(scheduler, nbColorElements, d_parallelGrainSize.getValue());
+        simulation::parallelForRange(scheduler, 0, nbColorElements, grainSize, [&](std::size_t begin, std::size_t end)
+        {
+            for (const Index* it = first + begin; it != first + end; ++it)
+                func(*it);
+        });
+    }
 }
 
 
@@ -1625,6 +1763,30 @@ inline void TetrahedronFEMForceField<DataTypes>::addForce (const core::Mechanica
         needUpdateTopology = false;
     }
 
+    if (useParallelComputation())
+    {
+        const typename VecElement::const_iterator begin = _indexedElements->begin();
+        switch(method)
+        {
+        case SMALL :
+            parallelForEachElement([&](Index i) { accumulateForceSmall( f, p, begin + i, i ); });
+            break;
+        case LARGE :
+            parallelForEachElement([&](Index i) { accumulateForceLarge( f, p, begin + i, i ); });
+            break;
+        case POLAR :
+            parallelForEachElement([&](Index i) { accumulateForcePolar( f, p, begin + i, i ); });
+            break;
+        case SVD :
+            parallelForEachElement([&](Index i) { accumulateForceSVD( f, p, begin + i, i ); });
+            break;
+        }
+        d_f.endEdit();
+
+        updateVonMisesStress = true;
+        return;
+    }
+
     unsigned int i;
     typename VecElement::const_iterator it;
     switch(method)
@@ -1676,6 +1838,31 @@ inline void TetrahedronFEMForceField<DataTypes>::addDForce(const core::Mechanica
     Real kFactor = (Real)mparams->kFactorIncludingRayleighDamping(this->rayleighStiffness.getValue());
 
     df.resize(dx.size());
+
+    if (useParallelComputation())
+    {
+        const VecElement& elements = *_indexedElements;
+        if( method == SMALL )
+        {
+            parallelForEachElement([&](Index i)
+            {
+                const Element& e = elements[i];
+                applyStiffnessSmall( df,dx, i, e[0],e[1],e[2],e[3], kFactor );
+            });
+        }
+        else
+        {
+            parallelForEachElement([&](Index i)
+            {
+                const Element& e = elements[i];
+                applyStiffnessCorotational( df,dx, i, e[0],e[1],e[2],e[3], kFactor );
+            });
+        }
+
+        d_df.endEdit();
+        return;
+    }
+
     unsigned int i;
     typename VecElement::const_iterator it;
 
@@ -2,15 +2,22 @@
 
 #include <sofa/simulation/TaskScheduler.h>
 #include <sofa/simulation/DefaultTaskScheduler.h>
+#include <sofa/simulation/WorkStealingTaskScheduler.h>
+#include <sofa/simulation/WorkStealingDeque.h>
+#include <sofa/simulation/ParallelForRange.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
 #include <sofa/helper/testing/BaseTest.h>
 
 namespace sofa
 {
 
     // compute the Fibonacci number for input N
-    static int64_t Fibonacci(int64_t N, int nbThread = 0)
+    static int64_t Fibonacci(int64_t N, int nbThread = 0, const char* schedulerName = simulation::DefaultTaskScheduler::name())
     {
-        simulation::TaskScheduler* scheduler = simulation::TaskScheduler::create(simulation::DefaultTaskScheduler::name());
+        simulation::TaskScheduler* scheduler = simulation::TaskScheduler::create(schedulerName);
         scheduler->init(nbThread);
         
         simulation::CpuTask::Status status;
@@ -26,9 +33,9 @@ namespace sofa
     
     
     // compute the sum of integers from 1 to N
-    static int64_t IntSum1ToN(const int64_t N, int nbThread = 0)
+    static int64_t IntSum1ToN(const int64_t N, int nbThread = 0, const char* schedulerName = simulation::DefaultTaskScheduler::name())
     {
-        simulation::TaskScheduler* scheduler = simulation::TaskScheduler::create(simulation::DefaultTaskScheduler::name());
+        simulation::TaskScheduler* scheduler = simulation::TaskScheduler::create(schedulerName);
         scheduler->init(nbThread);
         
         simulation::CpuTask::Status status;
@@ -98,5 +105,131 @@ namespace sofa
         return;
     }
     
+    // compute the Fibonacci number with the work-stealing scheduler
+    TEST(TaskSchedulerTests, FibonacciWorkStealing)
+    {
+        const int64_t res = Fibonacci(27, 4, simulation::WorkStealingTaskScheduler::name());
+        EXPECT_EQ(res, 196418);
+        EXPECT_EQ(simulation::TaskScheduler::getCurrentName(), simulation::WorkStealingTaskScheduler::name());
+        return;
+    }
+    
+    // compute the sum of integers from 1 to N with the work-stealing scheduler
+    TEST(TaskSchedulerTests, IntSumWorkStealing)
+    {
+        const int64_t N = 1 << 20;
+        int64_t res = IntSum1ToN(N, 4, simulation::WorkStealingTaskScheduler::name());
+        EXPECT_EQ(res, (N)*(N + 1) / 2);
+        return;
+    }
+    
+    // the workers report their type, the threads outside of the scheduler are flagged
+    TEST(TaskSchedulerTests, WorkStealingThreadType)
+    {
+        simulation::TaskScheduler* scheduler = simulation::TaskScheduler::create(simulation::WorkStealingTaskScheduler::name());
+        scheduler->init(4);
+        EXPECT_EQ(scheduler->getCurrentThreadType(), 0);
+        
+        int externalType = 0;
+        std::thread external([&]() { externalType = scheduler->getCurrentThreadType(); });
+        external.join();
+        EXPECT_EQ(externalType, -1);
+        
+        scheduler->stop();
+    }
+    
+    // an unknown scheduler name falls back to the default scheduler
+    TEST(TaskSchedulerTests, UnknownSchedulerName)
+    {
+        simulation::TaskScheduler::create("notAScheduler");
+        EXPECT_EQ(simulation::TaskScheduler::getCurrentName(), simulation::DefaultTaskScheduler::name());
+        return;
+    }
+    
+    // the owner pops and pushes while other threads steal: each item must be taken exactly once
+    TEST(TaskSchedulerTests, WorkStealingDeque)
+    {
+        const int64_t N = 1 << 18;
+        simulation::WorkStealingDeque<int64_t> deque(4); // small capacity to test the growth
+        std::atomic<int64_t> stolenCount(0);
+        std::atomic<int64_t> stolenSum(0);
+        std::atomic<bool> done(false);
+        
+        std::vector<std::thread> thieves;
+        for (int i = 0; i < 3; ++i)
+        {
+            thieves.emplace_back([&]()
+            {
+                int64_t item;
+                while (!done.load() || !deque.empty())
+                {
+                    if (deque.steal(item))
+                    {
+                        ++stolenCount;
+                        stolenSum += item;
+                    }
+                }
+            });
+        }
+        
+        int64_t poppedCount = 0;
+        int64_t poppedSum = 0;
+        int64_t item;
+        for (int64_t i = 1; i <= N; ++i)
+        {
+            deque.push(i);
+            if (i % 3 == 0 && deque.pop(item))
+            {
+                ++poppedCount;
+                poppedSum += item;
+            }
+        }
+        while (deque.pop(item))
+        {
+            ++poppedCount;
+            poppedSum += item;
+        }
+        done.store(true);
+        for (std::thread& thief : thieves)
+        {
+            thief.join();
+        }
+        
+        EXPECT_EQ(poppedCount + stolenCount.load(), N);
+        EXPECT_EQ(poppedSum + stolenSum.load(), N*(N + 1) / 2);
+    }
+    
+    // the sub-ranges cover the range exactly once, with or without threads
+    TEST(TaskSchedulerTests, ParallelForRange)
+    {
+        const std::size_t first = 3, last = 1003, grainSize = 64;
+        simulation::TaskScheduler* scheduler = simulation::TaskScheduler::create(simulation::DefaultTaskScheduler::name());
+        for (unsigned int nbThreads : { 1u, 4u })
+        {
+            scheduler->init(nbThreads);
+            std::vector<std::atomic<int> > visits(last);
+            std::atomic<int> nbRanges(0);
+            simulation::parallelForRange(scheduler, first, last, grainSize, [&](std::size_t begin, std::size_t end)
+            {
+                ++nbRanges;
+                EXPECT_EQ((begin - first) % grainSize, 0u);
+                EXPECT_LE(end - begin, grainSize);
+                for (std::size_t i = begin; i < end; ++i)
+                    ++visits[i];
+            });
+            EXPECT_EQ(nbRanges.load(), int((last - first + grainSize - 1) / grainSize));
+            for (std::size_t i = 0; i < last; ++i)
+                EXPECT_EQ(visits[i].load(), i < first ? 0 : 1);
+        }
+        scheduler->stop();
+
+        EXPECT_EQ(simulation::getParallelGrainSize(nullptr, 1000, 10), 1000u);
+        scheduler->init(4);
+        EXPECT_EQ(simulation::getParallelGrainSize(scheduler, 1000, 10), 250u);
+        EXPECT_EQ(simulation::getParallelGrainSize(scheduler, 1000, 10, 4), 63u);
+        EXPECT_EQ(simulation::getParallelGrainSize(scheduler, 1000, 400), 400u);
+        scheduler->stop();
+    }
+
 
 } // namespace sofa
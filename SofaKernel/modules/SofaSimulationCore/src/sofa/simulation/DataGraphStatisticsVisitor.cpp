@@ -0,0 +1,90 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/simulation/DataGraphStatisticsVisitor.h>
+#include <sofa/core/objectmodel/BaseData.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace sofa
+{
+
+namespace simulation
+{
+
+Visitor::Result DataGraphStatisticsVisitor::processNodeTopDown(simulation::Node* node)
+{
+    for_each(this, node, node->object, &DataGraphStatisticsVisitor::processObject);
+    return RESULT_CONTINUE;
+}
+
+void DataGraphStatisticsVisitor::processObject(simulation::Node*, core::objectmodel::BaseObject* obj)
+{
+    Entry entry { obj, core::objectmodel::DDGNode::Statistics() };
+    auto add = [&](core::objectmodel::DDGNode* ddgNode)
+    {
+        entry.statistics.nbSetDirty += ddgNode->getStatistics().nbSetDirty;
+        entry.statistics.nbUpdate += ddgNode->getStatistics().nbUpdate;
+        if (m_reset)
+            ddgNode->resetStatistics();
+    };
+
+    for (core::objectmodel::BaseData* data : obj->getDataFields())
+        add(data);
+    // the engines are nodes of the graph themselves
+    if (core::objectmodel::DDGNode* ddgNode = dynamic_cast<core::objectmodel::DDGNode*>(obj))
+        add(ddgNode);
+
+    if (entry.statistics.nbSetDirty > 0 || entry.statistics.nbUpdate > 0)
+    {
+        m_entries.push_back(entry);
+        m_sorted = false;
+    }
+}
+
+const helper::vector<DataGraphStatisticsVisitor::Entry>& DataGraphStatisticsVisitor::getEntries()
+{
+    if (!m_sorted)
+    {
+        std::stable_sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b)
+        {
+            return a.statistics.nbSetDirty > b.statistics.nbSetDirty;
+        });
+        m_sorted = true;
+    }
+    return m_entries;
+}
+
+void DataGraphStatisticsVisitor::print(std::ostream& out, std::size_t nbEntries)
+{
+    const helper::vector<Entry>& entries = getEntries();
+    for (std::size_t i = 0; i < entries.size() && i < nbEntries; ++i)
+    {
+        out << entries[i].object->getPathName() << " (" << entries[i].object->getClassName() << "): "
+            << entries[i].statistics.nbSetDirty << " setDirty, "
+            << entries[i].statistics.nbUpdate << " update" << std::endl;
+    }
+}
+
+} // namespace simulation
+
+} // namespace sofa
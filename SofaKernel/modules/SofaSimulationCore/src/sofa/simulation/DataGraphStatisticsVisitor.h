@@ -0,0 +1,77 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#ifndef SOFA_SIMULATION_DATAGRAPHSTATISTICSVISITOR_H
+#define SOFA_SIMULATION_DATAGRAPHSTATISTICSVISITOR_H
+
+#include <sofa/core/ExecParams.h>
+#include <sofa/core/objectmodel/DDGNode.h>
+#include <sofa/simulation/Visitor.h>
+#include <sofa/simulation/Node.h>
+
+#include <iosfwd>
+
+namespace sofa
+{
+
+namespace simulation
+{
+
+/** Collect, for each component, the number of dirty flags set and of updates of its Data
+ * (and of the component itself for the engines), counted since the last reset of the
+ * statistics (see DDGNode::setStatisticsEnabled).
+ * Executed after each step with reset enabled, it gives the propagation cost per step.
+ */
+class SOFA_SIMULATION_CORE_API DataGraphStatisticsVisitor : public Visitor
+{
+public:
+    struct Entry
+    {
+        core::objectmodel::BaseObject* object;
+        core::objectmodel::DDGNode::Statistics statistics;
+    };
+
+    DataGraphStatisticsVisitor(const core::ExecParams* params, bool reset = true)
+        : Visitor(params), m_reset(reset) {}
+
+    Result processNodeTopDown(simulation::Node* node) override;
+
+    /// Components with a non zero count, by decreasing number of dirty flags set
+    const helper::vector<Entry>& getEntries();
+
+    /// Print the first nbEntries components
+    void print(std::ostream& out, std::size_t nbEntries = 10);
+
+    const char* getClassName() const override { return "DataGraphStatisticsVisitor"; }
+
+protected:
+    void processObject(simulation::Node* node, core::objectmodel::BaseObject* obj);
+
+    bool m_reset;
+    bool m_sorted { true };
+    helper::vector<Entry> m_entries;
+};
+
+} // namespace simulation
+
+} // namespace sofa
+
+#endif
@@ -0,0 +1,101 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#ifndef SOFA_SIMULATION_PARALLELFORRANGE_H
+#define SOFA_SIMULATION_PARALLELFORRANGE_H
+
+#include <sofa/simulation/TaskScheduler.h>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace sofa
+{
+
+namespace simulation
+{
+
+/// Task calling func(begin, end) on a sub-range, see parallelForRange
+template<class RangeFunction>
+class RangeTask : public CpuTask
+{
+public:
+    RangeTask(CpuTask::Status* status, const RangeFunction& func, std::size_t begin, std::size_t end)
+        : CpuTask(status)
+        , m_func(func)
+        , m_begin(begin)
+        , m_end(end)
+    {}
+
+    MemoryAlloc run() final
+    {
+        m_func(m_begin, m_end);
+        return MemoryAlloc::Dynamic;
+    }
+
+private:
+    const RangeFunction& m_func;
+    std::size_t m_begin;
+    std::size_t m_end;
+};
+
+/// Size of the sub-ranges splitting n indices in nbRangesPerThread ranges per thread of the
+/// scheduler, unless they get smaller than minGrainSize. Without scheduler, n is returned.
+inline std::size_t getParallelGrainSize(const TaskScheduler* scheduler, std::size_t n, std::size_t minGrainSize, std::size_t nbRangesPerThread = 1)
+{
+    const std::size_t nbThreads = scheduler ? std::max(1u, scheduler->getThreadCount()) : 1;
+    if (nbThreads <= 1)
+        return std::max<std::size_t>(1, n);
+    const std::size_t nbRanges = nbThreads * std::max<std::size_t>(1, nbRangesPerThread);
+    return std::max<std::size_t>(std::max<std::size_t>(1, minGrainSize), (n + nbRanges - 1) / nbRanges);
+}
+
+/// @brief Call func(begin, end) on the consecutive sub-ranges of grainSize indices covering [first, last)
+/// (the last one can be smaller), and wait until they are all done.
+///
+/// The sub-ranges are tasks of the given scheduler. Without scheduler, or if it only has one thread, they are
+/// called in order in the calling thread: a function written for one index per sub-range (grainSize = 1)
+/// gets the same calls in both cases.
+template<class RangeFunction>
+void parallelForRange(TaskScheduler* scheduler, std::size_t first, std::size_t last, std::size_t grainSize, const RangeFunction& func)
+{
+    if (first >= last)
+        return;
+    grainSize = std::max<std::size_t>(1, grainSize);
+
+    if (scheduler == nullptr || scheduler->getThreadCount() <= 1 || last - first <= grainSize)
+    {
+        for (std::size_t begin = first; begin < last; begin += grainSize)
+            func(begin, std::min(begin + grainSize, last));
+        return;
+    }
+
+    CpuTask::Status status;
+    for (std::size_t begin = first; begin < last; begin += grainSize)
+        scheduler->addTask(new RangeTask<RangeFunction>(&status, func, begin, std::min(begin + grainSize, last)));
+    scheduler->workUntilDone(&status);
+}
+
+} // namespace simulation
+
+} // namespace sofa
+
+#endif // SOFA_SIMULATION_PARALLELFORRANGE_H
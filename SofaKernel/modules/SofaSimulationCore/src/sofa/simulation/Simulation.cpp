@@ -40,6 +40,7 @@
 #include <sofa/simulation/AnimateEndEvent.h>
 #include <sofa/simulation/UpdateMappingEndEvent.h>
 #include <sofa/simulation/CleanupVisitor.h>
+#include <sofa/simulation/DataGraphStatisticsVisitor.h>
 #include <sofa/simulation/DeleteVisitor.h>
 #include <sofa/simulation/UpdateBoundingBoxVisitor.h>
 #include <sofa/simulation/UpdateLinksVisitor.h>
@@ -51,6 +52,8 @@
 #include <sofa/helper/AdvancedTimer.h>
 #include <sofa/helper/init.h>
 
+#include <sstream>
+
 #include <sofa/core/ObjectFactory.h>
 #include <sofa/core/visual/VisualParams.h>
 
@@ -234,7 +237,22 @@ void Simulation::animate ( Node* root, SReal dt )
     sofa::core::behavior::BaseAnimationLoop* aloop = root->getAnimationLoop();
     if(aloop)
     {
-        aloop->step(params,dt);
+        const std::size_t copiedBytes = sofa::core::objectmodel::BaseData::getCopiedBytes();
+        {
+            // the Data modified during the step notify their outputs once, at the end of the step
+            sofa::core::objectmodel::DDGNode::NotificationBatch notificationBatch;
+            aloop->step(params,dt);
+        }
+        sofa::helper::AdvancedTimer::valSet("DataCopiedBytes", double(sofa::core::objectmodel::BaseData::getCopiedBytes() - copiedBytes));
+
+        if (sofa::core::objectmodel::DDGNode::isStatisticsEnabled())
+        {
+            DataGraphStatisticsVisitor statistics(params);
+            root->execute(statistics);
+            std::ostringstream out;
+            statistics.print(out);
+            msg_info() << "Data graph propagation during the step:" << msgendl << out.str();
+        }
     }
     else
     {
@@ -0,0 +1,196 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#ifndef WorkStealingDeque_h__
+#define WorkStealingDeque_h__
+
+#include <sofa/config.h>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+
+namespace sofa
+{
+
+    namespace simulation
+    {
+        
+        
+        /** Lock-free work-stealing deque (Chase & Lev, "Dynamic Circular Work-Stealing Deque", SPAA 2005)
+         *  with the memory orders of Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models", PPoPP 2013.
+         *
+         *  Only the owner thread may call push() and pop(), which work at the bottom end (LIFO).
+         *  Any other thread may call steal(), which takes items at the top end (FIFO).
+         *  T must be trivially copyable (typically a pointer).
+         */
+        template<class T>
+        class WorkStealingDeque
+        {
+        public:
+            
+            explicit WorkStealingDeque(const std::int64_t capacity = 256)
+            : m_top(0)
+            , m_bottom(0)
+            {
+                std::int64_t c = 1;
+                while (c < capacity) c <<= 1;
+                m_array.store(new Array(c), std::memory_order_relaxed);
+            }
+            
+            ~WorkStealingDeque()
+            {
+                for (Array* a : m_garbage)
+                    delete a;
+                delete m_array.load(std::memory_order_relaxed);
+            }
+            
+            WorkStealingDeque(const WorkStealingDeque&) = delete;
+            WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+            
+            // owner only
+            void push(T item)
+            {
+                const std::int64_t b = m_bottom.load(std::memory_order_relaxed);
+                const std::int64_t t = m_top.load(std::memory_order_acquire);
+                Array* a = m_array.load(std::memory_order_relaxed);
+                if (b - t > a->capacity() - 1)
+                {
+                    a = grow(a, t, b);
+                }
+                a->put(b, item);
+                std::atomic_thread_fence(std::memory_order_release);
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+            }
+            
+            // owner only: take the most recently pushed item
+            bool pop(T& item)
+            {
+                const std::int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+                Array* a = m_array.load(std::memory_order_relaxed);
+                m_bottom.store(b, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                std::int64_t t = m_top.load(std::memory_order_relaxed);
+                
+                if (t > b)
+                {
+                    // empty
+                    m_bottom.store(b + 1, std::memory_order_relaxed);
+                    return false;
+                }
+                
+                item = a->get(b);
+                if (t == b)
+                {
+                    // last item: race against the thieves
+                    const bool won = m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                    m_bottom.store(b + 1, std::memory_order_relaxed);
+                    return won;
+                }
+                return true;
+            }
+            
+            // any thread: take the oldest item
+            bool steal(T& item)
+            {
+                std::int64_t t = m_top.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                const std::int64_t b = m_bottom.load(std::memory_order_acquire);
+                
+                if (t >= b)
+                {
+                    return false;
+                }
+                
+                Array* a = m_array.load(std::memory_order_acquire);
+                item = a->get(t);
+                // fails if another thief or the owner took it first
+                return m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            }
+            
+            // approximate when called concurrently
+            std::int64_t size() const
+            {
+                const std::int64_t b = m_bottom.load(std::memory_order_relaxed);
+                const std::int64_t t = m_top.load(std::memory_order_relaxed);
+                return b > t ? b - t : 0;
+            }
+            
+            bool empty() const { return size() == 0; }
+            
+        private:
+            
+            class Array
+            {
+            public:
+                explicit Array(std::int64_t capacity)
+                : m_capacity(capacity)
+                , m_mask(capacity - 1)
+                , m_buffer(new std::atomic<T>[capacity])
+                {}
+                
+                ~Array() { delete[] m_buffer; }
+                
+                std::int64_t capacity() const { return m_capacity; }
+                
+                T get(std::int64_t i) const { return m_buffer[i & m_mask].load(std::memory_order_relaxed); }
+                
+                void put(std::int64_t i, T item) { m_buffer[i & m_mask].store(item, std::memory_order_relaxed); }
+                
+                Array* grow(std::int64_t top, std::int64_t bottom) const
+                {
+                    Array* a = new Array(2 * m_capacity);
+                    for (std::int64_t i = top; i != bottom; ++i)
+                        a->put(i, get(i));
+                    return a;
+                }
+                
+            private:
+                const std::int64_t m_capacity;
+                const std::int64_t m_mask;
+                std::atomic<T>* m_buffer;
+            };
+            
+            Array* grow(Array* a, std::int64_t top, std::int64_t bottom)
+            {
+                Array* bigger = a->grow(top, bottom);
+                // thieves may still read the old array: it is released with the deque
+                m_garbage.push_back(a);
+                m_array.store(bigger, std::memory_order_release);
+                return bigger;
+            }
+            
+            enum { CACHE_LINE = 64 };
+            
+            alignas(CACHE_LINE) std::atomic<std::int64_t> m_top;
+            alignas(CACHE_LINE) std::atomic<std::int64_t> m_bottom;
+            alignas(CACHE_LINE) std::atomic<Array*> m_array;
+            std::vector<Array*> m_garbage;
+        };
+        
+        
+    } // namespace simulation
+
+} // namespace sofa
+
+
+#endif // WorkStealingDeque_h__
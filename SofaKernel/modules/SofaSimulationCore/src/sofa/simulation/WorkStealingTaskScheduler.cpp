@@ -0,0 +1,545 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/simulation/WorkStealingTaskScheduler.h>
+
+#include <cassert>
+
+
+namespace sofa
+{
+    namespace simulation
+    {
+        
+        namespace
+        {
+            // worker of the current thread, valid only for the scheduler of the same generation
+            struct CurrentWorker
+            {
+                std::uint64_t generation = 0;
+                void* worker = nullptr;
+            };
+            
+            thread_local CurrentWorker currentWorker;
+            
+            thread_local WorkStealingTaskPool* currentPool = nullptr;
+            
+            std::atomic<std::uint64_t> schedulerGeneration(0);
+        }
+        
+        
+        //----------------------
+        // WorkStealingTaskPool
+        //----------------------
+        
+        WorkStealingTaskPool::WorkStealingTaskPool()
+        {
+            for (unsigned int c = 0; c < NB_SIZE_CLASSES; ++c)
+            {
+                m_free[c] = nullptr;
+                m_remoteFree[c].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+        
+        WorkStealingTaskPool::~WorkStealingTaskPool()
+        {
+            if (currentPool == this)
+            {
+                currentPool = nullptr;
+            }
+            
+            for (unsigned int c = 0; c < NB_SIZE_CLASSES; ++c)
+            {
+                Block* lists[2] = { m_free[c], m_remoteFree[c].exchange(nullptr, std::memory_order_acquire) };
+                for (Block* block : lists)
+                {
+                    while (block)
+                    {
+                        Block* next = block->next;
+                        ::operator delete(block);
+                        block = next;
+                    }
+                }
+                m_free[c] = nullptr;
+            }
+        }
+        
+        void WorkStealingTaskPool::bindToCurrentThread()
+        {
+            currentPool = this;
+        }
+        
+        unsigned int WorkStealingTaskPool::getSizeClass(std::size_t sz)
+        {
+            const std::size_t blockSize = sz + HEADER_SIZE;
+            for (unsigned int c = 0; c < NB_SIZE_CLASSES; ++c)
+            {
+                if (blockSize <= getBlockSize(c))
+                    return c;
+            }
+            return LARGE_BLOCK;
+        }
+        
+        void* WorkStealingTaskPool::allocate(std::size_t sz)
+        {
+            const unsigned int sizeClass = getSizeClass(sz);
+            if (sizeClass == LARGE_BLOCK)
+            {
+                return allocateUnpooled(sz);
+            }
+            
+            Block* block = m_free[sizeClass];
+            if (block == nullptr)
+            {
+                // take back all the blocks freed by the other threads at once
+                block = m_remoteFree[sizeClass].exchange(nullptr, std::memory_order_acquire);
+            }
+            
+            if (block != nullptr)
+            {
+                m_free[sizeClass] = block->next;
+            }
+            else
+            {
+                block = static_cast<Block*>(::operator new(getBlockSize(sizeClass)));
+                block->owner = this;
+                block->sizeClass = sizeClass;
+            }
+            
+            return reinterpret_cast<char*>(block) + HEADER_SIZE;
+        }
+        
+        void* WorkStealingTaskPool::allocateUnpooled(std::size_t sz)
+        {
+            Block* block = static_cast<Block*>(::operator new(sz + HEADER_SIZE));
+            block->owner = nullptr;
+            block->sizeClass = LARGE_BLOCK;
+            return reinterpret_cast<char*>(block) + HEADER_SIZE;
+        }
+        
+        void WorkStealingTaskPool::free(void* ptr)
+        {
+            if (ptr == nullptr)
+            {
+                return;
+            }
+            
+            Block* block = reinterpret_cast<Block*>(static_cast<char*>(ptr) - HEADER_SIZE);
+            if (block->owner == nullptr)
+            {
+                ::operator delete(block);
+                return;
+            }
+            block->owner->release(block);
+        }
+        
+        void WorkStealingTaskPool::release(Block* block)
+        {
+            const unsigned int sizeClass = block->sizeClass;
+            if (currentPool == this)
+            {
+                block->next = m_free[sizeClass];
+                m_free[sizeClass] = block;
+                return;
+            }
+            
+            // lock-free push: only the owner pops, and it takes the whole list, so there is no ABA problem
+            Block* head = m_remoteFree[sizeClass].load(std::memory_order_relaxed);
+            do
+            {
+                block->next = head;
+            }
+            while (!m_remoteFree[sizeClass].compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+        }
+        
+        
+        //----------------------
+        // Worker
+        //----------------------
+        
+        class WorkStealingTaskScheduler::Worker
+        {
+        public:
+            
+            Worker(const int index, const std::string& name, WorkStealingTaskPool* pool)
+            : m_index(index)
+            , m_name(name + std::to_string(index))
+            , m_type(0)
+            , m_pool(pool)
+            , m_seed(std::uint32_t(index) * 2654435761u + 1u)
+            {}
+            
+            // xorshift generator used to pick the victims of the steals
+            std::uint32_t random()
+            {
+                m_seed ^= m_seed << 13;
+                m_seed ^= m_seed >> 17;
+                m_seed ^= m_seed << 5;
+                return m_seed;
+            }
+            
+            const int m_index;
+            
+            const std::string m_name;
+            
+            const int m_type;
+            
+            WorkStealingTaskPool* const m_pool;
+            
+            WorkStealingDeque<Task*> m_tasks;
+            
+            std::thread m_thread;
+            
+        private:
+            
+            std::uint32_t m_seed;
+        };
+        
+        
+        //----------------------
+        // Allocator
+        //----------------------
+        
+        class WorkStealingTaskScheduler::Allocator : public Task::Allocator
+        {
+        public:
+            
+            explicit Allocator(const WorkStealingTaskScheduler* scheduler)
+            : m_scheduler(scheduler)
+            {}
+            
+            void* allocate(std::size_t sz) final
+            {
+                Worker* worker = m_scheduler->getCurrentWorker();
+                if (worker == nullptr)
+                {
+                    return WorkStealingTaskPool::allocateUnpooled(sz);
+                }
+                return worker->m_pool->allocate(sz);
+            }
+            
+            // the size is not reliable (Task::operator delete may give 0 or the size of the base class)
+            void free(void* ptr, std::size_t sz) final
+            {
+                SOFA_UNUSED(sz);
+                WorkStealingTaskPool::free(ptr);
+            }
+            
+        private:
+            
+            const WorkStealingTaskScheduler* m_scheduler;
+        };
+        
+        
+        //----------------------
+        // WorkStealingTaskScheduler
+        //----------------------
+        
+        WorkStealingTaskScheduler* WorkStealingTaskScheduler::create()
+        {
+            return new WorkStealingTaskScheduler();
+        }
+        
+        WorkStealingTaskScheduler::WorkStealingTaskScheduler()
+        : TaskScheduler()
+        , m_allocator(new Allocator(this))
+        , m_threadCount(1)
+        , m_isInitialized(false)
+        , m_generation(++schedulerGeneration)
+        , m_isClosing(false)
+        , m_pendingTasks(0)
+        , m_sleepingWorkers(0)
+        {
+            // the creating thread is the main thread until init is called
+            m_pools.emplace_back(new WorkStealingTaskPool());
+            m_workers.emplace_back(new Worker(0, "Main  ", m_pools[0].get()));
+            currentWorker.generation = m_generation;
+            currentWorker.worker = m_workers[0].get();
+            m_pools[0]->bindToCurrentThread();
+        }
+        
+        WorkStealingTaskScheduler::~WorkStealingTaskScheduler()
+        {
+            if (m_isInitialized)
+            {
+                stop();
+            }
+            
+            if (getCurrentWorker() != nullptr)
+            {
+                currentWorker = CurrentWorker();
+            }
+        }
+        
+        unsigned WorkStealingTaskScheduler::GetHardwareThreadsCount()
+        {
+            // only physical cores: no advantage from hyperthreading
+            return std::max(1u, std::thread::hardware_concurrency() / 2);
+        }
+        
+        Task::Allocator* WorkStealingTaskScheduler::getTaskAllocator()
+        {
+            return m_allocator.get();
+        }
+        
+        void WorkStealingTaskScheduler::init(const unsigned int nbThread)
+        {
+            if (m_isInitialized)
+            {
+                if ((nbThread == m_threadCount) || (nbThread == 0 && m_threadCount == GetHardwareThreadsCount()))
+                {
+                    return;
+                }
+                stop();
+            }
+            
+            start(nbThread);
+        }
+        
+        void WorkStealingTaskScheduler::start(const unsigned int nbThread)
+        {
+            stop();
+            
+            m_isClosing.store(false, std::memory_order_relaxed);
+            m_pendingTasks.store(0, std::memory_order_relaxed);
+            
+            m_threadCount = (nbThread > 0) ? nbThread : GetHardwareThreadsCount();
+            
+            // the calling thread is the main thread
+            currentWorker.generation = m_generation;
+            currentWorker.worker = m_workers[0].get();
+            m_pools[0]->bindToCurrentThread();
+            
+            // all the workers must exist before any thread starts stealing
+            while (m_pools.size() < m_threadCount)
+            {
+                m_pools.emplace_back(new WorkStealingTaskPool());
+            }
+            for (unsigned int i = 1; i < m_threadCount; ++i)
+            {
+                m_workers.emplace_back(new Worker(int(i), "Worker", m_pools[i].get()));
+            }
+            for (unsigned int i = 1; i < m_threadCount; ++i)
+            {
+                Worker* worker = m_workers[i].get();
+                worker->m_thread = std::thread(&WorkStealingTaskScheduler::workerLoop, this, worker);
+            }
+            
+            m_isInitialized = true;
+        }
+        
+        void WorkStealingTaskScheduler::stop()
+        {
+            if (!m_isInitialized)
+            {
+                return;
+            }
+            
+            m_isClosing.store(true, std::memory_order_seq_cst);
+            wakeUpWorkers();
+            
+            for (std::size_t i = 1; i < m_workers.size(); ++i)
+            {
+                if (m_workers[i]->m_thread.joinable())
+                {
+                    m_workers[i]->m_thread.join();
+                }
+            }
+            m_workers.resize(1);
+            
+            m_threadCount = 1;
+            m_isInitialized = false;
+        }
+        
+        WorkStealingTaskScheduler::Worker* WorkStealingTaskScheduler::getCurrentWorker() const
+        {
+            if (currentWorker.generation != m_generation)
+            {
+                return nullptr;
+            }
+            return static_cast<Worker*>(currentWorker.worker);
+        }
+        
+        const char* WorkStealingTaskScheduler::getCurrentThreadName()
+        {
+            Worker* worker = getCurrentWorker();
+            return worker ? worker->m_name.c_str() : "External";
+        }
+        
+        int WorkStealingTaskScheduler::getCurrentThreadType()
+        {
+            Worker* worker = getCurrentWorker();
+            return worker ? worker->m_type : -1;
+        }
+        
+        bool WorkStealingTaskScheduler::addTask(Task* task)
+        {
+            Worker* worker = getCurrentWorker();
+            if (m_threadCount < 2 || worker == nullptr)
+            {
+                // we are single thread, or not in a thread of the scheduler: run the task
+                if (task->run() & Task::MemoryAlloc::Dynamic)
+                {
+                    task->operator delete (task, sizeof(*task));
+                }
+                return false;
+            }
+            
+            task->getStatus()->setBusy(true);
+            worker->m_tasks.push(task);
+            
+            // pairs with the check of idle(): either the sleeping worker sees the task, or we see the sleeping worker
+            m_pendingTasks.fetch_add(1, std::memory_order_seq_cst);
+            if (m_sleepingWorkers.load(std::memory_order_seq_cst) > 0)
+            {
+                wakeUpWorkers();
+            }
+            return true;
+        }
+        
+        bool WorkStealingTaskScheduler::findTask(Worker* worker, Task** task)
+        {
+            if (worker->m_tasks.pop(*task))
+            {
+                m_pendingTasks.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            
+            const std::size_t nbWorkers = m_workers.size();
+            if (nbWorkers < 2)
+            {
+                return false;
+            }
+            
+            // start from a random victim to spread the steals
+            const std::size_t first = worker->random() % nbWorkers;
+            for (std::size_t i = 0; i < nbWorkers; ++i)
+            {
+                Worker* victim = m_workers[(first + i) % nbWorkers].get();
+                if (victim != worker && victim->m_tasks.steal(*task))
+                {
+                    m_pendingTasks.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            return false;
+        }
+        
+        void WorkStealingTaskScheduler::runTask(Task* task)
+        {
+            // the task may be freed by run()
+            Task::Status* status = task->getStatus();
+            
+            if (task->run() & Task::MemoryAlloc::Dynamic)
+            {
+                task->operator delete (task, sizeof(*task));
+            }
+            
+            // publish the results of the task before it is marked as done
+            std::atomic_thread_fence(std::memory_order_release);
+            status->setBusy(false);
+        }
+        
+        void WorkStealingTaskScheduler::workUntilDone(Task::Status* status)
+        {
+            Worker* worker = getCurrentWorker();
+            if (worker == nullptr)
+            {
+                // not a thread of the scheduler: the tasks were run by addTask
+                while (status->isBusy())
+                {
+                    std::this_thread::yield();
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return;
+            }
+            
+            unsigned int spin = 0;
+            while (status->isBusy())
+            {
+                Task* task;
+                if (findTask(worker, &task))
+                {
+                    runTask(task);
+                    spin = 0;
+                }
+                else if (++spin > SPIN_COUNT)
+                {
+                    std::this_thread::yield();
+                }
+            }
+            
+            // see the results of the tasks
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        
+        void WorkStealingTaskScheduler::workerLoop(Worker* worker)
+        {
+            currentWorker.generation = m_generation;
+            currentWorker.worker = worker;
+            worker->m_pool->bindToCurrentThread();
+            
+            unsigned int spin = 0;
+            while (!m_isClosing.load(std::memory_order_acquire))
+            {
+                Task* task;
+                if (findTask(worker, &task))
+                {
+                    runTask(task);
+                    spin = 0;
+                }
+                else if (++spin < SPIN_COUNT)
+                {
+                    std::this_thread::yield();
+                }
+                else
+                {
+                    spin = 0;
+                    idle();
+                }
+            }
+            
+            currentWorker = CurrentWorker();
+        }
+        
+        void WorkStealingTaskScheduler::idle()
+        {
+            std::unique_lock<std::mutex> lock(m_wakeUpMutex);
+            m_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+            m_wakeUpEvent.wait(lock, [&] {
+                return m_isClosing.load(std::memory_order_seq_cst) || m_pendingTasks.load(std::memory_order_seq_cst) > 0;
+            });
+            m_sleepingWorkers.fetch_sub(1, std::memory_order_seq_cst);
+        }
+        
+        void WorkStealingTaskScheduler::wakeUpWorkers()
+        {
+            {
+                // a worker checking its wake up condition holds the lock: wait for it to be in wait()
+                std::lock_guard<std::mutex> guard(m_wakeUpMutex);
+            }
+            m_wakeUpEvent.notify_all();
+        }
+        
+        
+    } // namespace simulation
+
+} // namespace sofa
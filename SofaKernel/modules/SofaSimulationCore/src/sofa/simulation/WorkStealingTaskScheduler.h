@@ -0,0 +1,203 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#ifndef WorkStealingTaskScheduler_h__
+#define WorkStealingTaskScheduler_h__
+
+#include <sofa/config.h>
+
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/simulation/WorkStealingDeque.h>
+
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace sofa  {
+
+    namespace simulation
+    {
+        
+        class WorkStealingTaskScheduler;
+        
+        
+        /** Task memory pool owned by a worker thread.
+         *  Blocks are allocated without any lock by the owner thread. A block freed by the owner goes back
+         *  to its local free list, a block freed by another thread is pushed on a lock-free list which the
+         *  owner reclaims when its local list is empty.
+         */
+        class SOFA_SIMULATION_CORE_API WorkStealingTaskPool
+        {
+        public:
+            
+            WorkStealingTaskPool();
+            
+            ~WorkStealingTaskPool();
+            
+            // the calling thread becomes the owner of the pool
+            void bindToCurrentThread();
+            
+            // owner thread only
+            void* allocate(std::size_t sz);
+            
+            // any thread: memory which is not taken from a pool, for threads without pool
+            static void* allocateUnpooled(std::size_t sz);
+            
+            // any thread; ptr must come from one of the allocate functions above or be nullptr
+            static void free(void* ptr);
+            
+        private:
+            
+            struct Block
+            {
+                WorkStealingTaskPool* owner;
+                Block* next;
+                unsigned int sizeClass;
+            };
+            
+            enum
+            {
+                HEADER_SIZE = 32,   // keeps the task memory aligned on 16 bytes
+                NB_SIZE_CLASSES = 4,
+                LARGE_BLOCK = NB_SIZE_CLASSES,
+            };
+            
+            static unsigned int getSizeClass(std::size_t sz);
+            
+            static std::size_t getBlockSize(unsigned int sizeClass) { return std::size_t(64) << sizeClass; }
+            
+            void release(Block* block);
+            
+            Block* m_free[NB_SIZE_CLASSES];
+            
+            std::atomic<Block*> m_remoteFree[NB_SIZE_CLASSES];
+        };
+        
+        
+        /** Task scheduler in which each worker thread owns a lock-free work-stealing deque.
+         *  A worker pushes and pops its own tasks at the bottom of its deque and steals from the top
+         *  of a randomly chosen victim when it runs out of work. Idle workers spin for a while, then
+         *  sleep until new tasks are queued. Task memory comes from per-worker pools.
+         */
+        class SOFA_SIMULATION_CORE_API WorkStealingTaskScheduler : public TaskScheduler
+        {
+        public:
+            
+            // interface
+            
+            virtual void init(const unsigned int nbThread = 0) final;
+            virtual void stop(void) final;
+            virtual unsigned int getThreadCount(void)  const final { return m_threadCount; }
+            virtual const char* getCurrentThreadName() override final;
+            // type of the worker of the calling thread, -1 if the thread does not belong to the scheduler
+            virtual int getCurrentThreadType() override final;
+            
+            // queue task if there is space, and run it otherwise
+            bool addTask(Task* task) override final;
+            void workUntilDone(Task::Status* status) override final;
+            Task::Allocator* getTaskAllocator() override final;
+            
+        public:
+            
+            // factory methods: name, creator function
+            static const char* name() { return "_workstealing"; }
+            
+            static WorkStealingTaskScheduler* create();
+            
+            static const bool isRegistered;
+            
+        private:
+            
+            class Worker;
+            class Allocator;
+            
+            WorkStealingTaskScheduler();
+            
+            WorkStealingTaskScheduler(const WorkStealingTaskScheduler&) = delete;
+            
+            ~WorkStealingTaskScheduler() override;
+            
+            void start(unsigned int nbThread);
+            
+            // worker of the calling thread, nullptr if the thread does not belong to this scheduler
+            Worker* getCurrentWorker() const;
+            
+            // pop a task from the worker deque or steal one from another worker
+            bool findTask(Worker* worker, Task** task);
+            
+            void runTask(Task* task);
+            
+            // main loop of the worker threads
+            void workerLoop(Worker* worker);
+            
+            // block the calling worker until a task is queued or the scheduler stops
+            void idle();
+            
+            void wakeUpWorkers();
+            
+            static unsigned GetHardwareThreadsCount();
+            
+            
+        private:
+            
+            enum
+            {
+                SPIN_COUNT = 64,
+            };
+            
+            std::vector< std::unique_ptr<Worker> > m_workers;
+            
+            std::vector< std::unique_ptr<WorkStealingTaskPool> > m_pools;
+            
+            std::unique_ptr<Allocator> m_allocator;
+            
+            unsigned m_threadCount;
+            
+            bool m_isInitialized;
+            
+            // identifies this instance for the thread local worker pointers
+            const std::uint64_t m_generation;
+            
+            // The following members may be accessed by _multiple_ threads at the same time:
+            std::atomic<bool> m_isClosing;
+            
+            // number of tasks queued and not taken yet
+            std::atomic<int> m_pendingTasks;
+            
+            // number of workers waiting on m_wakeUpEvent
+            std::atomic<int> m_sleepingWorkers;
+            
+            std::mutex  m_wakeUpMutex;
+            
+            std::condition_variable m_wakeUpEvent;
+        };
+
+	} // namespace simulation
+
+} // namespace sofa
+
+
+#endif // WorkStealingTaskScheduler_h__
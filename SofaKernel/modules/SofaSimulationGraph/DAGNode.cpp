@@ -22,6 +22,13 @@
 #include <SofaSimulationGraph/DAGNode.h>
 #include <SofaSimulationCommon/xml/NodeElement.h>
 #include <sofa/helper/Factory.inl>
+#include <sofa/simulation/MechanicalVisitor.h>
+#include <sofa/simulation/ParallelForRange.h>
+#include <sofa/core/BaseMapping.h>
+#include <sofa/core/behavior/BaseInteractionForceField.h>
+#include <sofa/core/behavior/BaseInteractionConstraint.h>
+#include <sofa/core/behavior/BaseInteractionProjectiveConstraintSet.h>
+#include <sofa/core/behavior/BaseMechanicalState.h>
 
 namespace sofa
 {
@@ -126,6 +133,7 @@ GetUpObjectsVisitor::~GetUpObjectsVisitor(){}
 
 DAGNode::DAGNode(const std::string& name, DAGNode* parent)
     : simulation::Node(name)
+    , d_parallelChildren(initData(&d_parallelChildren, false, "parallelChildren", "Execute the top-down pass of thread-safe visitors in parallel on the independent child sub-graphs (using the TaskScheduler)"))
     , l_parents(initLink("parents", "Parents nodes in the graph"))
 {
     if( parent )
@@ -221,6 +229,18 @@ void DAGNode::doMoveChild(BaseNode::SPtr node, BaseNode::SPtr previous_parent)
     addChild(node);
 }
 
+bool DAGNode::doAddObject(sofa::core::objectmodel::BaseObject::SPtr obj)
+{
+    setDirtyTraversalOrder();
+    return Node::doAddObject(obj);
+}
+
+bool DAGNode::doRemoveObject(sofa::core::objectmodel::BaseObject::SPtr obj)
+{
+    setDirtyTraversalOrder();
+    return Node::doRemoveObject(obj);
+}
+
 /// Remove a child
 void DAGNode::detachFromGraph()
 {
@@ -525,6 +545,23 @@ core::topology::BaseMeshTopology* DAGNode::getMeshTopologyLink(SearchDirection d
 }
 
 
+namespace
+{
+/// replay the cached traversal orders (see DAGNode::setTraversalOrderCacheEnabled)
+bool s_traversalOrderCacheEnabled = true;
+}
+
+void DAGNode::setTraversalOrderCacheEnabled( bool enabled )
+{
+    s_traversalOrderCacheEnabled = enabled;
+}
+
+bool DAGNode::isTraversalOrderCacheEnabled()
+{
+    return s_traversalOrderCacheEnabled;
+}
+
+
 void DAGNode::precomputeTraversalOrder( const core::ExecParams* params )
 {
     // acumulating traversed Nodes
@@ -553,6 +590,318 @@ void DAGNode::precomputeTraversalOrder( const core::ExecParams* params )
 }
 
 
+DAGNode::TraversalOrderPtr DAGNode::getTraversalOrder( bool childOrderReversed )
+{
+    // the cached order is shared by the visitors possibly running simultaneously on the graph:
+    // it is built aside, then published atomically
+    TraversalOrderPtr cached = std::atomic_load( &_traversalOrder[childOrderReversed ? 1 : 0] );
+    if( !cached )
+    {
+        updateDescendancy();
+
+        std::shared_ptr<TraversalOrder> order = std::make_shared<TraversalOrder>();
+        order->nodes.reserve( _descendancy.size()+1 );
+        order->trigger.reserve( _descendancy.size()+1 );
+
+        std::map<DAGNode*,unsigned int> indices;
+        computeTraversalOrder( *order, indices, 0, childOrderReversed, this );
+
+        // parents belonging to the sub-graph, as indices in the traversal order
+        order->parentBegin.resize( order->nodes.size()+1 );
+        order->parentBegin[0] = 0;
+        for( unsigned int i = 0 ; i < order->nodes.size() ; ++i )
+        {
+            if( i > 0 ) // the parents of the root are outside of the sub-graph
+            {
+                const LinkParents::Container &parents = order->nodes[i]->l_parents.getValue();
+                for ( unsigned int p = 0; p < parents.size() ; p++ )
+                {
+                    std::map<DAGNode*,unsigned int>::const_iterator it = indices.find( parents[p] );
+                    if( it != indices.end() )
+                        order->parents.push_back( it->second );
+                }
+            }
+            order->parentBegin[i+1] = unsigned(order->parents.size());
+        }
+
+        // independent sub-graphs: a node with a single parent, followed by its descendants,
+        // which only have parents in this range
+        const unsigned int nbNodes = unsigned(order->nodes.size());
+        order->subtreeEnd.resize( nbNodes );
+        for( unsigned int i = 0 ; i < nbNodes ; ++i )
+        {
+            const unsigned int end = i + 1 + unsigned(order->nodes[i]->_descendancy.size());
+            bool independent = ( end <= nbNodes ) && ( i == 0 || order->parentBegin[i+1] - order->parentBegin[i] == 1 );
+            for( unsigned int k = i+1 ; k < end && independent ; ++k )
+                for( unsigned int p = order->parentBegin[k] ; p < order->parentBegin[k+1] && independent ; ++p )
+                    independent = ( order->parents[p] >= i );
+            order->subtreeEnd[i] = independent ? end : i;
+        }
+        order->childrenInteraction.reset( new std::atomic<unsigned char>[nbNodes] );
+        for( unsigned int i = 0 ; i < nbNodes ; ++i )
+            order->childrenInteraction[i].store( TraversalOrder::UNKNOWN, std::memory_order_relaxed );
+
+        cached = order;
+        std::atomic_store( &_traversalOrder[childOrderReversed ? 1 : 0], cached );
+    }
+    return cached;
+}
+
+
+void DAGNode::computeTraversalOrder( TraversalOrder& order, std::map<DAGNode*,unsigned int>& indices, unsigned int trigger, bool childOrderReversed, DAGNode* root )
+{
+    if( indices.find(this) != indices.end() )
+        return; // already visited
+
+    if( root != this )
+    {
+        // all parents from the sub-graph must have been visited before
+        const LinkParents::Container &parents = l_parents.getValue();
+        for ( unsigned int i = 0; i < parents.size() ; i++ )
+        {
+            if ( ( root->_descendancy.find(parents[i])!=root->_descendancy.end() || parents[i]==root )
+                 && indices.find(parents[i]) == indices.end() )
+                return; // skipped for now... the other parent should come later
+        }
+    }
+
+    const unsigned int index = unsigned(order.nodes.size());
+    indices[this] = index;
+    order.nodes.push_back( this );
+    order.trigger.push_back( trigger );
+
+    if( childOrderReversed )
+        for(unsigned int i = unsigned(child.size()); i>0;)
+            static_cast<DAGNode*>(child[--i].get())->computeTraversalOrder(order,indices,index,childOrderReversed,root);
+    else
+        for(unsigned int i = 0; i<child.size(); ++i)
+            static_cast<DAGNode*>(child[i].get())->computeTraversalOrder(order,indices,index,childOrderReversed,root);
+}
+
+
+namespace
+{
+/// STOPPED is a node pruned without recursion to its children (inactive or sleeping),
+/// it is considered as PRUNED by its children.
+enum { STOPPED = 3 };
+}
+
+bool DAGNode::childSubGraphsInteract( const TraversalOrder& order, unsigned int i, const helper::vector<std::pair<unsigned int,unsigned int> >& ranges )
+{
+    const unsigned char known = order.childrenInteraction[i].load( std::memory_order_relaxed );
+    if( known != TraversalOrder::UNKNOWN )
+        return known == TraversalOrder::INTERACTING;
+
+    // sub-graph of each node, ranges.size() for the nodes outside of the sub-graphs
+    std::map<const core::objectmodel::BaseContext*,std::size_t> nodeRange;
+    for( std::size_t r = 0 ; r < ranges.size() ; ++r )
+        for( unsigned int j = ranges[r].first ; j < ranges[r].second ; ++j )
+            nodeRange[ order.nodes[j] ] = r;
+    const std::size_t outside = ranges.size();
+
+    auto rangeOf = [&]( const core::behavior::BaseMechanicalState* state ) -> std::size_t
+    {
+        std::map<const core::objectmodel::BaseContext*,std::size_t>::const_iterator it = nodeRange.find( state->getContext() );
+        return it != nodeRange.end() ? it->second : outside;
+    };
+
+    bool interact = false;
+    bool conclusive = true; // false while some links to the states are not resolved yet
+    for( std::size_t r = 0 ; r < ranges.size() && !interact ; ++r )
+    {
+        for( unsigned int j = ranges[r].first ; j < ranges[r].second && !interact ; ++j )
+        {
+            for( const core::objectmodel::BaseObject::SPtr& obj : order.nodes[j]->object )
+            {
+                helper::vector<core::behavior::BaseMechanicalState*> written, read;
+                if( core::BaseMapping* mapping = dynamic_cast<core::BaseMapping*>( obj.get() ) )
+                {
+                    written = mapping->getMechTo();
+                    read = mapping->getMechFrom();
+                }
+                else if( core::behavior::BaseInteractionForceField* ff = dynamic_cast<core::behavior::BaseInteractionForceField*>( obj.get() ) )
+                {
+                    written.push_back( ff->getMechModel1() );
+                    written.push_back( ff->getMechModel2() );
+                }
+                else if( core::behavior::BaseInteractionConstraint* c = dynamic_cast<core::behavior::BaseInteractionConstraint*>( obj.get() ) )
+                {
+                    written.push_back( c->getMechModel1() );
+                    written.push_back( c->getMechModel2() );
+                }
+                else if( core::behavior::BaseInteractionProjectiveConstraintSet* pc = dynamic_cast<core::behavior::BaseInteractionProjectiveConstraintSet*>( obj.get() ) )
+                {
+                    written.push_back( pc->getMechModel1() );
+                    written.push_back( pc->getMechModel2() );
+                }
+
+                // the written states must belong to the sub-graph, the read states must not belong to another one
+                for( core::behavior::BaseMechanicalState* state : written )
+                {
+                    conclusive = conclusive && state;
+                    interact = interact || ( state && rangeOf( state ) != r );
+                }
+                for( core::behavior::BaseMechanicalState* state : read )
+                {
+                    conclusive = conclusive && state;
+                    const std::size_t stateRange = state ? rangeOf( state ) : outside;
+                    interact = interact || ( stateRange != r && stateRange != outside );
+                }
+                if( interact )
+                    break;
+            }
+        }
+    }
+
+    if( interact || conclusive )
+        order.childrenInteraction[i].store( interact ? TraversalOrder::INTERACTING : TraversalOrder::INDEPENDENT, std::memory_order_relaxed );
+    return interact || !conclusive;
+}
+
+
+void DAGNode::executeVisitorTopDownRange( simulation::Visitor* action, const TraversalOrderPtr& order, helper::vector<unsigned char>& status,
+                                                  unsigned int begin, unsigned int end, helper::vector<DAGNode*>& executedNodes,
+                                                  bool parallel, bool checkGraphChanges )
+{
+    const bool childOrderReversed = action->childOrderReversed(this);
+
+    for( unsigned int i = begin ; i < end ; ++i )
+    {
+        if( status[i] != NOT_VISITED )
+            continue; // already visited before the traversal order was updated
+
+        const unsigned int* parentIt = order->parents.data() + order->parentBegin[i];
+        const unsigned int* parentEnd = order->parents.data() + order->parentBegin[i+1];
+
+        // a node is reached when one of its parents continued the recursion
+        if( i > 0 )
+        {
+            bool reached = false;
+            for( const unsigned int* p = parentIt ; p != parentEnd && !reached ; ++p )
+                reached = ( status[*p] == VISITED || status[*p] == PRUNED );
+            if( !reached )
+                continue;
+        }
+
+        DAGNode* node = order->nodes[i];
+
+        if( !node->isActive() || ( node->isSleeping() && !action->canAccessSleepingNode ) )
+        {
+            // do not execute the visitor on this node nor on its children
+            status[i] = STOPPED;
+            continue;
+        }
+
+        // a child is only executed from its last parent, when all its parents have been visited
+        // and it is pruned only if all its parents are pruned
+        bool allParentsPruned = ( i > 0 );
+        if( i > 0 )
+        {
+            if( status[order->trigger[i]] != VISITED && status[order->trigger[i]] != PRUNED )
+                continue;
+            bool allParentsVisited = true;
+            for( const unsigned int* p = parentIt ; p != parentEnd ; ++p )
+            {
+                allParentsVisited = allParentsVisited && ( status[*p] != NOT_VISITED );
+                allParentsPruned = allParentsPruned && ( status[*p] != VISITED );
+            }
+            if( !allParentsVisited )
+                continue;
+        }
+
+        if( allParentsPruned )
+        {
+            status[i] = PRUNED;
+        }
+        else
+        {
+            Visitor::Result result = action->processNodeTopDown( node );
+            status[i] = ( result == simulation::Visitor::RESULT_PRUNE ? (unsigned char)PRUNED : (unsigned char)VISITED );
+            executedNodes.push_back( node );
+
+            // the graph structure was modified by the visitor
+            if( checkGraphChanges && std::atomic_load( &_traversalOrder[childOrderReversed ? 1 : 0] ) != order )
+                return;
+        }
+
+        if( parallel && node->d_parallelChildren.getValue() )
+        {
+            // the independent child sub-graphs directly following the node
+            helper::vector<std::pair<unsigned int,unsigned int> > ranges;
+            for( unsigned int j = i+1 ; j < end && order->trigger[j] == i && order->subtreeEnd[j] > j ; j = order->subtreeEnd[j] )
+                ranges.push_back( std::make_pair( j, order->subtreeEnd[j] ) );
+
+            TaskScheduler* scheduler = ranges.size() > 1 && !childSubGraphsInteract( *order, i, ranges ) ? TaskScheduler::getInstance() : nullptr;
+            if( scheduler && scheduler->getThreadCount() > 1 )
+            {
+                helper::vector< helper::vector<DAGNode*> > executedInRange( ranges.size() );
+                core::objectmodel::BaseData::ParallelTraversalScope parallelTraversal;
+                parallelForRange( scheduler, 0, ranges.size(), 1, [&]( std::size_t r, std::size_t )
+                {
+                    executeVisitorTopDownRange( action, order, status, ranges[r].first, ranges[r].second, executedInRange[r], true, false );
+                } );
+
+                for( std::size_t r = 0 ; r < ranges.size() ; ++r )
+                    executedNodes.insert( executedNodes.end(), executedInRange[r].begin(), executedInRange[r].end() );
+                i = ranges.back().second - 1;
+
+                if( checkGraphChanges && std::atomic_load( &_traversalOrder[childOrderReversed ? 1 : 0] ) != order )
+                    return;
+            }
+        }
+    }
+}
+
+
+bool DAGNode::executeVisitorWithTraversalOrder( simulation::Visitor* action )
+{
+    const bool childOrderReversed = action->childOrderReversed(this);
+    TraversalOrderPtr order = getTraversalOrder( childOrderReversed );
+
+    // an inactive or sleeping node changes the parent from which its children are reached,
+    // these (rare) cases are left to the recursive traversal
+    for( DAGNode* node : order->nodes )
+        if( !node->isActive() || ( node->isSleeping() && !action->canAccessSleepingNode ) )
+            return false;
+
+    // the independent sub-graphs can be traversed in parallel by the thread-safe visitors,
+    // except the mechanical reductions (dot products...) accumulating in a single value
+    const BaseMechanicalVisitor* mechanicalVisitor = dynamic_cast<const BaseMechanicalVisitor*>( action );
+    const bool parallel = action->isThreadSafe() && !( mechanicalVisitor && mechanicalVisitor->writeNodeData() );
+
+    helper::vector<unsigned char> status( order->nodes.size(), NOT_VISITED );
+    helper::vector<DAGNode*> executedNodes;
+    executedNodes.reserve( order->nodes.size() );
+
+    for(;;)
+    {
+        executeVisitorTopDownRange( action, order, status, 0, unsigned(order->nodes.size()), executedNodes, parallel, true );
+        if( std::atomic_load( &_traversalOrder[childOrderReversed ? 1 : 0] ) == order )
+            break;
+
+        // the graph structure was modified by the visitor,
+        // continue the traversal on the new order, keeping the already computed status
+        std::map<DAGNode*,unsigned char> previousStatus;
+        for( unsigned int j = 0 ; j < order->nodes.size() ; ++j )
+            if( status[j] != NOT_VISITED )
+                previousStatus[order->nodes[j]] = status[j];
+
+        order = getTraversalOrder( childOrderReversed );
+        status.assign( order->nodes.size(), NOT_VISITED );
+        for( unsigned int j = 0 ; j < order->nodes.size() ; ++j )
+        {
+            std::map<DAGNode*,unsigned char>::const_iterator it = previousStatus.find( order->nodes[j] );
+            if( it != previousStatus.end() )
+                status[j] = it->second;
+        }
+    }
+
+    for( helper::vector<DAGNode*>::reverse_iterator it = executedNodes.rbegin(), itend = executedNodes.rend() ; it != itend ; ++it )
+        action->processNodeBottomUp( *it );
+
+    return true;
+}
+
 
 /// Execute a recursive action starting from this node
 void DAGNode::doExecuteVisitor(simulation::Visitor* action, bool precomputedOrder)
@@ -591,6 +940,11 @@ void DAGNode::doExecuteVisitor(simulation::Visitor* action, bool precomputedOrde
             StatusMap statusMap;
             executeVisitorTreeTraversal( action, statusMap, repeat );
         }
+        else if( s_traversalOrderCacheEnabled && executeVisitorWithTraversalOrder( action ) )
+        {
+            // Direct acyclic graph traversal order, replayed from the cached order
+            // (see executeVisitorTopDown for the traversal rules)
+        }
         else
         {
             // Direct acyclic graph traversal order
@@ -722,6 +1076,8 @@ void DAGNode::executeVisitorBottomUp( simulation::Visitor* action, NodeList& exe
 void DAGNode::setDirtyDescendancy()
 {
     _descendancy.clear();
+    std::atomic_store( &_traversalOrder[0], TraversalOrderPtr() );
+    std::atomic_store( &_traversalOrder[1], TraversalOrderPtr() );
     const LinkParents::Container &parents = l_parents.getValue();
     for ( unsigned int i = 0; i < parents.size() ; i++ )
     {
@@ -729,6 +1085,17 @@ void DAGNode::setDirtyDescendancy()
     }
 }
 
+void DAGNode::setDirtyTraversalOrder()
+{
+    std::atomic_store( &_traversalOrder[0], TraversalOrderPtr() );
+    std::atomic_store( &_traversalOrder[1], TraversalOrderPtr() );
+    const LinkParents::Container &parents = l_parents.getValue();
+    for ( unsigned int i = 0; i < parents.size() ; i++ )
+    {
+        parents[i]->setDirtyTraversalOrder();
+    }
+}
+
 void DAGNode::updateDescendancy()
 {
     if( _descendancy.empty() && !child.empty() )
@@ -26,6 +26,8 @@
 #include <sofa/simulation/Node.h>
 #include <sofa/core/objectmodel/Link.h>
 #include <sofa/simulation/Visitor.h>
+#include <atomic>
+#include <memory>
 
 namespace sofa
 {
@@ -43,6 +45,16 @@ namespace graph
  * NB: contrary to the "tree" traversal, there are no interlinked forward/backward callbacks. There are only forward then only backward callbacks.
  *
  * Note that nodes created during a traversal are not traversed if they are created upper than the current node during the top-down traversal or if they are created during the bottom-up traversal.
+ *
+ * The DAG traversal order of the sub-graph rooted at a node is flattened in an array the first time a visitor is executed
+ * from this node, then replayed by the following visitors. This array is only recomputed when a child is added, removed
+ * or moved somewhere in the sub-graph. Activation, sleeping and pruning are still evaluated for each visitor.
+ *
+ * When 'parallelChildren' is set, the top-down pass of thread-safe visitors is executed in parallel (with the TaskScheduler)
+ * on the independent child sub-graphs of the node, i.e. the child sub-graphs that do not share any node with the rest of the graph.
+ * The bottom-up pass (where the mappings go back up) remains sequential. The child sub-graphs accessing the states of each other
+ * (through interaction force fields, interaction constraints or mappings placed in one of them) are traversed sequentially.
+ * This is checked when the graph structure or the objects of the sub-graph change, not when a link is changed.
  */
 class SOFA_SIMULATION_GRAPH_API DAGNode : public simulation::Node
 {
@@ -136,9 +148,16 @@ public:
     /// it uses the node descendancy informations.
     Node* findCommonParent( Node* node2 ) override;
 
+    Data<bool> d_parallelChildren; ///< execute the top-down pass of thread-safe visitors in parallel on the independent child sub-graphs
+
     /// compute the traversal order from this Node
     void precomputeTraversalOrder( const core::ExecParams* params ) override;
 
+    /// Enable/disable the replay of the cached traversal orders (enabled by default).
+    /// When disabled, every visitor recomputes its traversal (used for debugging and benchmarking).
+    static void setTraversalOrderCacheEnabled( bool enabled );
+    static bool isTraversalOrderCacheEnabled();
+
 protected:
 
     /// bottom-up traversal, returning the first node which have a descendancy containing both node1 & node2
@@ -153,6 +172,9 @@ protected:
     virtual void doRemoveChild(BaseNode::SPtr node) override;
     virtual void doMoveChild(BaseNode::SPtr node, BaseNode::SPtr previous_parent) override;
 
+    bool doAddObject(sofa::core::objectmodel::BaseObject::SPtr obj) override;
+    bool doRemoveObject(sofa::core::objectmodel::BaseObject::SPtr obj) override;
+
 
     /// Execute a recursive action starting from this node.
     void doExecuteVisitor(simulation::Visitor* action, bool precomputedOrder=false) override;
@@ -168,6 +190,9 @@ protected:
     /// bottom-up traversal removing descendancy
     void setDirtyDescendancy();
 
+    /// bottom-up traversal removing the cached traversal orders (the interactions between the sub-graphs may have changed)
+    void setDirtyTraversalOrder();
+
     /// traversal updating the descendancy
     void updateDescendancy();
 
@@ -203,6 +228,53 @@ protected:
     /// the ordered list of Node to traverse from this Node
     NodeList _precomputedTraversalOrder;
 
+    /// flattened top-down traversal order of the sub-graph rooted at a node
+    struct TraversalOrder
+    {
+        /// the nodes in top-down order, nodes[0] being the root of the sub-graph
+        helper::vector<DAGNode*> nodes;
+        /// for each node, index of the parent from which the recursive traversal reaches it
+        /// (its last parent in the top-down order)
+        helper::vector<unsigned int> trigger;
+        /// for each node, range [parentBegin[i],parentBegin[i+1]) of its parents indices in 'parents'
+        /// (only the parents belonging to the sub-graph are stored)
+        helper::vector<unsigned int> parentBegin;
+        helper::vector<unsigned int> parents;
+        /// for each node, end of the range [i,subtreeEnd[i]) containing exactly the node and its descendants
+        /// when this sub-graph is independent (single parent, no descendant with a parent outside of the range),
+        /// or i otherwise
+        helper::vector<unsigned int> subtreeEnd;
+        /// for each node, whether its independent child sub-graphs interact (INTERACTING) or not (INDEPENDENT),
+        /// checked at the first parallel traversal of the node (UNKNOWN before)
+        std::unique_ptr< std::atomic<unsigned char>[] > childrenInteraction;
+        enum { UNKNOWN=0, INDEPENDENT, INTERACTING };
+    };
+    typedef std::shared_ptr<const TraversalOrder> TraversalOrderPtr;
+
+    /// the cached traversal orders from this Node, with the children in the regular and in the reversed order
+    TraversalOrderPtr _traversalOrder[2];
+
+    /// return the cached traversal order from this Node, recomputing it if the graph changed
+    TraversalOrderPtr getTraversalOrder( bool childOrderReversed );
+
+    /// @internal recursive computation of the traversal order, following the same rules than executeVisitorTopDown
+    void computeTraversalOrder( TraversalOrder& order, std::map<DAGNode*,unsigned int>& indices, unsigned int trigger, bool childOrderReversed, DAGNode* root );
+
+    /// @internal DAG traversal replaying the cached traversal order
+    /// @return false (w/o traversing) when the sub-graph contains inactive or sleeping nodes
+    bool executeVisitorWithTraversalOrder( simulation::Visitor* action );
+
+    /// @internal top-down traversal of the range [begin,end) of a cached traversal order,
+    /// stopping after the first node where the visitor modified the graph structure if checkGraphChanges is set
+    void executeVisitorTopDownRange( simulation::Visitor* action, const TraversalOrderPtr& order, helper::vector<unsigned char>& status,
+                                             unsigned int begin, unsigned int end, helper::vector<DAGNode*>& executedNodes,
+                                             bool parallel, bool checkGraphChanges );
+
+    /// @internal whether a component of one of the given independent child sub-graphs of the node order.nodes[i]
+    /// accesses the states of another one (interaction force field or constraint, mapping),
+    /// in which case they cannot be traversed in parallel
+    bool childSubGraphsInteract( const TraversalOrder& order, unsigned int i, const helper::vector<std::pair<unsigned int,unsigned int> >& ranges );
+
     /// @internal performing only the top-down traversal on a DAG
     /// @executedNodes will be fill with the DAGNodes where the top-down action is processed
     /// @statusMap the visitor's flag map
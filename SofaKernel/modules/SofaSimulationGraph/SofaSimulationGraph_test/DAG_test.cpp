@@ -31,6 +31,14 @@ using sofa::helper::testing::BaseTest ;
 using sofa::simulation::graph::DAGNode;
 
 #include <SofaSimulationGraph/DAGSimulation.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <SofaBaseMechanics/MechanicalObject.h>
+#include <SofaDeformable/StiffSpringForceField.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <thread>
 
 namespace sofa {
 
@@ -290,6 +298,244 @@ Expected output: RABCDEEDCBAR
 
 
 
+    /// Visitor pruning the traversal on the nodes whose name is listed in 'pruned'
+    struct PruningVisitor : public TestVisitor
+    {
+        std::string pruned;
+
+        Result processNodeTopDown(simulation::Node* node) override
+        {
+            TestVisitor::processNodeTopDown(node);
+            return pruned.find(node->getName()) != std::string::npos ? RESULT_PRUNE : RESULT_CONTINUE;
+        }
+    };
+
+    /// check the cached traversal order gives the same traversal than the recursive one
+    static void compareWithRecursiveTraversal( Node::SPtr node, const std::string& pruned )
+    {
+        PruningVisitor cached, recursive;
+        cached.pruned = recursive.pruned = pruned;
+
+        DAGNode::setTraversalOrderCacheEnabled(false);
+        recursive.execute( node.get() );
+        DAGNode::setTraversalOrderCacheEnabled(true);
+        cached.execute( node.get() );
+
+        EXPECT_EQ( recursive.topdown, cached.topdown ) << "pruned nodes: " << pruned;
+        EXPECT_EQ( recursive.bottomup, cached.bottomup ) << "pruned nodes: " << pruned;
+    }
+
+    /**
+      * @brief Compare the cached traversal order with the recursive traversal,
+      * with pruned, inactive nodes and modifications of the graph structure
+      */
+    void traverse_cachedOrder()
+    {
+        /*
+          R______
+         / \ \ \ \
+         A B C D E
+         \/__/_/_/
+          F
+          |\
+          G |
+          |/
+          H
+        */
+        Node::SPtr root = clearScene();
+        root->setName("R");
+        Node::SPtr A = root->createChild("A");
+        Node::SPtr B = root->createChild("B");
+        Node::SPtr C = root->createChild("C");
+        Node::SPtr D = root->createChild("D");
+        Node::SPtr E = root->createChild("E");
+        Node::SPtr F = A->createChild("F");
+        B->addChild(F);
+        C->addChild(F);
+        D->addChild(F);
+        E->addChild(F);
+        Node::SPtr G = F->createChild("G");
+        Node::SPtr H = G->createChild("H");
+        F->addChild(H);
+
+        for( const std::string pruned : { "", "R", "A", "AB", "ABCDE", "F", "G", "GF" } )
+        {
+            compareWithRecursiveTraversal( root, pruned );
+            compareWithRecursiveTraversal( F, pruned );
+        }
+
+        // inactive nodes stop the traversal
+        C->setActive(false);
+        compareWithRecursiveTraversal( root, "" );
+        E->setActive(false);
+        compareWithRecursiveTraversal( root, "" );
+        C->setActive(true);
+        E->setActive(true);
+        G->setActive(false);
+        compareWithRecursiveTraversal( root, "" );
+        G->setActive(true);
+
+        // the cached order is updated when the graph changes
+        TestVisitor t;
+        t.execute( root.get() );
+        EXPECT_EQ( "RABCDEFGH", t.topdown );
+
+        Node::SPtr I = C->createChild("I");
+        t.clear();
+        t.execute( root.get() );
+        EXPECT_EQ( "RABCIDEFGH", t.topdown );
+
+        G->removeChild(H);
+        t.clear();
+        t.execute( root.get() );
+        EXPECT_EQ( "RABCIDEFGH", t.topdown );
+        t.clear();
+        t.execute( F.get() );
+        EXPECT_EQ( "FGH", t.topdown );
+
+        I->moveChild(G);
+        t.clear();
+        t.execute( root.get() );
+        EXPECT_EQ( "RABCIGDEFH", t.topdown );
+        compareWithRecursiveTraversal( root, "I" );
+
+        // w/o precomputation, a visitor asking for the precomputed order follows the regular traversal
+        PruningVisitor p;
+        p.pruned = "C";
+        p.execute( root.get(), true );
+        EXPECT_EQ( "RABCDEFH", p.topdown );
+
+        // the precomputed order is replayed w/o pruning
+        root->precomputeTraversalOrder( sofa::core::ExecParams::defaultInstance() );
+        p.clear();
+        p.execute( root.get(), true );
+        EXPECT_EQ( "RABCIGDEFH", p.topdown );
+    }
+
+
+    /// Thread-safe visitor recording the traversed nodes: the top-down callbacks of the
+    /// parallel sub-graphs are recorded per thread, the bottom-up ones in a single string.
+    struct ThreadSafeTestVisitor : public sofa::simulation::Visitor
+    {
+        std::mutex mutex;
+        std::map<std::thread::id, std::string> topdown;
+        std::string bottomup;
+
+        ThreadSafeTestVisitor() : Visitor(sofa::core::ExecParams::defaultInstance()) {}
+
+        Result processNodeTopDown(simulation::Node* node) override
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            topdown[std::this_thread::get_id()] += node->getName();
+            return RESULT_CONTINUE;
+        }
+
+        void processNodeBottomUp(simulation::Node* node) override
+        {
+            bottomup += node->getName();
+        }
+
+        bool isThreadSafe() const override { return true; }
+
+        std::string allTopDown() const
+        {
+            std::string all;
+            for( const auto& t : topdown )
+                all += t.second;
+            std::sort(all.begin(), all.end());
+            return all;
+        }
+    };
+
+    /**
+      * @brief Parallel traversal of the independent child sub-graphs
+      *
+          R___
+         / \  \
+         A  B  C
+         |  |\ |
+         D  E F|
+            |/ |
+            G  H
+      */
+    void traverse_parallelChildren()
+    {
+        Node::SPtr root = clearScene();
+        root->setName("R");
+        Node::SPtr A = root->createChild("A");
+        Node::SPtr B = root->createChild("B");
+        Node::SPtr C = root->createChild("C");
+        Node::SPtr D = A->createChild("D");
+        Node::SPtr E = B->createChild("E");
+        Node::SPtr F = B->createChild("F");
+        Node::SPtr G = E->createChild("G");
+        F->addChild(G);
+        C->createChild("H");
+
+        TestVisitor serial;
+        serial.execute( root.get() );
+        EXPECT_EQ( "RADBEFGCH", serial.topdown );
+
+        static_cast<DAGNode*>(root.get())->d_parallelChildren.setValue(true);
+
+        ThreadSafeTestVisitor parallel;
+        parallel.execute( root.get() );
+
+        // same nodes traversed, and bottom-up pass identical to the serial one
+        std::string sortedSerial = serial.topdown;
+        std::sort(sortedSerial.begin(), sortedSerial.end());
+        EXPECT_EQ( sortedSerial, parallel.allTopDown() );
+        EXPECT_EQ( serial.bottomup, parallel.bottomup );
+
+        // a sub-graph shared with another branch is not independent
+        Node::SPtr I = C->createChild("I");
+        D->addChild(I);
+        serial.clear();
+        serial.execute( root.get() );
+        ThreadSafeTestVisitor parallel2;
+        parallel2.execute( root.get() );
+        sortedSerial = serial.topdown;
+        std::sort(sortedSerial.begin(), sortedSerial.end());
+        EXPECT_EQ( sortedSerial, parallel2.allTopDown() );
+        EXPECT_EQ( serial.bottomup, parallel2.bottomup );
+    }
+
+    /**
+      * @brief The child sub-graphs linked by an interaction force field are traversed sequentially
+      *
+          R
+         / \
+         A  B
+      */
+    void traverse_parallelChildrenInteraction()
+    {
+        typedef sofa::component::container::MechanicalObject<sofa::defaulttype::Vec3Types> MechanicalObject3;
+        typedef sofa::component::interactionforcefield::StiffSpringForceField<sofa::defaulttype::Vec3Types> StiffSpringForceField3;
+
+        Node::SPtr root = clearScene();
+        root->setName("R");
+        Node::SPtr A = root->createChild("A");
+        Node::SPtr B = root->createChild("B");
+        MechanicalObject3::SPtr stateA = sofa::core::objectmodel::New<MechanicalObject3>();
+        MechanicalObject3::SPtr stateB = sofa::core::objectmodel::New<MechanicalObject3>();
+        A->addObject(stateA);
+        B->addObject(stateB);
+        static_cast<DAGNode*>(root.get())->d_parallelChildren.setValue(true);
+
+        // the spring writes the forces of both sub-graphs
+        A->addObject( sofa::core::objectmodel::New<StiffSpringForceField3>(stateA.get(), stateB.get()) );
+
+        for( int i = 0 ; i < 10 ; ++i )
+        {
+            ThreadSafeTestVisitor parallel;
+            parallel.execute( root.get() );
+            ASSERT_EQ( 1u, parallel.topdown.size() );
+            EXPECT_EQ( "RAB", parallel.topdown[std::this_thread::get_id()] );
+            EXPECT_EQ( "BAR", parallel.bottomup );
+        }
+    }
+
+
     static void getObjectByPath( Node::SPtr node, const std::string& searchpath, const std::string& objpath )
     {
         void *foundObj = node->getObject(classid(Dummy), searchpath);
@@ -378,6 +624,20 @@ TEST_F( DAG_test, traverse )
     traverse_morecomplex2();
 }
 
+TEST_F( DAG_test, traverseParallelChildren )
+{
+    EXPECT_MSG_NOEMIT(Error) ;
+    sofa::simulation::TaskScheduler::create()->init(4);
+    traverse_parallelChildren();
+    traverse_parallelChildrenInteraction();
+}
+
+TEST_F( DAG_test, traverseCachedOrder )
+{
+    EXPECT_MSG_NOEMIT(Error) ;
+    traverse_cachedOrder();
+}
+
 TEST(DAGNodeTest, objectDestruction_singleObject)
 {
     EXPECT_MSG_NOEMIT(Error) ;
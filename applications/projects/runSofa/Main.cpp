@@ -94,6 +94,8 @@ using  sofa::helper::logging::RichConsoleStyleMessageFormatter ;
 using  sofa::helper::logging::MainPerComponentLoggingMessageHandler ;
 
 #include <sofa/helper/AdvancedTimer.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/core/objectmodel/BaseData.h>
 
 #include <sofa/gui/GuiDataRepository.h>
 using sofa::gui::GuiDataRepository ;
@@ -182,9 +184,16 @@ int main(int argc, char** argv)
     bool computationTimeAtBegin = false;
     unsigned int computationTimeSampling=0; ///< Frequency of display of the computation time statistics, in number of animation steps. 0 means never.
     string    computationTimeOutputType="stdout";
+    string    traceFile = ""; ///< Chrome trace-event file written with the AdvancedTimer records of the animation steps
+    unsigned int traceFirstStep = 0;
+    unsigned int traceNbSteps = 0;
 
     string gui = "";
     string verif = "";
+    string taskScheduler = "";
+    bool sharedDataBuffers = false;
+    bool dataNotificationBatch = false;
+    bool dataGraphStatistics = false;
 
 #if defined(SOFA_HAVE_DAG)
     string simulationType = "dag";
@@ -237,7 +246,25 @@ int main(int argc, char** argv)
         boost::program_options::value<std::string>(&computationTimeOutputType)
         ->default_value("stdout"),
         "computationTimeOutputType,o",
-        "Output type for the computation time statistics: either stdout, json or ljson"
+        "Output type for the computation time statistics: either stdout, json, ljson or trace"
+    );
+    argParser->addArgument(
+        boost::program_options::value<std::string>(&traceFile)
+        ->default_value(""),
+        "traceFile",
+        "Write the AdvancedTimer events of the animation steps to this file in the Chrome trace-event format (chrome://tracing, ui.perfetto.dev)"
+    );
+    argParser->addArgument(
+        boost::program_options::value<unsigned int>(&traceFirstStep)
+        ->default_value(0),
+        "traceFirstStep",
+        "Index of the first animation step written to the trace file"
+    );
+    argParser->addArgument(
+        boost::program_options::value<unsigned int>(&traceNbSteps)
+        ->default_value(0),
+        "traceNbSteps",
+        "Number of animation steps written to the trace file. 0 means all the steps."
     );
     argParser->addArgument(
         boost::program_options::value<std::string>(&gui)->default_value(""),
@@ -325,6 +352,35 @@ int main(int argc, char** argv)
         "forward extra args to the python interpreter"
     );
 
+    argParser->addArgument(
+        boost::program_options::value<std::string>(&taskScheduler)
+        ->default_value(""),
+        "taskScheduler",
+        "select the task scheduler used by the multithreaded components (_default, _workstealing)"
+    );
+
+    argParser->addArgument(
+        boost::program_options::value<bool>(&sharedDataBuffers)
+        ->default_value(false)
+        ->implicit_value(true),
+        "sharedDataBuffers",
+        "edit in place the vectors only shared with the Data linked to them, instead of copying them"
+    );
+    argParser->addArgument(
+        boost::program_options::value<bool>(&dataNotificationBatch)
+        ->default_value(false)
+        ->implicit_value(true),
+        "dataNotificationBatch",
+        "notify the modified Data once at the end of each animation step (the DataCallbacks are delayed to the end of the step)"
+    );
+    argParser->addArgument(
+        boost::program_options::value<bool>(&dataGraphStatistics)
+        ->default_value(false)
+        ->implicit_value(true),
+        "dataGraphStatistics",
+        "count the propagations in the Data graph and log the busiest components after each animation step"
+    );
+
     // example of an option using lambda function which ensure the value passed is > 0
     argParser->addArgument(
         boost::program_options::value<unsigned int>(&nbMSSASamples)
@@ -360,6 +416,17 @@ int main(int argc, char** argv)
     sofa::component::initSofaGeneral();
     sofa::component::initSofaMisc();
 
+    sofa::core::objectmodel::BaseData::setSharedBufferEnabled(sharedDataBuffers);
+    sofa::core::objectmodel::DDGNode::setNotificationBatchEnabled(dataNotificationBatch);
+    sofa::core::objectmodel::DDGNode::setStatisticsEnabled(dataGraphStatistics);
+
+    if (!taskScheduler.empty())
+    {
+        sofa::simulation::TaskScheduler::create(taskScheduler.c_str())->init();
+        if (sofa::simulation::TaskScheduler::getCurrentName() != taskScheduler)
+            msg_warning("runSofa") << "Unknown task scheduler '" << taskScheduler << "', using '" << sofa::simulation::TaskScheduler::getCurrentName() << "'";
+    }
+
 #ifdef SOFA_HAVE_DAG
     if (simulationType == "tree")
         sofa::simulation::setSimulation(new TreeSimulation());
@@ -534,6 +601,11 @@ int main(int argc, char** argv)
         sofa::helper::AdvancedTimer::setOutputType("Animate", computationTimeOutputType);
     }
 
+    if (!traceFile.empty())
+    {
+        sofa::helper::AdvancedTimer::setTraceOutput("Animate", traceFile, traceFirstStep, traceNbSteps);
+    }
+
     //=======================================
     // Run the main loop
     if (int err = GUIManager::MainLoop(groot,fileName.c_str()))
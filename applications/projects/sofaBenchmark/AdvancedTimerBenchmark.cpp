@@ -0,0 +1,208 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Benchmark.h"
+
+#include <SofaSimulationCommon/SceneLoaderXML.h>
+#include <SofaSimulationGraph/DAGSimulation.h>
+#include <sofa/core/ExecParams.h>
+#include <sofa/helper/AdvancedTimer.h>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using sofa::helper::AdvancedTimer;
+using sofa::simulation::Node;
+
+namespace
+{
+
+using namespace sofa::benchmark;
+
+const char* timerName = "TimerOverhead";
+
+/// Small FEM beam used when no scene is given with --input.
+const std::string defaultScene =
+    "<Node name='root' dt='0.01' gravity='0 -9.81 0'>"
+    "  <DefaultAnimationLoop/>"
+    "  <DefaultVisualManagerLoop/>"
+    "  <EulerImplicitSolver rayleighStiffness='0.1' rayleighMass='0.1'/>"
+    "  <CGLinearSolver iterations='25' tolerance='1e-9' threshold='1e-9'/>"
+    "  <RegularGridTopology name='grid' n='16 4 4' min='0 0 0' max='15 3 3'/>"
+    "  <MechanicalObject template='Vec3d'/>"
+    "  <TetrahedronSetTopologyContainer name='tetras'/>"
+    "  <Hexa2TetraTopologicalMapping input='@grid' output='@tetras'/>"
+    "  <UniformMass totalMass='10'/>"
+    "  <TetrahedronFEMForceField youngModulus='5000' poissonRatio='0.3' method='large' topology='@tetras'/>"
+    "  <BoxROI name='box' box='-0.1 -0.1 -0.1 0.1 3.1 3.1'/>"
+    "  <FixedConstraint indices='@box.indices'/>"
+    "</Node>";
+
+/// Enable the timer and make sure it never prints during the measures.
+void setTimerEnabled(bool enabled)
+{
+    AdvancedTimer::setEnabled(timerName, enabled);
+    if (enabled)
+        AdvancedTimer::setInterval(timerName, 1 << 30);
+}
+
+void reportPairCost(const std::string& label, double bestMs, std::size_t nbPairs)
+{
+    std::cout << "  " << std::left << std::setw(56) << label << std::right
+              << std::fixed << std::setprecision(1)
+              << " " << std::setw(8) << bestMs * 1e6 / nbPairs << " ns per stepBegin/stepEnd" << std::endl;
+}
+
+void benchmarkAdvancedTimerSteps(const BenchmarkOptions& options)
+{
+    const std::size_t nbPairs = options.size > 0 ? options.size : 100000;
+    const unsigned int nbNames = 256;
+
+    std::vector<std::string> names;
+    for (unsigned int i = 0; i < nbNames; ++i)
+        names.push_back("BenchmarkStep" + std::to_string(i));
+    // intern the names once so that the first measure does not pay for the insertions
+    for (const std::string& name : names)
+        AdvancedTimer::IdStep stepId(name);
+
+    for (bool enabled : { false, true })
+    {
+        setTimerEnabled(enabled);
+        const std::string mode = enabled ? "timer on,  " : "timer off, ";
+
+        // the timer keeps every record until end() is called, so each measure is its own timer iteration
+        const double sameMs = measure(options, mode + "string step, same name", [&]()
+        {
+            AdvancedTimer::begin(timerName);
+            for (std::size_t i = 0; i < nbPairs; ++i)
+            {
+                AdvancedTimer::stepBegin("BenchmarkStep0");
+                AdvancedTimer::stepEnd("BenchmarkStep0");
+            }
+            AdvancedTimer::end(timerName);
+        });
+        reportPairCost(mode + "string step, same name", sameMs, nbPairs);
+
+        const double distinctMs = measure(options, mode + "string step, " + std::to_string(nbNames) + " names", [&]()
+        {
+            AdvancedTimer::begin(timerName);
+            for (std::size_t i = 0; i < nbPairs; ++i)
+            {
+                const std::string& name = names[i % nbNames];
+                AdvancedTimer::stepBegin(name);
+                AdvancedTimer::stepEnd(name);
+            }
+            AdvancedTimer::end(timerName);
+        });
+        reportPairCost(mode + "string step, " + std::to_string(nbNames) + " names", distinctMs, nbPairs);
+
+        const double macroMs = measure(options, mode + "SOFA_ADVANCEDTIMER_STEP_ID step", [&]()
+        {
+            AdvancedTimer::begin(timerName);
+            for (std::size_t i = 0; i < nbPairs; ++i)
+            {
+                AdvancedTimer::stepBegin(SOFA_ADVANCEDTIMER_STEP_ID("BenchmarkStep0"));
+                AdvancedTimer::stepEnd(SOFA_ADVANCEDTIMER_STEP_ID("BenchmarkStep0"));
+            }
+            AdvancedTimer::end(timerName);
+        });
+        reportPairCost(mode + "SOFA_ADVANCEDTIMER_STEP_ID step", macroMs, nbPairs);
+
+        const double scopedMs = measure(options, mode + "ScopedAdvancedTimer in a worker thread", [&]()
+        {
+            AdvancedTimer::begin(timerName);
+            std::thread worker([&]()
+            {
+                for (std::size_t i = 0; i < nbPairs; ++i)
+                {
+                    sofa::helper::ScopedAdvancedTimer step("BenchmarkStep0");
+                }
+            });
+            worker.join();
+            AdvancedTimer::end(timerName);
+        });
+        reportPairCost(mode + "ScopedAdvancedTimer in a worker thread", scopedMs, nbPairs);
+    }
+    setTimerEnabled(false);
+}
+
+void benchmarkAdvancedTimerScene(const BenchmarkOptions& options)
+{
+    const unsigned int nbSteps = 100;
+    sofa::simulation::setSimulation(new sofa::simulation::graph::DAGSimulation());
+    sofa::simulation::Simulation* simulation = sofa::simulation::getSimulation();
+
+    Node::SPtr root;
+    std::string sceneName = "default FEM beam";
+    if (!options.inputs.empty())
+    {
+        sceneName = options.inputs.front();
+        root = simulation->load(sceneName.c_str());
+    }
+    else
+    {
+        root = sofa::simulation::SceneLoaderXML::loadFromMemory("AdvancedTimerBenchmark", defaultScene.c_str(), defaultScene.size());
+    }
+    if (!root)
+    {
+        std::cerr << "  unable to load the scene " << sceneName << std::endl;
+        return;
+    }
+    simulation->init(root.get());
+    std::cout << "  " << sceneName << ", " << nbSteps << " steps per measure" << std::endl;
+
+    double offMs = 0;
+    for (bool enabled : { false, true })
+    {
+        setTimerEnabled(enabled);
+        const std::string label = std::string(enabled ? "timer on" : "timer off") + ", animate";
+        const double bestMs = measure(options, label, [&]()
+        {
+            for (unsigned int i = 0; i < nbSteps; ++i)
+            {
+                AdvancedTimer::begin(timerName);
+                simulation->animate(root.get(), root->getDt());
+                AdvancedTimer::end(timerName);
+            }
+        });
+        if (enabled)
+            std::cout << "  overhead of the enabled timer: " << std::fixed << std::setprecision(1)
+                      << 100.0 * (bestMs - offMs) / offMs << " % of the step time" << std::endl;
+        else
+            offMs = bestMs;
+    }
+    setTimerEnabled(false);
+
+    simulation->unload(root);
+}
+
+const bool advancedTimerStepsRegistered = registerBenchmark("AdvancedTimerSteps",
+    "cost of an AdvancedTimer stepBegin/stepEnd pair with the timer off and on, by name, by interned id and from a worker thread",
+    &benchmarkAdvancedTimerSteps);
+
+const bool advancedTimerSceneRegistered = registerBenchmark("AdvancedTimerScene",
+    "step time of a scene (first --input, or a built-in FEM beam) with the AdvancedTimer off and on",
+    &benchmarkAdvancedTimerScene);
+
+} // namespace
@@ -0,0 +1,80 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+namespace sofa
+{
+
+namespace benchmark
+{
+
+std::vector<Benchmark>& getBenchmarks()
+{
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+bool registerBenchmark(const std::string& name, const std::string& description,
+                       std::function<void(const BenchmarkOptions&)> run)
+{
+    getBenchmarks().push_back(Benchmark{ name, description, run });
+    return true;
+}
+
+double measure(const BenchmarkOptions& options, const std::string& label, const std::function<void()>& func)
+{
+    using clock = std::chrono::steady_clock;
+
+    func(); // warm-up
+
+    const unsigned int repeat = std::max(1u, options.repeat);
+    double best = std::numeric_limits<double>::max();
+    double total = 0.0;
+    for (unsigned int i = 0; i < repeat; ++i)
+    {
+        const clock::time_point start = clock::now();
+        func();
+        const double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        best = std::min(best, ms);
+        total += ms;
+    }
+    reportTiming(label, best, total / repeat);
+    return best;
+}
+
+void reportTiming(const std::string& label, double bestMs, double meanMs)
+{
+    std::cout << "  " << std::left << std::setw(48) << label << std::right
+              << std::fixed << std::setprecision(3)
+              << " best " << std::setw(10) << bestMs << " ms"
+              << "   mean " << std::setw(10) << meanMs << " ms" << std::endl;
+}
+
+} // namespace benchmark
+
+} // namespace sofa
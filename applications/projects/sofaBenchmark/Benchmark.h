@@ -0,0 +1,72 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#ifndef SOFABENCHMARK_BENCHMARK_H
+#define SOFABENCHMARK_BENCHMARK_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace sofa
+{
+
+namespace benchmark
+{
+
+/// Options forwarded by sofaBenchmark to every benchmark.
+struct BenchmarkOptions
+{
+    unsigned int repeat { 5 };   ///< number of timed repetitions (best and mean are reported)
+    unsigned int threads { 0 };  ///< number of threads for parallel benchmarks (0: hardware default)
+    unsigned int size { 0 };     ///< problem size (0: benchmark default)
+    std::vector<std::string> inputs; ///< extra inputs (e.g. scene files)
+};
+
+/// A named micro-benchmark. The function runs all its measurements itself and
+/// reports them with reportTiming() so that each benchmark can compare several
+/// variants (e.g. serial vs parallel) in a single run.
+struct Benchmark
+{
+    std::string name;
+    std::string description;
+    std::function<void(const BenchmarkOptions&)> run;
+};
+
+std::vector<Benchmark>& getBenchmarks();
+
+/// Helper used to register a benchmark at static initialization time:
+///   static const bool registered = registerBenchmark("name", "description", &function);
+bool registerBenchmark(const std::string& name, const std::string& description,
+                       std::function<void(const BenchmarkOptions&)> run);
+
+/// Run func options.repeat times (after one untimed warm-up run) and print the
+/// best and mean wall-clock time under the given label. Returns the best time in ms.
+double measure(const BenchmarkOptions& options, const std::string& label, const std::function<void()>& func);
+
+/// Print a single line of result.
+void reportTiming(const std::string& label, double bestMs, double meanMs);
+
+} // namespace benchmark
+
+} // namespace sofa
+
+#endif // SOFABENCHMARK_BENCHMARK_H
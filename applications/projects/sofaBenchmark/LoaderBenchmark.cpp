@@ -0,0 +1,169 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Benchmark.h"
+
+#include <SofaGeneralLoader/MeshGmshLoader.h>
+#include <SofaLoader/MeshObjLoader.h>
+#include <SofaLoader/MeshVTKLoader.h>
+#include <sofa/simulation/TaskScheduler.h>
+
+#include <boost/filesystem.hpp>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using sofa::core::loader::MeshLoader;
+
+namespace
+{
+
+using namespace sofa::benchmark;
+
+/// Write a triangulated grid of n x n vertices in the given format ("obj", "vtk" or "msh")
+bool writeGrid(const std::string& fileName, const std::string& format, unsigned int n)
+{
+    std::FILE* file = std::fopen(fileName.c_str(), "w");
+    if (file == nullptr) return false;
+
+    const unsigned int nbPoints = n * n;
+    const unsigned int nbTriangles = 2 * (n - 1) * (n - 1);
+    const auto point = [n](unsigned int p, double* x)
+    {
+        x[0] = (p % n) * 0.01;
+        x[1] = (p / n) * 0.01;
+        x[2] = 0.1 * std::sin((p % n) * 0.05) * std::cos((p / n) * 0.05);
+    };
+    const auto triangle = [n](unsigned int t, unsigned int* v)
+    {
+        const unsigned int q = t / 2, i = q % (n - 1), j = q / (n - 1), p = j * n + i;
+        if (t % 2 == 0) { v[0] = p; v[1] = p + 1; v[2] = p + n + 1; }
+        else { v[0] = p; v[1] = p + n + 1; v[2] = p + n; }
+    };
+
+    double x[3];
+    unsigned int v[3];
+    if (format == "obj")
+    {
+        for (unsigned int p = 0; p < nbPoints; ++p)
+        {
+            point(p, x);
+            std::fprintf(file, "v %.9g %.9g %.9g\n", x[0], x[1], x[2]);
+        }
+        for (unsigned int t = 0; t < nbTriangles; ++t)
+        {
+            triangle(t, v);
+            std::fprintf(file, "f %u %u %u\n", v[0] + 1, v[1] + 1, v[2] + 1);
+        }
+    }
+    else if (format == "vtk")
+    {
+        std::fprintf(file, "# vtk DataFile Version 2.0\nsofaBenchmark grid\nASCII\nDATASET POLYDATA\nPOINTS %u float\n", nbPoints);
+        for (unsigned int p = 0; p < nbPoints; ++p)
+        {
+            point(p, x);
+            std::fprintf(file, "%.9g %.9g %.9g\n", x[0], x[1], x[2]);
+        }
+        std::fprintf(file, "POLYGONS %u %u\n", nbTriangles, 4 * nbTriangles);
+        for (unsigned int t = 0; t < nbTriangles; ++t)
+        {
+            triangle(t, v);
+            std::fprintf(file, "3 %u %u %u\n", v[0], v[1], v[2]);
+        }
+    }
+    else // msh
+    {
+        std::fprintf(file, "$MeshFormat\n2.2 0 8\n$EndMeshFormat\n$Nodes\n%u\n", nbPoints);
+        for (unsigned int p = 0; p < nbPoints; ++p)
+        {
+            point(p, x);
+            std::fprintf(file, "%u %.9g %.9g %.9g\n", p + 1, x[0], x[1], x[2]);
+        }
+        std::fprintf(file, "$EndNodes\n$Elements\n%u\n", nbTriangles);
+        for (unsigned int t = 0; t < nbTriangles; ++t)
+        {
+            triangle(t, v);
+            std::fprintf(file, "%u 2 2 0 1 %u %u %u\n", t + 1, v[0] + 1, v[1] + 1, v[2] + 1);
+        }
+        std::fprintf(file, "$EndElements\n");
+    }
+    return std::fclose(file) == 0;
+}
+
+void benchmarkLoaders(const BenchmarkOptions& options)
+{
+    sofa::simulation::TaskScheduler::getInstance()->init(options.threads);
+    const unsigned int nbThreads = sofa::simulation::TaskScheduler::getInstance()->getThreadCount();
+
+    // from 20k to 2M triangles, unless a grid size is given
+    const std::vector<unsigned int> sizes = options.size > 0 ? std::vector<unsigned int>{ options.size } : std::vector<unsigned int>{ 100, 317, 1000 };
+    const std::string directory = boost::filesystem::temp_directory_path().string();
+
+    for (const char* format : { "obj", "vtk", "msh" })
+    {
+        for (unsigned int n : sizes)
+        {
+            const std::string fileName = directory + "/sofaBenchmark_grid" + std::to_string(n) + "." + format;
+            if (!writeGrid(fileName, format, n))
+            {
+                std::cerr << "  can't write " << fileName << std::endl;
+                continue;
+            }
+
+            MeshLoader::SPtr loader;
+            if (std::string(format) == "obj")
+                loader = sofa::core::objectmodel::New<sofa::component::loader::MeshObjLoader>();
+            else if (std::string(format) == "vtk")
+                loader = sofa::core::objectmodel::New<sofa::component::loader::MeshVTKLoader>();
+            else
+                loader = sofa::core::objectmodel::New<sofa::component::loader::MeshGmshLoader>();
+            loader->setFilename(fileName);
+
+            const std::string size = std::to_string(boost::filesystem::file_size(fileName) >> 20) + " MB, "
+                    + std::to_string(2 * (n - 1) * (n - 1)) + " triangles";
+            sofa::core::objectmodel::BaseData* parallelData = loader->findData("parallel");
+            for (bool parallel : { false, true })
+            {
+                if (parallel && parallelData == nullptr)
+                    continue; // the gmsh files are read by helper::io::MeshGmsh, which is not parallel
+                if (parallelData)
+                    parallelData->read(parallel ? "1" : "0");
+                measure(options, std::string(loader->getClassName()) + (parallel ? " parallel (" + std::to_string(nbThreads) + " threads)" : " serial")
+                        + ", " + size, [&]()
+                {
+                    loader->load();
+                });
+            }
+            if (loader->d_triangles.getValue().size() != 2 * (n - 1) * (n - 1))
+                std::cerr << "  " << loader->getClassName() << " loaded " << loader->d_triangles.getValue().size() << " triangles" << std::endl;
+
+            std::remove(fileName.c_str());
+        }
+    }
+}
+
+const bool loadersRegistered = registerBenchmark("MeshLoaders",
+    "loading of OBJ, legacy VTK and Gmsh text files of increasing sizes, serial vs parallel parsing",
+    &benchmarkLoaders);
+
+} // namespace
@@ -0,0 +1,112 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Benchmark.h"
+
+#include <SofaSimulationCommon/SceneLoaderXML.h>
+#include <SofaSimulationGraph/DAGSimulation.h>
+#include <sofa/core/behavior/Mass.h>
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/defaulttype/VecTypes.h>
+#include <sofa/simulation/TaskScheduler.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using sofa::simulation::Node;
+using sofa::defaulttype::Vec3Types;
+
+namespace
+{
+
+using namespace sofa::benchmark;
+
+/// Tetrahedral grid of n x n x n vertices with the given mass component
+std::string createScene(unsigned int n, const std::string& mass)
+{
+    const std::string size = std::to_string(n);
+    return
+        "<Node name='root'>"
+        "  <RegularGridTopology name='grid' n='" + size + " " + size + " " + size + "' min='0 0 0' max='1 1 1'/>"
+        "  <MechanicalObject template='Vec3d'/>"
+        "  <TetrahedronSetTopologyContainer name='tetras'/>"
+        "  <TetrahedronSetTopologyModifier/>"
+        "  <TetrahedronSetGeometryAlgorithms template='Vec3d'/>"
+        "  <Hexa2TetraTopologicalMapping input='@grid' output='@tetras'/>"
+        "  <" + mass + " name='mass' template='Vec3d' massDensity='1' topology='@tetras'/>"
+        "</Node>";
+}
+
+void benchmarkMass(const BenchmarkOptions& options)
+{
+    sofa::simulation::setSimulation(new sofa::simulation::graph::DAGSimulation());
+    sofa::simulation::TaskScheduler::getInstance()->init(options.threads);
+    const unsigned int nbThreads = sofa::simulation::TaskScheduler::getInstance()->getThreadCount();
+
+    // from 10k to 1M vertices, unless a grid size is given
+    const std::vector<unsigned int> sizes = options.size > 0 ? std::vector<unsigned int>{ options.size } : std::vector<unsigned int>{ 22, 47, 100 };
+    const unsigned int nbProducts = 20;
+
+    for (const char* massName : { "MeshMatrixMass", "DiagonalMass" })
+    {
+        for (unsigned int n : sizes)
+        {
+            const std::string sceneXML = createScene(n, massName);
+            Node::SPtr root = sofa::simulation::SceneLoaderXML::loadFromMemory("MassBenchmark", sceneXML.c_str(), sceneXML.size());
+            sofa::simulation::getSimulation()->init(root.get());
+
+            sofa::core::behavior::Mass<Vec3Types>* mass = nullptr;
+            root->get(mass);
+            if (mass == nullptr || mass->findData("parallel") == nullptr)
+            {
+                std::cerr << "  no " << massName << " in the scene" << std::endl;
+                sofa::simulation::getSimulation()->unload(root);
+                continue;
+            }
+
+            const std::size_t nbVertices = std::size_t(n) * n * n;
+            sofa::core::objectmodel::Data<Vec3Types::VecDeriv> f, dx;
+            f.setValue(Vec3Types::VecDeriv(nbVertices));
+            dx.setValue(Vec3Types::VecDeriv(nbVertices, Vec3Types::Deriv(1, 2, 3)));
+            sofa::core::MechanicalParams mparams;
+
+            for (bool parallel : { false, true })
+            {
+                mass->findData("parallel")->read(parallel ? "1" : "0");
+                measure(options, std::string(massName) + (parallel ? " parallel (" + std::to_string(nbThreads) + " threads)" : " serial")
+                        + ", " + std::to_string(nbProducts) + " addMDx on " + std::to_string(nbVertices) + " vertices", [&]()
+                {
+                    for (unsigned int i = 0; i < nbProducts; ++i)
+                        mass->addMDx(&mparams, f, dx, 1.0);
+                });
+            }
+
+            sofa::simulation::getSimulation()->unload(root);
+        }
+    }
+}
+
+const bool massRegistered = registerBenchmark("MassProduct",
+    "product by the mass matrix (addMDx) of MeshMatrixMass and DiagonalMass, serial vs parallel",
+    &benchmarkMass);
+
+} // namespace
@@ -0,0 +1,113 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Benchmark.h"
+
+#include <SofaSimulationCommon/SceneLoaderXML.h>
+#include <SofaSimulationGraph/DAGSimulation.h>
+#include <sofa/core/behavior/LinearSolver.h>
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/simulation/TaskScheduler.h>
+
+#include <iostream>
+#include <string>
+
+using sofa::simulation::Node;
+
+namespace
+{
+
+using namespace sofa::benchmark;
+
+/// Scene made of nbBeams independent FEM beams solved by a single SparseLDLSolver,
+/// so that the system matrix gathers as many force fields and masses.
+std::string createScene(unsigned int nbBeams)
+{
+    std::string scene =
+        "<Node name='root' dt='0.01' gravity='0 -9.81 0'>"
+        "  <DefaultAnimationLoop/>"
+        "  <EulerImplicitSolver rayleighStiffness='0.1' rayleighMass='0.1'/>"
+        "  <SparseLDLSolver name='solver' template='CompressedRowSparseMatrix3d'/>";
+    for (unsigned int i = 0; i < nbBeams; ++i)
+    {
+        const std::string z = std::to_string(4 * i), zmax = std::to_string(4 * i + 2);
+        scene +=
+            "  <Node name='beam" + std::to_string(i) + "'>"
+            "    <RegularGridTopology name='grid' n='8 3 3' min='0 0 " + z + "' max='7 2 " + zmax + "'/>"
+            "    <MechanicalObject template='Vec3d'/>"
+            "    <TetrahedronSetTopologyContainer name='tetras'/>"
+            "    <TetrahedronSetTopologyModifier/>"
+            "    <Hexa2TetraTopologicalMapping input='@grid' output='@tetras'/>"
+            "    <UniformMass totalMass='1'/>"
+            "    <TetrahedronFEMForceField youngModulus='5000' poissonRatio='0.3' method='large' topology='@tetras'/>"
+            "    <FixedConstraint indices='0'/>"
+            "  </Node>";
+    }
+    scene += "</Node>";
+    return scene;
+}
+
+void benchmarkMatrixAssembly(const BenchmarkOptions& options)
+{
+    const unsigned int nbBeams = options.size > 0 ? options.size : 64;
+    const unsigned int nbAssemblies = 20;
+    sofa::simulation::setSimulation(new sofa::simulation::graph::DAGSimulation());
+    sofa::simulation::TaskScheduler::getInstance()->init(options.threads);
+
+    const std::string sceneXML = createScene(nbBeams);
+    Node::SPtr root = sofa::simulation::SceneLoaderXML::loadFromMemory("MatrixAssemblyBenchmark", sceneXML.c_str(), sceneXML.size());
+    sofa::simulation::getSimulation()->init(root.get());
+    // one step to compute the rotations of the FEM
+    sofa::simulation::getSimulation()->animate(root.get(), root->getDt());
+
+    sofa::core::behavior::LinearSolver* solver = nullptr;
+    root->get(solver);
+    if (solver == nullptr || solver->findData("parallelAssembly") == nullptr)
+    {
+        std::cerr << "  no SparseLDLSolver in the scene, is SofaSparseSolver loaded?" << std::endl;
+        return;
+    }
+
+    sofa::core::MechanicalParams mparams;
+    mparams.setMFactor(1.0);
+    mparams.setBFactor(-0.1);
+    mparams.setKFactor(-0.01);
+
+    for (bool parallel : { false, true })
+    {
+        solver->findData("parallelAssembly")->read(parallel ? "1" : "0");
+        measure(options, std::string(parallel ? "parallel" : "serial") + " assembly of " + std::to_string(nbBeams)
+                + " beams on " + std::to_string(sofa::simulation::TaskScheduler::getInstance()->getThreadCount())
+                + " threads, " + std::to_string(nbAssemblies) + " assemblies", [&]()
+        {
+            for (unsigned int i = 0; i < nbAssemblies; ++i)
+                solver->setSystemMBKMatrix(&mparams);
+        });
+    }
+
+    sofa::simulation::getSimulation()->unload(root);
+}
+
+const bool matrixAssemblyRegistered = registerBenchmark("MatrixAssembly",
+    "assembly of the system matrix of a SparseLDLSolver, serial vs parallelAssembly",
+    &benchmarkMatrixAssembly);
+
+} // namespace
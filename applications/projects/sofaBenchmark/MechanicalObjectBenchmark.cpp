@@ -0,0 +1,131 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Benchmark.h"
+
+#include <SofaBaseMechanics/MechanicalObject.h>
+#include <sofa/core/ExecParams.h>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using sofa::component::container::MechanicalObject;
+using sofa::core::ConstVecCoordId;
+using sofa::core::ConstVecDerivId;
+using sofa::core::VecCoordId;
+using sofa::core::VecDerivId;
+using sofa::defaulttype::Vec3Types;
+
+namespace
+{
+
+using namespace sofa::benchmark;
+
+const unsigned int nbOperations = 10;
+
+/// Print the bandwidth reached by an operation streaming nbBytes in bestMs, relative to the reference.
+void reportBandwidth(const std::string& label, double nbBytes, double bestMs, double referenceGBs)
+{
+    const double gbs = nbBytes / (bestMs * 1e6);
+    std::cout << "  " << std::left << std::setw(48) << label << std::right
+              << std::fixed << std::setprecision(2)
+              << " " << std::setw(8) << gbs << " GB/s";
+    if (referenceGBs > 0)
+        std::cout << "   " << std::setw(6) << std::setprecision(1) << 100.0 * gbs / referenceGBs << " % of triad";
+    std::cout << std::endl;
+}
+
+void benchmarkMechanicalObjectVecOps(const BenchmarkOptions& options)
+{
+    typedef MechanicalObject<Vec3Types> MO;
+    const std::size_t nbPoints = options.size > 0 ? options.size : 1000000;
+    const double vectorBytes = double(nbPoints) * sizeof(Vec3Types::Deriv);
+    const sofa::core::ExecParams* params = sofa::core::ExecParams::defaultInstance();
+
+    std::cout << "  " << nbPoints << " Vec3d points, " << nbOperations << " operations per measure" << std::endl;
+
+    // reference: STREAM-like triad on plain arrays, the best bandwidth a streaming kernel can expect here
+    std::vector<double> a(3 * nbPoints, 1.0), b(3 * nbPoints, 2.0), c(3 * nbPoints, 0.0);
+    const double triadMs = measure(options, "reference triad c = a + b*s on double arrays", [&]()
+    {
+        for (unsigned int k = 0; k < nbOperations; ++k)
+        {
+            const double s = 0.5 + k;
+            const std::size_t n = c.size();
+            for (std::size_t i = 0; i < n; ++i)
+                c[i] = a[i] + b[i] * s;
+        }
+    });
+    const double triadGBs = 3 * vectorBytes * nbOperations / (triadMs * 1e6);
+    reportBandwidth("reference triad", 3 * vectorBytes * nbOperations, triadMs, 0);
+
+    for (bool flat : { false, true })
+    {
+        MO::SPtr mo = sofa::core::objectmodel::New<MO>();
+        mo->d_flatVectorOps.setValue(flat);
+        mo->resize(nbPoints);
+        const std::string mode = flat ? "flat " : "";
+
+        const double axpyMs = measure(options, mode + "vOp dx = f + v*s", [&]()
+        {
+            for (unsigned int k = 0; k < nbOperations; ++k)
+                mo->vOp(params, VecDerivId::dx(), VecDerivId::force(), VecDerivId::velocity(), 0.5 + k);
+        });
+        reportBandwidth(mode + "vOp dx = f + v*s", 3 * vectorBytes * nbOperations, axpyMs, triadGBs);
+
+        const double peqMs = measure(options, mode + "vOp dx += f*s", [&]()
+        {
+            for (unsigned int k = 0; k < nbOperations; ++k)
+                mo->vOp(params, VecDerivId::dx(), VecDerivId::dx(), VecDerivId::force(), 1e-3);
+        });
+        reportBandwidth(mode + "vOp dx += f*s", 3 * vectorBytes * nbOperations, peqMs, triadGBs);
+
+        sofa::core::behavior::BaseMechanicalState::VMultiOp ops(2);
+        ops[0].first = VecDerivId::velocity();
+        ops[0].second.push_back(std::make_pair(ConstVecDerivId::velocity(), 1.0));
+        ops[0].second.push_back(std::make_pair(ConstVecDerivId::dx(), 1e-3));
+        ops[1].first = VecCoordId::position();
+        ops[1].second.push_back(std::make_pair(ConstVecCoordId::position(), 1.0));
+        ops[1].second.push_back(std::make_pair(ConstVecDerivId::velocity(), 1e-3));
+        const double multiMs = measure(options, mode + "vMultiOp v += a*dt, x += v*dt", [&]()
+        {
+            for (unsigned int k = 0; k < nbOperations; ++k)
+                mo->vMultiOp(params, ops);
+        });
+        reportBandwidth(mode + "vMultiOp v += a*dt, x += v*dt", 5 * vectorBytes * nbOperations, multiMs, triadGBs);
+
+        double dot = 0;
+        const double dotMs = measure(options, mode + "vDot dx.f", [&]()
+        {
+            for (unsigned int k = 0; k < nbOperations; ++k)
+                dot += mo->vDot(params, VecDerivId::dx(), VecDerivId::force());
+        });
+        reportBandwidth(mode + "vDot dx.f", 2 * vectorBytes * nbOperations, dotMs, triadGBs);
+    }
+}
+
+const bool mechanicalObjectVecOpsRegistered = registerBenchmark("MechanicalObjectVecOps",
+    "bandwidth of MechanicalObject vOp/vMultiOp/vDot on Vec3d states, default vs flat kernels, compared to a plain array triad",
+    &benchmarkMechanicalObjectVecOps);
+
+} // namespace
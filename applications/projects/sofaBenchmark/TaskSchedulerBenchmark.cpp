@@ -0,0 +1,152 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Benchmark.h"
+
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/simulation/DefaultTaskScheduler.h>
+#include <sofa/simulation/WorkStealingTaskScheduler.h>
+
+#include <atomic>
+#include <iostream>
+
+using sofa::simulation::Task;
+using sofa::simulation::CpuTask;
+using sofa::simulation::TaskScheduler;
+
+namespace
+{
+
+using namespace sofa::benchmark;
+
+/// Empty task, only measures the cost of allocation, queueing and release.
+class EmptyTask : public CpuTask
+{
+public:
+    EmptyTask(CpuTask::Status* status, std::atomic<int>* counter)
+        : CpuTask(status), m_counter(counter) {}
+
+    MemoryAlloc run() final
+    {
+        m_counter->fetch_add(1, std::memory_order_relaxed);
+        return MemoryAlloc::Dynamic;
+    }
+
+private:
+    std::atomic<int>* m_counter;
+};
+
+/// Binary tree of tasks: every task spawns its two children and waits for them,
+/// which stresses the stealing path of the schedulers.
+class TreeTask : public CpuTask
+{
+public:
+    TreeTask(CpuTask::Status* status, unsigned int depth, std::atomic<int>* counter)
+        : CpuTask(status), m_depth(depth), m_counter(counter) {}
+
+    MemoryAlloc run() final
+    {
+        m_counter->fetch_add(1, std::memory_order_relaxed);
+        if (m_depth > 0)
+        {
+            TaskScheduler* scheduler = TaskScheduler::getInstance();
+            CpuTask::Status status;
+            scheduler->addTask(new TreeTask(&status, m_depth - 1, m_counter));
+            scheduler->addTask(new TreeTask(&status, m_depth - 1, m_counter));
+            scheduler->workUntilDone(&status);
+        }
+        return MemoryAlloc::Dynamic;
+    }
+
+private:
+    unsigned int m_depth;
+    std::atomic<int>* m_counter;
+};
+
+void checkCount(const std::atomic<int>& counter, int expected)
+{
+    if (counter.load() != expected)
+        std::cerr << "  error: " << counter.load() << " tasks executed, " << expected << " expected" << std::endl;
+}
+
+void benchmarkTaskScheduler(const BenchmarkOptions& options)
+{
+    const char* schedulers[] = {
+        sofa::simulation::DefaultTaskScheduler::name(),
+        sofa::simulation::WorkStealingTaskScheduler::name()
+    };
+
+    const int nbTasks = options.size > 0 ? int(options.size) : 100000;
+    unsigned int depth = 0;
+    while ((2 << depth) - 1 < nbTasks / 4)
+        ++depth;
+    const int nbTreeTasks = (2 << depth) - 1;
+
+    for (const char* name : schedulers)
+    {
+        TaskScheduler* scheduler = TaskScheduler::create(name);
+        scheduler->init(options.threads);
+        const std::string prefix = std::string(name) + " (" + std::to_string(scheduler->getThreadCount()) + " threads) ";
+
+        std::atomic<int> counter(0);
+
+        measure(options, prefix + "spawn " + std::to_string(nbTasks) + " tasks", [&]()
+        {
+            counter = 0;
+            CpuTask::Status status;
+            for (int i = 0; i < nbTasks; ++i)
+                scheduler->addTask(new EmptyTask(&status, &counter));
+            scheduler->workUntilDone(&status);
+        });
+        checkCount(counter, nbTasks);
+
+        measure(options, prefix + "task tree of " + std::to_string(nbTreeTasks) + " tasks", [&]()
+        {
+            counter = 0;
+            CpuTask::Status status;
+            scheduler->addTask(new TreeTask(&status, depth, &counter));
+            scheduler->workUntilDone(&status);
+        });
+        checkCount(counter, nbTreeTasks);
+
+        const int nbRoundTrips = nbTasks / 10;
+        measure(options, prefix + std::to_string(nbRoundTrips) + " addTask/workUntilDone", [&]()
+        {
+            counter = 0;
+            for (int i = 0; i < nbRoundTrips; ++i)
+            {
+                CpuTask::Status status;
+                scheduler->addTask(new EmptyTask(&status, &counter));
+                scheduler->workUntilDone(&status);
+            }
+        });
+        checkCount(counter, nbRoundTrips);
+    }
+
+    // restore the default scheduler for the following benchmarks
+    TaskScheduler::create(sofa::simulation::DefaultTaskScheduler::name())->init(options.threads);
+}
+
+const bool taskSchedulerRegistered = registerBenchmark("TaskScheduler",
+    "task spawn, steal and wait latency of the registered task schedulers",
+    &benchmarkTaskScheduler);
+
+} // namespace
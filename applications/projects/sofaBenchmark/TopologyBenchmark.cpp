@@ -0,0 +1,115 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Benchmark.h"
+
+#include <SofaBaseTopology/CompressedRowArray.h>
+#include <sofa/core/topology/BaseMeshTopology.h>
+#include <sofa/simulation/TaskScheduler.h>
+
+#include <iostream>
+#include <string>
+
+using sofa::component::topology::CompressedRowArray;
+using sofa::core::topology::BaseMeshTopology;
+
+namespace
+{
+
+using namespace sofa::benchmark;
+
+typedef BaseMeshTopology::Tetra Tetra;
+typedef BaseMeshTopology::TetraID TetraID;
+
+/// Split each cube of a n x n x n grid in 6 tetrahedra sharing its diagonal.
+sofa::helper::vector<Tetra> createTetrahedra(unsigned int n)
+{
+    const unsigned int p = n + 1;
+    auto id = [p](unsigned int i, unsigned int j, unsigned int k) { return i + p * (j + p * k); };
+
+    sofa::helper::vector<Tetra> tetrahedra;
+    tetrahedra.reserve(6 * n * n * n);
+    for (unsigned int k = 0; k < n; ++k)
+        for (unsigned int j = 0; j < n; ++j)
+            for (unsigned int i = 0; i < n; ++i)
+            {
+                const unsigned int c[8] = { id(i,j,k), id(i+1,j,k), id(i,j+1,k), id(i+1,j+1,k),
+                                            id(i,j,k+1), id(i+1,j,k+1), id(i,j+1,k+1), id(i+1,j+1,k+1) };
+                tetrahedra.push_back(Tetra(c[0], c[1], c[3], c[7]));
+                tetrahedra.push_back(Tetra(c[0], c[1], c[5], c[7]));
+                tetrahedra.push_back(Tetra(c[0], c[2], c[3], c[7]));
+                tetrahedra.push_back(Tetra(c[0], c[2], c[6], c[7]));
+                tetrahedra.push_back(Tetra(c[0], c[4], c[5], c[7]));
+                tetrahedra.push_back(Tetra(c[0], c[4], c[6], c[7]));
+            }
+    return tetrahedra;
+}
+
+void benchmarkTopologyAroundArrays(const BenchmarkOptions& options)
+{
+    const unsigned int n = options.size > 0 ? options.size : 55; // 998250 tetrahedra
+    const sofa::helper::vector<Tetra> tetrahedra = createTetrahedra(n);
+    const std::size_t nbPoints = std::size_t(n + 1) * (n + 1) * (n + 1);
+    std::cout << "  " << tetrahedra.size() << " tetrahedra, " << nbPoints << " points" << std::endl;
+
+    // previous construction: one vector per vertex, grown by push_back
+    sofa::helper::vector< sofa::helper::vector<TetraID> > aroundVertex;
+    measure(options, "vector of vectors, push_back", [&]()
+    {
+        aroundVertex.clear();
+        aroundVertex.resize(nbPoints);
+        for (std::size_t i = 0; i < tetrahedra.size(); ++i)
+            for (unsigned int j = 0; j < 4; ++j)
+                aroundVertex[tetrahedra[i][j]].push_back(TetraID(i));
+    });
+
+    std::size_t vectorBytes = aroundVertex.capacity() * sizeof(aroundVertex[0]);
+    for (const auto& row : aroundVertex)
+        vectorBytes += row.capacity() * sizeof(TetraID);
+
+    sofa::simulation::TaskScheduler* scheduler = sofa::simulation::TaskScheduler::getInstance();
+    CompressedRowArray<TetraID> compressed;
+    for (unsigned int threads : { 1u, options.threads })
+    {
+        scheduler->init(threads);
+        measure(options, "compressed rows, " + std::to_string(scheduler->getThreadCount()) + " thread(s)", [&]()
+        {
+            compressed.build(nbPoints, tetrahedra);
+        });
+    }
+
+    sofa::helper::vector< sofa::helper::vector<TetraID> > copied;
+    measure(options, "compressed rows copied to vectors", [&]()
+    {
+        compressed.build(nbPoints, tetrahedra);
+        copied.clear();
+        compressed.copyTo(copied);
+    });
+
+    std::cout << "  memory: vector of vectors " << vectorBytes / 1024 << " KiB in " << nbPoints + 1
+              << " allocations, compressed rows " << compressed.getMemorySize() / 1024 << " KiB in 2 allocations" << std::endl;
+}
+
+const bool topologyAroundArraysRegistered = registerBenchmark("TopologyAroundArrays",
+    "construction of the tetrahedra around vertex adjacency, vector of vectors vs compressed rows",
+    &benchmarkTopologyAroundArrays);
+
+} // namespace
@@ -0,0 +1,148 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Benchmark.h"
+
+#include <SofaBaseTopology/TetrahedronSetTopologyContainer.h>
+#include <SofaBaseTopology/TetrahedronSetTopologyModifier.h>
+#include <SofaSimulationCommon/SceneLoaderXML.h>
+#include <SofaSimulationGraph/DAGSimulation.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <string>
+
+using sofa::simulation::Node;
+using sofa::component::topology::TetrahedronSetTopologyContainer;
+using sofa::component::topology::TetrahedronSetTopologyModifier;
+
+namespace
+{
+
+using namespace sofa::benchmark;
+
+/// Tetrahedral grid of n x n x n vertices, with the components reacting to the removal of tetrahedra
+std::string createScene(unsigned int n)
+{
+    const std::string size = std::to_string(n);
+    return
+        "<Node name='root'>"
+        "  <RegularGridTopology name='grid' n='" + size + " " + size + " " + size + "' min='0 0 0' max='1 1 1'/>"
+        "  <MechanicalObject template='Vec3d'/>"
+        "  <TetrahedronSetTopologyContainer name='tetras'/>"
+        "  <TetrahedronSetTopologyModifier/>"
+        "  <TetrahedronSetTopologyAlgorithms template='Vec3d'/>"
+        "  <TetrahedronSetGeometryAlgorithms template='Vec3d'/>"
+        "  <Hexa2TetraTopologicalMapping input='@grid' output='@tetras'/>"
+        "  <DiagonalMass template='Vec3d' massDensity='1' topology='@tetras'/>"
+        "  <TetrahedralCorotationalFEMForceField template='Vec3d' youngModulus='1000' poissonRatio='0.3' topology='@tetras'/>"
+        "</Node>";
+}
+
+/// Tetrahedra with their first vertex in a sphere centered in the grid, holding about 10% of the grid
+sofa::helper::vector<TetrahedronSetTopologyContainer::TetrahedronID> selectCarvedTetrahedra(TetrahedronSetTopologyContainer* container)
+{
+    const double radius = 0.288; // (4/3 pi r^3 = 0.1)
+    sofa::helper::vector<TetrahedronSetTopologyContainer::TetrahedronID> carved;
+    const auto& tetrahedra = container->getTetrahedronArray();
+    for (std::size_t i = 0; i < tetrahedra.size(); ++i)
+    {
+        const auto p = tetrahedra[i][0];
+        const double x = container->getPX(p) - 0.5, y = container->getPY(p) - 0.5, z = container->getPZ(p) - 0.5;
+        if (x * x + y * y + z * z < radius * radius)
+            carved.push_back(TetrahedronSetTopologyContainer::TetrahedronID(i));
+    }
+    return carved;
+}
+
+void benchmarkTopologyChange(const BenchmarkOptions& options)
+{
+    using clock = std::chrono::steady_clock;
+    sofa::simulation::setSimulation(new sofa::simulation::graph::DAGSimulation());
+
+    // about 500k tetrahedra, unless a grid size is given
+    const unsigned int n = options.size > 0 ? options.size : 45;
+    const std::string sceneXML = createScene(n);
+
+    // each repetition carves a fresh scene, as the removals can't be undone
+    enum Mode { OneByOne, OneCommit, OneCommitAll };
+    for (const Mode mode : { OneByOne, OneCommit, OneCommitAll })
+    {
+        const unsigned int repeat = std::max(1u, options.repeat);
+        double best = std::numeric_limits<double>::max();
+        double total = 0.0;
+        std::size_t nbCarved = 0, nbTetrahedra = 0;
+        for (unsigned int r = 0; r < repeat; ++r)
+        {
+            Node::SPtr root = sofa::simulation::SceneLoaderXML::loadFromMemory("TopologyChangeBenchmark", sceneXML.c_str(), sceneXML.size());
+            sofa::simulation::getSimulation()->init(root.get());
+
+            TetrahedronSetTopologyContainer* container = nullptr;
+            TetrahedronSetTopologyModifier* modifier = nullptr;
+            root->get(container);
+            root->get(modifier);
+            if (container == nullptr || modifier == nullptr)
+            {
+                std::cerr << "  no tetrahedron topology in the scene" << std::endl;
+                sofa::simulation::getSimulation()->unload(root);
+                return;
+            }
+
+            nbTetrahedra = container->getNumberOfTetrahedra();
+            sofa::helper::vector<TetrahedronSetTopologyContainer::TetrahedronID> carved = selectCarvedTetrahedra(container);
+            // removing the whole selection one tetrahedron at a time is too slow, only the first ones are compared
+            if (mode != OneCommitAll && carved.size() > 1000)
+                carved.resize(1000);
+            nbCarved = carved.size();
+
+            const clock::time_point start = clock::now();
+            if (mode == OneByOne)
+            {
+                // the indices of the remaining tetrahedra change after each removal: remove from the highest
+                for (auto it = carved.rbegin(); it != carved.rend(); ++it)
+                    modifier->removeTetrahedra(sofa::helper::vector<TetrahedronSetTopologyContainer::TetrahedronID>(1, *it));
+            }
+            else
+            {
+                modifier->beginTetrahedraChangeSet();
+                modifier->queueTetrahedraRemoval(carved);
+                modifier->commitTetrahedraChangeSet();
+            }
+            const double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+            best = std::min(best, ms);
+            total += ms;
+
+            sofa::simulation::getSimulation()->unload(root);
+        }
+
+        const std::string label = std::string(mode == OneByOne ? "one removal per tetrahedron" : "one change set")
+                + ", " + std::to_string(nbCarved) + " of " + std::to_string(nbTetrahedra) + " tetrahedra";
+        reportTiming(label, best, total / repeat);
+    }
+}
+
+const bool topologyChangeRegistered = registerBenchmark("TopologyCarving",
+    "removal of the tetrahedra in a sphere (10% of a grid), one by one vs one change set",
+    &benchmarkTopologyChange);
+
+} // namespace
@@ -0,0 +1,107 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Benchmark.h"
+
+#include <SofaSimulationGraph/DAGNode.h>
+#include <SofaSimulationGraph/DAGSimulation.h>
+#include <sofa/simulation/Visitor.h>
+
+#include <string>
+
+using sofa::simulation::Node;
+using sofa::simulation::Visitor;
+using sofa::simulation::graph::DAGNode;
+
+namespace
+{
+
+using namespace sofa::benchmark;
+
+/// Visitor doing nothing but counting the nodes, to only measure the dispatch cost.
+class CountingVisitor : public Visitor
+{
+public:
+    CountingVisitor() : Visitor(sofa::core::ExecParams::defaultInstance()) {}
+
+    Result processNodeTopDown(Node*) override { ++nbNodes; return RESULT_CONTINUE; }
+    void processNodeBottomUp(Node*) override { ++nbNodes; }
+    const char* getClassName() const override { return "CountingVisitor"; }
+
+    std::size_t nbNodes { 0 };
+};
+
+/// Build a graph of nbNodes nodes: a root with chains of nodes, one node
+/// in ten having a second parent in the neighbour chain.
+Node::SPtr createGraph(unsigned int nbNodes)
+{
+    Node::SPtr root = sofa::simulation::getSimulation()->createNewGraph("root");
+
+    const unsigned int chainLength = 10;
+    std::vector<Node::SPtr> previousChain;
+    unsigned int count = 1;
+    for (unsigned int c = 0; count < nbNodes; ++c)
+    {
+        std::vector<Node::SPtr> chain;
+        Node::SPtr parent = root;
+        for (unsigned int i = 0; i < chainLength && count < nbNodes; ++i, ++count)
+        {
+            parent = parent->createChild("node" + std::to_string(count));
+            if (i % 10 == 5 && i < previousChain.size())
+                previousChain[i - 1]->addChild(parent);
+            chain.push_back(parent);
+        }
+        previousChain.swap(chain);
+    }
+    return root;
+}
+
+void benchmarkVisitorDispatch(const BenchmarkOptions& options)
+{
+    sofa::simulation::setSimulation(new sofa::simulation::graph::DAGSimulation());
+
+    const unsigned int nbNodes = options.size > 0 ? options.size : 5000;
+    const unsigned int nbVisitors = 100;
+    Node::SPtr root = createGraph(nbNodes);
+
+    for (bool cached : { false, true })
+    {
+        DAGNode::setTraversalOrderCacheEnabled(cached);
+        measure(options, std::string(cached ? "cached" : "recursive") + " traversal, "
+                + std::to_string(nbVisitors) + " visitors on " + std::to_string(nbNodes) + " nodes", [&]()
+        {
+            for (unsigned int i = 0; i < nbVisitors; ++i)
+            {
+                CountingVisitor visitor;
+                root->executeVisitor(&visitor);
+            }
+        });
+    }
+    DAGNode::setTraversalOrderCacheEnabled(true);
+
+    sofa::simulation::getSimulation()->unload(root);
+}
+
+const bool visitorDispatchRegistered = registerBenchmark("VisitorDispatch",
+    "cost of the DAG traversal of an empty visitor, recursive vs cached traversal order",
+    &benchmarkVisitorDispatch);
+
+} // namespace
@@ -0,0 +1,126 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Benchmark.h"
+
+#include <SofaBaseVisual/VisualModelImpl.h>
+#include <sofa/simulation/TaskScheduler.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+using sofa::component::visualmodel::VisualModelImpl;
+
+namespace
+{
+
+using namespace sofa::benchmark;
+
+/// VisualModelImpl without graphics, the uploads are only accounted.
+struct HeadlessVisualModel : public VisualModelImpl
+{
+    /// Bytes which would be sent to the vertex buffer since the last call
+    std::size_t uploadedBytes()
+    {
+        std::size_t bytes = 0;
+        VecVertexRange ranges;
+        getDirtyPositionRanges(ranges);
+        for (const VertexRange& r : ranges)
+            bytes += (r.second - r.first) * 3 * sizeof(float);
+        getDirtyNormalRanges(ranges);
+        for (const VertexRange& r : ranges)
+            bytes += (r.second - r.first) * 3 * sizeof(float);
+        clearDirtyVertices();
+        return bytes;
+    }
+};
+
+/// Triangulated grid of size x size vertices
+void createGrid(HeadlessVisualModel& model, unsigned int size)
+{
+    VisualModelImpl::VecCoord positions;
+    for (unsigned int j = 0; j < size; ++j)
+        for (unsigned int i = 0; i < size; ++i)
+            positions.push_back(VisualModelImpl::Coord(i, j, 0));
+
+    VisualModelImpl::VecTriangle triangles;
+    for (unsigned int j = 0; j < size - 1; ++j)
+        for (unsigned int i = 0; i < size - 1; ++i)
+        {
+            const unsigned int p = j * size + i;
+            triangles.push_back(VisualModelImpl::Triangle(p, p + 1, p + size));
+            triangles.push_back(VisualModelImpl::Triangle(p + 1, p + size + 1, p + size));
+        }
+
+    model.setVertices(&positions);
+    model.setTriangles(&triangles);
+    model.m_updateTangents.setValue(false);
+}
+
+void benchmarkVisualModelUpdate(const BenchmarkOptions& options)
+{
+    sofa::simulation::TaskScheduler::getInstance()->init(options.threads);
+
+    const unsigned int size = options.size > 0 ? options.size : 500;
+    const unsigned int nbVertices = size * size;
+    const unsigned int nbFrames = 20;
+    // 1% of the vertices move at each frame
+    const unsigned int nbMoved = std::max(1u, nbVertices / 100);
+
+    struct Variant { const char* name; bool parallel; bool incremental; };
+    for (const Variant& v : { Variant{ "serial", false, false }, Variant{ "parallel", true, false },
+                              Variant{ "incremental", false, true }, Variant{ "incremental parallel", true, true } })
+    {
+        HeadlessVisualModel model;
+        createGrid(model, size);
+        model.d_parallel.setValue(v.parallel);
+        model.d_incrementalUpdate.setValue(v.incremental);
+        model.modified = true;
+        model.updateVisual();
+        model.uploadedBytes();
+
+        std::size_t bytes = 0;
+        unsigned int frame = 0;
+        measure(options, std::string(v.name) + ", " + std::to_string(nbFrames) + " frames on "
+                + std::to_string(nbVertices) + " vertices", [&]()
+        {
+            for (unsigned int f = 0; f < nbFrames; ++f, ++frame)
+            {
+                {
+                    sofa::helper::WriteAccessor< sofa::Data<VisualModelImpl::VecCoord> > x = *model.write(sofa::core::VecCoordId::position());
+                    for (unsigned int i = 0; i < nbMoved; ++i)
+                        x[(i * 101 + frame * 7) % nbVertices][2] += 0.01;
+                }
+                model.modified = true;
+                model.updateVisual();
+                bytes += model.uploadedBytes();
+            }
+        });
+        std::cout << "    uploaded " << bytes / std::max(1u, frame) << " bytes per frame" << std::endl;
+    }
+}
+
+const bool visualModelUpdateRegistered = registerBenchmark("VisualModelUpdate",
+    "update of the normals and of the vertex buffer of a visual model with 1% of moving vertices",
+    &benchmarkVisualModelUpdate);
+
+} // namespace
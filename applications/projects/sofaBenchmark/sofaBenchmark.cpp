@@ -0,0 +1,128 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Benchmark.h"
+
+#include <sofa/helper/ArgumentParser.h>
+using sofa::helper::ArgumentParser;
+
+#include <SofaGeneral/initSofaGeneral.h>
+#include <SofaMisc/initSofaMisc.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using sofa::benchmark::Benchmark;
+using sofa::benchmark::BenchmarkOptions;
+using sofa::benchmark::getBenchmarks;
+
+// ---------------------------------------------------------------------
+// sofaBenchmark: run the registered micro-benchmarks.
+//   sofaBenchmark --list
+//   sofaBenchmark [-r repeat] [-t threads] [-s size] [-i inputs...] [benchmark...]
+// Without benchmark names, every registered benchmark is run.
+// ---------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    bool showHelp = false;
+    bool listBenchmarks = false;
+    BenchmarkOptions options;
+
+    ArgumentParser* argParser = new ArgumentParser(argc, argv);
+    argParser->addArgument(
+        boost::program_options::value<bool>(&showHelp)
+        ->default_value(false)
+        ->implicit_value(true),
+        "help,h",
+        "Display this help message"
+    );
+    argParser->addArgument(
+        boost::program_options::value<bool>(&listBenchmarks)
+        ->default_value(false)
+        ->implicit_value(true),
+        "list,l",
+        "list the available benchmarks"
+    );
+    argParser->addArgument(
+        boost::program_options::value<unsigned int>(&options.repeat)
+        ->default_value(5),
+        "repeat,r",
+        "number of timed repetitions of each measure"
+    );
+    argParser->addArgument(
+        boost::program_options::value<unsigned int>(&options.threads)
+        ->default_value(0),
+        "threads,t",
+        "number of threads used by the parallel benchmarks (0: hardware default)"
+    );
+    argParser->addArgument(
+        boost::program_options::value<unsigned int>(&options.size)
+        ->default_value(0),
+        "size,s",
+        "problem size (0: default size of each benchmark)"
+    );
+    argParser->addArgument(
+        boost::program_options::value<std::vector<std::string> >(&options.inputs)
+        ->multitoken(),
+        "input,i",
+        "extra input files forwarded to the benchmarks (e.g. scenes)"
+    );
+
+    argParser->parse();
+    const std::vector<std::string> selection = argParser->getInputFileList();
+
+    if (showHelp)
+    {
+        argParser->showHelp();
+        return EXIT_SUCCESS;
+    }
+
+    if (listBenchmarks)
+    {
+        for (const Benchmark& b : getBenchmarks())
+            std::cout << b.name << ": " << b.description << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    sofa::component::initSofaGeneral();
+    sofa::component::initSofaMisc();
+
+    int nbRun = 0;
+    for (const Benchmark& b : getBenchmarks())
+    {
+        if (!selection.empty() && std::find(selection.begin(), selection.end(), b.name) == selection.end())
+            continue;
+
+        std::cout << "[" << b.name << "] " << b.description << std::endl;
+        b.run(options);
+        ++nbRun;
+    }
+
+    if (nbRun == 0)
+    {
+        std::cerr << "No benchmark matches the selection, use --list to see the available ones." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
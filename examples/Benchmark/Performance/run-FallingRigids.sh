@@ -0,0 +1,8 @@
+#!/bin/bash
+for d in BruteForceDetection ParallelSpatialHashDetection;
+do
+export detection=$d
+echo $d
+php examples/Benchmark/Performance/FallingRigids-collision.pscn > examples/Benchmark/Performance/FallingRigids-collision-$d.scn
+runSofa -g batch -n 100 examples/Benchmark/Performance/FallingRigids-collision-$d.scn
+done
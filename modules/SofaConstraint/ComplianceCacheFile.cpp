@@ -0,0 +1,309 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaConstraint/ComplianceCacheFile.h>
+#include <sofa/helper/logging/Messaging.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <process.h>
+#endif
+
+#if SOFACONSTRAINT_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace sofa
+{
+
+namespace component
+{
+
+namespace constraintset
+{
+
+namespace
+{
+
+const char cacheMagic[8] = { 'S', 'O', 'F', 'A', 'C', 'O', 'M', 'P' };
+
+int getProcessId()
+{
+#ifndef WIN32
+    return (int)getpid();
+#else
+    return _getpid();
+#endif
+}
+
+}
+
+ComplianceCacheFile::ComplianceCacheFile()
+    : m_header()
+    , m_data(nullptr)
+    , m_mapping(nullptr)
+    , m_mappingSize(0)
+{
+}
+
+ComplianceCacheFile::~ComplianceCacheFile()
+{
+    close();
+}
+
+bool ComplianceCacheFile::hasCompression()
+{
+#if SOFACONSTRAINT_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint64_t ComplianceCacheFile::hash(const std::string& s, uint64_t h)
+{
+    for (const char c : s)
+    {
+        h ^= (unsigned char)c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+bool ComplianceCacheFile::isCacheFile(const std::string& fileName)
+{
+    std::ifstream in(fileName.c_str(), std::ifstream::binary);
+    if (!in.is_open()) return false;
+    char magic[sizeof(cacheMagic)];
+    in.read(magic, sizeof(magic));
+    return in.gcount() == (std::streamsize)sizeof(magic) && std::memcmp(magic, cacheMagic, sizeof(magic)) == 0;
+}
+
+bool ComplianceCacheFile::open(const std::string& fileName, uint64_t hash, uint64_t nbRows, uint64_t nbCols)
+{
+    close();
+
+    const char* begin = nullptr;
+    std::size_t size = 0;
+#ifndef WIN32
+    const int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (std::size_t)st.st_size < sizeof(Header))
+    {
+        ::close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) return false;
+    m_mapping = mapping;
+    m_mappingSize = (std::size_t)st.st_size;
+    begin = (const char*)mapping;
+    size = m_mappingSize;
+#else
+    std::ifstream in(fileName.c_str(), std::ifstream::binary);
+    if (!in.is_open()) return false;
+    m_buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    begin = m_buffer.data();
+    size = m_buffer.size();
+    if (size < sizeof(Header)) return false;
+#endif
+
+    std::memcpy(&m_header, begin, sizeof(Header));
+    const bool valid = std::memcmp(m_header.magic, cacheMagic, sizeof(cacheMagic)) == 0
+            && m_header.version == Version
+            && (m_header.scalarSize == sizeof(float) || m_header.scalarSize == sizeof(double))
+            && m_header.nbRows == nbRows && m_header.nbCols == nbCols
+            && m_header.hash == hash
+            && size >= sizeof(Header) + m_header.dataSize
+            && (m_header.compressed || m_header.dataSize == nbRows * nbCols * m_header.scalarSize);
+    if (!valid)
+    {
+        close();
+        return false;
+    }
+
+    m_data = begin + sizeof(Header);
+    return true;
+}
+
+void ComplianceCacheFile::close()
+{
+#ifndef WIN32
+    if (m_mapping)
+        munmap(m_mapping, m_mappingSize);
+#endif
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_data = nullptr;
+    std::vector<char>().swap(m_buffer);
+}
+
+const void* ComplianceCacheFile::getMappedValues(std::size_t scalarSize) const
+{
+    if (m_data == nullptr || m_header.compressed || m_header.scalarSize != scalarSize)
+        return nullptr;
+    return m_data;
+}
+
+bool ComplianceCacheFile::readValues(double* values) const
+{
+    return readValuesImpl(values);
+}
+
+bool ComplianceCacheFile::readValues(float* values) const
+{
+    return readValuesImpl(values);
+}
+
+template<class Real>
+bool ComplianceCacheFile::readValuesImpl(Real* values) const
+{
+    if (m_data == nullptr) return false;
+
+    const std::size_t nbValues = (std::size_t)(m_header.nbRows * m_header.nbCols);
+    const char* raw = m_data;
+    std::vector<char> uncompressed;
+    if (m_header.compressed)
+    {
+#if SOFACONSTRAINT_HAVE_ZLIB
+        uncompressed.resize(nbValues * m_header.scalarSize);
+        uLongf size = (uLongf)uncompressed.size();
+        if (uncompress((Bytef*)uncompressed.data(), &size, (const Bytef*)m_data, (uLong)m_header.dataSize) != Z_OK
+                || size != (uLongf)uncompressed.size())
+        {
+            msg_error("ComplianceCacheFile") << "Corrupted compressed compliance";
+            return false;
+        }
+        raw = uncompressed.data();
+#else
+        msg_error("ComplianceCacheFile") << "This compliance is compressed, but SofaConstraint was built without zlib";
+        return false;
+#endif
+    }
+
+    if (m_header.scalarSize == sizeof(double))
+        std::copy_n(reinterpret_cast<const double*>(raw), nbValues, values);
+    else
+        std::copy_n(reinterpret_cast<const float*>(raw), nbValues, values);
+    return true;
+}
+
+bool ComplianceCacheFile::write(const std::string& fileName, uint64_t hash, uint64_t nbRows, uint64_t nbCols,
+                                const double* values, bool float32, bool compress)
+{
+    return writeImpl(fileName, hash, nbRows, nbCols, values, float32, compress);
+}
+
+bool ComplianceCacheFile::write(const std::string& fileName, uint64_t hash, uint64_t nbRows, uint64_t nbCols,
+                                const float* values, bool float32, bool compress)
+{
+    return writeImpl(fileName, hash, nbRows, nbCols, values, float32, compress);
+}
+
+template<class Real>
+bool ComplianceCacheFile::writeImpl(const std::string& fileName, uint64_t hash, uint64_t nbRows, uint64_t nbCols,
+                                    const Real* values, bool float32, bool compress)
+{
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.version = Version;
+    header.scalarSize = float32 ? sizeof(float) : sizeof(double);
+    header.compressed = (compress && hasCompression()) ? 1 : 0;
+    header.nbRows = nbRows;
+    header.nbCols = nbCols;
+    header.hash = hash;
+
+    const std::size_t nbValues = (std::size_t)(nbRows * nbCols);
+    const char* raw = reinterpret_cast<const char*>(values);
+    std::size_t rawSize = nbValues * header.scalarSize;
+
+    std::vector<char> converted;
+    if (header.scalarSize != sizeof(Real))
+    {
+        converted.resize(rawSize);
+        if (float32)
+            std::copy_n(values, nbValues, reinterpret_cast<float*>(converted.data()));
+        else
+            std::copy_n(values, nbValues, reinterpret_cast<double*>(converted.data()));
+        raw = converted.data();
+    }
+
+#if SOFACONSTRAINT_HAVE_ZLIB
+    std::vector<char> compressed;
+    if (header.compressed)
+    {
+        uLongf size = compressBound((uLong)rawSize);
+        compressed.resize(size);
+        if (compress2((Bytef*)compressed.data(), &size, (const Bytef*)raw, (uLong)rawSize, Z_BEST_SPEED) == Z_OK)
+        {
+            raw = compressed.data();
+            rawSize = size;
+        }
+        else
+            header.compressed = 0;
+    }
+#endif
+    header.dataSize = rawSize;
+
+    std::ostringstream tmpName;
+    tmpName << fileName << ".tmp" << getProcessId();
+    {
+        std::ofstream out(tmpName.str().c_str(), std::ofstream::binary);
+        if (!out.is_open()) return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(raw, rawSize);
+        if (!out)
+        {
+            out.close();
+            std::remove(tmpName.str().c_str());
+            return false;
+        }
+    }
+#ifdef WIN32
+    std::remove(fileName.c_str());
+#endif
+    if (std::rename(tmpName.str().c_str(), fileName.c_str()) != 0)
+    {
+        std::remove(tmpName.str().c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace constraintset
+
+} // namespace component
+
+} // namespace sofa
@@ -0,0 +1,120 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#ifndef SOFA_COMPONENT_CONSTRAINTSET_COMPLIANCECACHEFILE_H
+#define SOFA_COMPONENT_CONSTRAINTSET_COMPLIANCECACHEFILE_H
+#include "config.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sofa
+{
+
+namespace component
+{
+
+namespace constraintset
+{
+
+/**
+ *  \brief File storing a precomputed compliance matrix, with a header used to detect outdated files.
+ *
+ *  The values are stored in single or double precision, optionally compressed with zlib.
+ *  Uncompressed files are memory-mapped (read-only): the pages are loaded on demand and
+ *  shared through the page cache by all the processes using the same file.
+ */
+class SOFA_CONSTRAINT_API ComplianceCacheFile
+{
+public:
+    struct Header
+    {
+        char magic[8];          ///< "SOFACOMP"
+        uint32_t version;
+        uint32_t scalarSize;    ///< 4 (float32) or 8 (float64)
+        uint32_t compressed;    ///< 1 if the values are compressed with zlib
+        uint32_t reserved;
+        uint64_t nbRows;
+        uint64_t nbCols;
+        uint64_t hash;          ///< hash of the parameters the compliance was computed with
+        uint64_t dataSize;      ///< size in bytes of the stored values
+    };
+
+    static const uint32_t Version = 1;
+
+    ComplianceCacheFile();
+    ~ComplianceCacheFile();
+    ComplianceCacheFile(const ComplianceCacheFile&) = delete;
+    ComplianceCacheFile& operator=(const ComplianceCacheFile&) = delete;
+
+    /// Return true if the file exists and starts with a compliance cache header
+    static bool isCacheFile(const std::string& fileName);
+
+    /// Open the file and check its header.
+    /// Return false if the file is missing, or was not computed with the given size and hash.
+    bool open(const std::string& fileName, uint64_t hash, uint64_t nbRows, uint64_t nbCols);
+    void close();
+
+    const Header& getHeader() const { return m_header; }
+
+    /// Values of the matrix if they can be used in place, i.e. uncompressed and stored
+    /// with scalarSize bytes, nullptr otherwise.
+    const void* getMappedValues(std::size_t scalarSize) const;
+
+    /// Copy the values, converted if needed, into a buffer of nbRows*nbCols scalars
+    bool readValues(double* values) const;
+    bool readValues(float* values) const;
+
+    /// Write a file, through a temporary file renamed at the end so that concurrent readers
+    /// never see a partially written file.
+    static bool write(const std::string& fileName, uint64_t hash, uint64_t nbRows, uint64_t nbCols,
+                      const double* values, bool float32, bool compress);
+    static bool write(const std::string& fileName, uint64_t hash, uint64_t nbRows, uint64_t nbCols,
+                      const float* values, bool float32, bool compress);
+
+    /// Return true if the values can be compressed in this build
+    static bool hasCompression();
+
+    /// FNV-1a hash of a string, to be chained to hash several values
+    static uint64_t hash(const std::string& s, uint64_t h = 14695981039346656037ULL);
+
+protected:
+    template<class Real>
+    bool readValuesImpl(Real* values) const;
+    template<class Real>
+    static bool writeImpl(const std::string& fileName, uint64_t hash, uint64_t nbRows, uint64_t nbCols,
+                          const Real* values, bool float32, bool compress);
+
+    Header m_header;
+    const char* m_data;         ///< stored values, in the mapping or in m_buffer
+    std::vector<char> m_buffer; ///< file content when it cannot be mapped
+    void* m_mapping;
+    std::size_t m_mappingSize;
+};
+
+} // namespace constraintset
+
+} // namespace component
+
+} // namespace sofa
+
+#endif
@@ -25,8 +25,11 @@
 #include <sofa/simulation/VectorOperations.h>
 #include <sofa/helper/AdvancedTimer.h>
 #include <sofa/core/ObjectFactory.h>
+#include <sofa/simulation/ParallelForRange.h>
 #include "ConstraintStoreLambdaVisitor.h"
 #include <algorithm>
+#include <atomic>
+#include <functional>
 
 namespace sofa
 {
@@ -52,6 +55,12 @@ void clearMultiVecId(sofa::core::objectmodel::BaseContext* ctx, const sofa::core
     ctx->executeVisitor(&clearVisitor);
 }
 
+/// Call func(0..nbTasks-1), concurrently when a scheduler is given
+void runTasks(simulation::TaskScheduler* scheduler, int nbTasks, const std::function<void(int)>& func)
+{
+    simulation::parallelForRange(scheduler, 0, std::max(nbTasks, 0), 1, [&](std::size_t t, std::size_t) { func(int(t)); });
+}
+
 }
 
 GenericConstraintSolver::GenericConstraintSolver()
@@ -77,6 +86,18 @@ GenericConstraintSolver::GenericConstraintSolver()
     , d_computeConstraintForces(initData(&d_computeConstraintForces,false,
                                         "computeConstraintForces",
                                         "enable the storage of the constraintForces (default = False)."))
+    , d_sparseCompliance(initData(&d_sparseCompliance, false, "sparseCompliance",
+                                  "Assemble the compliance in a sparse matrix and solve the independent groups of constraints separately"))
+    , d_parallelResolution(initData(&d_parallelResolution, false, "parallelResolution",
+                                    "Solve the independent groups of constraints concurrently (requires sparseCompliance)"))
+    , d_coloredGroupSize(initData(&d_coloredGroupSize, 64u, "coloredGroupSize",
+                                  "Minimum number of constraint blocks of a group to solve it with a colored parallel Gauss-Seidel (0 to disable)"))
+    , d_warmStart(initData(&d_warmStart, false, "warmStart",
+                           "Initialize the constraint forces with the forces of the previous step, for the constraints having a persistent id (such as contacts)"))
+    , d_computeColdStartIterations(initData(&d_computeColdStartIterations, false, "computeColdStartIterations",
+                                            "Also solve each step from zero forces, to measure the iterations saved by the warm start (costly, not available with unbuilt)"))
+    , d_warmStartedConstraints(initData(&d_warmStartedConstraints, 0, "warmStartedConstraints", "OUTPUT: number of constraints initialized with the forces of the previous step"))
+    , d_coldStartIterations(initData(&d_coldStartIterations, 0, "coldStartIterations", "OUTPUT: number of iterations needed without warm start (computed only if computeColdStartIterations is true)"))
     , current_cp(&m_cpBuffer[0])
     , last_cp(nullptr)
 {
@@ -102,6 +123,10 @@ GenericConstraintSolver::GenericConstraintSolver()
     currentIterations.setGroup("Stats");
     currentError.setReadOnly(true);
     currentError.setGroup("Stats");
+    d_warmStartedConstraints.setReadOnly(true);
+    d_warmStartedConstraints.setGroup("Stats");
+    d_coldStartIterations.setReadOnly(true);
+    d_coldStartIterations.setGroup("Stats");
 
     maxIt.setRequired(true);
     tolerance.setRequired(true);
@@ -129,6 +154,11 @@ void GenericConstraintSolver::init()
         constraintCorrections[i]->addConstraintSolver(this);
     context = (simulation::Node*) getContext();
 
+    msg_warning_when(d_parallelResolution.getValue() && !d_sparseCompliance.getValue())
+            << "parallelResolution requires sparseCompliance, the constraints will be solved sequentially.";
+    msg_warning_when(computeGraphs.getValue() && d_sparseCompliance.getValue())
+            << "computeGraphs is not supported with sparseCompliance, no graph will be computed.";
+
     simulation::common::VectorOperations vop(sofa::core::ExecParams::defaultInstance(), this->getContext());
     {
         sofa::core::behavior::MultiVecDeriv lambda(&vop, m_lambdaId);
@@ -221,6 +251,7 @@ bool GenericConstraintSolver::buildSystem(const core::ConstraintParams *cParams,
     sofa::helper::AdvancedTimer::stepEnd  ("Accumulate Constraint");
     sofa::helper::AdvancedTimer::valSet("numConstraints", numConstraints);
 
+    current_cp->sparse = d_sparseCompliance.getValue() && !unbuilt.getValue();
     current_cp->clear(numConstraints);
 
     sofa::helper::AdvancedTimer::stepBegin("Get Constraint Value");
@@ -231,6 +262,20 @@ bool GenericConstraintSolver::buildSystem(const core::ConstraintParams *cParams,
     MechanicalGetConstraintResolutionVisitor(cParams, current_cp->constraintsResolutions).execute(context);
     sofa::helper::AdvancedTimer::stepEnd("Get Constraint Resolutions");
 
+    if (d_warmStart.getValue())
+    {
+        sofa::helper::AdvancedTimer::stepBegin("Get Constraint Info");
+        m_constraintBlockInfo.clear();
+        m_constraintIds.clear();
+        m_constraintPositions.clear();
+        m_constraintDirections.clear();
+        m_constraintAreas.clear();
+        MechanicalGetConstraintInfoVisitor(cParams, m_constraintBlockInfo, m_constraintIds, m_constraintPositions, m_constraintDirections, m_constraintAreas).execute(context);
+        sofa::helper::AdvancedTimer::stepEnd("Get Constraint Info");
+
+        computeInitialGuess();
+    }
+
     msg_info() <<"GenericConstraintSolver: "<<numConstraints<<" constraints";
 
     // Test if the nodes containing the constraint correction are active (not sleeping)
@@ -246,6 +291,11 @@ bool GenericConstraintSolver::buildSystem(const core::ConstraintParams *cParams,
             cc->resetForUnbuiltResolution(current_cp->getF(), current_cp->constraints_sequence);
         }
 
+        if (d_warmStart.getValue())
+            current_cp->unbuiltInitialForces.assign(current_cp->getF(), current_cp->getF() + numConstraints);
+        else
+            current_cp->unbuiltInitialForces.clear();
+
         sofa::component::linearsolver::SparseMatrix<double>* Wdiag = &current_cp->Wdiag;
         Wdiag->resize(numConstraints, numConstraints);
 
@@ -300,11 +350,21 @@ bool GenericConstraintSolver::buildSystem(const core::ConstraintParams *cParams,
             core::behavior::BaseConstraintCorrection* cc = constraintCorrections[i];
             if (!cc->isActive()) continue;
             sofa::helper::AdvancedTimer::stepBegin("Object name: " + cc->getName());
-            cc->addComplianceInConstraintSpace(cParams, &current_cp->W);
+            if (current_cp->sparse)
+                cc->addComplianceInConstraintSpace(cParams, &current_cp->Wsparse);
+            else
+                cc->addComplianceInConstraintSpace(cParams, &current_cp->W);
             sofa::helper::AdvancedTimer::stepEnd("Object name: " + cc->getName());
         }
 
         sofa::helper::AdvancedTimer::stepEnd  ("Get Compliance");
+
+        if (current_cp->sparse)
+        {
+            sofa::helper::AdvancedTimer::stepBegin("Build Constraint Groups");
+            current_cp->buildSparseStructure(d_parallelResolution.getValue() ? d_coloredGroupSize.getValue() : 0);
+            sofa::helper::AdvancedTimer::stepEnd("Build Constraint Groups");
+        }
         msg_info() << " computeCompliance_done "  ;
     }
 
@@ -378,14 +438,38 @@ bool GenericConstraintSolver::solveSystem(const core::ConstraintParams * /*cPara
         {
             std::stringstream tmp;
             tmp << "---> Before Resolution" << msgendl  ;
-            printLCP(tmp, current_cp->getDfree(), current_cp->getW(), current_cp->getF(), current_cp->getDimension(), true);
+            printLCP(tmp, current_cp->getDfree(), current_cp->getW(), current_cp->getF(), current_cp->getDimension(), !current_cp->sparse);
 
             msg_info() << tmp.str() ;
         }
 
-        sofa::helper::AdvancedTimer::stepBegin("ConstraintsGaussSeidel");
-        current_cp->gaussSeidel(0, this);
-        sofa::helper::AdvancedTimer::stepEnd("ConstraintsGaussSeidel");
+        if (current_cp->sparse)
+        {
+            sofa::helper::AdvancedTimer::stepBegin("ConstraintsSparseGaussSeidel");
+            current_cp->sparseGaussSeidel(0, this, d_parallelResolution.getValue());
+            sofa::helper::AdvancedTimer::stepEnd("ConstraintsSparseGaussSeidel");
+        }
+        else
+        {
+            sofa::helper::AdvancedTimer::stepBegin("ConstraintsGaussSeidel");
+            current_cp->gaussSeidel(0, this);
+            sofa::helper::AdvancedTimer::stepEnd("ConstraintsGaussSeidel");
+        }
+    }
+
+    if (d_warmStart.getValue())
+    {
+        if (d_computeColdStartIterations.getValue() && !unbuilt.getValue())
+        {
+            const int coldStartIterations = computeColdStartIterations();
+            d_coldStartIterations.setValue(coldStartIterations);
+            msg_info() << "Warm start: " << current_cp->currentIterations << " iterations instead of " << coldStartIterations
+                       << " (" << d_warmStartedConstraints.getValue() << " constraints initialized)";
+        }
+
+        sofa::helper::AdvancedTimer::stepBegin("Keep Contact Forces");
+        keepContactForcesValue();
+        sofa::helper::AdvancedTimer::stepEnd("Keep Contact Forces");
     }
 
     this->currentError.setValue(current_cp->currentError);
@@ -520,6 +604,82 @@ bool GenericConstraintSolver::applyCorrection(const core::ConstraintParams *cPar
 }
 
 
+void GenericConstraintSolver::computeInitialGuess()
+{
+    sofa::helper::AdvancedTimer::StepVar vtimer("InitialGuess");
+
+    double* force = current_cp->getF();
+    const int dimension = current_cp->getDimension();
+    int nbInitialized = 0;
+    for (const core::behavior::BaseConstraint::ConstraintBlockInfo& info : m_constraintBlockInfo)
+    {
+        if (!info.hasId) continue;
+        const auto previt = m_previousConstraints.find(info.parent);
+        if (previt == m_previousConstraints.end()) continue;
+        const ConstraintBlockBuf& buf = previt->second;
+        const int nbl = std::min(info.nbLines, buf.nbLines);
+        for (int c = 0; c < info.nbGroups; ++c)
+        {
+            const auto it = buf.persistentToConstraintIdMap.find(m_constraintIds[info.offsetId + c]);
+            if (it == buf.persistentToConstraintIdMap.end()) continue;
+            const int prevIndex = it->second;
+            const int index = info.const0 + c * info.nbLines;
+            if (prevIndex >= 0 && prevIndex + nbl <= (int)m_previousForces.size() && index + nbl <= dimension)
+            {
+                for (int l = 0; l < nbl; ++l)
+                    force[index + l] = m_previousForces[prevIndex + l];
+                ++nbInitialized;
+            }
+        }
+    }
+    d_warmStartedConstraints.setValue(nbInitialized);
+}
+
+void GenericConstraintSolver::keepContactForcesValue()
+{
+    const double* force = current_cp->getF();
+    m_previousForces.assign(force, force + current_cp->getDimension());
+
+    // only the constraints of this step are kept, the others will not come back with the same ids
+    m_previousConstraints.clear();
+    for (const core::behavior::BaseConstraint::ConstraintBlockInfo& info : m_constraintBlockInfo)
+    {
+        if (!info.parent || !info.hasId) continue;
+        ConstraintBlockBuf& buf = m_previousConstraints[info.parent];
+        buf.nbLines = info.nbLines;
+        for (int c = 0; c < info.nbGroups; ++c)
+            buf.persistentToConstraintIdMap[m_constraintIds[info.offsetId + c]] = info.const0 + c * info.nbLines;
+    }
+}
+
+int GenericConstraintSolver::computeColdStartIterations()
+{
+    sofa::helper::AdvancedTimer::StepVar vtimer("ColdStartResolution");
+
+    GenericConstraintProblem* cp = current_cp;
+    const int dimension = cp->getDimension();
+    const std::vector<double> warmForces(cp->getF(), cp->getF() + dimension);
+    const std::vector<double> warmD(cp->_d.ptr(), cp->_d.ptr() + dimension);
+    const double warmError = cp->currentError;
+    const int warmIterations = cp->currentIterations;
+
+    // no solver given: the resolutions are not initialized again and do not store this solution
+    cp->f.clear();
+    if (cp->sparse)
+        cp->sparseGaussSeidel();
+    else
+        cp->gaussSeidel();
+    const int coldIterations = cp->currentIterations;
+
+    std::copy(warmForces.begin(), warmForces.end(), cp->getF());
+    std::copy(warmD.begin(), warmD.end(), cp->_d.ptr());
+    cp->currentError = warmError;
+    cp->currentIterations = warmIterations;
+    sofa::helper::AdvancedTimer::valSet("GS iterations", warmIterations);
+
+    return coldIterations;
+}
+
 ConstraintProblem* GenericConstraintSolver::getConstraintProblem()
 {
     return last_cp;
@@ -557,7 +717,21 @@ void GenericConstraintSolver::lockConstraintProblem(sofa::core::objectmodel::Bas
 
 void GenericConstraintProblem::clear(int nbC)
 {
-    ConstraintProblem::clear(nbC);
+    if (sparse)
+    {
+        // the dense W is left empty, the compliance is assembled in Wsparse
+        ConstraintProblem::clear(0);
+        dimension = nbC;
+        dFree.resize(nbC);
+        f.resize(nbC);
+        // restart from an empty pattern, the coupled constraints change at each step
+        Wsparse.resize(0, 0);
+        Wsparse.resize(nbC, nbC);
+    }
+    else
+    {
+        ConstraintProblem::clear(nbC);
+    }
 
     freeConstraintResolutions();
     constraintsResolutions.resize(nbC);
@@ -603,7 +777,10 @@ void GenericConstraintProblem::solveTimed(double tol, int maxIt, double timeout)
     tolerance = tol;
     maxIterations = maxIt;
 
-    gaussSeidel(timeout);
+    if (sparse)
+        sparseGaussSeidel(timeout);
+    else
+        gaussSeidel(timeout);
 
     tolerance = tempTol;
     maxIterations = tempMaxIt;
@@ -885,7 +1062,11 @@ void GenericConstraintProblem::unbuiltGaussSeidel(double timeout, GenericConstra
             constraintsResolutions[i]->init(i, w, force);
             i += constraintsResolutions[i]->getNbLines();
         }
-        memset(force, 0, dimension * sizeof(double));	// Erase previous forces for the time being
+        // Start from the forces given to the constraint corrections by resetForUnbuiltResolution
+        if (unbuiltInitialForces.size() >= (std::size_t)dimension)
+            std::copy_n(unbuiltInitialForces.begin(), dimension, force);
+        else
+            memset(force, 0, dimension * sizeof(double));	// Erase previous forces for the time being
     }
 
     bool showGraphs = false;
@@ -1094,6 +1275,378 @@ void GenericConstraintProblem::unbuiltGaussSeidel(double timeout, GenericConstra
     }
 }
 
+void GenericConstraintProblem::buildSparseStructure(unsigned int minColoredGroupSize)
+{
+    Wsparse.compress();
+    // one row per line, even empty, to access the rows directly in sparseGaussSeidel
+    const bool emptyW = Wsparse.getColsIndex().empty();
+    if (!emptyW)
+        Wsparse.fullRows();
+
+    // 1. the constraint blocks, as given by the resolutions
+    std::vector<int> lineBlock(dimension, -1);
+    blockLines.clear();
+    int end = 0;
+    while (end < dimension && constraintsResolutions[end])
+    {
+        const int nb = std::min<int>(constraintsResolutions[end]->getNbLines(), dimension - end);
+        for (int l = 0; l < nb; ++l)
+            lineBlock[end + l] = (int)blockLines.size();
+        blockLines.push_back(end);
+        end += nb;
+    }
+    blockLines.push_back(end);
+    const int nbBlocks = (int)blockLines.size() - 1;
+
+    // 2. the diagonal blocks, and the couplings between blocks
+    std::size_t blockWSize = 0;
+    for (int b = 0; b < nbBlocks; ++b)
+        blockWSize += (std::size_t)(blockLines[b+1] - blockLines[b]) * (blockLines[b+1] - blockLines[b]);
+    blockW.assign(blockWSize, 0.0);
+    blockWRows.assign(dimension, nullptr);
+    std::size_t offset = 0;
+    for (int b = 0; b < nbBlocks; ++b)
+    {
+        const int first = blockLines[b];
+        const int nb = blockLines[b+1] - first;
+        // row l of the block, indexed from the first line of the block
+        for (int l = 0; l < nb; ++l)
+            blockWRows[first + l] = blockW.data() + offset + (std::size_t)l * nb;
+        offset += (std::size_t)nb * nb;
+    }
+
+    std::vector< std::pair<int,int> > couplings;
+    const auto& rowBegin = Wsparse.getRowBegin();
+    const auto& colsIndex = Wsparse.getColsIndex();
+    const auto& colsValue = Wsparse.getColsValue();
+    for (int row = 0; !emptyW && row < end; ++row)
+    {
+        const int bi = lineBlock[row];
+        for (auto x = rowBegin[row]; x < rowBegin[row+1]; ++x)
+        {
+            const int col = colsIndex[x];
+            if (col >= end || colsValue[x] == 0.0) continue;
+            const int bj = lineBlock[col];
+            if (bi == bj)
+                blockWRows[row][col - blockLines[bi]] = colsValue[x];
+            else
+            {
+                couplings.emplace_back(bi, bj);
+                couplings.emplace_back(bj, bi);
+            }
+        }
+    }
+    std::sort(couplings.begin(), couplings.end());
+    couplings.erase(std::unique(couplings.begin(), couplings.end()), couplings.end());
+
+    std::vector<int> neighbourBegin(nbBlocks + 1, 0);
+    for (const auto& c : couplings)
+        ++neighbourBegin[c.first + 1];
+    for (int b = 0; b < nbBlocks; ++b)
+        neighbourBegin[b+1] += neighbourBegin[b];
+
+    // 3. the independent groups: connected components of the coupling graph
+    std::vector<int> blockGroup(nbBlocks, -1);
+    groupBegin.clear();
+    groupBlocks.clear();
+    for (int b0 = 0; b0 < nbBlocks; ++b0)
+    {
+        if (blockGroup[b0] >= 0) continue;
+        const int g = (int)groupBegin.size();
+        groupBegin.push_back((int)groupBlocks.size());
+        blockGroup[b0] = g;
+        groupBlocks.push_back(b0);
+        for (std::size_t k = groupBegin.back(); k < groupBlocks.size(); ++k)
+        {
+            const int b = groupBlocks[k];
+            for (int n = neighbourBegin[b]; n < neighbourBegin[b+1]; ++n)
+            {
+                const int bn = couplings[n].second;
+                if (blockGroup[bn] >= 0) continue;
+                blockGroup[bn] = g;
+                groupBlocks.push_back(bn);
+            }
+        }
+        // keep the order of the constraints, as done by the dense Gauss-Seidel
+        std::sort(groupBlocks.begin() + groupBegin.back(), groupBlocks.end());
+    }
+    const int nbGroups = (int)groupBegin.size();
+    groupBegin.push_back((int)groupBlocks.size());
+
+    // 4. greedy coloring of the large groups: blocks of a same color are not coupled
+    std::vector<int> blockColor(nbBlocks, -1);
+    std::vector<char> usedColors;
+    groupColorBegin.clear();
+    colorBegin.clear();
+    colorBlocks.clear();
+    for (int g = 0; g < nbGroups; ++g)
+    {
+        groupColorBegin.push_back((int)colorBegin.size());
+        if (minColoredGroupSize == 0 || (unsigned int)(groupBegin[g+1] - groupBegin[g]) < minColoredGroupSize)
+            continue;
+
+        int nbColors = 0;
+        for (int k = groupBegin[g]; k < groupBegin[g+1]; ++k)
+        {
+            const int b = groupBlocks[k];
+            usedColors.assign(nbColors + 1, 0);
+            for (int n = neighbourBegin[b]; n < neighbourBegin[b+1]; ++n)
+            {
+                const int c = blockColor[couplings[n].second];
+                if (c >= 0) usedColors[c] = 1;
+            }
+            int c = 0;
+            while (usedColors[c]) ++c;
+            blockColor[b] = c;
+            nbColors = std::max(nbColors, c + 1);
+        }
+        for (int c = 0; c < nbColors; ++c)
+        {
+            colorBegin.push_back((int)colorBlocks.size());
+            for (int k = groupBegin[g]; k < groupBegin[g+1]; ++k)
+                if (blockColor[groupBlocks[k]] == c)
+                    colorBlocks.push_back(groupBlocks[k]);
+        }
+    }
+    groupColorBegin.push_back((int)colorBegin.size());
+    colorBegin.push_back((int)colorBlocks.size());
+
+    groupError.assign(nbGroups, 0.0);
+    groupIterations.assign(nbGroups, 0);
+    groupConverged.assign(nbGroups, 0);
+    blockError.assign(nbBlocks, 0.0);
+    blockVerified.assign(nbBlocks, 1);
+}
+
+void GenericConstraintProblem::sparseGaussSeidel(double timeout, GenericConstraintSolver* solver, bool parallel)
+{
+    if(!dimension)
+    {
+        currentError = 0.0;
+        currentIterations = 0;
+        return;
+    }
+
+    const double t0 = (double)sofa::helper::system::thread::CTime::getTime();
+    const double timeScale = 1.0 / (double)sofa::helper::system::thread::CTime::getTicksPerSec();
+
+    double *dfree = getDfree();
+    double *force = getF();
+    double **w = blockWRows.data();
+    double *d = _d.ptr();
+
+    const int nbBlocks = (int)blockLines.size() - 1;
+    const int nbGroups = (int)groupBegin.size() - 1;
+
+    if(solver)
+    {
+        if(blockLines.back() < dimension)
+        {
+            msg_error(solver) << "Bad size of constraintsResolutions in GenericConstraintProblem" ;
+            dimension = blockLines.back();
+        }
+        for(int b=0; b<nbBlocks; ++b)
+        {
+            // each block is given to its resolution as a local problem starting at line 0
+            const int j = blockLines[b];
+            constraintsResolutions[j]->init(0, &w[j], &force[j]);
+        }
+    }
+
+    double tol = tolerance;
+    if(scaleTolerance && !allVerified)
+        tol *= dimension;
+
+    simulation::TaskScheduler* scheduler = (solver && parallel) ? simulation::TaskScheduler::getInstance() : nullptr;
+    const int nbThreads = scheduler ? std::max<int>(scheduler->getThreadCount(), 1) : 1;
+
+    // One Gauss-Seidel step on block b, returning its error as measured by gaussSeidel()
+    auto relaxBlock = [&](int b, bool& verified, std::vector<double>& errF) -> double
+    {
+        const int j = blockLines[b];
+        const int nb = blockLines[b+1] - j;
+        const auto& rowBegin = Wsparse.getRowBegin();
+        const auto& colsIndex = Wsparse.getColsIndex();
+        const auto& colsValue = Wsparse.getColsValue();
+
+        errF.assign(&force[j], &force[j+nb]);
+        for(int l=0; l<nb; l++)
+        {
+            double dl = dfree[j+l];
+            if(!colsIndex.empty())
+                for(auto x = rowBegin[j+l]; x < rowBegin[j+l+1]; ++x)
+                    dl += colsValue[x] * force[colsIndex[x]];
+            d[j+l] = dl;
+        }
+
+        constraintsResolutions[j]->resolution(0, &w[j], &d[j], &force[j], &dfree[j]);
+
+        double contraintError = 0.0;
+        if(nb > 1)
+        {
+            for(int l=0; l<nb; l++)
+            {
+                double lineError = 0.0;
+                for (int m=0; m<nb; m++)
+                {
+                    double dofError = w[j+l][m] * (force[j+m] - errF[m]);
+                    lineError += dofError * dofError;
+                }
+                lineError = sqrt(lineError);
+                if(lineError > tol)
+                    verified = false;
+
+                contraintError += lineError;
+            }
+        }
+        else
+        {
+            contraintError = fabs(w[j][0] * (force[j] - errF[0]));
+            if(contraintError > tol)
+                verified = false;
+        }
+
+        if(constraintsResolutions[j]->getTolerance())
+        {
+            if(contraintError > constraintsResolutions[j]->getTolerance())
+                verified = false;
+            contraintError *= tol / constraintsResolutions[j]->getTolerance();
+        }
+        return contraintError;
+    };
+
+    // Gauss-Seidel on group g, until its own share of the tolerance is reached
+    auto solveGroup = [&](int g, bool colorsInParallel)
+    {
+        std::vector<double> errF, tempForces;
+        int groupDimension = 0;
+        for(int k=groupBegin[g]; k<groupBegin[g+1]; ++k)
+            groupDimension += blockLines[groupBlocks[k]+1] - blockLines[groupBlocks[k]];
+        const double groupTol = tol * groupDimension / dimension;
+
+        double error = 0.0;
+        bool convergence = false;
+        int iter;
+        for(iter=0; iter<maxIterations; iter++)
+        {
+            bool constraintsAreVerified = true;
+            if(sor != 1.0)
+            {
+                tempForces.clear();
+                for(int k=groupBegin[g]; k<groupBegin[g+1]; ++k)
+                    tempForces.insert(tempForces.end(), &force[blockLines[groupBlocks[k]]], &force[blockLines[groupBlocks[k]+1]]);
+            }
+
+            error = 0.0;
+            if(groupColorBegin[g] == groupColorBegin[g+1])
+            {
+                for(int k=groupBegin[g]; k<groupBegin[g+1]; ++k)
+                    error += relaxBlock(groupBlocks[k], constraintsAreVerified, errF);
+            }
+            else
+            {
+                for(int c=groupColorBegin[g]; c<groupColorBegin[g+1]; ++c)
+                {
+                    const int first = colorBegin[c], last = colorBegin[c+1];
+                    const int nbTasks = colorsInParallel ? std::min(nbThreads, last - first) : 1;
+                    const std::function<void(int)> relaxColor = [&](int t)
+                    {
+                        std::vector<double> taskErrF;
+                        for(int k = first + t; k < last; k += nbTasks)
+                        {
+                            bool verified = true;
+                            blockError[colorBlocks[k]] = relaxBlock(colorBlocks[k], verified, taskErrF);
+                            blockVerified[colorBlocks[k]] = verified;
+                        }
+                    };
+                    runTasks(colorsInParallel ? scheduler : nullptr, nbTasks, relaxColor);
+                    for(int k=first; k<last; ++k)
+                    {
+                        error += blockError[colorBlocks[k]];
+                        constraintsAreVerified &= (bool)blockVerified[colorBlocks[k]];
+                    }
+                }
+            }
+
+            if(sor != 1.0)
+            {
+                auto previous = tempForces.begin();
+                for(int k=groupBegin[g]; k<groupBegin[g+1]; ++k)
+                    for(int j=blockLines[groupBlocks[k]]; j<blockLines[groupBlocks[k]+1]; ++j, ++previous)
+                        force[j] = sor * force[j] + (1-sor) * (*previous);
+            }
+
+            if(timeout && ((double)sofa::helper::system::thread::CTime::getTime() - t0)*timeScale > timeout)
+                break;
+            else if(allVerified)
+            {
+                if(constraintsAreVerified)
+                {
+                    convergence = true;
+                    break;
+                }
+            }
+            else if(error < groupTol)
+            {
+                convergence = true;
+                break;
+            }
+        }
+
+        groupError[g] = error;
+        groupIterations[g] = std::min(iter+1, maxIterations);
+        groupConverged[g] = convergence;
+    };
+
+    // the small groups are solved concurrently, the colored ones one after the other, each by all the threads
+    std::vector<int> smallGroups;
+    for(int g=0; g<nbGroups; ++g)
+        if(groupColorBegin[g] == groupColorBegin[g+1])
+            smallGroups.push_back(g);
+    std::stable_sort(smallGroups.begin(), smallGroups.end(), [&](int a, int b)
+    {
+        return groupBegin[a+1] - groupBegin[a] > groupBegin[b+1] - groupBegin[b];
+    });
+
+    std::atomic<int> nextGroup(0);
+    const std::function<void(int)> solveSmallGroups = [&](int)
+    {
+        for(int i = nextGroup++; i < (int)smallGroups.size(); i = nextGroup++)
+            solveGroup(smallGroups[i], false);
+    };
+    runTasks(scheduler, std::min<int>(nbThreads, (int)smallGroups.size()), solveSmallGroups);
+
+    for(int g=0; g<nbGroups; ++g)
+        if(groupColorBegin[g] != groupColorBegin[g+1])
+            solveGroup(g, scheduler != nullptr);
+
+    // a sum of the errors of the groups, comparable to the error of the dense resolution
+    bool convergence = true;
+    currentError = 0.0;
+    currentIterations = 0;
+    for(int g=0; g<nbGroups; ++g)
+    {
+        currentError += groupError[g];
+        currentIterations = std::max(currentIterations, groupIterations[g]);
+        convergence &= (bool)groupConverged[g];
+    }
+
+    sofa::helper::AdvancedTimer::valSet("GS iterations", currentIterations);
+
+    if(solver)
+    {
+        if(!convergence)
+        {
+            msg_info(solver) << "No convergence : error = " << currentError ;
+        }
+        else msg_info_when(solver->displayTime.getValue(), solver) << " Convergence after " << currentIterations << " iterations in " << nbGroups << " groups" ;
+
+        for(int g=0; g<nbGroups; ++g)
+            for(int k=groupBegin[g]; k<groupBegin[g+1]; ++k)
+                constraintsResolutions[blockLines[groupBlocks[k]]]->store(blockLines[groupBlocks[k]], force, groupConverged[g]);
+    }
+}
+
 sofa::core::MultiVecDerivId GenericConstraintSolver::getLambda()  const
 {
     return m_lambdaId;
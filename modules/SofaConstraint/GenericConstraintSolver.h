@@ -26,6 +26,7 @@
 #include <SofaConstraint/ConstraintSolverImpl.h>
 #include <sofa/core/behavior/BaseConstraintCorrection.h>
 #include <SofaBaseLinearSolver/SparseMatrix.h>
+#include <SofaBaseLinearSolver/CompressedRowSparseMatrix.h>
 
 namespace sofa
 {
@@ -53,16 +54,40 @@ public:
     sofa::component::linearsolver::SparseMatrix<double> Wdiag;
     std::list<unsigned int> constraints_sequence;
     bool change_sequence;
+    /// initial forces, already given to the constraint corrections (empty to start from zero forces)
+    std::vector<double> unbuiltInitialForces;
 
     typedef std::vector< core::behavior::BaseConstraintCorrection* > ConstraintCorrections;
     typedef std::vector< core::behavior::BaseConstraintCorrection* >::iterator ConstraintCorrectionIterator;
 
     std::vector< ConstraintCorrections > cclist_elems;
 
+    // For sparse version :
+    /// W stored as a sparse matrix, instead of the dense ConstraintProblem::W
+    sofa::component::linearsolver::CompressedRowSparseMatrix<double> Wsparse;
+    bool sparse;
+    /// first line of each constraint block, with a last entry equal to the dimension
+    std::vector<int> blockLines;
+    /// dense diagonal blocks of Wsparse, and their row pointers: the rows of a block are indexed from its first line,
+    /// and &blockWRows[first] is given to the resolutions as the W of a problem starting at line 0
+    std::vector<double> blockW;
+    std::vector<double*> blockWRows;
+    /// independent groups of constraint blocks (no coupling term of W between two groups), stored as ranges of groupBlocks
+    std::vector<int> groupBegin, groupBlocks;
+    /// for the groups solved with a colored Gauss-Seidel, ranges of colorBlocks containing blocks not coupled together
+    std::vector<int> groupColorBegin, colorBegin, colorBlocks;
+    /// per-group output of the last resolution
+    std::vector<double> groupError;
+    std::vector<int> groupIterations;
+    std::vector<char> groupConverged;
+    /// per-block error of the current iteration, used by the colored Gauss-Seidel
+    std::vector<double> blockError;
+    std::vector<char> blockVerified;
+
 
     GenericConstraintProblem() : scaleTolerance(true), allVerified(false), sor(1.0)
       , sceneTime(0.0), currentError(0.0), currentIterations(0)
-      , change_sequence(false) {}
+      , change_sequence(false), sparse(false) {}
     ~GenericConstraintProblem() override { freeConstraintResolutions(); }
 
     void clear(int nbConstraints) override;
@@ -72,6 +97,14 @@ public:
     void gaussSeidel(double timeout=0, GenericConstraintSolver* solver = nullptr);
     void unbuiltGaussSeidel(double timeout=0, GenericConstraintSolver* solver = nullptr);
 
+    /// Build the blocks, groups and colors of the constraints from the sparsity of Wsparse.
+    /// Groups of at least minColoredGroupSize blocks are colored (0 to disable the coloring).
+    void buildSparseStructure(unsigned int minColoredGroupSize);
+    /// Gauss-Seidel on Wsparse, solving each independent group of constraints on its own.
+    /// When a solver is given and parallel is true, groups are solved concurrently and colored groups
+    /// are solved by a parallel Gauss-Seidel, one color after the other.
+    void sparseGaussSeidel(double timeout=0, GenericConstraintSolver* solver = nullptr, bool parallel = false);
+
     int getNumConstraints();
     int getNumConstraintGroups();
 };
@@ -123,6 +156,13 @@ public:
     Data<bool> reverseAccumulateOrder; ///< True to accumulate constraints from nodes in reversed order (can be necessary when using multi-mappings or interaction constraints not following the node hierarchy)
     Data<helper::vector< double >> d_constraintForces; ///< OUTPUT: The Data constraintForces is used to provide the intensities of constraint forces in the simulation. The user can easily check the constraint forces from the GenericConstraint component interface.
     Data<bool> d_computeConstraintForces; ///< The indices of the constraintForces to store in the constraintForce data field.
+    Data<bool> d_sparseCompliance; ///< Assemble the compliance in a sparse matrix and solve the independent groups of constraints separately
+    Data<bool> d_parallelResolution; ///< Solve the independent groups of constraints concurrently (requires sparseCompliance)
+    Data<unsigned int> d_coloredGroupSize; ///< Minimum number of constraint blocks of a group to solve it with a colored parallel Gauss-Seidel (0 to disable)
+    Data<bool> d_warmStart; ///< Initialize the constraint forces with the forces of the previous step, for the constraints having a persistent id (such as contacts)
+    Data<bool> d_computeColdStartIterations; ///< Also solve each step from zero forces, to measure the iterations saved by the warm start (costly)
+    Data<int> d_warmStartedConstraints; ///< OUTPUT: number of constraints initialized with the forces of the previous step
+    Data<int> d_coldStartIterations; ///< OUTPUT: number of iterations needed without warm start
 
     sofa::core::MultiVecDerivId getLambda() const override;
     sofa::core::MultiVecDerivId getDx() const override;
@@ -131,6 +171,13 @@ protected:
 
     void clearConstraintProblemLocks();
 
+    /// Initialize the forces of the current problem with the forces of the previous step
+    void computeInitialGuess();
+    /// Keep the forces of the current problem, indexed by the persistent ids of the constraints
+    void keepContactForcesValue();
+    /// Number of iterations needed to solve the current problem from zero forces
+    int computeColdStartIterations();
+
     enum { CP_BUFFER_SIZE = 10 };
     sofa::helper::fixed_array<GenericConstraintProblem,CP_BUFFER_SIZE> m_cpBuffer;
     sofa::helper::fixed_array<bool,CP_BUFFER_SIZE> m_cpIsLocked;
@@ -150,6 +197,24 @@ protected:
     double time;
     double timeTotal;
     double timeScale;
+
+    typedef core::behavior::BaseConstraint::PersistentID PersistentID;
+
+    class ConstraintBlockBuf
+    {
+    public:
+        std::map<PersistentID,int> persistentToConstraintIdMap;
+        int nbLines; ///< how many dofs (i.e. lines in the matrix) are used by each constraint
+    };
+
+    std::map<core::behavior::BaseConstraint*, ConstraintBlockBuf> m_previousConstraints;
+    helper::vector<double> m_previousForces;
+
+    core::behavior::BaseConstraint::VecConstraintBlockInfo m_constraintBlockInfo;
+    core::behavior::BaseConstraint::VecPersistentID m_constraintIds;
+    core::behavior::BaseConstraint::VecConstCoord m_constraintPositions;
+    core::behavior::BaseConstraint::VecConstDeriv m_constraintDirections;
+    core::behavior::BaseConstraint::VecConstArea m_constraintAreas;
 };
 
 
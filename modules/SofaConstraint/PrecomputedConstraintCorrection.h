@@ -25,12 +25,15 @@
 
 #include <sofa/core/behavior/ConstraintCorrection.h>
 #include <sofa/core/objectmodel/DataFileName.h>
+#include <SofaConstraint/ComplianceCacheFile.h>
 
 #include <SofaBaseLinearSolver/FullMatrix.h>
 
 #include <sofa/defaulttype/Mat.h>
 #include <sofa/defaulttype/Vec.h>
 
+#include <memory>
+
 namespace sofa
 {
 
@@ -72,6 +75,8 @@ public:
 	Data<double> debugViewFrameScale; ///< Scale on computed node's frame
 	sofa::core::objectmodel::DataFileName f_fileCompliance; ///< Precomputed compliance matrix data file
 	Data<std::string> fileDir; ///< If not empty, the compliance will be saved in this repertory
+    Data<bool> d_storeFloat32; ///< Store the compliance file in single precision
+    Data<bool> d_compressCompliance; ///< Compress the compliance file
     
 protected:
     PrecomputedConstraintCorrection(sofa::core::behavior::MechanicalState<DataTypes> *mm = nullptr);
@@ -128,6 +133,7 @@ public:
     {
         Real* data;
         int nbref;
+        std::shared_ptr<ComplianceCacheFile> file; ///< file mapped in data, if any (data is then read-only)
         InverseStorage() : data(nullptr), nbref(0) {}
     };
 
@@ -182,6 +188,13 @@ protected:
      */
     bool loadCompliance(std::string fileName);
 
+    /**
+     * @brief Load compliance matrix from a file, memory-mapping it when possible.
+     *
+     * @return Loading success, false if the file was computed with other parameters.
+     */
+    bool loadComplianceFile(const std::string& path);
+
     /**
      * @brief Save compliance matrix into a file.
      */
@@ -192,6 +205,13 @@ protected:
      */
     std::string buildFileName();
 
+    /**
+     * @brief Hash of the parameters the compliance depends on: size, time step, rest positions,
+     * and the Data set in the topologies, forcefields, masses, projective constraints and solvers.
+     */
+    uint64_t computeComplianceHash();
+    uint64_t m_complianceHash;
+
     /**
      * @brief Compute dx correction from motion space force vector.
      */
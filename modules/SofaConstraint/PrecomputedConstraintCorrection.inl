@@ -44,10 +44,18 @@
 #include <SofaConstraint/LMConstraintSolver.h>
 #include <sofa/simulation/Node.h>
 
+#include <sofa/core/behavior/BaseForceField.h>
+#include <sofa/core/behavior/BaseMass.h>
+#include <sofa/core/behavior/BaseProjectiveConstraintSet.h>
+#include <sofa/core/behavior/LinearSolver.h>
+#include <sofa/core/behavior/OdeSolver.h>
+#include <sofa/core/topology/BaseMeshTopology.h>
+
 #include <fstream>
 #include <sstream>
 #include <list>
 #include <iomanip>
+#include <set>
 
 //#define NEW_METHOD_UNBUILT
 
@@ -69,9 +77,12 @@ PrecomputedConstraintCorrection<DataTypes>::PrecomputedConstraintCorrection(sofa
     , debugViewFrameScale(initData(&debugViewFrameScale, 1.0, "debugViewFrameScale", "Scale on computed node's frame"))
     , f_fileCompliance(initData(&f_fileCompliance, "fileCompliance", "Precomputed compliance matrix data file"))
     , fileDir(initData(&fileDir, "fileDir", "If not empty, the compliance will be saved in this repertory"))
+    , d_storeFloat32(initData(&d_storeFloat32, false, "storeFloat32", "Store the compliance file in single precision (half the size, converted when loaded)"))
+    , d_compressCompliance(initData(&d_compressCompliance, false, "compressCompliance", "Compress the compliance file (a compressed file is decompressed in memory instead of being memory-mapped)"))
     , invM(nullptr)
     , appCompliance(nullptr)
     , nbRows(0), nbCols(0), dof_on_node(0), nbNodes(0)
+    , m_complianceHash(0)
 {
     this->addAlias(&f_fileCompliance, "filePrefix");
 }
@@ -104,7 +115,7 @@ void PrecomputedConstraintCorrection<DataTypes>::releaseInverse(std::string name
     std::map< std::string, InverseStorage >& registry = getInverseMap();
     if (--inv->nbref == 0)
     {
-        if (inv->data) delete[] inv->data;
+        if (inv->data && !inv->file) delete[] inv->data;
         registry.erase(name);
     }
 }
@@ -125,6 +136,49 @@ std::string PrecomputedConstraintCorrection<DataTypes>::buildFileName()
     return ss.str();
 }
 
+template<class DataTypes>
+uint64_t PrecomputedConstraintCorrection<DataTypes>::computeComplianceHash()
+{
+    // Data not changing the compliance
+    static const std::set<std::string> ignoredData = { "name", "printLog", "tags", "bbox", "listening", "componentState" };
+
+    std::stringstream ss;
+    ss << DataTypes::Name() << " " << nbRows << " " << nbCols << " " << this->getContext()->getDt();
+    uint64_t h = ComplianceCacheFile::hash(ss.str());
+    h = ComplianceCacheFile::hash(this->mstate->read(core::ConstVecCoordId::restPosition())->getValueString(), h);
+
+    helper::vector<core::objectmodel::BaseObject*> objects;
+    this->getContext()->template get<core::objectmodel::BaseObject>(&objects, core::objectmodel::BaseContext::SearchDown);
+    // the solvers used for the precomputation can be above this node
+    core::behavior::OdeSolver* odeSolver = nullptr;
+    core::behavior::LinearSolver* linearSolver = nullptr;
+    this->getContext()->get(odeSolver);
+    this->getContext()->get(linearSolver);
+    for (core::objectmodel::BaseObject* solver : { (core::objectmodel::BaseObject*)odeSolver, (core::objectmodel::BaseObject*)linearSolver })
+        if (solver && std::find(objects.begin(), objects.end(), solver) == objects.end())
+            objects.push_back(solver);
+
+    for (core::objectmodel::BaseObject* o : objects)
+    {
+        if (!dynamic_cast<core::topology::BaseMeshTopology*>(o)
+                && !dynamic_cast<core::behavior::BaseForceField*>(o)
+                && !dynamic_cast<core::behavior::BaseMass*>(o)
+                && !dynamic_cast<core::behavior::BaseProjectiveConstraintSet*>(o)
+                && !dynamic_cast<core::behavior::OdeSolver*>(o)
+                && !dynamic_cast<core::behavior::LinearSolver*>(o))
+            continue;
+
+        h = ComplianceCacheFile::hash(o->getClassName(), h);
+        for (const core::objectmodel::BaseData* data : o->getDataFields())
+        {
+            if (!data->isSet() || data->isReadOnly() || ignoredData.count(data->getName())) continue;
+            h = ComplianceCacheFile::hash(data->getName(), h);
+            h = ComplianceCacheFile::hash(data->getValueString(), h);
+        }
+    }
+    return h;
+}
+
 
 
 template<class DataTypes>
@@ -144,40 +198,65 @@ bool PrecomputedConstraintCorrection<DataTypes>::loadCompliance(std::string file
         std::string dir = fileDir.getValue();
         if (!dir.empty())
         {
-            std::ifstream compFileIn((dir + "/" + fileName).c_str(), std::ifstream::binary);
-            if (compFileIn.is_open())
-            {
-                invM->data = new Real[nbRows * nbCols];
-
-                msg_info() << "File " << dir + "/" + fileName << " found. Loading..." ;
-
-                compFileIn.read((char*)invM->data, nbCols * nbRows * sizeof(double));
-                compFileIn.close();
-
-                return true;
-            }
-            else
-                return false;
+            return loadComplianceFile(dir + "/" + fileName);
         }
         else if (recompute.getValue() == false)
         {
             if(sofa::helper::system::DataRepository.findFile(fileName))
             {
-                invM->data = new Real[nbRows * nbCols];
+                return loadComplianceFile(fileName);
+            }
+        }
+
+        return false;
+    }
 
-                std::ifstream compFileIn(fileName.c_str(), std::ifstream::binary);
+    return true;
+}
 
-                msg_info() << "File " << fileName << " found. Loading..." ;
+template<class DataTypes>
+bool PrecomputedConstraintCorrection<DataTypes>::loadComplianceFile(const std::string& path)
+{
+    if (ComplianceCacheFile::isCacheFile(path))
+    {
+        std::shared_ptr<ComplianceCacheFile> file = std::make_shared<ComplianceCacheFile>();
+        if (!file->open(path, m_complianceHash, nbRows, nbCols))
+        {
+            msg_info() << "File " << path << " was computed with other parameters, the compliance will be recomputed";
+            return false;
+        }
 
-                compFileIn.read((char*)invM->data, nbCols * nbRows * sizeof(double));
-                compFileIn.close();
+        if (const void* values = file->getMappedValues(sizeof(Real)))
+        {
+            msg_info() << "File " << path << " found. Mapping..." ;
+            // the compliance is never modified once computed: the mapping is shared by all the processes using this file
+            invM->data = const_cast<Real*>(static_cast<const Real*>(values));
+            invM->file = file;
+            return true;
+        }
 
-                return true;
-            }
+        msg_info() << "File " << path << " found. Loading..." ;
+        invM->data = new Real[nbRows * nbCols];
+        if (!file->readValues(invM->data))
+        {
+            delete[] invM->data;
+            invM->data = nullptr;
+            return false;
         }
+        return true;
+    }
 
+    // raw file, saved by previous versions
+    std::ifstream compFileIn(path.c_str(), std::ifstream::binary);
+    if (!compFileIn.is_open())
         return false;
-    }
+
+    invM->data = new Real[nbRows * nbCols];
+
+    msg_info() << "File " << path << " found. Loading..." ;
+
+    compFileIn.read((char*)invM->data, nbCols * nbRows * sizeof(double));
+    compFileIn.close();
 
     return true;
 }
@@ -196,9 +275,26 @@ void PrecomputedConstraintCorrection<DataTypes>::saveCompliance(const std::strin
     else
         filePathInSofaShare  = sofa::helper::system::DataRepository.getFirstPath() + "/" + fileName;
 
-    std::ofstream compFileOut(filePathInSofaShare.c_str(), std::fstream::out | std::fstream::binary);
-    compFileOut.write((char*)invM->data, nbCols * nbRows * sizeof(double));
-    compFileOut.close();
+    if (!ComplianceCacheFile::write(filePathInSofaShare, m_complianceHash, nbRows, nbCols, invM->data,
+                                    d_storeFloat32.getValue(), d_compressCompliance.getValue()))
+    {
+        msg_error() << "Unable to save the compliance in " << filePathInSofaShare;
+        return;
+    }
+    msg_warning_when(d_compressCompliance.getValue() && !ComplianceCacheFile::hasCompression())
+            << "SofaConstraint was built without zlib, the compliance is saved uncompressed";
+
+    // use the mapping of the file instead of the computed buffer, to share it with the other processes
+    std::shared_ptr<ComplianceCacheFile> file = std::make_shared<ComplianceCacheFile>();
+    if (file->open(filePathInSofaShare, m_complianceHash, nbRows, nbCols))
+    {
+        if (const void* values = file->getMappedValues(sizeof(Real)))
+        {
+            delete[] invM->data;
+            invM->data = const_cast<Real*>(static_cast<const Real*>(values));
+            invM->file = file;
+        }
+    }
 }
 
 
@@ -226,6 +322,7 @@ void PrecomputedConstraintCorrection<DataTypes>::bwdInit()
     double dt = this->getContext()->getDt();
 
     invName = f_fileCompliance.getFullPath().empty() ? buildFileName() : f_fileCompliance.getFullPath();
+    m_complianceHash = computeComplianceHash();
 
     if (!loadCompliance(invName))
     {
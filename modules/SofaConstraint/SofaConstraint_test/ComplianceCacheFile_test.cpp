@@ -0,0 +1,135 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <SofaConstraint/ComplianceCacheFile.h>
+using sofa::component::constraintset::ComplianceCacheFile;
+
+#include <boost/filesystem.hpp>
+
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+
+const uint64_t nbRows = 30;
+const uint64_t nbCols = 30;
+const uint64_t hash = 12345;
+
+std::vector<double> createCompliance()
+{
+    std::vector<double> values(nbRows * nbCols);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        values[i] = 1.0 / (1.0 + i % 17);
+    return values;
+}
+
+std::string cacheFileName()
+{
+    return boost::filesystem::temp_directory_path().string() + "/ComplianceCacheFile_test.comp";
+}
+
+TEST(ComplianceCacheFile_test, mappedDouble)
+{
+    const std::vector<double> values = createCompliance();
+    const std::string fileName = cacheFileName();
+    ASSERT_TRUE(ComplianceCacheFile::write(fileName, hash, nbRows, nbCols, values.data(), false, false));
+    EXPECT_TRUE(ComplianceCacheFile::isCacheFile(fileName));
+
+    ComplianceCacheFile file;
+    ASSERT_TRUE(file.open(fileName, hash, nbRows, nbCols));
+    const double* mapped = static_cast<const double*>(file.getMappedValues(sizeof(double)));
+    ASSERT_NE(mapped, nullptr);
+    EXPECT_EQ(file.getMappedValues(sizeof(float)), nullptr);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        ASSERT_EQ(mapped[i], values[i]);
+
+    std::vector<float> converted(values.size());
+    ASSERT_TRUE(file.readValues(converted.data()));
+    for (std::size_t i = 0; i < values.size(); ++i)
+        ASSERT_EQ(converted[i], (float)values[i]);
+
+    file.close();
+    std::remove(fileName.c_str());
+}
+
+TEST(ComplianceCacheFile_test, float32)
+{
+    const std::vector<double> values = createCompliance();
+    const std::string fileName = cacheFileName();
+    ASSERT_TRUE(ComplianceCacheFile::write(fileName, hash, nbRows, nbCols, values.data(), true, false));
+
+    ComplianceCacheFile file;
+    ASSERT_TRUE(file.open(fileName, hash, nbRows, nbCols));
+    EXPECT_EQ(file.getHeader().scalarSize, sizeof(float));
+    EXPECT_EQ(file.getMappedValues(sizeof(double)), nullptr);
+
+    std::vector<double> read(values.size());
+    ASSERT_TRUE(file.readValues(read.data()));
+    for (std::size_t i = 0; i < values.size(); ++i)
+        ASSERT_EQ(read[i], (double)(float)values[i]);
+
+    file.close();
+    std::remove(fileName.c_str());
+}
+
+TEST(ComplianceCacheFile_test, compressed)
+{
+    const std::vector<double> values = createCompliance();
+    const std::string fileName = cacheFileName();
+    ASSERT_TRUE(ComplianceCacheFile::write(fileName, hash, nbRows, nbCols, values.data(), false, true));
+
+    ComplianceCacheFile file;
+    ASSERT_TRUE(file.open(fileName, hash, nbRows, nbCols));
+    EXPECT_EQ(file.getHeader().compressed != 0, ComplianceCacheFile::hasCompression());
+    if (ComplianceCacheFile::hasCompression())
+    {
+        EXPECT_EQ(file.getMappedValues(sizeof(double)), nullptr);
+        EXPECT_LT(file.getHeader().dataSize, values.size() * sizeof(double));
+    }
+
+    std::vector<double> read(values.size());
+    ASSERT_TRUE(file.readValues(read.data()));
+    for (std::size_t i = 0; i < values.size(); ++i)
+        ASSERT_EQ(read[i], values[i]);
+
+    file.close();
+    std::remove(fileName.c_str());
+}
+
+TEST(ComplianceCacheFile_test, outdated)
+{
+    const std::vector<double> values = createCompliance();
+    const std::string fileName = cacheFileName();
+    ASSERT_TRUE(ComplianceCacheFile::write(fileName, hash, nbRows, nbCols, values.data(), false, false));
+
+    ComplianceCacheFile file;
+    EXPECT_FALSE(file.open(fileName, hash + 1, nbRows, nbCols));
+    EXPECT_FALSE(file.open(fileName, hash, nbRows + 1, nbCols));
+    EXPECT_FALSE(file.open(fileName + ".missing", hash, nbRows, nbCols));
+    EXPECT_FALSE(ComplianceCacheFile::isCacheFile(fileName + ".missing"));
+
+    std::remove(fileName.c_str());
+}
+
+} // namespace
@@ -25,6 +25,16 @@ using sofa::helper::testing::BaseSimulationTest;
 #include <SofaSimulationGraph/SimpleApi.h>
 using namespace sofa::simpleapi;
 
+#include <SofaConstraint/GenericConstraintSolver.h>
+#include <SofaConstraint/BilateralConstraintResolution.h>
+#include <SofaConstraint/UnilateralInteractionConstraint.h>
+using sofa::component::constraintset::GenericConstraintProblem;
+using sofa::component::constraintset::UnilateralConstraintResolution;
+using sofa::component::constraintset::bilateralconstraintresolution::BilateralConstraintResolution3Dof;
+
+#include <iterator>
+#include <sstream>
+
 namespace
 {
 
@@ -68,6 +78,176 @@ TEST_F(GenericConstraintSolver_test, checkConstraintForce)
     enableConstraintForce();
 }
 
+/// Positions and iteration counts of a rigid cube resting on a floor with friction
+struct WarmStartResult
+{
+    std::vector<std::vector<double>> positions;
+    std::vector<int> iterations, coldStartIterations, warmStartedConstraints;
+};
+
+WarmStartResult simulateRestingCube(bool warmStart, bool computeColdStartIterations, bool sparse)
+{
+    const std::string scene =
+            "<Node dt='0.01' gravity='0 -9.81 0'>\n"
+            "   <RequiredPlugin name='SofaComponentAll'/>"
+            "   <RequiredPlugin name='SofaMiscCollision'/>"
+            "   <FreeMotionAnimationLoop />\n"
+            "   <GenericConstraintSolver name='solver' maxIterations='1000' tolerance='1e-10'"
+            "       sparseCompliance='" + std::to_string(sparse) + "'"
+            "       warmStart='" + std::to_string(warmStart) + "'"
+            "       computeColdStartIterations='" + std::to_string(computeColdStartIterations) + "' />\n"
+            "   <DefaultPipeline />\n"
+            "   <BruteForceDetection />\n"
+            "   <LocalMinDistance alarmDistance='0.2' contactDistance='0.05' />\n"
+            "   <DefaultContactManager response='FrictionContact' responseParams='mu=0.6' />\n"
+            "   <Node name='floor'>\n"
+            "       <MechanicalObject position='-5 0 -5  5 0 -5  5 0 5  -5 0 5' />\n"
+            "       <MeshTopology triangles='0 2 1  0 3 2' />\n"
+            "       <TriangleCollisionModel moving='0' simulated='0' />\n"
+            "   </Node>\n"
+            "   <Node name='cube'>\n"
+            "       <EulerImplicitSolver />\n"
+            "       <CGLinearSolver iterations='100' tolerance='1e-12' threshold='1e-12' />\n"
+            "       <MechanicalObject name='dofs' template='Rigid3d' position='0.1 0.8 0  0.05 0 0 0.9987' />\n"
+            "       <UniformMass totalMass='1' />\n"
+            "       <UncoupledConstraintCorrection />\n"
+            "       <Node name='collision'>\n"
+            "           <MechanicalObject position='-0.5 -0.5 -0.5  0.5 -0.5 -0.5  0.5 -0.5 0.5  -0.5 -0.5 0.5"
+            "                                      -0.5 0.5 -0.5  0.5 0.5 -0.5  0.5 0.5 0.5  -0.5 0.5 0.5' />\n"
+            "           <PointCollisionModel />\n"
+            "           <RigidMapping />\n"
+            "       </Node>\n"
+            "   </Node>\n"
+            "</Node>\n";
+    BaseSimulationTest::SceneInstance sceneinstance("xml", scene);
+    sceneinstance.initScene();
+
+    auto solver = sceneinstance.root->getObject("solver");
+    auto dofs = sceneinstance.root->getChild("cube")->getObject("dofs");
+    WarmStartResult result;
+    for (int step = 0; step < 100; ++step)
+    {
+        sceneinstance.simulate(0.01);
+        std::istringstream position(dofs->findData("position")->getValueString());
+        result.positions.emplace_back(std::istream_iterator<double>(position), std::istream_iterator<double>());
+        result.iterations.push_back(std::stoi(solver->findData("currentIterations")->getValueString()));
+        result.coldStartIterations.push_back(std::stoi(solver->findData("coldStartIterations")->getValueString()));
+        result.warmStartedConstraints.push_back(std::stoi(solver->findData("warmStartedConstraints")->getValueString()));
+    }
+    return result;
+}
+
+/// Once the contacts persist, the warm start needs fewer iterations than a resolution from zero
+/// forces, and reaches the same solution. Measuring the cold start iterations does not change it.
+void checkWarmStart(bool sparse)
+{
+    const WarmStartResult cold = simulateRestingCube(false, false, sparse);
+    const WarmStartResult warm = simulateRestingCube(true, false, sparse);
+    const WarmStartResult warmMeasured = simulateRestingCube(true, true, sparse);
+
+    for (int n : cold.warmStartedConstraints)
+        EXPECT_EQ(n, 0);
+
+    EXPECT_EQ(warmMeasured.positions, warm.positions);
+    EXPECT_EQ(warmMeasured.iterations, warm.iterations);
+
+    ASSERT_EQ(warm.positions.size(), cold.positions.size());
+    for (std::size_t step = 0; step < cold.positions.size(); ++step)
+    {
+        ASSERT_EQ(warm.positions[step].size(), cold.positions[step].size());
+        for (std::size_t i = 0; i < cold.positions[step].size(); ++i)
+            EXPECT_NEAR(warm.positions[step][i], cold.positions[step][i], 1e-6) << "step " << step << ", coordinate " << i;
+    }
+
+    int warmIterations = 0, coldIterations = 0, warmStartedSteps = 0;
+    for (std::size_t step = 0; step < warmMeasured.iterations.size(); ++step)
+    {
+        if (warmMeasured.warmStartedConstraints[step] == 0) continue;
+        ++warmStartedSteps;
+        warmIterations += warmMeasured.iterations[step];
+        coldIterations += warmMeasured.coldStartIterations[step];
+    }
+    EXPECT_GT(warmStartedSteps, 10);
+    EXPECT_LT(warmIterations, coldIterations);
+}
+
+TEST_F(GenericConstraintSolver_test, warmStart)
+{
+    EXPECT_MSG_NOEMIT(Error);
+    checkWarmStart(false);
+}
+
+TEST_F(GenericConstraintSolver_test, warmStartSparse)
+{
+    EXPECT_MSG_NOEMIT(Error);
+    checkWarmStart(true);
+}
+
+/** Fill a problem with three independent groups of constraints: a chain of unilateral
+ * constraints, a chain of bilateral 3-dof constraints, and a single unilateral constraint.
+ */
+void createProblem(GenericConstraintProblem& problem, bool sparse)
+{
+    const int nbUnilateral = 40, nbBilateral = 5;
+    const int dim = nbUnilateral + 3*nbBilateral + 1;
+    problem.sparse = sparse;
+    problem.clear(dim);
+    problem.tolerance = 1e-12;
+    problem.maxIterations = 10000;
+    problem.allVerified = false;
+    problem.scaleTolerance = false;
+
+    auto setW = [&](int i, int j, double v)
+    {
+        if (sparse) problem.Wsparse.add(i, j, v);
+        else problem.W.set(i, j, v);
+    };
+
+    for (int i = 0; i < nbUnilateral; ++i)
+    {
+        problem.constraintsResolutions[i] = new UnilateralConstraintResolution();
+        setW(i, i, 4.0);
+        if (i > 0) { setW(i, i-1, -1.0); setW(i-1, i, -1.0); }
+        problem.getDfree()[i] = (i % 3 == 0) ? 1.0 : -0.5;
+    }
+    for (int b = 0; b < nbBilateral; ++b)
+    {
+        const int line = nbUnilateral + 3*b;
+        problem.constraintsResolutions[line] = new BilateralConstraintResolution3Dof();
+        for (int l = 0; l < 3; ++l)
+        {
+            for (int m = 0; m < 3; ++m)
+                setW(line+l, line+m, (l == m) ? 3.0 : 0.5);
+            if (b > 0) { setW(line+l, line+l-3, 0.5); setW(line+l-3, line+l, 0.5); }
+            problem.getDfree()[line+l] = 0.1 * (l + 1) - 0.2 * b;
+        }
+    }
+    problem.constraintsResolutions[dim-1] = new UnilateralConstraintResolution();
+    setW(dim-1, dim-1, 2.0);
+    problem.getDfree()[dim-1] = -1.0;
+}
+
+TEST(GenericConstraintProblem_test, sparseGaussSeidel)
+{
+    GenericConstraintProblem dense;
+    createProblem(dense, false);
+    dense.gaussSeidel();
+
+    for (unsigned int coloredGroupSize : { 0u, 4u })
+    {
+        GenericConstraintProblem sparse;
+        createProblem(sparse, true);
+        sparse.buildSparseStructure(coloredGroupSize);
+        EXPECT_EQ(sparse.groupBegin.size(), 4u);
+
+        sparse.sparseGaussSeidel();
+        EXPECT_GT(sparse.currentIterations, 0);
+        EXPECT_LT(sparse.currentError, 1e-12);
+        for (int i = 0; i < dense.getDimension(); ++i)
+            EXPECT_NEAR(sparse.getF()[i], dense.getF()[i], 1e-10) << "coloredGroupSize " << coloredGroupSize << ", line " << i;
+    }
+}
+
 
 } /// namespace sofa
 
@@ -31,6 +31,7 @@
 #include <sofa/simulation/AnimateEndEvent.h>
 #include <sofa/defaulttype/DataTypeInfo.h>
 #include <sofa/simulation/Visitor.h>
+#include <sofa/helper/io/TrajectoryFile.h>
 
 #if SOFAEXPORTER_HAVE_ZLIB
 #include <zlib.h>
@@ -69,6 +70,11 @@ public:
     Data < helper::vector<unsigned int> > d_DOFsV; ///< set the velocity DOFs to write
     Data < double > d_stopAt; ///< stop the simulation when the given threshold is reached
     Data < double > d_keperiod; ///< set the period to measure the kinetic energy increase
+    Data < bool > d_binary; ///< write a binary trajectory file instead of text lines
+    Data < bool > d_float32; ///< store the values of the binary file in single precision
+    Data < bool > d_compress; ///< compress the chunks of the binary file
+    Data < unsigned int > d_framesPerChunk; ///< number of states grouped in each chunk of the binary file
+    Data < bool > d_asynchronous; ///< write the binary file from a separate thread
 
 protected:
     core::behavior::BaseMechanicalState* mmodel;
@@ -84,6 +90,11 @@ protected:
     bool firstExport;
     bool periodicExport;
     bool validInit;
+    helper::io::TrajectoryWriter m_trajectory;
+    helper::io::TrajectoryFrame m_frame;
+
+    /// Add the current state to the binary trajectory
+    void writeTrajectoryFrame(double time);
 
 
     WriteState();
@@ -52,6 +52,11 @@ WriteState::WriteState()
     , d_DOFsV( initData(&d_DOFsV, helper::vector<unsigned int>(0), "DOFsV", "set the velocity DOFs to write"))
     , d_stopAt( initData(&d_stopAt, 0.0, "stopAt", "stop the simulation when the given threshold is reached"))
     , d_keperiod( initData(&d_keperiod, 0.0, "keperiod", "set the period to measure the kinetic energy increase"))
+    , d_binary( initData(&d_binary, false, "binary", "write a binary trajectory file, indexed by time, instead of text lines"))
+    , d_float32( initData(&d_float32, false, "float32", "store the values of the binary file in single precision"))
+    , d_compress( initData(&d_compress, true, "compress", "compress the chunks of the binary file"))
+    , d_framesPerChunk( initData(&d_framesPerChunk, 16u, "framesPerChunk", "number of states grouped in each chunk of the binary file"))
+    , d_asynchronous( initData(&d_asynchronous, true, "asynchronous", "write the binary file from a separate thread, to not stall the simulation"))
     , mmodel(nullptr)
     , outfile(nullptr)
 #if SOFAEXPORTER_HAVE_ZLIB
@@ -69,6 +74,7 @@ WriteState::WriteState()
 
 WriteState::~WriteState()
 {
+    m_trajectory.close();
     if (outfile)
         delete outfile;
 #if SOFAEXPORTER_HAVE_ZLIB
@@ -92,7 +98,25 @@ void WriteState::init()
     ///////////// end of the tests.
 
     const std::string& filename = d_filename.getFullPath();
-    if (!filename.empty())
+    if (!filename.empty() && d_binary.getValue())
+    {
+        helper::io::TrajectoryWriter::Options options;
+        options.float32 = d_float32.getValue();
+        options.compress = d_compress.getValue();
+        options.framesPerChunk = d_framesPerChunk.getValue();
+        options.asynchronous = d_asynchronous.getValue();
+
+        const unsigned int dimensions[helper::io::TrajectoryFrame::NbVectors] = {
+            mmodel ? (unsigned int)mmodel->getCoordDimension() : 0u,
+            mmodel ? (unsigned int)mmodel->getCoordDimension() : 0u,
+            mmodel ? (unsigned int)mmodel->getDerivDimension() : 0u,
+            mmodel ? (unsigned int)mmodel->getDerivDimension() : 0u };
+        if (!m_trajectory.open(filename, dimensions, options))
+        {
+            msg_error() << "Error creating file "<<filename;
+        }
+    }
+    else if (!filename.empty())
     {
 #if SOFAEXPORTER_HAVE_ZLIB
         if (filename.size() >= 3 && filename.substr(filename.size()-3)==".gz")
@@ -227,6 +251,7 @@ void WriteState::init()
 }
 
 void WriteState::reinit(){
+m_trajectory.close();
 if (outfile)
     delete outfile;
 #if SOFAEXPORTER_HAVE_ZLIB
@@ -257,7 +282,7 @@ void WriteState::handleEvent(sofa::core::objectmodel::Event* event)
 #if SOFAEXPORTER_HAVE_ZLIB
             && !gzfile
 #endif
-           )
+            && !m_trajectory.isOpen())
             return;
 
         if (kineticEnergyThresholdReached)
@@ -325,6 +350,11 @@ void WriteState::handleEvent(sofa::core::objectmodel::Event* event)
         }
         if (writeCurrent)
         {
+            if (m_trajectory.isOpen())
+            {
+                writeTrajectoryFrame(time);
+            }
+            else
 #if SOFAEXPORTER_HAVE_ZLIB
             if (gzfile)
             {
@@ -392,6 +422,34 @@ void WriteState::handleEvent(sofa::core::objectmodel::Event* event)
     }
 }
 
+void WriteState::writeTrajectoryFrame(double time)
+{
+    typedef helper::io::TrajectoryFrame Frame;
+    const unsigned int size = (unsigned int)mmodel->getSize();
+
+    auto copyVector = [&](Frame::Vector v, bool write, core::ConstVecId id, std::size_t dimension)
+    {
+        std::vector<SReal>& values = m_frame.values[v];
+        if (!write)
+        {
+            values.clear();
+            return;
+        }
+        values.resize(size * dimension);
+        mmodel->copyToBuffer(values.data(), id, (unsigned int)values.size());
+    };
+
+    m_frame.time = time;
+    m_frame.nbElements = size;
+    copyVector(Frame::Position, d_writeX.getValue(), core::VecId::position(), mmodel->getCoordDimension());
+    copyVector(Frame::RestPosition, d_writeX0.getValue(), core::VecId::restPosition(), mmodel->getCoordDimension());
+    copyVector(Frame::Velocity, d_writeV.getValue(), core::VecId::velocity(), mmodel->getDerivDimension());
+    copyVector(Frame::Force, d_writeF.getValue(), core::VecId::force(), mmodel->getDerivDimension());
+
+    // the conversion, compression and writing are done by the writer thread
+    m_trajectory.addFrame(m_frame);
+}
+
 } // namespace misc
 
 } // namespace component
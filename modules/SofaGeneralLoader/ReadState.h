@@ -26,6 +26,7 @@
 #include <sofa/simulation/AnimateBeginEvent.h>
 #include <sofa/simulation/AnimateEndEvent.h>
 #include <sofa/simulation/Visitor.h>
+#include <sofa/helper/io/TrajectoryFile.h>
 
 #if SOFAGENERALLOADER_HAVE_ZLIB
 #include <zlib.h>
@@ -64,6 +65,14 @@ protected:
     double nextTime;
     double lastTime;
     double loopTime;
+    helper::io::TrajectoryReader m_trajectory;
+    helper::io::TrajectoryFrame m_frame;
+    int m_currentFrame;
+
+    /// Set the state stored in the binary trajectory at the given time
+    void readTrajectoryFrame(double time);
+    /// Propagate the state which was read to the mappings
+    void updateMechanicalState();
 
     ReadState();
 
@@ -27,6 +27,7 @@
 #include <sofa/simulation/MechanicalVisitor.h>
 #include <sofa/simulation/UpdateMappingVisitor.h>
 
+#include <cmath>
 #include <cstring>
 #include <sstream>
 
@@ -53,6 +54,7 @@ ReadState::ReadState()
     , nextTime(0)
     , lastTime(0)
     , loopTime(0)
+    , m_currentFrame(-1)
 {
     this->f_listening.setValue(true);
 }
@@ -87,12 +89,27 @@ void ReadState::reset()
         gzfile = nullptr;
     }
 #endif
+    m_trajectory.close();
+    m_currentFrame = -1;
 
     const std::string& filename = d_filename.getFullPath();
     if (filename.empty())
     {
         msg_error() << "ERROR: empty filename";
     }
+    else if (helper::io::TrajectoryReader::isTrajectoryFile(filename))
+    {
+        if (!m_trajectory.open(filename))
+        {
+            msg_error() << "Error opening trajectory file "<<filename;
+        }
+        else if (mmodel && (m_trajectory.getDimension(helper::io::TrajectoryFrame::Position) != mmodel->getCoordDimension()
+                            || m_trajectory.getDimension(helper::io::TrajectoryFrame::Velocity) != mmodel->getDerivDimension()))
+        {
+            msg_error() << "The trajectory "<<filename<<" was not recorded with the same DataTypes as "<<mmodel->getName();
+            m_trajectory.close();
+        }
+    }
 #if SOFAGENERALLOADER_HAVE_ZLIB
     else if (filename.size() >= 3 && filename.substr(filename.size()-3)==".gz")
     {
@@ -134,6 +151,8 @@ void ReadState::handleEvent(sofa::core::objectmodel::Event* event)
 
 void ReadState::setTime(double time)
 {
+    // the binary trajectory is read at any time without rewinding
+    if (m_trajectory.isOpen()) return;
     if (time+getContext()->getDt()*0.5 < lastTime) {reset();}
 }
 
@@ -222,6 +241,11 @@ bool ReadState::readNext(double time, std::vector<std::string>& validLines)
 void ReadState::processReadState()
 {
     double time = getContext()->getTime() + d_shift.getValue();
+    if (m_trajectory.isOpen())
+    {
+        readTrajectoryFrame(time);
+        return;
+    }
     std::vector<std::string> validLines;
     if (!readNext(time, validLines)) return;
     bool updated = false;
@@ -245,14 +269,52 @@ void ReadState::processReadState()
     }
 
     if (updated)
+        updateMechanicalState();
+}
+
+void ReadState::readTrajectoryFrame(double time)
+{
+    typedef helper::io::TrajectoryFrame Frame;
+    if (!mmodel || m_trajectory.getNbFrames() == 0) return;
+
+    const double endTime = m_trajectory.getFrameTime(m_trajectory.getNbFrames()-1);
+    if (d_loop.getValue() && endTime > 0 && time > endTime)
+        time = std::fmod(time, endTime);
+
+    // O(log n) search in the index of the file
+    const int frame = m_trajectory.findFrame(time);
+    if (frame < 0 || frame == m_currentFrame) return;
+    if (!m_trajectory.readFrame(frame, m_frame)) return;
+    m_currentFrame = frame;
+
+    if (m_frame.nbElements != mmodel->getSize())
+        mmodel->resize(m_frame.nbElements);
+
+    bool updated = false;
+    if (m_frame.has(Frame::Position))
+    {
+        mmodel->copyFromBuffer(core::VecId::position(), m_frame.values[Frame::Position].data(), (unsigned int)m_frame.values[Frame::Position].size());
+        mmodel->applyScale(d_scalePos.getValue(), d_scalePos.getValue(), d_scalePos.getValue());
+        updated = true;
+    }
+    if (m_frame.has(Frame::Velocity))
     {
-        sofa::simulation::MechanicalProjectPositionAndVelocityVisitor action0(core::MechanicalParams::defaultInstance());
-        this->getContext()->executeVisitor(&action0);
-        sofa::simulation::MechanicalPropagateOnlyPositionAndVelocityVisitor action1(core::MechanicalParams::defaultInstance());
-        this->getContext()->executeVisitor(&action1);
-        sofa::simulation::UpdateMappingVisitor action2(core::MechanicalParams::defaultInstance());
-        this->getContext()->executeVisitor(&action2);
+        mmodel->copyFromBuffer(core::VecId::velocity(), m_frame.values[Frame::Velocity].data(), (unsigned int)m_frame.values[Frame::Velocity].size());
+        updated = true;
     }
+
+    if (updated)
+        updateMechanicalState();
+}
+
+void ReadState::updateMechanicalState()
+{
+    sofa::simulation::MechanicalProjectPositionAndVelocityVisitor action0(core::MechanicalParams::defaultInstance());
+    this->getContext()->executeVisitor(&action0);
+    sofa::simulation::MechanicalPropagateOnlyPositionAndVelocityVisitor action1(core::MechanicalParams::defaultInstance());
+    this->getContext()->executeVisitor(&action1);
+    sofa::simulation::UpdateMappingVisitor action2(core::MechanicalParams::defaultInstance());
+    this->getContext()->executeVisitor(&action2);
 }
 
 } // namespace misc
@@ -75,8 +75,11 @@ int BatchGUI::mainLoop()
         {
             if (i != nbIter)
             {
-                sofa::helper::ScopedAdvancedTimer("Animate");
+                sofa::helper::AdvancedTimer::begin("Animate");
                 sofa::simulation::getSimulation()->animate(groot.get());
+                const std::string timerOutput = sofa::helper::AdvancedTimer::end("Animate", groot.get());
+                if (!timerOutput.empty() && timerOutput != "null")
+                    msg_info("BatchGUI") << timerOutput << msgendl;
             }
 
             if ( i == nbIter || (nbIter == -1 && i%1000 == 0) )
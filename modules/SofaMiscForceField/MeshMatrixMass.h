@@ -123,6 +123,8 @@ public:
     /// if specific mass information should be outputed
     Data< bool >         d_printMass; ///< Boolean to print the mass
     Data< std::map < std::string, sofa::helper::vector<double> > > f_graph; ///< Graph of the controlled potential
+    /// compute addMDx and accFromF in parallel, the consistent mass being applied as a matrix-vector product by rows
+    Data< bool >         d_parallel;
 
     /// Link to be set to the topology container in the component graph.
     SingleLink<MeshMatrixMass<DataTypes, TMassType>, sofa::core::topology::BaseMeshTopology, BaseLink::FLAG_STOREPATH | BaseLink::FLAG_STRONGLINK> l_topology;
@@ -424,6 +426,24 @@ protected:
     EdgeMassHandler* m_edgeMassHandler;
 
     sofa::core::topology::BaseMeshTopology* m_topology;
+
+    /// @name Consistent mass stored by rows (CSR), used by the parallel addMDx
+    /// Each row gathers the contributions of the edges around a vertex, so that rows are
+    /// computed independently. The entries refer to the edges, the edge masses being read
+    /// from d_edgeMassInfo which follows the topological changes.
+    /// @{
+    helper::vector<std::size_t> m_massRowBegin;
+    helper::vector<unsigned int> m_massRowColumns;
+    helper::vector<unsigned int> m_massRowEdges;
+    int m_massRowsTopologyRevision;
+    std::size_t m_massRowsNbEdges;
+
+    /// Rebuild the rows if the topology changed
+    void updateMassRows();
+
+    template<class RowFunction>
+    void parallelForEachRow(std::size_t nbRows, const RowFunction& func);
+    /// @}
 };
 
 #if  !defined(SOFA_COMPONENT_MASS_MESHMATRIXMASS_CPP)
@@ -37,6 +37,9 @@
 #include <SofaBaseTopology/QuadSetGeometryAlgorithms.h>
 #include <SofaBaseTopology/HexahedronSetGeometryAlgorithms.h>
 #include <sofa/simulation/AnimateEndEvent.h>
+#include <sofa/simulation/ParallelForRange.h>
+
+#include <algorithm>
 
 
 namespace sofa::component::mass
@@ -59,11 +62,14 @@ MeshMatrixMass<DataTypes, MassType>::MeshMatrixMass()
     , d_lumping( initData(&d_lumping, false, "lumping","boolean if you need to use a lumped mass matrix") )
     , d_printMass( initData(&d_printMass, false, "printMass","boolean if you want to check the mass conservation") )
     , f_graph( initData(&f_graph,"graph","Graph of the controlled potential") )
+    , d_parallel( initData(&d_parallel, false, "parallel","compute addMDx and accFromF in parallel with the TaskScheduler, the consistent mass being applied as a matrix-vector product by rows") )
     , l_topology(initLink("topology", "link to the topology container"))
     , m_topologyType(TOPOLOGY_UNKNOWN)
     , m_vertexMassHandler(nullptr)
     , m_edgeMassHandler(nullptr)
     , m_topology(nullptr)
+    , m_massRowsTopologyRevision(-1)
+    , m_massRowsNbEdges(0)
 {
     f_graph.setWidget("graph");
 
@@ -1784,6 +1790,72 @@ void MeshMatrixMass<DataTypes, MassType>::clear()
 
 
 // -- Mass interface
+template <class DataTypes, class MassType>
+template <class RowFunction>
+void MeshMatrixMass<DataTypes, MassType>::parallelForEachRow(std::size_t nbRows, const RowFunction& func)
+{
+    const std::size_t minGrainSize = 1024;
+    simulation::TaskScheduler* scheduler = simulation::TaskScheduler::getInstance();
+
+    // one chunk per thread, unless it gets smaller than the grain size
+    simulation::parallelForRange(scheduler, 0, nbRows, simulation::getParallelGrainSize(scheduler, nbRows, minGrainSize), [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+            func(i);
+    });
+}
+
+template <class DataTypes, class MassType>
+void MeshMatrixMass<DataTypes, MassType>::updateMassRows()
+{
+    const std::size_t nbPoints = d_vertexMassInfo.getValue().size();
+    const std::size_t nbEdges = m_topology->getNbEdges();
+    if (m_massRowsTopologyRevision == m_topology->getRevision() && m_massRowsNbEdges == nbEdges
+            && m_massRowBegin.size() == nbPoints + 1)
+        return;
+
+    m_massRowsTopologyRevision = m_topology->getRevision();
+    m_massRowsNbEdges = nbEdges;
+
+    // count the entries of each row, then fill them
+    m_massRowBegin.assign(nbPoints + 1, 0);
+    for (std::size_t e = 0; e < nbEdges; ++e)
+    {
+        const core::topology::BaseMeshTopology::Edge& edge = m_topology->getEdge(core::topology::BaseMeshTopology::EdgeID(e));
+        ++m_massRowBegin[edge[0] + 1];
+        ++m_massRowBegin[edge[1] + 1];
+    }
+    for (std::size_t i = 0; i < nbPoints; ++i)
+        m_massRowBegin[i + 1] += m_massRowBegin[i];
+
+    m_massRowColumns.resize(m_massRowBegin[nbPoints]);
+    m_massRowEdges.resize(m_massRowBegin[nbPoints]);
+    helper::vector<std::size_t> next(m_massRowBegin.begin(), m_massRowBegin.end() - 1);
+    for (std::size_t e = 0; e < nbEdges; ++e)
+    {
+        const core::topology::BaseMeshTopology::Edge& edge = m_topology->getEdge(core::topology::BaseMeshTopology::EdgeID(e));
+        m_massRowColumns[next[edge[0]]] = edge[1];
+        m_massRowEdges[next[edge[0]]++] = unsigned(e);
+        m_massRowColumns[next[edge[1]]] = edge[0];
+        m_massRowEdges[next[edge[1]]++] = unsigned(e);
+    }
+
+    // sort each row by column, so that the gathered values are read in memory order
+    helper::vector< std::pair<unsigned int, unsigned int> > row;
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        row.clear();
+        for (std::size_t k = m_massRowBegin[i]; k < m_massRowBegin[i + 1]; ++k)
+            row.emplace_back(m_massRowColumns[k], m_massRowEdges[k]);
+        std::sort(row.begin(), row.end());
+        for (std::size_t k = 0; k < row.size(); ++k)
+        {
+            m_massRowColumns[m_massRowBegin[i] + k] = row[k].first;
+            m_massRowEdges[m_massRowBegin[i] + k] = row[k].second;
+        }
+    }
+}
+
 template <class DataTypes, class MassType>
 void MeshMatrixMass<DataTypes, MassType>::addMDx(const core::MechanicalParams*, DataVecDeriv& vres, const DataVecDeriv& vdx, SReal factor)
 {
@@ -1795,8 +1867,44 @@ void MeshMatrixMass<DataTypes, MassType>::addMDx(const core::MechanicalParams*,
 
     SReal massTotal = 0.0;
 
+    if (d_parallel.getValue())
+    {
+        // each row only writes its own vertex
+        VecDeriv& r = res.wref();
+        const VecDeriv& x = dx.ref();
+        const Real f = Real(factor);
+        if (d_lumping.getValue())
+        {
+            const Real coeff = m_massLumpingCoeff * f;
+            parallelForEachRow(x.size(), [&](std::size_t i)
+            {
+                r[i] += x[i] * (vertexMass[i] * coeff);
+            });
+        }
+        else
+        {
+            updateMassRows();
+            parallelForEachRow(x.size(), [&](std::size_t i)
+            {
+                Deriv sum = x[i] * vertexMass[i];
+                for (std::size_t k = m_massRowBegin[i]; k < m_massRowBegin[i + 1]; ++k)
+                    sum += x[m_massRowColumns[k]] * edgeMass[m_massRowEdges[k]];
+                r[i] += sum * f;
+            });
+        }
+
+        if (d_printMass.getValue())
+        {
+            const Real coeff = d_lumping.getValue() ? m_massLumpingCoeff : Real(1);
+            for (std::size_t i = 0; i < x.size(); ++i)
+                massTotal += vertexMass[i] * coeff * f;
+            if (!d_lumping.getValue())
+                for (const MassType& m : edgeMass)
+                    massTotal += 2 * m * f;
+        }
+    }
     //using a lumped matrix (default)-----
-    if(d_lumping.getValue())
+    else if(d_lumping.getValue())
     {
         for (size_t i=0; i<dx.size(); i++)
         {
@@ -1864,6 +1972,16 @@ void MeshMatrixMass<DataTypes, MassType>::accFromF(const core::MechanicalParams*
     const VecDeriv& _f = f.getValue();
     const MassVector &vertexMass= d_vertexMassInfo.getValue();
 
+    if (d_parallel.getValue())
+    {
+        VecDeriv& acc = _a.wref();
+        parallelForEachRow(vertexMass.size(), [&](std::size_t i)
+        {
+            acc[i] = _f[i] / ( vertexMass[i] * m_massLumpingCoeff);
+        });
+        return;
+    }
+
     for (unsigned int i=0; i<vertexMass.size(); i++)
     {
         _a[i] = _f[i] / ( vertexMass[i] * m_massLumpingCoeff);
@@ -41,6 +41,7 @@ using sofa::simulation::Node ;
 
 #include <sofa/simulation/Simulation.h>
 #include <SofaSimulationGraph/DAGSimulation.h>
+#include <sofa/simulation/TaskScheduler.h>
 
 #include <SofaSimulationCommon/SceneLoaderXML.h>
 using sofa::simulation::SceneLoaderXML ;
@@ -743,6 +744,59 @@ public:
     }
 
 
+    void check_ParallelProduct_Tetra(){
+        string scene =
+                "<?xml version='1.0'?>                                                                              "
+                "<Node  name='Root' gravity='0 0 0' time='0' animate='0'   >                                        "
+                "    <MechanicalObject />                                                                           "
+                "    <RegularGridTopology name='grid' n='12 12 12' min='0 0 0' max='2 2 2' p0='0 0 0' />            "
+                "    <Node name='Tetra' >                                                                           "
+                "        <MechanicalObject src='@../grid'/>                                                         "
+                "        <TetrahedronSetTopologyContainer name='Container' />                                       "
+                "        <TetrahedronSetTopologyModifier name='Modifier' />                                         "
+                "        <TetrahedronSetTopologyAlgorithms template='Vec3d' name='TopoAlgo' />                      "
+                "        <TetrahedronSetGeometryAlgorithms template='Vec3d' name='GeomAlgo' />                      "
+                "        <Hexa2TetraTopologicalMapping name='default28' input='@../grid' output='@Container' />     "
+                "        <MeshMatrixMass name='m_mass' massDensity='1.0' />                                         "
+                "    </Node>                                                                                        "
+                "</Node>                                                                                            ";
+
+        Node::SPtr root = SceneLoaderXML::loadFromMemory ("loadWithNoParam",
+                                                          scene.c_str(),
+                                                          scene.size()) ;
+
+        ASSERT_NE(root.get(), nullptr) ;
+        root->init(ExecParams::defaultInstance()) ;
+
+        TheMeshMatrixMass* mass = root->getTreeObject<TheMeshMatrixMass>() ;
+        ASSERT_TRUE( mass != nullptr ) ;
+        simulation::TaskScheduler::getInstance()->init(4);
+
+        const size_t nbPoints = size_t(mass->getMassCount());
+        typename TheMeshMatrixMass::VecDeriv dxValue(nbPoints);
+        for (size_t i = 0 ; i < nbPoints ; i++)
+            dxValue[i] = typename TheMeshMatrixMass::Deriv(SReal(i % 7), SReal(i % 5), 1.0);
+        typename TheMeshMatrixMass::DataVecDeriv dx, fSerial, fParallel;
+        dx.setValue(dxValue);
+        fSerial.setValue(typename TheMeshMatrixMass::VecDeriv(nbPoints));
+        fParallel.setValue(typename TheMeshMatrixMass::VecDeriv(nbPoints));
+
+        for (bool lumping : { false, true })
+        {
+            mass->d_lumping.setValue(lumping);
+            mass->d_parallel.setValue(false);
+            mass->addMDx(nullptr, fSerial, dx, 2.0);
+            mass->d_parallel.setValue(true);
+            mass->addMDx(nullptr, fParallel, dx, 2.0);
+
+            for (size_t i = 0 ; i < nbPoints ; i++)
+                for (unsigned int c = 0 ; c < 3 ; c++)
+                    ASSERT_NEAR(fSerial.getValue()[i][c], fParallel.getValue()[i][c], 1e-12) ;
+        }
+        mass->d_parallel.setValue(false);
+    }
+
+
     void check_VertexMass_Lumping_Initialization_Tetra(){
         string scene =
                 "<?xml version='1.0'?>                                                                              "
@@ -1408,6 +1462,10 @@ TEST_F(MeshMatrixMass3_test, check_VertexMass_WrongSize_Tetra){
     check_VertexMass_WrongSize_Tetra() ;
 }
 
+TEST_F(MeshMatrixMass3_test, check_ParallelProduct_Tetra){
+    check_ParallelProduct_Tetra() ;
+}
+
 
 TEST_F(MeshMatrixMass3_test, check_DoubleDeclaration_TotalMassAndMassDensity_WrongValue_Tetra){
     check_DoubleDeclaration_TotalMassAndMassDensity_WrongValue_Tetra() ;
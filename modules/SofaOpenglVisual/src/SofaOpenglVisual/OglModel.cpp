@@ -67,10 +67,13 @@ OglModel::OglModel()
     , blendEquation( initData(&blendEquation, "blendEquation", "if alpha blending is enabled this specifies how source and destination colors are combined") )
     , sourceFactor( initData(&sourceFactor, "sfactor", "if alpha blending is enabled this specifies how the red, green, blue, and alpha source blending factors are computed") )
     , destFactor( initData(&destFactor, "dfactor", "if alpha blending is enabled this specifies how the red, green, blue, and alpha destination blending factors are computed") )
+    , d_persistentMapping( initData(&d_persistentMapping, false, "persistentMapping", "Write the vertex buffer through a persistent mapping (requires GL_ARB_buffer_storage)") )
     , tex(nullptr)
     , vbo(0), iboEdges(0), iboTriangles(0), iboQuads(0)
     , VBOGenDone(false), initDone(false), useEdges(false), useTriangles(false), useQuads(false), canUsePatches(false)
     , oldVerticesSize(0), oldNormalsSize(0), oldTexCoordsSize(0), oldTangentsSize(0), oldBitangentsSize(0), oldEdgesSize(0), oldTrianglesSize(0), oldQuadsSize(0)
+    , m_mappedVbo(nullptr), m_vboFence(nullptr), m_canUseBufferStorage(false), m_uploadAllVertices(true)
+    , m_texCoordsCounter(-1), m_tangentsCounter(-1), m_bitangentsCounter(-1), m_edgesCounter(-1), m_trianglesCounter(-1), m_quadsCounter(-1)
 {
 
     textures.clear();
@@ -110,6 +113,10 @@ OglModel::~OglModel()
     // graphics memory leaks after destroying the GLContext
     // even if the vbos destruction is claimed with the following
     // lines...
+    if( m_vboFence )
+    {
+        glDeleteSync(m_vboFence);
+    }
     if( vbo > 0 )
     {
         glDeleteBuffers(1,&vbo);
@@ -596,6 +603,14 @@ void OglModel::internalDraw(const core::visual::VisualParams* vparams, bool tran
             glPopMatrix();
         }
     }
+
+    if (m_mappedVbo)
+    {
+        // the next update of the mapped vbo must wait for this draw
+        if (m_vboFence)
+            glDeleteSync(m_vboFence);
+        m_vboFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
 }
 
 bool OglModel::hasTransparent()
@@ -694,6 +709,12 @@ void OglModel::initVisual()
 
     canUsePatches = (glewIsSupported("GL_ARB_tessellation_shader")!=0);
 
+    m_canUseBufferStorage = (glewIsSupported("GL_ARB_buffer_storage")!=0);
+    if (d_persistentMapping.getValue() && !m_canUseBufferStorage)
+    {
+        msg_warning() << "GL_ARB_buffer_storage not supported by your graphics card and/or OpenGL driver, persistentMapping is ignored." ;
+    }
+
     if (primitiveType.getValue().getSelectedId() == 2 && !canUsePatches)
     {
         msg_warning() << "GL_ARB_tessellation_shader not supported by your graphics card and/or OpenGL driver." ;
@@ -794,12 +815,31 @@ void OglModel::initVertexBuffer()
     size_t totalSize = positionsBufferSize + normalsBufferSize + textureCoordsBufferSize +
             tangentsBufferSize + bitangentsBufferSize;
 
+    if (m_mappedVbo)
+    {
+        // the storage of a persistently mapped buffer is immutable, a new buffer is needed to resize it
+        waitVertexBuffer();
+        glDeleteBuffers(1, &vbo);
+        m_mappedVbo = nullptr;
+        glGenBuffers(1, &vbo);
+    }
+
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER,
-                 long(totalSize),
-                 nullptr,
-                 GL_DYNAMIC_DRAW);
+    if (d_persistentMapping.getValue() && m_canUseBufferStorage && totalSize > 0)
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, long(totalSize), nullptr, flags);
+        m_mappedVbo = glMapBufferRange(GL_ARRAY_BUFFER, 0, long(totalSize), flags);
+    }
+    else
+    {
+        glBufferData(GL_ARRAY_BUFFER,
+                     long(totalSize),
+                     nullptr,
+                     GL_DYNAMIC_DRAW);
+    }
 
+    m_uploadAllVertices = true;
     updateVertexBuffer();
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
@@ -838,6 +878,40 @@ void OglModel::initQuadsIndicesBuffer()
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
+void OglModel::waitVertexBuffer()
+{
+    if (m_vboFence)
+    {
+        glClientWaitSync(m_vboFence, GL_SYNC_FLUSH_COMMANDS_BIT, GLuint64(1000000000));
+        glDeleteSync(m_vboFence);
+        m_vboFence = nullptr;
+    }
+}
+
+void OglModel::uploadVertexData(size_t offset, size_t size, const void* data)
+{
+    if (size == 0)
+        return;
+    if (m_mappedVbo)
+        std::memcpy(static_cast<char*>(m_mappedVbo) + offset, data, size);
+    else
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+}
+
+void OglModel::uploadVertexRanges(const VecCoord& v, std::vector<Vec3f>& tmpBuffer, size_t offset, const VecVertexRange& ranges)
+{
+    // with a mapped vbo the conversion is done in place
+    tmpBuffer.resize(v.size());
+    Vec3f* dst = m_mappedVbo ? reinterpret_cast<Vec3f*>(static_cast<char*>(m_mappedVbo) + offset) : tmpBuffer.data();
+    for (const VertexRange& r : ranges)
+    {
+        for (size_t i = r.first; i < r.second; ++i)
+            dst[i].set(v[i]);
+        if (!m_mappedVbo)
+            glBufferSubData(GL_ARRAY_BUFFER, offset + r.first * sizeof(Vec3f), (r.second - r.first) * sizeof(Vec3f), dst + r.first);
+    }
+}
+
 void OglModel::updateVertexBuffer()
 {
 
@@ -851,22 +925,8 @@ void OglModel::updateVertexBuffer()
     size_t positionsBufferSize, normalsBufferSize;
     size_t textureCoordsBufferSize = 0, tangentsBufferSize = 0, bitangentsBufferSize = 0;
 
-    positionsBufferSize = (vertices.size()*sizeof(vertices[0]));
-    normalsBufferSize = (vnormals.size()*sizeof(vnormals[0]));
-    const void* positionBuffer = vertices.data();
-    const void* normalBuffer = vnormals.data();
-
-
-    verticesTmpBuffer.resize( vertices.size() );
-    normalsTmpBuffer.resize( vnormals.size() );
-
-    copyVector(vertices, verticesTmpBuffer);
-    copyVector(vnormals, normalsTmpBuffer);
-
     positionsBufferSize = (vertices.size()*sizeof(Vec3f));
     normalsBufferSize = (vnormals.size()*sizeof(Vec3f));
-    positionBuffer = verticesTmpBuffer.data();
-    normalBuffer = normalsTmpBuffer.data();
 
     if (tex || putOnlyTexCoords.getValue() || !textures.empty())
     {
@@ -879,41 +939,54 @@ void OglModel::updateVertexBuffer()
         }
     }
 
+    // with incrementalUpdate, only the modified vertices and Data are sent
+    const bool uploadAll = m_uploadAllVertices || !d_incrementalUpdate.getValue();
+
+    waitVertexBuffer();
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
     //Positions
-    glBufferSubData(GL_ARRAY_BUFFER,
-                    0,
-                    positionsBufferSize,
-                    positionBuffer);
+    if (uploadAll)
+        m_uploadRanges.assign(1, VertexRange(0, vertices.size()));
+    else
+        getDirtyPositionRanges(m_uploadRanges);
+    uploadVertexRanges(vertices, verticesTmpBuffer, 0, m_uploadRanges);
 
     //Normals
-    glBufferSubData(GL_ARRAY_BUFFER,
-                    positionsBufferSize,
-                    normalsBufferSize,
-                    normalBuffer);
+    if (uploadAll)
+        m_uploadRanges.assign(1, VertexRange(0, vnormals.size()));
+    else
+        getDirtyNormalRanges(m_uploadRanges);
+    uploadVertexRanges(vnormals, normalsTmpBuffer, positionsBufferSize, m_uploadRanges);
 
     //Texture coords
     if(tex || putOnlyTexCoords.getValue() ||!textures.empty())
     {
-        glBufferSubData(GL_ARRAY_BUFFER,
-                        positionsBufferSize + normalsBufferSize,
-                        textureCoordsBufferSize,
-                        getData(vtexcoords));
+        if (uploadAll || m_texCoordsCounter != m_vtexcoords.getCounter())
+            uploadVertexData(positionsBufferSize + normalsBufferSize,
+                             textureCoordsBufferSize,
+                             getData(vtexcoords));
 
         if (hasTangents)
         {
-            glBufferSubData(GL_ARRAY_BUFFER,
-                            positionsBufferSize + normalsBufferSize + textureCoordsBufferSize,
-                            tangentsBufferSize,
-                            vtangents.data());
-
-            glBufferSubData(GL_ARRAY_BUFFER,
-                            positionsBufferSize + normalsBufferSize + textureCoordsBufferSize + tangentsBufferSize,
-                            bitangentsBufferSize,
-                            vbitangents.data());
+            if (uploadAll || m_tangentsCounter != m_vtangents.getCounter())
+                uploadVertexData(positionsBufferSize + normalsBufferSize + textureCoordsBufferSize,
+                                 tangentsBufferSize,
+                                 vtangents.data());
+
+            if (uploadAll || m_bitangentsCounter != m_vbitangents.getCounter())
+                uploadVertexData(positionsBufferSize + normalsBufferSize + textureCoordsBufferSize + tangentsBufferSize,
+                                 bitangentsBufferSize,
+                                 vbitangents.data());
         }
     }
 
+    m_texCoordsCounter = m_vtexcoords.getCounter();
+    m_tangentsCounter = m_vtangents.getCounter();
+    m_bitangentsCounter = m_vbitangents.getCounter();
+    m_uploadAllVertices = false;
+    clearDirtyVertices();
+
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
@@ -984,28 +1057,34 @@ void OglModel::updateBuffers()
             //Indices
             //Edges
             if(useEdges)
+            {
                 if(oldEdgesSize != edges.size())
                     initEdgesIndicesBuffer();
-                else
+                else if (!d_incrementalUpdate.getValue() || m_edgesCounter != m_edges.getCounter())
                     updateEdgesIndicesBuffer();
+            }
             else if (edges.size() > 0)
                 createEdgesIndicesBuffer();
 
             //Triangles
             if(useTriangles)
+            {
                 if(oldTrianglesSize != triangles.size())
                     initTrianglesIndicesBuffer();
-                else
+                else if (!d_incrementalUpdate.getValue() || m_trianglesCounter != m_triangles.getCounter())
                     updateTrianglesIndicesBuffer();
+            }
             else if (triangles.size() > 0)
                 createTrianglesIndicesBuffer();
 
             //Quads
-            if (useQuads)
+            if(useQuads)
+            {
                 if(oldQuadsSize != quads.size())
                     initQuadsIndicesBuffer();
-                else
+                else if (!d_incrementalUpdate.getValue() || m_quadsCounter != m_quads.getCounter())
                     updateQuadsIndicesBuffer();
+            }
             else if (quads.size() > 0)
                 createQuadsIndicesBuffer();
         }
@@ -1017,6 +1096,9 @@ void OglModel::updateBuffers()
         oldEdgesSize = edges.size();
         oldTrianglesSize = triangles.size();
         oldQuadsSize = quads.size();
+        m_edgesCounter = m_edges.getCounter();
+        m_trianglesCounter = m_triangles.getCounter();
+        m_quadsCounter = m_quads.getCounter();
     }
 }
 
@@ -81,6 +81,7 @@ protected:
     Data<sofa::helper::OptionsGroup> blendEquation; ///< if alpha blending is enabled this specifies how source and destination colors are combined
     Data<sofa::helper::OptionsGroup> sourceFactor; ///< if alpha blending is enabled this specifies how the red, green, blue, and alpha source blending factors are computed
     Data<sofa::helper::OptionsGroup> destFactor; ///< if alpha blending is enabled this specifies how the red, green, blue, and alpha destination blending factors are computed
+    Data<bool> d_persistentMapping; ///< Write the vertex buffer through a persistent mapping (requires GL_ARB_buffer_storage)
     GLenum blendEq, sfactor, dfactor;
 
     helper::gl::Texture *tex; //this texture is used only if a texture name is specified in the scn
@@ -93,6 +94,24 @@ protected:
     std::vector<sofa::defaulttype::Vec3f> verticesTmpBuffer;
     std::vector<sofa::defaulttype::Vec3f> normalsTmpBuffer;
 
+    /// Persistent mapping of the vbo, when persistentMapping is used
+    void* m_mappedVbo;
+    /// Fence inserted after the last draw using the mapped vbo
+    GLsync m_vboFence;
+    bool m_canUseBufferStorage;
+    /// Full upload requested, after the allocation of the buffer
+    bool m_uploadAllVertices;
+    /// Counters of the Data uploaded by the last update, to skip the unchanged ones with incrementalUpdate
+    int m_texCoordsCounter, m_tangentsCounter, m_bitangentsCounter, m_edgesCounter, m_trianglesCounter, m_quadsCounter;
+    VecVertexRange m_uploadRanges;
+
+    /// Write size bytes at offset in the bound vbo
+    void uploadVertexData(size_t offset, size_t size, const void* data);
+    /// Convert to float and write the given ranges of v, stored at offset in the bound vbo
+    void uploadVertexRanges(const VecCoord& v, std::vector<sofa::defaulttype::Vec3f>& tmpBuffer, size_t offset, const VecVertexRange& ranges);
+    /// Wait until the GPU does not use the mapped vbo anymore
+    void waitVertexBuffer();
+
     void internalDraw(const core::visual::VisualParams* vparams, bool transparent) override;
 
     void drawGroup(int ig, bool transparent);
@@ -58,9 +58,22 @@ ShewchukPCGLinearSolver<TMatrix,TVector>::ShewchukPCGLinearSolver()
     , f_build_precond( initData(&f_build_precond,true,"build_precond","Build the preconditioners, if false build the preconditioner only at the initial step") )
     , f_preconditioners( initData(&f_preconditioners, "preconditioners", "If not empty: path to the solvers to use as preconditioners") )
     , f_graph( initData(&f_graph,"graph","Graph of residuals at each iteration") )
+    , d_adaptiveUpdate( initData(&d_adaptiveUpdate,false,"adaptiveUpdate","Refresh the preconditioners only when the number of iterations degrades, instead of every update_step steps") )
+    , d_iterationsThreshold( initData(&d_iterationsThreshold,1.5,"iterationsThreshold","Ratio of the number of iterations over the reference one (measured after the last refresh) above which the preconditioners are refreshed") )
+    , d_nbIterations( initData(&d_nbIterations,(unsigned)0,"nbIterations","Output: number of iterations of the last solve") )
+    , d_referenceIterations( initData(&d_referenceIterations,(unsigned)0,"referenceIterations","Output: number of iterations of the first solve after the last refresh of the preconditioners") )
+    , d_nbRefreshes( initData(&d_nbRefreshes,(unsigned)0,"nbRefreshes","Output: number of refreshes of the preconditioners since the initialization") )
     , m_preconditioners(0)
+    , m_needRefresh(false)
+    , m_measureReference(false)
 {
     f_graph.setWidget("graph");
+    d_nbIterations.setReadOnly(true);
+    d_nbIterations.setGroup("Stats");
+    d_referenceIterations.setReadOnly(true);
+    d_referenceIterations.setGroup("Stats");
+    d_nbRefreshes.setReadOnly(true);
+    d_nbRefreshes.setGroup("Stats");
 //    f_graph.setReadOnly(true);
     first = true;
     this->f_listening.setValue(true);
@@ -85,6 +98,9 @@ void ShewchukPCGLinearSolver<TMatrix,TVector>::init()
     }
 
     first = true;
+    m_needRefresh = false;
+    m_measureReference = false;
+    d_nbRefreshes.setValue(0);
 }
 
 template<class TMatrix, class TVector>
@@ -99,7 +115,9 @@ void ShewchukPCGLinearSolver<TMatrix,TVector>::setSystemMBKMatrix(const core::Me
 
     if (m_preconditioners==nullptr) return;
 
-    if (first) {  //We initialize all the preconditioners for the first step
+    if (d_adaptiveUpdate.getValue()) {
+        adaptiveUpdatePreconditioners(mparams);
+    } else if (first) {  //We initialize all the preconditioners for the first step
         m_preconditioners->setSystemMBKMatrix(mparams);
         first = false;
         next_refresh_step = 1;
@@ -123,6 +141,51 @@ void ShewchukPCGLinearSolver<TMatrix,TVector>::setSystemMBKMatrix(const core::Me
     m_preconditioners->updateSystemMatrix();
 }
 
+template<class TMatrix, class TVector>
+void ShewchukPCGLinearSolver<TMatrix,TVector>::adaptiveUpdatePreconditioners(const core::MechanicalParams* mparams)
+{
+    sofa::helper::AdvancedTimer::stepBegin("PCG::PrecondSetSystemMBKMatrix");
+
+    if (first || m_needRefresh) {
+        m_preconditioners->unfreezeSystemMatrix();
+        m_preconditioners->setSystemMBKMatrix(mparams);
+        m_preconditioners->freezeSystemMatrix();
+
+        first = false;
+        m_needRefresh = false;
+        m_measureReference = true;
+        d_nbRefreshes.setValue(d_nbRefreshes.getValue() + 1);
+        sofa::helper::AdvancedTimer::valSet("PCG::PrecondRefresh", 1);
+    } else {
+        // the preconditioners are frozen: only the cheap parts (e.g. the warping rotations) are updated
+        m_preconditioners->setSystemMBKMatrix(mparams);
+    }
+
+    sofa::helper::AdvancedTimer::stepEnd("PCG::PrecondSetSystemMBKMatrix");
+}
+
+template<class TMatrix, class TVector>
+void ShewchukPCGLinearSolver<TMatrix,TVector>::checkIterations(unsigned nbIterations)
+{
+    d_nbIterations.setValue(nbIterations);
+
+    if (!d_adaptiveUpdate.getValue() || m_preconditioners==nullptr || !f_use_precond.getValue()) return;
+
+    if (m_measureReference) {
+        d_referenceIterations.setValue(nbIterations);
+        m_measureReference = false;
+        return;
+    }
+
+    const unsigned reference = d_referenceIterations.getValue();
+    if (nbIterations > f_maxIter.getValue() || nbIterations > d_iterationsThreshold.getValue() * reference)
+    {
+        msg_info() << "Refresh of the preconditioners requested: " << nbIterations
+                   << " iterations instead of " << reference << " after the last refresh.";
+        m_needRefresh = true;
+    }
+}
+
 template<>
 inline void ShewchukPCGLinearSolver<component::linearsolver::GraphScatteredMatrix,component::linearsolver::GraphScatteredVector>::cgstep_beta(Vector& p, Vector& r, double beta)
 {
@@ -224,6 +287,8 @@ void ShewchukPCGLinearSolver<TMatrix,TVector>::solve (Matrix& M, Vector& x, Vect
     vtmp.deleteTempVector(&w);
     vtmp.deleteTempVector(&s);
 
+    checkIterations(iter);
+
     sofa::helper::AdvancedTimer::valSet("PCG iterations", iter);
     sofa::helper::AdvancedTimer::stepEnd("PCGLinearSolver::solve");
 }
@@ -57,6 +57,11 @@ public:
     Data<bool> f_build_precond; ///< Build the preconditioners, if false build the preconditioner only at the initial step
     Data< std::string > f_preconditioners; ///< If not empty: path to the solvers to use as preconditioners
     Data<std::map < std::string, sofa::helper::vector<double> > > f_graph; ///< Graph of residuals at each iteration
+    Data<bool> d_adaptiveUpdate; ///< Refresh the preconditioners only when the number of iterations degrades, instead of every update_step steps
+    Data<double> d_iterationsThreshold; ///< Ratio of the number of iterations over the reference one (measured after the last refresh) above which the preconditioners are refreshed
+    Data<unsigned> d_nbIterations; ///< Output: number of iterations of the last solve
+    Data<unsigned> d_referenceIterations; ///< Output: number of iterations of the first solve after the last refresh of the preconditioners
+    Data<unsigned> d_nbRefreshes; ///< Output: number of refreshes of the preconditioners since the initialization
 
 
 protected:
@@ -73,6 +78,15 @@ private :
     sofa::core::behavior::LinearSolver* m_preconditioners;
     bool first;
     int newton_iter;
+    bool m_needRefresh; ///< set by solve when the adaptive policy asks for a refresh at the next step
+    bool m_measureReference; ///< the next solve gives the reference number of iterations
+
+    /// Adaptive policy: refresh the preconditioners when asked by the previous solves, otherwise
+    /// keep their frozen factorization (a WarpPreconditioner still updates its rotations).
+    void adaptiveUpdatePreconditioners(const core::MechanicalParams* mparams);
+
+    /// Adaptive policy: compare the number of iterations to the reference one.
+    void checkIterations(unsigned nbIterations);
 
 protected:
     /// This method is separated from the rest to be able to use custom/optimized versions depending on the types of vectors.
@@ -88,6 +88,11 @@ public:
 
     void updateSystemMatrix() override;
 
+    /// Only the warped solver is frozen: the rotations are still updated at each step,
+    /// so that the frozen factorization is applied in the current frame.
+    void freezeSystemMatrix() override { if (realSolver) realSolver->freezeSystemMatrix(); }
+    void unfreezeSystemMatrix() override { if (realSolver) realSolver->unfreezeSystemMatrix(); }
+
 private :
 
     core::behavior::LinearSolver* realSolver;
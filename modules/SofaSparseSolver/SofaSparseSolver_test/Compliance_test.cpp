@@ -0,0 +1,153 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaSparseSolver/SparseLDLSolver.h>
+#include <SofaSparseSolver/SparseCholeskySolver.h>
+#include <SofaBaseLinearSolver/FullMatrix.h>
+#include <SofaBaseLinearSolver/SparseMatrix.h>
+#include <sofa/simulation/TaskScheduler.h>
+
+#include <sofa/helper/testing/BaseTest.h>
+using sofa::helper::testing::BaseTest;
+
+namespace
+{
+
+using namespace sofa::component::linearsolver;
+
+typedef CompressedRowSparseMatrix<double> Matrix;
+typedef FullVector<double> Vector;
+typedef MatrixLinearSolver<Matrix, Vector> PerColumnSolver;
+
+/// The compliance J A^-1 J^T computed from the factor by panels of rows of J must give the matrix
+/// computed by the generic path of MatrixLinearSolver, solving the system for each row of J
+template<class Solver>
+struct Compliance_test : public BaseTest
+{
+    Matrix A;
+    SparseMatrix<double> J;
+
+    /// stiffness-like symmetric positive definite matrix of a chain of 3x3 blocks
+    void createSystem(int nbNodes)
+    {
+        const int n = 3 * nbNodes;
+        A.resize(n, n);
+        for (int k = 0; k < nbNodes; ++k)
+        {
+            for (int a = 0; a < 3; ++a)
+                A.add(3*k + a, 3*k + a, 10.0 + a + k % 3);
+            for (int l = k + 1; l < std::min(k + 3, nbNodes); ++l)
+                for (int a = 0; a < 3; ++a)
+                {
+                    A.add(3*k + a, 3*l + a, -1.5);
+                    A.add(3*l + a, 3*k + a, -1.5);
+                }
+        }
+        A.compress();
+    }
+
+    /// constraints acting on a few nodes each, with an inactive constraint
+    void createConstraints(int nbConstraints)
+    {
+        const int n = A.rowSize();
+        J.resize(nbConstraints, n);
+        for (int c = 0; c < nbConstraints; ++c)
+        {
+            if (c == nbConstraints / 2)
+                continue;
+            const int node = (7 * c) % (n / 3);
+            for (int a = 0; a < 3; ++a)
+            {
+                J.set(c, 3*node + a, 0.5 + 0.25 * ((a + c) % 3));
+                J.set(c, (3*node + 5 * a + 1) % n, -0.3);
+            }
+        }
+    }
+
+    FullMatrix<double> compliance(typename Solver::SPtr solver, double fact, bool perColumn)
+    {
+        FullMatrix<double> W(J.rowSize(), J.rowSize());
+        W.clear();
+        // the solver owns its system matrix
+        Matrix* M = new Matrix(A);
+        solver->setSystemMatrix(M);
+        solver->invertSystem();
+        if (perColumn)
+            EXPECT_TRUE(solver->PerColumnSolver::addJMInvJtLocal(M, &W, &J, fact));
+        else
+            EXPECT_TRUE(solver->addJMInvJtLocal(M, &W, &J, fact));
+        return W;
+    }
+
+    void compare(int panelSize, bool parallel)
+    {
+        createSystem(50);
+        createConstraints(37);
+        const double fact = 0.5;
+
+        typename Solver::SPtr reference = sofa::core::objectmodel::New<Solver>();
+        const FullMatrix<double> Wref = compliance(reference, fact, true);
+
+        typename Solver::SPtr solver = sofa::core::objectmodel::New<Solver>();
+        solver->d_compliancePanelSize.setValue(panelSize);
+        solver->d_parallelCompliance.setValue(parallel);
+        const FullMatrix<double> W = compliance(solver, fact, false);
+
+        double maxValue = 0;
+        for (int i = 0; i < Wref.rowSize(); ++i)
+            for (int j = 0; j < Wref.colSize(); ++j)
+                maxValue = std::max(maxValue, std::abs(Wref.element(i, j)));
+        ASSERT_GT(maxValue, 0);
+
+        for (int i = 0; i < Wref.rowSize(); ++i)
+            for (int j = 0; j < Wref.colSize(); ++j)
+                EXPECT_NEAR(W.element(i, j), Wref.element(i, j), 1e-12 * maxValue) << "W(" << i << "," << j << ")";
+    }
+};
+
+typedef ::testing::Types<
+    SparseLDLSolver<Matrix, Vector>,
+    SparseCholeskySolver<Matrix, Vector>
+> SolverTypes;
+TYPED_TEST_CASE(Compliance_test, SolverTypes);
+
+TYPED_TEST(Compliance_test, singlePanel)
+{
+    this->compare(1, false);
+}
+
+TYPED_TEST(Compliance_test, panels)
+{
+    this->compare(8, false);
+}
+
+TYPED_TEST(Compliance_test, parallelPanels)
+{
+    sofa::simulation::TaskScheduler* scheduler = sofa::simulation::TaskScheduler::getInstance();
+    const unsigned int nbThreads = scheduler->getThreadCount();
+    scheduler->init(4);
+
+    this->compare(4, true);
+
+    scheduler->init(nbThreads);
+}
+
+} // namespace
@@ -0,0 +1,168 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaBase/initSofaBase.h>
+#include <SofaCommon/initSofaCommon.h>
+#include <SofaGeneral/initSofaGeneral.h>
+#include <SofaSimulationCommon/SceneLoaderXML.h>
+#include <SofaSimulationGraph/DAGSimulation.h>
+#include <sofa/core/behavior/LinearSolver.h>
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/simulation/TaskScheduler.h>
+
+#include <sofa/helper/testing/BaseTest.h>
+using sofa::helper::testing::BaseTest;
+
+#include <string>
+
+namespace
+{
+
+using sofa::simulation::Node;
+using sofa::defaulttype::BaseMatrix;
+
+/// The parallel assembly of the system matrix gives the same matrix than the serial visitor,
+/// on a scene with several force fields and masses on each state, an interaction force field,
+/// a force field on a mapped state (assembled serially) and projective constraints
+struct ParallelMatrixAssembly_test : public BaseTest
+{
+    Node::SPtr root;
+    sofa::core::behavior::LinearSolver* solver = nullptr;
+    unsigned int nbThreads = 0;
+
+    void SetUp() override
+    {
+        sofa::component::initSofaBase();
+        sofa::component::initSofaCommon();
+        sofa::component::initSofaGeneral();
+        sofa::simulation::setSimulation(new sofa::simulation::graph::DAGSimulation());
+
+        sofa::simulation::TaskScheduler* scheduler = sofa::simulation::TaskScheduler::getInstance();
+        nbThreads = scheduler->getThreadCount();
+        scheduler->init(4);
+    }
+
+    void TearDown() override
+    {
+        if (root)
+            sofa::simulation::getSimulation()->unload(root);
+        sofa::simulation::TaskScheduler::getInstance()->init(nbThreads);
+    }
+
+    static std::string beam(int i)
+    {
+        const std::string z = std::to_string(4 * i), zmax = std::to_string(4 * i + 2);
+        return
+            "  <Node name='beam" + std::to_string(i) + "'>"
+            "    <RegularGridTopology name='grid' n='6 3 3' min='0 0 " + z + "' max='5 2 " + zmax + "'/>"
+            "    <MechanicalObject name='dofs' template='Vec3d'/>"
+            "    <TetrahedronSetTopologyContainer name='tetras'/>"
+            "    <TetrahedronSetTopologyModifier/>"
+            "    <Hexa2TetraTopologicalMapping input='@grid' output='@tetras'/>"
+            "    <UniformMass totalMass='1'/>"
+            "    <TetrahedronFEMForceField youngModulus='5000' poissonRatio='0.3' method='large' topology='@tetras'/>"
+            "    <MeshSpringForceField linesStiffness='100' topology='@grid'/>"
+            "    <FixedConstraint indices='0 1 2'/>"
+            "    <Node name='mapped'>"
+            "      <MechanicalObject template='Vec3d' position='1 1 " + z + "  3 1 " + z + "'/>"
+            "      <RestShapeSpringsForceField stiffness='50'/>"
+            "      <BarycentricMapping/>"
+            "    </Node>"
+            "  </Node>";
+    }
+
+    void loadScene(const std::string& matrixTemplate)
+    {
+        const std::string scene =
+            "<Node name='root' dt='0.01' gravity='0 -9.81 0'>"
+            "  <DefaultAnimationLoop/>"
+            "  <EulerImplicitSolver rayleighStiffness='0.1' rayleighMass='0.1'/>"
+            "  <SparseLDLSolver name='solver' template='" + matrixTemplate + "'/>"
+            + beam(0) + beam(1) + beam(2) +
+            "  <StiffSpringForceField object1='@beam0/dofs' object2='@beam1/dofs' spring='53 0 10 0.5 1  52 1 20 0.5 2'/>"
+            "</Node>";
+        root = sofa::simulation::SceneLoaderXML::loadFromMemory("ParallelMatrixAssembly", scene.c_str(), scene.size());
+        ASSERT_NE(root.get(), nullptr);
+        sofa::simulation::getSimulation()->init(root.get());
+        // one step to compute the rotations of the FEM
+        sofa::simulation::getSimulation()->animate(root.get(), root->getDt());
+
+        root->get(solver);
+        ASSERT_NE(solver, nullptr);
+        ASSERT_NE(solver->findData("parallelAssembly"), nullptr);
+    }
+
+    /// assemble the system matrix, returning a dense copy of it
+    std::vector<SReal> assemble(bool parallel)
+    {
+        sofa::core::MechanicalParams mparams;
+        mparams.setMFactor(1.0);
+        mparams.setBFactor(-0.1);
+        mparams.setKFactor(-0.01);
+
+        solver->findData("parallelAssembly")->read(parallel ? "1" : "0");
+        solver->setSystemMBKMatrix(&mparams);
+
+        const BaseMatrix* M = solver->getSystemBaseMatrix();
+        std::vector<SReal> values;
+        values.reserve(M->rowSize() * M->colSize());
+        for (BaseMatrix::Index i = 0; i < M->rowSize(); ++i)
+            for (BaseMatrix::Index j = 0; j < M->colSize(); ++j)
+                values.push_back(M->element(i, j));
+        return values;
+    }
+
+    void compare(const std::string& matrixTemplate)
+    {
+        loadScene(matrixTemplate);
+        if (HasFatalFailure()) return;
+
+        const std::vector<SReal> serial = assemble(false);
+        // twice, to test the assembly with a new and with the previous sparsity pattern
+        for (int step = 0; step < 2; ++step)
+        {
+            const std::vector<SReal> parallel = assemble(true);
+            ASSERT_EQ(serial.size(), parallel.size());
+            std::size_t nbNonZeros = 0;
+            for (std::size_t i = 0; i < serial.size(); ++i)
+            {
+                EXPECT_NEAR(parallel[i], serial[i], 1e-12 * std::max<SReal>(1, std::abs(serial[i]))) << "entry " << i;
+                nbNonZeros += (serial[i] != 0);
+            }
+            EXPECT_GT(nbNonZeros, 0u);
+        }
+
+        // and back to the serial assembly
+        EXPECT_EQ(assemble(false), serial);
+    }
+};
+
+TEST_F(ParallelMatrixAssembly_test, scalarMatrix)
+{
+    compare("CompressedRowSparseMatrixd");
+}
+
+TEST_F(ParallelMatrixAssembly_test, blocMatrix)
+{
+    compare("CompressedRowSparseMatrix3d");
+}
+
+} // namespace
@@ -0,0 +1,153 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaSparseSolver/SparseLDLSolver.h>
+#include <SofaBaseLinearSolver/FullVector.h>
+#include <sofa/simulation/TaskScheduler.h>
+
+#include <sofa/helper/testing/BaseTest.h>
+using sofa::helper::testing::BaseTest;
+
+#include <cmath>
+
+namespace
+{
+
+typedef sofa::component::linearsolver::CompressedRowSparseMatrix<double> Matrix;
+typedef sofa::component::linearsolver::FullVector<double> Vector;
+typedef sofa::component::linearsolver::SparseLDLSolver<Matrix, Vector> SparseLDLSolver;
+typedef SparseLDLSolver::InvertData InvertData;
+
+struct SparseLDLSolver_test : public BaseTest
+{
+    Matrix M;
+    Vector b;
+
+    /// Symmetric matrix of a chain of 3x3 blocks (as the matrices of FEM meshes, forming supernodes),
+    /// made indefinite by a shift of its diagonal and ill-conditioned by a scaling of its rows and columns
+    void createIndefiniteSystem(int nbNodes)
+    {
+        const int n = 3 * nbNodes;
+        std::vector<double> scale(n);
+        for (int i = 0; i < n; ++i)
+            scale[i] = std::pow(10.0, (i % 5) - 2);
+
+        M.resize(n, n);
+        auto addSymmetric = [&](int i, int j, double value)
+        {
+            M.add(i, j, scale[i] * value * scale[j]);
+            if (i != j)
+                M.add(j, i, scale[i] * value * scale[j]);
+        };
+        for (int k = 0; k < nbNodes; ++k)
+        {
+            for (int a = 0; a < 3; ++a)
+            {
+                addSymmetric(3*k + a, 3*k + a, 6.0 - 2.5 * ((k + a) % 2));
+                for (int c = a + 1; c < 3; ++c)
+                    addSymmetric(3*k + a, 3*k + c, 0.3);
+            }
+            for (int l = k + 1; l < std::min(k + 3, nbNodes); ++l)
+                for (int a = 0; a < 3; ++a)
+                    for (int c = 0; c < 3; ++c)
+                        addSymmetric(3*k + a, 3*l + c, -0.5 - 0.1 * ((a + 2*c + k) % 5));
+        }
+        M.compress();
+
+        b.resize(n);
+        for (int i = 0; i < n; ++i)
+            b[i] = std::sin(double(i));
+    }
+
+    /// factorize M and solve M x = b with the given options
+    Vector solve(bool supernodal, bool parallelSolve, sofa::helper::vector<double>* invD = nullptr)
+    {
+        SparseLDLSolver::SPtr solver = sofa::core::objectmodel::New<SparseLDLSolver>();
+        solver->d_supernodal.setValue(supernodal);
+        solver->d_parallelSolve.setValue(parallelSolve);
+        solver->invert(M);
+
+        Vector x(b.size());
+        solver->solve(M, x, b);
+        if (invD)
+            *invD = static_cast<InvertData*>(solver->getMatrixInvertData(&M))->invD;
+        return x;
+    }
+
+    static double relativeDifference(const Vector& x, const Vector& ref)
+    {
+        double diff = 0, norm = 0;
+        for (Vector::Index i = 0; i < ref.size(); ++i)
+        {
+            diff += (x[i] - ref[i]) * (x[i] - ref[i]);
+            norm += ref[i] * ref[i];
+        }
+        return std::sqrt(diff / norm);
+    }
+};
+
+/// the supernodal factorization gives the same factor and solution than the simplicial one
+TEST_F(SparseLDLSolver_test, supernodalVsSimplicial)
+{
+    createIndefiniteSystem(60);
+
+    sofa::helper::vector<double> simplicialInvD, supernodalInvD;
+    const Vector simplicial = solve(false, false, &simplicialInvD);
+    const Vector supernodal = solve(true, false, &supernodalInvD);
+
+    // the matrix is indefinite
+    bool negativePivot = false, positivePivot = false;
+    for (double d : simplicialInvD)
+    {
+        negativePivot = negativePivot || d < 0;
+        positivePivot = positivePivot || d > 0;
+    }
+    EXPECT_TRUE(negativePivot && positivePivot);
+
+    ASSERT_EQ(simplicialInvD.size(), supernodalInvD.size());
+    for (std::size_t i = 0; i < simplicialInvD.size(); ++i)
+        EXPECT_NEAR(simplicialInvD[i], supernodalInvD[i], 1e-10 * std::abs(simplicialInvD[i])) << "pivot " << i;
+
+    EXPECT_LT(relativeDifference(supernodal, simplicial), 1e-10);
+
+    // the residual of the solution
+    Vector Mx(b.size());
+    M.mul(Mx, simplicial);
+    EXPECT_LT(relativeDifference(Mx, b), 1e-8);
+}
+
+/// the parallel solve gives the same solution than the sequential one
+TEST_F(SparseLDLSolver_test, parallelSolve)
+{
+    createIndefiniteSystem(200);
+
+    sofa::simulation::TaskScheduler* scheduler = sofa::simulation::TaskScheduler::getInstance();
+    const unsigned int nbThreads = scheduler->getThreadCount();
+    scheduler->init(4);
+
+    const Vector sequential = solve(true, false);
+    const Vector parallel = solve(true, true);
+    EXPECT_LT(relativeDifference(parallel, sequential), 1e-12);
+
+    scheduler->init(nbThreads);
+}
+
+} // namespace
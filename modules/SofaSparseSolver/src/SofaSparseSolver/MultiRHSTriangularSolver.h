@@ -0,0 +1,254 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#ifndef SOFA_COMPONENT_LINEARSOLVER_MULTIRHSTRIANGULARSOLVER_H
+#define SOFA_COMPONENT_LINEARSOLVER_MULTIRHSTRIANGULARSOLVER_H
+#include <SofaSparseSolver/config.h>
+
+#include <SofaBaseLinearSolver/SparseMatrix.h>
+#include <sofa/defaulttype/BaseMatrix.h>
+#include <sofa/simulation/ParallelForRange.h>
+#include <algorithm>
+#include <atomic>
+
+namespace sofa
+{
+
+namespace component
+{
+
+namespace linearsolver
+{
+
+/// Lower triangular factor of A = P^T L D L^T P (or P^T L L^T P) in compressed columns, with its elimination tree
+template<class Real>
+struct LowerTriangularFactor
+{
+    int n = 0;
+    const int * colptr = nullptr;
+    const int * rowind = nullptr;
+    const Real * values = nullptr;
+    bool unitDiagonal = true;           ///< otherwise the diagonal is the first entry of each column
+    const int * parent = nullptr;       ///< elimination tree, -1 for the roots
+    const int * permutation = nullptr;  ///< permuted index of each row of A, nullptr for the identity
+    const Real * invD = nullptr;        ///< inverse of D for a LDL^T factorization, nullptr for LL^T
+};
+
+/// Computation of J A^-1 J^T from a sparse factorization of A, solving the rows of J by panels.
+///
+/// With Y = L^-1 P J^T, J A^-1 J^T = Y^T D^-1 Y. The rows of J are sorted by their first permuted
+/// index and grouped in panels of panelSize right-hand sides, which are solved together: only the
+/// nodes of the elimination tree reachable from the non-zeros of the panel are visited, and the
+/// panel is stored node by node so the updates of the right-hand sides are contiguous. The products
+/// Y_p^T D^-1 Y_q are then computed on the intersection of the reached nodes of each pair of panels.
+/// The panels, then the rows of panels of the result, can be processed in parallel by the TaskScheduler.
+template<class Real>
+class MultiRHSTriangularSolver
+{
+public:
+    typedef LowerTriangularFactor<Real> Factor;
+
+    template<class JReal>
+    void addJMInvJt(const Factor& L, const SparseMatrix<JReal>& J, defaulttype::BaseMatrix* result, double fact,
+                    int panelSize, simulation::TaskScheduler* scheduler)
+    {
+        gatherRows(L, J);
+        const int nbRows = (int)m_rowIds.size();
+        if (nbRows == 0) return;
+
+        panelSize = std::max(panelSize, 1);
+        const int nbPanels = (nbRows + panelSize - 1) / panelSize;
+        m_panels.resize(nbPanels);
+        for (int p = 0; p < nbPanels; p++) {
+            m_panels[p].begin = p * panelSize;
+            m_panels[p].end = std::min(nbRows, (p+1) * panelSize);
+        }
+
+        const int nbTasks = (scheduler == nullptr) ? 1 : std::max(1, std::min<int>((int)scheduler->getThreadCount(), nbPanels));
+        m_work.resize(nbTasks);
+        for (Work & w : m_work) {
+            w.mark.assign(L.n, -1);
+            w.pos.resize(L.n);
+        }
+
+        // Y = L^-1 P J^T, by panels
+        std::atomic<int> nextPanel(0);
+        auto solvePanels = [&](int t) {
+            for (int p = nextPanel++; p < nbPanels; p = nextPanel++) solvePanel(L, m_panels[p], m_work[t], p);
+        };
+        run(scheduler, nbTasks, solvePanels);
+
+        // W = Y^T D^-1 Y, the upper triangle of panels only
+        m_W.resize((std::size_t)nbRows * nbRows);
+        std::atomic<int> nextRow(0);
+        auto multiplyRows = [&](int /*t*/) {
+            for (int p = nextRow++; p < nbPanels; p = nextRow++) {
+                for (int q = p; q < nbPanels; q++) multiplyPanels(L, m_panels[p], m_panels[q], nbRows);
+            }
+        };
+        run(scheduler, nbTasks, multiplyRows);
+
+        for (int a = 0; a < nbRows; a++) {
+            const Real * w = &m_W[(std::size_t)a * nbRows];
+            for (int b = a; b < nbRows; b++) {
+                const double val = w[b] * fact;
+                result->add(m_rowIds[a], m_rowIds[b], val);
+                if (m_rowIds[a] != m_rowIds[b]) result->add(m_rowIds[b], m_rowIds[a], val);
+            }
+        }
+    }
+
+protected:
+
+    struct Panel {
+        int begin, end;                 ///< range of gathered rows of J
+        helper::vector<int> reach;      ///< reached nodes, in increasing order
+        helper::vector<Real> values;    ///< Y restricted to the reached nodes, (end-begin) values per node
+    };
+
+    struct Work {
+        helper::vector<int> mark, pos;
+    };
+
+    /// Copy the non-empty rows of J with permuted column indices, sorted by their first permuted index
+    template<class JReal>
+    void gatherRows(const Factor& L, const SparseMatrix<JReal>& J)
+    {
+        helper::vector<std::pair<int,int> > order; // (first permuted index, row)
+        m_entries.clear();
+        helper::vector<int> rowIds, entryPtr(1, 0);
+        helper::vector<std::pair<int,Real> > entries;
+        for (typename SparseMatrix<JReal>::LineConstIterator jit = J.begin(), jitend = J.end(); jit != jitend; ++jit) {
+            int first = L.n;
+            for (typename SparseMatrix<JReal>::LElementConstIterator it = jit->second.begin(), itend = jit->second.end(); it != itend; ++it) {
+                if (it->second == 0) continue;
+                const int col = L.permutation ? L.permutation[it->first] : (int)it->first;
+                entries.push_back(std::make_pair(col, (Real)it->second));
+                first = std::min(first, col);
+            }
+            if (first == L.n) continue;
+            order.push_back(std::make_pair(first, (int)rowIds.size()));
+            rowIds.push_back(jit->first);
+            entryPtr.push_back((int)entries.size());
+        }
+        std::sort(order.begin(), order.end());
+
+        m_rowIds.resize(order.size());
+        m_entryPtr.resize(order.size() + 1);
+        m_entryPtr[0] = 0;
+        for (std::size_t r = 0; r < order.size(); r++) {
+            const int src = order[r].second;
+            m_rowIds[r] = rowIds[src];
+            m_entries.insert(m_entries.end(), entries.begin() + entryPtr[src], entries.begin() + entryPtr[src+1]);
+            m_entryPtr[r+1] = (int)m_entries.size();
+        }
+    }
+
+    /// Solve L Y = P J^T for the rows of the panel, visiting only the reached nodes
+    void solvePanel(const Factor& L, Panel& panel, Work& work, int stamp)
+    {
+        const int k = panel.end - panel.begin;
+        int * mark = work.mark.data();
+        int * pos = work.pos.data();
+
+        // the non-zeros of Y are the ancestors of the non-zeros of J^T in the elimination tree
+        panel.reach.clear();
+        for (int e = m_entryPtr[panel.begin]; e < m_entryPtr[panel.end]; e++) {
+            for (int j = m_entries[e].first; j != -1 && mark[j] != stamp; j = L.parent[j]) {
+                mark[j] = stamp;
+                panel.reach.push_back(j);
+            }
+        }
+        std::sort(panel.reach.begin(), panel.reach.end());
+        const int nbReached = (int)panel.reach.size();
+        for (int t = 0; t < nbReached; t++) pos[panel.reach[t]] = t;
+
+        panel.values.assign((std::size_t)nbReached * k, (Real)0);
+        Real * Y = panel.values.data();
+        for (int r = panel.begin; r < panel.end; r++) {
+            for (int e = m_entryPtr[r]; e < m_entryPtr[r+1]; e++) {
+                Y[(std::size_t)pos[m_entries[e].first] * k + (r - panel.begin)] += m_entries[e].second;
+            }
+        }
+
+        for (int t = 0; t < nbReached; t++) {
+            const int j = panel.reach[t];
+            Real * yj = Y + (std::size_t)t * k;
+            int p = L.colptr[j];
+            if (!L.unitDiagonal) {
+                const Real invDiag = (Real)1 / L.values[p++];
+                for (int c = 0; c < k; c++) yj[c] *= invDiag;
+            }
+            for (; p < L.colptr[j+1]; p++) {
+                const Real l = L.values[p];
+                Real * yi = Y + (std::size_t)pos[L.rowind[p]] * k;
+                for (int c = 0; c < k; c++) yi[c] -= l * yj[c];
+            }
+        }
+    }
+
+    /// Block (p,q) of Y^T D^-1 Y, computed on the nodes reached by both panels
+    void multiplyPanels(const Factor& L, const Panel& p, const Panel& q, int nbRows)
+    {
+        const int kp = p.end - p.begin, kq = q.end - q.begin;
+        for (int a = 0; a < kp; a++) {
+            Real * w = &m_W[(std::size_t)(p.begin + a) * nbRows + q.begin];
+            std::fill(w, w + kq, (Real)0);
+        }
+
+        std::size_t i = 0, j = 0;
+        while (i < p.reach.size() && j < q.reach.size()) {
+            if (p.reach[i] < q.reach[j]) { i++; continue; }
+            if (q.reach[j] < p.reach[i]) { j++; continue; }
+            const Real d = L.invD ? L.invD[p.reach[i]] : (Real)1;
+            const Real * yp = &p.values[i * kp];
+            const Real * yq = &q.values[j * kq];
+            for (int a = 0; a < kp; a++) {
+                const Real ya = yp[a] * d;
+                if (ya == 0) continue;
+                Real * w = &m_W[(std::size_t)(p.begin + a) * nbRows + q.begin];
+                for (int b = 0; b < kq; b++) w[b] += ya * yq[b];
+            }
+            i++;
+            j++;
+        }
+    }
+
+    template<class Function>
+    static void run(simulation::TaskScheduler* scheduler, int nbTasks, const Function& func)
+    {
+        simulation::parallelForRange(scheduler, 0, std::max(nbTasks, 0), 1, [&](std::size_t t, std::size_t) { func(int(t)); });
+    }
+
+    helper::vector<int> m_rowIds, m_entryPtr;
+    helper::vector<std::pair<int,Real> > m_entries;
+    helper::vector<Panel> m_panels;
+    helper::vector<Work> m_work;
+    helper::vector<Real> m_W;
+};
+
+} // namespace linearsolver
+
+} // namespace component
+
+} // namespace sofa
+
+#endif
@@ -46,6 +46,8 @@ using sofa::helper::system::thread::ctime_t;
 template<class TMatrix, class TVector>
 SparseCholeskySolver<TMatrix,TVector>::SparseCholeskySolver()
     : f_verbose( initData(&f_verbose,false,"verbose","Dump system state at each iteration") )
+    , d_compliancePanelSize( initData(&d_compliancePanelSize, 16, "compliancePanelSize", "Number of rows of J solved together when computing the compliance J A^-1 J^T") )
+    , d_parallelCompliance( initData(&d_parallelCompliance, false, "parallelCompliance", "Compute the compliance J A^-1 J^T in parallel with the TaskScheduler") )
     , S(nullptr), N(nullptr)
 {
 }
@@ -129,6 +131,30 @@ void SparseCholeskySolver<TMatrix,TVector>::invert(Matrix& M)
     //sout << "SparseCholeskySolver: factorization complete, nnz = " << N->L->p[N->L->n] << sendl;
 }
 
+template<class TMatrix, class TVector>
+bool SparseCholeskySolver<TMatrix,TVector>::addJMInvJtLocal(Matrix * M, ResMatrixType * result, const JMatrixType * J, double fact)
+{
+    if (J->rowSize()==0) return true;
+
+    this->invertSystem();
+    if (N == nullptr || S == nullptr)
+        return Inherit::addJMInvJtLocal(M, result, J, fact);
+
+    LowerTriangularFactor<double> L;
+    L.n = A.n;
+    L.colptr = N->L->p;
+    L.rowind = N->L->i;
+    L.values = N->L->x;
+    L.unitDiagonal = false;
+    L.parent = S->parent;
+    L.permutation = S->Pinv;
+
+    simulation::TaskScheduler* scheduler = d_parallelCompliance.getValue() ? simulation::TaskScheduler::getInstance() : nullptr;
+    complianceSolver.addJMInvJt(L, *J, result, fact, d_compliancePanelSize.getValue(), scheduler);
+
+    return true;
+}
+
 int SparseCholeskySolverClass = core::RegisterObject("Direct linear solver based on Sparse Cholesky factorization, implemented with the CSPARSE library")
         .add< SparseCholeskySolver< CompressedRowSparseMatrix<double>,FullVector<double> > >(true)
         .add< SparseCholeskySolver< CompressedRowSparseMatrix<float>,FullVector<float> > >()
@@ -29,6 +29,7 @@
 #include <SofaBaseLinearSolver/FullMatrix.h>
 #include <SofaBaseLinearSolver/SparseMatrix.h>
 #include <SofaBaseLinearSolver/CompressedRowSparseMatrix.h>
+#include <SofaSparseSolver/MultiRHSTriangularSolver.h>
 #include <sofa/helper/map.h>
 #include <cmath>
 #include <csparse.h>
@@ -52,13 +53,18 @@ public:
     typedef TMatrix Matrix;
     typedef TVector Vector;
     typedef sofa::component::linearsolver::MatrixLinearSolver<TMatrix,TVector> Inherit;
+    typedef typename Inherit::ResMatrixType ResMatrixType;
+    typedef typename Inherit::JMatrixType JMatrixType;
 
     Data<bool> f_verbose; ///< Dump system state at each iteration
+    Data<int> d_compliancePanelSize; ///< number of rows of J solved together when computing J A^-1 J^T
+    Data<bool> d_parallelCompliance; ///< compute J A^-1 J^T in parallel with the TaskScheduler
 
     SparseCholeskySolver();
     ~SparseCholeskySolver();
     void solve (Matrix& M, Vector& x, Vector& b) override;
     void invert(Matrix& M) override;
+    bool addJMInvJtLocal(Matrix * M, ResMatrixType * result, const JMatrixType * J, double fact) override;
 
 public :
     cs A;
@@ -70,6 +76,9 @@ public :
 
     void solveT(double * z, double * r);
     void solveT(float * z, float * r);
+
+protected:
+    MultiRHSTriangularSolver<double> complianceSolver;
 };
 
 #if  !defined(SOFA_COMPONENT_LINEARSOLVER_SPARSECHOLESKYSOLVER_CPP)
@@ -31,6 +31,7 @@
 #include <sofa/helper/map.h>
 #include <cmath>
 #include <SofaSparseSolver/SparseLDLSolverImpl.h>
+#include <SofaSparseSolver/MultiRHSTriangularSolver.h>
 #include <sofa/defaulttype/BaseMatrix.h>
 #include <sofa/core/objectmodel/DataFileName.h>
 
@@ -66,6 +67,8 @@ public :
     Data<bool> f_saveMatrixToFile;      ///< save matrix to a text file (can be very slow, as full matrix is stored)
     sofa::core::objectmodel::DataFileName d_filename;   ///< file where this matrix will be saved
     Data<int> d_precision;      ///< number of digits used to save system's matrix, default is 6
+    Data<int> d_compliancePanelSize; ///< number of rows of J solved together when computing J A^-1 J^T
+    Data<bool> d_parallelCompliance; ///< compute J A^-1 J^T in parallel with the TaskScheduler
 
     MatrixInvertData * createInvertData() override {
         return new InvertData();
@@ -74,7 +77,7 @@ public :
 protected :
     SparseLDLSolver();
 
-    FullMatrix<Real> Jminv,Jdense;
+    MultiRHSTriangularSolver<Real> complianceSolver;
     sofa::component::linearsolver::CompressedRowSparseMatrix<Real> Mfiltered;
 };
 
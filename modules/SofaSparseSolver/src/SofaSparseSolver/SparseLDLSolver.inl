@@ -47,6 +47,8 @@ SparseLDLSolver<TMatrix,TVector,TThreadManager>::SparseLDLSolver()
     , f_saveMatrixToFile( initData(&f_saveMatrixToFile, false, "savingMatrixToFile", "save matrix to a text file (can be very slow, as full matrix is stored"))
     , d_filename( initData(&d_filename, std::string("MatrixInLDL_%04d.txt"),"savingFilename", "Name of file where system matrix (mass, stiffness and damping) will be stored."))
     , d_precision( initData(&d_precision, 6, "savingPrecision", "Number of digits used to store system's matrix. Default is 6."))
+    , d_compliancePanelSize( initData(&d_compliancePanelSize, 16, "compliancePanelSize", "Number of rows of J solved together when computing the compliance J A^-1 J^T"))
+    , d_parallelCompliance( initData(&d_parallelCompliance, false, "parallelCompliance", "Compute the compliance J A^-1 J^T in parallel with the TaskScheduler"))
 {}
 
 template<class TMatrix, class TVector, class TThreadManager>
@@ -91,63 +93,25 @@ void SparseLDLSolver<TMatrix,TVector,TThreadManager>::invert(Matrix& M) {
     numStep++;
 }
 
-/// Default implementation of Multiply the inverse of the system matrix by the transpose of the given matrix, and multiply the result with the given matrix J
+/// Multiply the inverse of the system matrix by the transpose of the given matrix, and multiply the result with the given matrix J
 template<class TMatrix, class TVector, class TThreadManager>
 bool SparseLDLSolver<TMatrix,TVector,TThreadManager>::addJMInvJtLocal(TMatrix * M, ResMatrixType * result,const JMatrixType * J, double fact) {
     if (J->rowSize()==0) return true;
 
     InvertData * data = (InvertData *) this->getMatrixInvertData(M);
 
-    Jdense.clear();
-    Jdense.resize(J->rowSize(),data->n);
-    Jminv.resize(J->rowSize(),data->n);
-
-    for (typename SparseMatrix<Real>::LineConstIterator jit = J->begin() , jitend = J->end(); jit != jitend; ++jit) {
-        int l = jit->first;
-        Real * line = Jdense[l];
-        for (typename SparseMatrix<Real>::LElementConstIterator it = jit->second.begin(), i2end = jit->second.end(); it != i2end; ++it) {
-            int col = data->invperm[it->first];
-            double val = it->second;
-
-            line[col] = val;
-        }
-    }
-
-    //Solve the lower triangular system
-    for (unsigned c=0;c<(unsigned)J->rowSize();c++) {
-        Real * line = Jdense[c];
-
-        for (int j=0; j<data->n; j++) {
-            for (int p = data->LT_colptr[j] ; p<data->LT_colptr[j+1] ; p++) {
-                int col = data->LT_rowind[p];
-                double val = data->LT_values[p];
-                line[j] -= val * line[col];
-            }
-        }
-    }
-
-    //apply diagonal
-    for (unsigned j=0; j<(unsigned)J->rowSize(); j++) {
-        Real * lineD = Jdense[j];
-        Real * lineM = Jminv[j];
-        for (unsigned i=0;i<(unsigned)J->colSize();i++) {
-            lineM[i] = lineD[i] * data->invD[i];
-        }
-    }
-
-    for (unsigned j=0; j<(unsigned)J->rowSize(); j++) {
-        Real * lineJ = Jminv[j];
-        for (unsigned i=j;i<(unsigned)J->rowSize();i++) {
-            Real * lineI = Jdense[i];
-
-            double acc = 0.0;
-            for (unsigned k=0;k<(unsigned)J->colSize();k++) {
-                acc += lineJ[k] * lineI[k];
-            }
-            result->add(j,i,acc*fact);
-            if(i!=j) result->add(i,j,acc*fact);
-        }
-    }
+    LowerTriangularFactor<Real> L;
+    L.n = data->n;
+    L.colptr = data->L_colptr.data();
+    L.rowind = data->L_rowind.data();
+    L.values = data->L_values.data();
+    L.unitDiagonal = true;
+    L.parent = data->Parent.data();
+    L.permutation = data->invperm.data();
+    L.invD = data->invD.data();
+
+    simulation::TaskScheduler* scheduler = d_parallelCompliance.getValue() ? simulation::TaskScheduler::getInstance() : nullptr;
+    complianceSolver.addJMInvJt(L, *J, result, fact, d_compliancePanelSize.getValue(), scheduler);
 
     return true;
 }
@@ -25,6 +25,9 @@
 
 #include <sofa/core/behavior/LinearSolver.h>
 #include <SofaBaseLinearSolver/MatrixLinearSolver.h>
+#include <sofa/simulation/ParallelForRange.h>
+#include <algorithm>
+#include <queue>
 
 extern "C" {
 #include <metis.h>
@@ -49,6 +52,15 @@ public :
     VecReal P_values,L_values,LT_values,invD;
     helper::vector<int> Parent;
     bool new_factorization_needed;
+
+    // supernodes: columns [super_begin[s],super_begin[s+1]) share the same structure in L and are stored
+    // as a dense column-major panel of rows super_rows[super_rowptr[s]..super_rowptr[s+1]) at offset super_valptr[s]
+    helper::vector<int> super_begin, super_of, super_rowptr, super_rows, super_valptr;
+
+    // partition of the elimination tree in independent groups of subtrees for the parallel solve,
+    // the remaining top nodes are solved sequentially
+    helper::vector<int> solve_group_ptr, solve_group_nodes, solve_top_nodes;
+    unsigned solve_partition_threads = 0;
 };
 
 inline void CSPARSE_symbolic (int n,int * M_colptr,int * M_rowind,int * colptr,int * perm,int * invperm,int * Parent, int * Flag, int * Lnz)
@@ -134,6 +146,272 @@ inline void CSPARSE_numeric(int n,int * M_colptr,int * M_rowind,Real * M_values,
     }
 }
 
+/// Fill the row indices of L, given the column pointers computed by CSPARSE_symbolic.
+/// The indices of each column are sorted, as CSPARSE_numeric would write them.
+inline void CSPARSE_symbolic_pattern (int n,int * M_colptr,int * M_rowind,int * colptr,int * rowind,int * perm,int * invperm,int * Parent, int * Flag, int * Lnz)
+{
+    for (int k = 0 ; k < n ; k++)
+    {
+        Flag [k] = k ;
+        Lnz [k] = 0 ;
+        int kk = perm[k];
+        for (int p = M_colptr[kk] ; p < M_colptr[kk+1] ; p++)
+        {
+            int i = invperm[M_rowind[p]];
+            if (i < k)
+            {
+                for ( ; Flag [i] != k ; i = Parent [i])
+                {
+                    rowind[colptr[i] + Lnz[i]++] = k ;	/* L (k,i) is nonzero */
+                    Flag [i] = k ;
+                }
+            }
+        }
+    }
+}
+
+/// Detect the supernodes of L: consecutive columns j,j+1 with Parent[j]==j+1 and the same structure below j+1.
+/// 3x3 blocks of FEM matrices naturally end up in the same supernode.
+inline void LDL_supernodes(int n,const int * colptr,const int * rowind,const int * Parent,
+                           helper::vector<int> & super_begin,helper::vector<int> & super_of,helper::vector<int> & super_rowptr,
+                           helper::vector<int> & super_rows,helper::vector<int> & super_valptr)
+{
+    super_begin.clear();
+    super_of.resize(n);
+    for (int j = 0 ; j < n ; j++)
+    {
+        if (j == 0 || Parent[j-1] != j || colptr[j] - colptr[j-1] != colptr[j+1] - colptr[j] + 1)
+            super_begin.push_back(j);
+        super_of[j] = (int)super_begin.size() - 1;
+    }
+    super_begin.push_back(n);
+
+    const int nsuper = (int)super_begin.size() - 1;
+    super_rowptr.resize(nsuper+1);
+    super_valptr.resize(nsuper+1);
+    super_rows.clear();
+    super_rowptr[0] = 0;
+    super_valptr[0] = 0;
+    for (int s = 0 ; s < nsuper ; s++)
+    {
+        const int first = super_begin[s], last = super_begin[s+1] - 1;
+        // the panel rows are the columns of the supernode followed by the structure of its last column
+        for (int j = first ; j <= last ; j++) super_rows.push_back(j);
+        for (int p = colptr[last] ; p < colptr[last+1] ; p++) super_rows.push_back(rowind[p]);
+        super_rowptr[s+1] = (int)super_rows.size();
+        super_valptr[s+1] = super_valptr[s] + (super_rowptr[s+1] - super_rowptr[s]) * (last - first + 1);
+    }
+}
+
+/// Left-looking supernodal LDL^T numeric factorization.
+/// Each supernode is assembled in a dense panel, updated by its descendants with dense block products,
+/// factorized with a dense LDL^T kernel, and finally scattered in the column storage of L.
+template<class Real>
+inline bool LDL_supernodal_numeric(int n,int * M_colptr,int * M_rowind,Real * M_values,int * colptr,Real * values,Real * D,int * perm,int * invperm,
+                                   const helper::vector<int> & super_begin,const helper::vector<int> & super_of,const helper::vector<int> & super_rowptr,
+                                   const helper::vector<int> & super_rows,const helper::vector<int> & super_valptr,
+                                   helper::vector<Real> & Panels,helper::vector<int> & Map,helper::vector<int> & Head,helper::vector<int> & Next,
+                                   helper::vector<int> & Pos,helper::vector<Real> & Update)
+{
+    const int nsuper = (int)super_begin.size() - 1;
+
+    Panels.clear();
+    Panels.resize(super_valptr[nsuper]);
+    Map.resize(n);
+    Head.clear();
+    Head.resize(nsuper,-1);
+    Next.resize(nsuper);
+    Pos.resize(nsuper);
+
+    for (int s = 0 ; s < nsuper ; s++)
+    {
+        const int first = super_begin[s];
+        const int last = super_begin[s+1] - 1;
+        const int nc = last - first + 1;
+        const int * rows = super_rows.data() + super_rowptr[s];
+        const int m = super_rowptr[s+1] - super_rowptr[s];
+        Real * P = Panels.data() + super_valptr[s];
+
+        for (int r = 0 ; r < m ; r++) Map[rows[r]] = r;
+
+        // scatter the lower part of the permuted matrix in the panel
+        for (int c = 0 ; c < nc ; c++)
+        {
+            const int j = first + c;
+            const int kk = perm[j];
+            for (int p = M_colptr[kk] ; p < M_colptr[kk+1] ; p++)
+            {
+                const int i = invperm[M_rowind[p]];
+                if (i >= j) P[c*m + Map[i]] += M_values[p];
+            }
+        }
+
+        // updates from the descendant supernodes having rows in the columns of s
+        int d = Head[s];
+        Head[s] = -1;
+        while (d != -1)
+        {
+            const int dnext = Next[d];
+            const int dfirst = super_begin[d];
+            const int dnc = super_begin[d+1] - dfirst;
+            const int * drows = super_rows.data() + super_rowptr[d];
+            const int dm = super_rowptr[d+1] - super_rowptr[d];
+            const Real * L = Panels.data() + super_valptr[d];
+
+            const int p1 = Pos[d];
+            int p2 = p1;
+            while (p2 < dm && drows[p2] <= last) p2++;
+
+            // dense product C = L(p1:dm,:) * D * L(p1:p2,:)^T, lower part only
+            const int cm = dm - p1;
+            const int cn = p2 - p1;
+            Update.clear();
+            Update.resize(cm * cn);
+            Real * C = Update.data();
+            for (int k = 0 ; k < dnc ; k++)
+            {
+                const Real * Lk = L + k*dm + p1;
+                const Real dk = D[dfirst + k];
+                for (int b = 0 ; b < cn ; b++)
+                {
+                    const Real w = Lk[b] * dk;
+                    Real * Cb = C + b*cm;
+                    for (int a = b ; a < cm ; a++) Cb[a] += Lk[a] * w;
+                }
+            }
+
+            for (int b = 0 ; b < cn ; b++)
+            {
+                Real * Pc = P + (drows[p1 + b] - first) * m;
+                const Real * Cb = C + b*cm;
+                for (int a = b ; a < cm ; a++) Pc[Map[drows[p1 + a]]] -= Cb[a];
+            }
+
+            Pos[d] = p2;
+            if (p2 < dm)
+            {
+                const int t = super_of[drows[p2]];
+                Next[d] = Head[t];
+                Head[t] = d;
+            }
+            d = dnext;
+        }
+
+        // dense LDL^T of the panel
+        for (int c = 0 ; c < nc ; c++)
+        {
+            Real * Pc = P + c*m;
+            const Real dc = Pc[c];
+            if (dc == 0.0)
+            {
+                msg_error("SparseLDLSolver") << "Failed to factorize, D(k,k) is zero" ;
+                return false;
+            }
+            D[first + c] = dc;
+
+            for (int c2 = c+1 ; c2 < nc ; c2++)
+            {
+                const Real l = Pc[c2] / dc;
+                Real * Pc2 = P + c2*m;
+                for (int r = c2 ; r < m ; r++) Pc2[r] -= Pc[r] * l;
+            }
+            const Real invdc = 1.0 / dc;
+            for (int r = c+1 ; r < m ; r++) Pc[r] *= invdc;
+        }
+
+        Pos[s] = nc;
+        if (nc < m)
+        {
+            const int t = super_of[rows[nc]];
+            Next[s] = Head[t];
+            Head[t] = s;
+        }
+
+        // copy the strictly lower part of the panel in the column storage of L
+        for (int c = 0 ; c < nc ; c++)
+        {
+            const int j = first + c;
+            std::copy(P + c*m + c + 1, P + (c+1)*m, values + colptr[j]);
+        }
+    }
+
+    return true;
+}
+
+/// Split the elimination tree in groups of independent subtrees of similar size.
+/// The nodes of each group only depend on nodes of the same group in L, the top nodes are all the remaining ones.
+inline void LDL_solve_partition(int n,const int * Parent,unsigned nbThreads,helper::vector<int> & group_ptr,helper::vector<int> & group_nodes,helper::vector<int> & top_nodes)
+{
+    group_ptr.clear();
+    group_nodes.clear();
+    top_nodes.clear();
+    group_ptr.push_back(0);
+    if (nbThreads < 2 || n == 0) return;
+
+    helper::vector<int> size(n,1), head(n,-1), next(n,-1);
+    for (int j = 0 ; j < n ; j++)
+    {
+        if (Parent[j] != -1)
+        {
+            size[Parent[j]] += size[j];
+            next[j] = head[Parent[j]];
+            head[Parent[j]] = j;
+        }
+    }
+
+    // split the largest subtrees until they are small enough to be balanced on the threads
+    const int maxSize = std::max(1, n / (int)(4*nbThreads));
+    std::priority_queue< std::pair<int,int> > candidates;
+    for (int j = 0 ; j < n ; j++)
+        if (Parent[j] == -1) candidates.push(std::make_pair(size[j],j));
+
+    helper::vector<int> owner(n,-1); // -2 for top nodes, otherwise the index of the root of the subtree
+    int nbTop = 0;
+    while (!candidates.empty() && candidates.top().first > maxSize && nbTop < n/2)
+    {
+        const int r = candidates.top().second;
+        candidates.pop();
+        owner[r] = -2;
+        nbTop++;
+        for (int c = head[r] ; c != -1 ; c = next[c]) candidates.push(std::make_pair(size[c],c));
+    }
+
+    // gather the subtrees in groups of about maxSize nodes
+    helper::vector<int> group(n,-1);
+    int nbGroups = 0, groupSize = 0;
+    while (!candidates.empty())
+    {
+        const int r = candidates.top().second;
+        candidates.pop();
+        if (groupSize == 0) nbGroups++;
+        group[r] = nbGroups - 1;
+        groupSize += size[r];
+        if (groupSize >= maxSize) groupSize = 0;
+    }
+
+    if (nbGroups < 2)
+    {
+        group_ptr.clear();
+        group_ptr.push_back(0);
+        return;
+    }
+
+    // propagate the group of each subtree root to its descendants
+    for (int j = n-1 ; j >= 0 ; j--)
+    {
+        if (owner[j] == -2) top_nodes.push_back(j);
+        else if (group[j] == -1) group[j] = group[Parent[j]];
+    }
+    std::reverse(top_nodes.begin(),top_nodes.end());
+
+    group_ptr.resize(nbGroups+1,0);
+    for (int j = 0 ; j < n ; j++) if (owner[j] != -2) group_ptr[group[j]+1]++;
+    for (int g = 0 ; g < nbGroups ; g++) group_ptr[g+1] += group_ptr[g];
+    group_nodes.resize(group_ptr[nbGroups]);
+    helper::vector<int> fill(group_ptr.begin(),group_ptr.end()-1);
+    for (int j = 0 ; j < n ; j++) if (owner[j] != -2) group_nodes[fill[group[j]]++] = j;
+}
+
 inline bool CSPARSE_need_symbolic_factorization(int s_M, int * M_colptr,int * M_rowind, int s_P, int * P_colptr,int * P_rowind) {
     if (s_M != s_P) return true;
     if (M_colptr[s_M] != P_colptr[s_M] ) return true;
@@ -162,9 +440,16 @@ public:
     typedef TThreadManager ThreadManager;
     typedef typename TMatrix::Real Real;
 
+    Data<bool> d_supernodal; ///< use the supernodal numeric factorization
+    Data<bool> d_parallelSolve; ///< solve the independent subtrees of the elimination tree in parallel
+
 protected :
 
-    SparseLDLSolverImpl() : Inherit() {}
+    SparseLDLSolverImpl()
+        : Inherit()
+        , d_supernodal(initData(&d_supernodal, false, "supernodal", "use a supernodal numeric factorization, computing the columns of L with the same structure with dense block operations"))
+        , d_parallelSolve(initData(&d_parallelSolve, false, "parallelSolve", "solve the independent subtrees of the elimination tree in parallel with the TaskScheduler"))
+    {}
 
     template<class VecInt,class VecReal>
     void solve_cpu(Real * x,const Real * b,SparseLDLImplInvertData<VecInt,VecReal> * data) {
@@ -180,24 +465,65 @@ protected :
 
         Tmp.clear();
         Tmp.fastResize(n);
+        Real * tmp = Tmp.data();
 
-        for (int j = 0 ; j < n ; j++) {
+        auto forward = [&](int j) {
             Real acc = b[perm[j]];
             for (int p = LT_colptr [j] ; p < LT_colptr[j+1] ; p++) {
-                acc -= LT_values[p] * Tmp[LT_rowind[p]];
+                acc -= LT_values[p] * tmp[LT_rowind[p]];
             }
-            Tmp[j] = acc;
-        }
+            tmp[j] = acc;
+        };
 
-        for (int j = n-1 ; j >= 0 ; j--) {
-            Tmp[j] *= invD[j];
+        auto backward = [&](int j) {
+            tmp[j] *= invD[j];
 
             for (int p = L_colptr[j] ; p < L_colptr[j+1] ; p++) {
-                Tmp[j] -= L_values[p] * Tmp[L_rowind[p]];
+                tmp[j] -= L_values[p] * tmp[L_rowind[p]];
             }
 
-            x[perm[j]] = Tmp[j];
+            x[perm[j]] = tmp[j];
+        };
+
+        simulation::TaskScheduler* scheduler = nullptr;
+        if (d_parallelSolve.getValue()) {
+            scheduler = simulation::TaskScheduler::getInstance();
+            const unsigned nbThreads = scheduler->getThreadCount();
+            if (data->solve_partition_threads != nbThreads) {
+                LDL_solve_partition(n,data->Parent.data(),nbThreads,data->solve_group_ptr,data->solve_group_nodes,data->solve_top_nodes);
+                data->solve_partition_threads = nbThreads;
+            }
         }
+
+        const int nbGroups = (int)data->solve_group_ptr.size() - 1;
+        if (scheduler == nullptr || nbGroups < 2) {
+            for (int j = 0 ; j < n ; j++) forward(j);
+            for (int j = n-1 ; j >= 0 ; j--) backward(j);
+            return;
+        }
+
+        const int * group_ptr = data->solve_group_ptr.data();
+        const int * group_nodes = data->solve_group_nodes.data();
+        const helper::vector<int> & top_nodes = data->solve_top_nodes;
+
+        // L y = b: the subtrees only depend on themselves, the top nodes depend on everything below
+        auto forwardGroup = [&](int g) {
+            for (int p = group_ptr[g] ; p < group_ptr[g+1] ; p++) forward(group_nodes[p]);
+        };
+        runOnGroups(scheduler, nbGroups, forwardGroup);
+        for (std::size_t i = 0 ; i < top_nodes.size() ; i++) forward(top_nodes[i]);
+
+        // D L^T x = y: the top nodes first, then the subtrees
+        for (std::size_t i = top_nodes.size() ; i-- > 0 ; ) backward(top_nodes[i]);
+        auto backwardGroup = [&](int g) {
+            for (int p = group_ptr[g+1] ; p-- > group_ptr[g] ; ) backward(group_nodes[p]);
+        };
+        runOnGroups(scheduler, nbGroups, backwardGroup);
+    }
+
+    template<class Function>
+    void runOnGroups(simulation::TaskScheduler* scheduler, int nbGroups, const Function& func) {
+        simulation::parallelForRange(scheduler, 0, nbGroups, 1, [&](std::size_t g, std::size_t) { func(int(g)); });
     }
 
     void LDL_ordering(int n,int * M_colptr,int * M_rowind,int * perm,int * invperm) {
@@ -278,6 +604,18 @@ protected :
         CSPARSE_numeric<Real>(n,M_colptr,M_rowind,M_values,colptr,rowind,values,D,perm,invperm,Parent,Flag.data(),Lnz.data(),Pattern.data(),Y.data());
     }
 
+    template<class VecInt,class VecReal>
+    void LDL_supernodal_symbolic(int n,int * M_colptr,int * M_rowind,SparseLDLImplInvertData<VecInt,VecReal> * data) {
+        Lnz.resize(n);
+        Flag.resize(n);
+
+        CSPARSE_symbolic_pattern(n,M_colptr,M_rowind,data->L_colptr.data(),data->L_rowind.data(),data->perm.data(),data->invperm.data(),data->Parent.data(),Flag.data(),Lnz.data());
+        LDL_supernodes(n,data->L_colptr.data(),data->L_rowind.data(),data->Parent.data(),
+                       data->super_begin,data->super_of,data->super_rowptr,data->super_rows,data->super_valptr);
+
+        msg_info() << n << " columns in " << data->super_begin.size()-1 << " supernodes" ;
+    }
+
     template<class VecInt,class VecReal>
     void factorize(int n,int * M_colptr, int * M_rowind, Real * M_values, SparseLDLImplInvertData<VecInt,VecReal> * data) {
         data->new_factorization_needed = data->P_colptr.size() == 0 || data->P_rowind.size() == 0 || CSPARSE_need_symbolic_factorization(n, M_colptr, M_rowind, data->n,
@@ -308,6 +646,8 @@ protected :
 
             data->Parent.clear();
             data->Parent.resize(data->n);
+            data->super_begin.clear();
+            data->solve_partition_threads = 0;
 
             //symbolic factorization
             LDL_symbolic(data->n,M_colptr,M_rowind,data->L_colptr.data(),
@@ -330,8 +670,21 @@ protected :
         Real * tran_values = data->LT_values.data();
 
         //Numeric Factorization
-        LDL_numeric(data->n,M_colptr,M_rowind,M_values,colptr,rowind,values,D,
-                    data->perm.data(),data->invperm.data(),data->Parent.data());
+        if (d_supernodal.getValue()) {
+            if (data->new_factorization_needed || data->super_begin.empty()) {
+                LDL_supernodal_symbolic(data->n,M_colptr,M_rowind,data);
+            }
+
+            LDL_supernodal_numeric<Real>(data->n,M_colptr,M_rowind,M_values,colptr,values,D,data->perm.data(),data->invperm.data(),
+                                         data->super_begin,data->super_of,data->super_rowptr,data->super_rows,data->super_valptr,
+                                         Panels,Map,Head,Next,Pos,Update);
+
+            // the panels are only a workspace, L is stored in its column storage
+            helper::vector<Real>().swap(Panels);
+        } else {
+            LDL_numeric(data->n,M_colptr,M_rowind,M_values,colptr,rowind,values,D,
+                        data->perm.data(),data->invperm.data(),data->Parent.data());
+        }
 
         //inverse the diagonal
         for (int i=0;i<data->n;i++) D[i] = 1.0/D[i];
@@ -370,6 +723,8 @@ protected : //the folowing variables are used during the factorization they cann
     helper::vector<int> xadj,adj,t_xadj,t_adj;
     helper::vector<Real> Y;
     helper::vector<int> Lnz,Flag,Pattern;
+    helper::vector<Real> Panels,Update;
+    helper::vector<int> Map,Head,Next,Pos;
     helper::vector<int> tran_countvec;
 
 //    helper::vector<int> perm, invperm; //premutation inverse
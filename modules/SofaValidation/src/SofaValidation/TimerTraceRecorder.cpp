@@ -0,0 +1,105 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#define SOFA_COMPONENT_MISC_TIMERTRACERECORDER_CPP
+#include <SofaValidation/TimerTraceRecorder.h>
+#include <sofa/core/ObjectFactory.h>
+#include <sofa/helper/AdvancedTimer.h>
+#include <sofa/simulation/AnimateBeginEvent.h>
+#include <sofa/simulation/AnimateEndEvent.h>
+
+namespace sofa::component::misc
+{
+
+using sofa::helper::AdvancedTimer;
+
+int TimerTraceRecorderClass = core::RegisterObject("Record the AdvancedTimer events of the animation steps in a Chrome trace-event file")
+        .add< TimerTraceRecorder >()
+        ;
+
+TimerTraceRecorder::TimerTraceRecorder()
+    : d_filename( initData(&d_filename, "filename", "Trace file, in the Chrome trace-event format") )
+    , d_timerName( initData(&d_timerName, std::string("TimerTraceRecorder"), "timerName", "Name of the AdvancedTimer recording the steps. It must differ from the timers started by the application (e.g. Animate).") )
+    , d_firstStep( initData(&d_firstStep, 0u, "firstStep", "Index of the first recorded animation step") )
+    , d_nbSteps( initData(&d_nbSteps, 0u, "nbSteps", "Number of recorded animation steps (0: all the steps)") )
+    , d_maxEvents( initData(&d_maxEvents, 1000000u, "maxEvents", "The trace is closed once this number of events is written") )
+    , m_recording(false)
+    , m_stepStarted(false)
+{
+    f_listening.setValue(true);
+}
+
+TimerTraceRecorder::~TimerTraceRecorder()
+{
+    closeTrace();
+}
+
+void TimerTraceRecorder::init()
+{
+    closeTrace();
+
+    if (d_filename.getValue().empty())
+    {
+        msg_error() << "No trace file given, nothing will be recorded.";
+        return;
+    }
+
+    AdvancedTimer::setTraceOutput(d_timerName.getValue(), d_filename.getFullPath(),
+                                  d_firstStep.getValue(), d_nbSteps.getValue(), d_maxEvents.getValue());
+    m_recording = true;
+}
+
+void TimerTraceRecorder::cleanup()
+{
+    closeTrace();
+}
+
+void TimerTraceRecorder::handleEvent(sofa::core::objectmodel::Event* event)
+{
+    if (!m_recording) return;
+
+    if (sofa::simulation::AnimateBeginEvent::checkEventType(event) && !m_stepStarted)
+    {
+        AdvancedTimer::begin(d_timerName.getValue().c_str());
+        m_stepStarted = true;
+    }
+    else if (sofa::simulation::AnimateEndEvent::checkEventType(event) && m_stepStarted)
+    {
+        AdvancedTimer::end(d_timerName.getValue().c_str());
+        m_stepStarted = false;
+    }
+}
+
+void TimerTraceRecorder::closeTrace()
+{
+    if (!m_recording) return;
+
+    if (m_stepStarted)
+    {
+        AdvancedTimer::end(d_timerName.getValue().c_str());
+        m_stepStarted = false;
+    }
+    AdvancedTimer::closeTraceOutput(d_timerName.getValue());
+    AdvancedTimer::setEnabled(d_timerName.getValue(), false);
+    m_recording = false;
+}
+
+} // namespace sofa::component::misc
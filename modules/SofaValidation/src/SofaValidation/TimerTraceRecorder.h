@@ -0,0 +1,65 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaValidation/config.h>
+
+#include <sofa/core/objectmodel/BaseObject.h>
+#include <sofa/core/objectmodel/DataFileName.h>
+
+namespace sofa::component::misc
+{
+
+/**
+ * @brief  TimerTraceRecorder Class
+ *
+ * Records the AdvancedTimer events of the animation steps in a file using the Chrome
+ * trace-event format, to be opened in chrome://tracing or https://ui.perfetto.dev.
+ * Each thread gets its own lane, so the work of the TaskScheduler workers, visitors
+ * and solvers inside one step can be inspected on the same timeline.
+ * The component runs its own timer from AnimateBeginEvent to AnimateEndEvent.
+ */
+class SOFA_SOFAVALIDATION_API TimerTraceRecorder : public virtual sofa::core::objectmodel::BaseObject
+{
+public:
+    SOFA_CLASS(TimerTraceRecorder, core::objectmodel::BaseObject);
+
+    void init() override;
+    void cleanup() override;
+    void handleEvent(sofa::core::objectmodel::Event* event) override;
+
+protected:
+    TimerTraceRecorder();
+    ~TimerTraceRecorder() override;
+
+    void closeTrace();
+
+    sofa::core::objectmodel::DataFileName d_filename; ///< trace file
+    Data<std::string> d_timerName; ///< name of the AdvancedTimer recording the steps
+    Data<unsigned int> d_firstStep; ///< index of the first recorded step
+    Data<unsigned int> d_nbSteps; ///< number of recorded steps (0: all)
+    Data<unsigned int> d_maxEvents; ///< maximum number of events written in the trace
+
+    bool m_recording;
+    bool m_stepStarted;
+};
+
+} // namespace sofa::component::misc